@@ -62,6 +62,7 @@ class AliCFContainer : public AliCFFrame
   virtual Int_t GetNStep() const {return fNStep;};
   virtual void  SetNStep(Int_t nStep) {fNStep=nStep;}
   virtual void  Fill(const Double_t *var, Int_t istep, Double_t weight=1.) ;
+  virtual void  SetFillBufferSize(Int_t size) ; // buffered filling of the grids, see AliCFGridSparse
 
   virtual Float_t  GetOverFlows (Int_t var,Int_t istep,Bool_t excl=kFALSE) const;
   virtual Float_t  GetUnderFlows(Int_t var,Int_t istep,Bool_t excl=kFALSE) const ;
@@ -135,6 +136,10 @@ inline Int_t AliCFContainer::GetVar(const Char_t* title) const {
   return fGrid[0]->GetVar(title);
 }
 
+inline void AliCFContainer::SetFillBufferSize(Int_t size) {
+  for (Int_t iStep=0; iStep<fNStep; iStep++) fGrid[iStep]->SetFillBufferSize(size);
+}
+
 inline void AliCFContainer::SetBinLabel(Int_t iVar, Int_t iBin, const Char_t* label) {
   for (Int_t iStep=0; iStep<GetNStep(); iStep++) GetAxis(iVar,iStep)->SetBinLabel(iBin,label);
 }
@@ -34,6 +34,8 @@
 #include "TH3D.h"
 #include "TAxis.h"
 #include "AliCFUnfolding.h"
+#include "TBuffer.h"
+#include <algorithm>
 
 //____________________________________________________________________
 ClassImp(AliCFGridSparse)
@@ -42,7 +44,10 @@ ClassImp(AliCFGridSparse)
 AliCFGridSparse::AliCFGridSparse() : 
   AliCFFrame(),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fFillBufferSize(0),
+  fFillBuffer(),
+  fFillBufferBits()
 {
   // default constructor
 }
@@ -50,7 +55,10 @@ AliCFGridSparse::AliCFGridSparse() :
 AliCFGridSparse::AliCFGridSparse(const Char_t* name, const Char_t* title) : 
   AliCFFrame(name,title),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fFillBufferSize(0),
+  fFillBuffer(),
+  fFillBufferBits()
 {
   // default constructor
 }
@@ -58,7 +66,10 @@ AliCFGridSparse::AliCFGridSparse(const Char_t* name, const Char_t* title) :
 AliCFGridSparse::AliCFGridSparse(const Char_t* name, const Char_t* title, Int_t nVarIn, const Int_t * nBinIn) :  
   AliCFFrame(name,title),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fFillBufferSize(0),
+  fFillBuffer(),
+  fFillBufferBits()
 {
   //
   // main constructor
@@ -80,7 +91,10 @@ AliCFGridSparse::~AliCFGridSparse()
 AliCFGridSparse::AliCFGridSparse(const AliCFGridSparse& c) :
   AliCFFrame(c),
   fSumW2(kFALSE),
-  fData(0x0)
+  fData(0x0),
+  fFillBufferSize(0),
+  fFillBuffer(),
+  fFillBufferBits()
 {
   //
   // copy constructor
@@ -127,8 +141,94 @@ void AliCFGridSparse::Fill(const Double_t *var, Double_t weight)
   // Fill the grid,
   // given a set of values of the input variable, 
   // with weight (by default w=1)
+  // With a fill buffer only the bin coordinates are computed here,
+  // the THnSparse is filled in FlushFillBuffer()
   //
-  fData->Fill(var,weight);
+  if (fFillBufferBits.empty()) {
+    fData->Fill(var,weight);
+    return;
+  }
+  ULong64_t coord = 0;
+  Int_t shift = 0;
+  for (Int_t iVar=0; iVar<GetNVar(); iVar++) {
+    coord |= ((ULong64_t)fData->GetAxis(iVar)->FindBin(var[iVar])) << shift;
+    shift += fFillBufferBits[iVar];
+  }
+  fFillBuffer.push_back(std::make_pair(coord,weight));
+  if ((Int_t)fFillBuffer.size()>=fFillBufferSize) FlushFillBuffer();
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::SetFillBufferSize(Int_t size)
+{
+  //
+  // Buffer up to size entries in Fill() (0: fill the THnSparse directly).
+  // The buffer is flushed when full and before the grid is accessed
+  //
+  FlushFillBuffer();
+  fFillBufferSize = size;
+  SetupFillBuffer();
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::SetupFillBuffer()
+{
+  //
+  // number of bits of the bin coordinate of each axis (with under/overflows)
+  // in the packed 64-bit coordinates of the buffered entries
+  //
+  fFillBufferBits.clear();
+  if (fFillBufferSize<=0 || !fData) return;
+  Int_t nBitsTot = 0;
+  for (Int_t iVar=0; iVar<GetNVar(); iVar++) {
+    Int_t nBits = 1;
+    while ((1ll<<nBits) < (Long64_t)GetNBins(iVar)+2) nBits++;
+    fFillBufferBits.push_back(nBits);
+    nBitsTot += nBits;
+  }
+  if (nBitsTot>64) {
+    AliWarning(Form("%i bits needed for the bin coordinates, filling without buffer",nBitsTot));
+    fFillBufferBits.clear();
+  }
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::FlushFillBuffer() const
+{
+  //
+  // Add the buffered entries to the grid: the THnSparse bin is looked up
+  // once per distinct bin, with the sum of the weights and of the squared
+  // weights. Bin contents, errors and entries are as with direct filling
+  // (up to the rounding of the sums); the running sums of the THnSparse
+  // (GetSumw(), GetSumwx(),...) are not updated
+  //
+  if (fFillBuffer.empty()) return;
+
+  std::sort(fFillBuffer.begin(),fFillBuffer.end());
+  const Int_t nVar = GetNVar();
+  Int_t* bin = new Int_t[nVar];
+  const Bool_t calculateErrors = fData->GetCalculateErrors();
+  const Long64_t nEntries = fFillBuffer.size();
+  for (Long64_t iEntry=0; iEntry<nEntries; ) {
+    const ULong64_t coord = fFillBuffer[iEntry].first;
+    Double_t sumw = 0., sumw2 = 0.;
+    for ( ; iEntry<nEntries && fFillBuffer[iEntry].first==coord; iEntry++) {
+      const Double_t w = fFillBuffer[iEntry].second;
+      sumw  += w;
+      sumw2 += w*w;
+    }
+    Int_t shift = 0;
+    for (Int_t iVar=0; iVar<nVar; iVar++) {
+      bin[iVar] = (Int_t)((coord >> shift) & ((1ull<<fFillBufferBits[iVar])-1));
+      shift += fFillBufferBits[iVar];
+    }
+    Long64_t index = fData->GetBin(bin,kTRUE);
+    fData->AddBinContent(index,sumw);
+    if (calculateErrors) fData->AddBinError2(index,sumw2);
+  }
+  fData->SetEntries(fData->GetEntries()+nEntries);
+  delete [] bin;
+  fFillBuffer.clear();
 }
 
 //___________________________________________________________________
@@ -140,6 +240,7 @@ AliCFGridSparse* AliCFGridSparse::MakeSlice(Int_t nVars, const Int_t* vars, cons
   // If useBins=true, varMin and varMax are taken as bin numbers
   //
 
+  FlushFillBuffer();
   // binning for new grid
   Int_t* bins = new Int_t[nVars];
   for (Int_t iVar=0; iVar<nVars; iVar++) {
@@ -192,6 +293,7 @@ Float_t AliCFGridSparse::GetEntries() const
   // total entries (including overflows and underflows)
   //
 
+  FlushFillBuffer();
   return fData->GetEntries();
 }
 
@@ -202,6 +304,7 @@ Float_t AliCFGridSparse::GetElement(Long_t index) const
   // Returns content of grid element index 
   //
   
+  FlushFillBuffer();
   return fData->GetBinContent(index);
 }
 //____________________________________________________________________
@@ -210,6 +313,7 @@ Float_t AliCFGridSparse::GetElement(const Int_t *bin) const
   //
   // Get the content in a bin corresponding to a set of bin indexes
   //
+  FlushFillBuffer();
   return fData->GetBinContent(bin);
 
 }  
@@ -220,6 +324,7 @@ Float_t AliCFGridSparse::GetElement(const Double_t *var) const
   // Get the content in a bin corresponding to a set of input variables
   //
 
+  FlushFillBuffer();
   Long_t index = fData->GetBin(var,kFALSE);
   if (index<0) return 0.;
   return fData->GetBinContent(index);
@@ -232,6 +337,7 @@ Float_t AliCFGridSparse::GetElementError(Long_t index) const
   // Returns the error on the content 
   //
 
+  FlushFillBuffer();
   return fData->GetBinError(index);
 }
 //____________________________________________________________________
@@ -240,6 +346,7 @@ Float_t AliCFGridSparse::GetElementError(const Int_t *bin) const
  //
   // Get the error in a bin corresponding to a set of bin indexes
   //
+  FlushFillBuffer();
   return fData->GetBinError(bin);
 
 }  
@@ -250,6 +357,7 @@ Float_t AliCFGridSparse::GetElementError(const Double_t *var) const
   // Get the error in a bin corresponding to a set of input variables
   //
 
+  FlushFillBuffer();
   Long_t index=fData->GetBin(var,kFALSE); //this is the THnSparse index (do not allocate new cells if content is empy)
   if (index<0) return 0.;
   return fData->GetBinError(index);
@@ -261,6 +369,7 @@ void AliCFGridSparse::SetElement(Long_t index, Float_t val)
   //
   // Sets grid element value
   //
+  FlushFillBuffer();
   Int_t* bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin); //affects the bin coordinates
   SetElement(bin,val);
@@ -273,6 +382,7 @@ void AliCFGridSparse::SetElement(const Int_t *bin, Float_t val)
   //
   // Sets grid element of bin indeces bin to val
   //
+  FlushFillBuffer();
   fData->SetBinContent(bin,val);
 }
 //____________________________________________________________________
@@ -281,6 +391,7 @@ void AliCFGridSparse::SetElement(const Double_t *var, Float_t val)
   //
   // Set the content in a bin to value val corresponding to a set of input variables
   //
+  FlushFillBuffer();
   Long_t index=fData->GetBin(var,kTRUE); //THnSparse index: allocate the cell
   Int_t *bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin); //trick to access the array of bins
@@ -294,6 +405,7 @@ void AliCFGridSparse::SetElementError(Long_t index, Float_t val)
   //
   // Sets grid element iel error to val (linear indexing) in AliCFFrame
   //
+  FlushFillBuffer();
   Int_t *bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin);
   SetElementError(bin,val);
@@ -306,6 +418,7 @@ void AliCFGridSparse::SetElementError(const Int_t *bin, Float_t val)
   //
   // Sets grid element error of bin indeces bin to val
   //
+  FlushFillBuffer();
   fData->SetBinError(bin,val);
 }
 //____________________________________________________________________
@@ -314,6 +427,7 @@ void AliCFGridSparse::SetElementError(const Double_t *var, Float_t val)
   //
   // Set the error in a bin to value val corresponding to a set of input variables
   //
+  FlushFillBuffer();
   Long_t index=fData->GetBin(var); //THnSparse index
   Int_t *bin = new Int_t[GetNVar()];
   fData->GetBinContent(index,bin); //trick to access the array of bins
@@ -327,6 +441,7 @@ void AliCFGridSparse::SumW2()
   //
   //set calculation of the squared sum of the weighted entries
   //
+  FlushFillBuffer();
   if(!fSumW2){
     fData->CalculateErrors(kTRUE); 
   }
@@ -340,6 +455,7 @@ void AliCFGridSparse::Add(const AliCFGridSparse* aGrid, Double_t c)
   //add aGrid to the current one
   //
 
+  FlushFillBuffer();
   if (aGrid->GetNVar() != GetNVar()){
     AliError("Different number of variables, cannot add the grids");
     return;
@@ -356,6 +472,7 @@ void AliCFGridSparse::Add(const AliCFGridSparse* aGrid1, const AliCFGridSparse*
   //Add aGrid1 and aGrid2 and deposit the result into the current one
   //
 
+  FlushFillBuffer();
   if (GetNVar() != aGrid1->GetNVar() || GetNVar() != aGrid2->GetNVar()) {
     AliInfo("Different number of variables, cannot add the grids");
     return;
@@ -375,6 +492,7 @@ void AliCFGridSparse::Multiply(const AliCFGridSparse* aGrid, Double_t c)
   // Multiply aGrid to the current one
   //
 
+  FlushFillBuffer();
   if (aGrid->GetNVar() != GetNVar()) {
     AliError("Different number of variables, cannot multiply the grids");
     return;
@@ -393,6 +511,7 @@ void AliCFGridSparse::Multiply(const AliCFGridSparse* aGrid1, const AliCFGridSpa
   //Multiply aGrid1 and aGrid2 and deposit the result into the current one
   //
 
+  FlushFillBuffer();
   if (GetNVar() != aGrid1->GetNVar() || GetNVar() != aGrid2->GetNVar()) {
     AliError("Different number of variables, cannot multiply the grids");
     return;
@@ -415,6 +534,7 @@ void AliCFGridSparse::Divide(const AliCFGridSparse* aGrid, Double_t c)
   // Divide aGrid to the current one
   //
 
+  FlushFillBuffer();
   if (aGrid->GetNVar() != GetNVar()) {
     AliError("Different number of variables, cannot divide the grids");
     return;
@@ -436,6 +556,7 @@ void AliCFGridSparse::Divide(const AliCFGridSparse* aGrid1, const AliCFGridSpars
   //binomial errors are supported
   //
 
+  FlushFillBuffer();
   if (GetNVar() != aGrid1->GetNVar() || GetNVar() != aGrid2->GetNVar()) {
     AliError("Different number of variables, cannot divide the grids");
     return;
@@ -458,6 +579,7 @@ void AliCFGridSparse::Rebin(const Int_t* group)
   // a given axis has to be divisible by the rebin group.
   //
 
+  FlushFillBuffer();
   for(Int_t i=0;i<GetNVar();i++){
     if (group[i]!=1) AliInfo(Form(" merging bins along dimension %i in groups of %i bins", i,group[i]));
   }
@@ -465,6 +587,7 @@ void AliCFGridSparse::Rebin(const Int_t* group)
   THnSparse *rebinned =fData->Rebin(group);
   fData->Reset();
   fData = rebinned;
+  SetupFillBuffer();
 }
 //____________________________________________________________________
 void AliCFGridSparse::Scale(Long_t index, const Double_t *fact)
@@ -473,6 +596,7 @@ void AliCFGridSparse::Scale(Long_t index, const Double_t *fact)
   //scale content of a certain cell by (positive) fact (with error)
   //
 
+  FlushFillBuffer();
   if (GetElement(index)==0 || fact[0]==0) return;
 
   Double_t in[2], out[2];
@@ -488,6 +612,7 @@ void AliCFGridSparse::Scale(const Int_t *bin, const Double_t *fact)
   //
   //scale content of a certain cell by (positive) fact (with error)
   //
+  FlushFillBuffer();
   if(GetElement(bin)==0 || fact[0]==0)return;
 
   Double_t in[2], out[2];
@@ -504,6 +629,7 @@ void AliCFGridSparse::Scale(const Double_t *var, const Double_t *fact)
   //
   //scale content of a certain cell by (positive) fact (with error)
   //
+  FlushFillBuffer();
   if(GetElement(var)==0 || fact[0]==0)return;
 
   Double_t in[2], out[2];
@@ -521,6 +647,7 @@ void AliCFGridSparse::Scale(const Double_t* fact)
   //scale contents of the whole grid by fact
   //
 
+  FlushFillBuffer();
   for (Long_t iel=0; iel<GetNFilledBins(); iel++) {
     Scale(iel,fact);
   }
@@ -531,6 +658,7 @@ Long_t AliCFGridSparse::GetEmptyBins() const {
   // Get empty bins 
   //
 
+  FlushFillBuffer();
   return (GetNBinsTotal() - GetNFilledBins()) ;
 } 
 
@@ -540,6 +668,7 @@ Int_t AliCFGridSparse::CheckStats(Double_t thr) const
   //
   // Count the cells below a certain threshold
   //
+  FlushFillBuffer();
   Int_t ncellsLow=0;
   for (Int_t i=0; i<GetNBinsTotal(); i++) {
     if (GetElement(i)<thr) ncellsLow++;
@@ -553,6 +682,7 @@ Double_t AliCFGridSparse::GetIntegral() const
   //
   // Get full Integral
   //
+  FlushFillBuffer();
   return fData->ComputeIntegral();  
 } 
 
@@ -564,6 +694,7 @@ Long64_t AliCFGridSparse::Merge(TCollection* list)
   // Returns the number of merged objects (including this).
   //
 
+  FlushFillBuffer();
   if (!list)
     return 0;
   
@@ -603,12 +734,32 @@ void AliCFGridSparse::Copy(TObject& c) const
   //
   // copy function
   //
+  FlushFillBuffer();
   AliCFFrame::Copy(c);
   AliCFGridSparse& target = (AliCFGridSparse &) c;
   target.fSumW2 = fSumW2 ;
   if (fData) {
     target.fData = (THnSparse*)fData->Clone();
   }
+  target.fFillBuffer.clear();
+  target.fFillBufferSize = fFillBufferSize;
+  target.SetupFillBuffer();
+}
+
+//____________________________________________________________________
+void AliCFGridSparse::Streamer(TBuffer &R__b)
+{
+  //
+  // Stream an object of class AliCFGridSparse, the buffered entries
+  // are added to the grid before writing
+  //
+  if (R__b.IsReading()) {
+    R__b.ReadClassBuffer(AliCFGridSparse::Class(),this);
+  }
+  else {
+    FlushFillBuffer();
+    R__b.WriteClassBuffer(AliCFGridSparse::Class(),this);
+  }
 }
 
 //____________________________________________________________________
@@ -621,6 +772,7 @@ TH1* AliCFGridSparse::Slice(Int_t iVar1, Int_t iVar2, Int_t iVar3, const Double_
   // If useBins=true, varMin and varMax are taken as bin numbers
   // if varmin or varmax point to null, all the range is taken, including over- and underflows
 
+  FlushFillBuffer();
   THnSparse* clone = (THnSparse*)fData->Clone();
   if (varMin != 0x0 && varMax != 0x0) {
     for (Int_t iAxis=0; iAxis<GetNVar(); iAxis++) SetAxisRange(clone->GetAxis(iAxis),varMin[iAxis],varMax[iAxis],useBins);
@@ -746,6 +898,7 @@ Float_t AliCFGridSparse::GetOverFlows(Int_t ivar, Bool_t exclusive) const
   // Returns overflows in variable ivar
   // Set 'exclusive' to true for an exclusive check on variable ivar
   //
+  FlushFillBuffer();
   Int_t* bin = new Int_t[GetNVar()];
   memset(bin, 0, sizeof(Int_t) * GetNVar());
   Float_t ovfl=0.;
@@ -772,6 +925,7 @@ Float_t AliCFGridSparse::GetUnderFlows(Int_t ivar, Bool_t exclusive) const
   // Returns exclusive overflows in variable ivar
   // Set 'exclusive' to true for an exclusive check on variable ivar
   //
+  FlushFillBuffer();
   Int_t* bin = new Int_t[GetNVar()];
   memset(bin, 0, sizeof(Int_t) * GetNVar());
   Float_t unfl=0.;
@@ -798,6 +952,7 @@ void AliCFGridSparse::Smooth() {
   // smoothing function: TO USE WITH CARE
   //
 
+  FlushFillBuffer();
   AliInfo("Your GridSparse is going to be smoothed");
   AliInfo(Form("N TOTAL  BINS : %li",GetNBinsTotal()));
   AliInfo(Form("N FILLED BINS : %li",GetNFilledBins()));
@@ -8,6 +8,8 @@
 // Author:S.Arcelli, silvia.arcelli@cern.ch
 //--------------------------------------------------------------------//
 
+#include <vector>
+#include <utility>
 #include "AliCFFrame.h"
 #include "THnSparse.h"
 #include "AliLog.h"
@@ -37,7 +39,7 @@ class AliCFGridSparse : public AliCFFrame
   virtual void       GetBinLimits(Int_t ivar, Double_t * array) const ;
   virtual Double_t * GetBinLimits(Int_t ivar) const ;
   virtual Long_t     GetNBinsTotal() const ;
-  virtual Long_t     GetNFilledBins() const {return fData->GetNbins();}
+  virtual Long_t     GetNFilledBins() const {FlushFillBuffer(); return fData->GetNbins();}
   virtual Int_t      GetNBins(Int_t ivar) const {return fData->GetAxis(ivar)->GetNbins();}
   virtual Int_t *    GetNBins() const ;
   virtual Float_t    GetBinCenter(Int_t ivar,Int_t ibin) const ;
@@ -56,6 +58,11 @@ class AliCFGridSparse : public AliCFFrame
   //virtual Int_t      GetBinIndex(Int_t ivar, Int_t ind) const ;
 
   virtual void    Fill(const Double_t *var, Double_t weight=1.);
+  //buffered filling: entries are accumulated and added per distinct bin when
+  //size entries are buffered or before the grid is accessed (0: direct filling)
+  virtual void    SetFillBufferSize(Int_t size);
+  Int_t           GetFillBufferSize() const {return fFillBufferSize;}
+  void            FlushFillBuffer() const;
   virtual Float_t GetEntries()const;
   virtual Float_t GetElement(Long_t iel)               const; 
   virtual Float_t GetElement(const Int_t *bin)         const; 
@@ -99,8 +106,8 @@ class AliCFGridSparse : public AliCFFrame
   //virtual Double_t GetIntegral(const Double_t *varMin, const Double_t *varMax) const;
   virtual Long64_t Merge(TCollection* list);
 
-  virtual void     SetGrid(THnSparse* grid) {if (fData) delete fData ; fData=grid;}
-  THnSparse   *    GetGrid() const {return fData;}
+  virtual void     SetGrid(THnSparse* grid) {if (fData) delete fData ; fData=grid; fFillBuffer.clear(); SetupFillBuffer();}
+  THnSparse   *    GetGrid() const {FlushFillBuffer(); return fData;}
 
   virtual Float_t GetOverFlows (Int_t var, Bool_t excl=kFALSE) const;
   virtual Float_t GetUnderFlows(Int_t var, Bool_t excl=kFALSE) const;
@@ -118,12 +125,16 @@ class AliCFGridSparse : public AliCFFrame
   void     SetAxisRange(TAxis* axis, Double_t min, Double_t max, Bool_t useBins) const;
   void     GetProjectionName (TString& s,Int_t var0, Int_t var1=-1, Int_t var2=-1) const;
   void     GetProjectionTitle(TString& s,Int_t var0, Int_t var1=-1, Int_t var2=-1) const;
+  void     SetupFillBuffer();
 
   // data members:
   Bool_t      fSumW2    ; // Flag to check if calculation of squared weights enabled
   THnSparse  *fData     ; // The data Container: a THnSparse  
+  Int_t       fFillBufferSize ; //! Maximum number of buffered entries (0: no buffering)
+  mutable std::vector<std::pair<ULong64_t,Double_t> > fFillBuffer ; //! Buffered entries: packed bin coordinates, weight
+  std::vector<Int_t> fFillBufferBits ; //! Bits of each axis in the packed bin coordinates
 
-  ClassDef(AliCFGridSparse,3);
+  ClassDef(AliCFGridSparse,4);
 };
 
 
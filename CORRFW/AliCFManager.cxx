@@ -21,6 +21,7 @@
 // efficiency calculation.
 // prototype version by S.Arcelli silvia.arcelli@cern.ch
 ///////////////////////////////////////////////////////////////////////////
+#include "TArrayI.h"
 #include "AliCFCutBase.h"
 #include "AliCFManager.h"
 
@@ -34,7 +35,11 @@ AliCFManager::AliCFManager() :
   fEvtContainer(0x0),
   fPartContainer(0x0),
   fEvtCutList(0x0),
-  fPartCutList(0x0)
+  fPartCutList(0x0),
+  fEvtSelCache(),
+  fPartSelCache(),
+  fEvtNCuts(),
+  fPartNCuts()
 { 
   //
   // ctor
@@ -48,7 +53,11 @@ AliCFManager::AliCFManager(const Char_t* name, const Char_t* title) :
   fEvtContainer(0x0),
   fPartContainer(0x0),
   fEvtCutList(0x0),
-  fPartCutList(0x0)
+  fPartCutList(0x0),
+  fEvtSelCache(),
+  fPartSelCache(),
+  fEvtNCuts(),
+  fPartNCuts()
 { 
    //
    // ctor
@@ -62,7 +71,11 @@ AliCFManager::AliCFManager(const AliCFManager& c) :
   fEvtContainer(c.fEvtContainer),
   fPartContainer(c.fPartContainer),
   fEvtCutList(c.fEvtCutList),
-  fPartCutList(c.fPartCutList)
+  fPartCutList(c.fPartCutList),
+  fEvtSelCache(),
+  fPartSelCache(),
+  fEvtNCuts(),
+  fPartNCuts()
 { 
    //
    //copy ctor
@@ -84,6 +97,8 @@ AliCFManager& AliCFManager::operator=(const AliCFManager& c)
   this->fPartContainer=c.fPartContainer;
   this->fEvtCutList=c.fEvtCutList;
   this->fPartCutList=c.fPartCutList;
+  fEvtSelCache.clear();
+  fPartSelCache.clear();
   return *this ;
 }
 
@@ -105,16 +120,45 @@ Bool_t AliCFManager::CheckParticleCuts(Int_t isel, TObject *obj, const TString
     return kTRUE;
   }
   if(!fPartCutList[isel])return kTRUE;
-  TObjArrayIter iter(fPartCutList[isel]);
-  AliCFCutBase *cut = 0;
-  while ( (cut = (AliCFCutBase*)iter.Next()) ) {
-    TString cutName=cut->GetName();
-    Bool_t checkCut=CompareStrings(cutName,selcuts);
-    if(checkCut && !cut->IsSelected(obj)) return kFALSE;   
+  const std::vector<AliCFCutBase*> &cuts = GetSelectedCuts(fPartCutList,fNStepPart,isel,selcuts,fPartSelCache,fPartNCuts);
+  for (UInt_t icut=0; icut<cuts.size(); icut++) {
+    if(!cuts[icut]->IsSelected(obj)) return kFALSE;
   }
   return kTRUE;
 }
 
+//_____________________________________________________________________________
+void AliCFManager::CheckParticleCuts(const TObjArray *objs, TArrayI &stepMasks, const TString  &selcuts) const {
+  //
+  // check the particle-level selections for all the objects in objs:
+  // bit isel of stepMasks[i] is set if objs->At(i) passes selection isel
+  //
+
+  Int_t nobj = objs ? objs->GetEntriesFast() : 0;
+  stepMasks.Set(nobj);
+  stepMasks.Reset();
+  Int_t nstep = fNStepPart;
+  if(nstep>32){
+    AliWarning(Form("Only the first 32 of the %i particle-selection steps are checked",nstep));
+    nstep=32;
+  }
+  for (Int_t isel=0; isel<nstep; isel++) {
+    const Int_t bit = (Int_t)(1u<<isel);
+    if(!fPartCutList || !fPartCutList[isel]){
+      for (Int_t iobj=0; iobj<nobj; iobj++) if(objs->UncheckedAt(iobj)) stepMasks[iobj] |= bit;
+      continue;
+    }
+    const std::vector<AliCFCutBase*> &cuts = GetSelectedCuts(fPartCutList,fNStepPart,isel,selcuts,fPartSelCache,fPartNCuts);
+    for (Int_t iobj=0; iobj<nobj; iobj++) {
+      TObject *obj = objs->UncheckedAt(iobj);
+      if(!obj) continue;
+      Bool_t isSelected = kTRUE;
+      for (UInt_t icut=0; icut<cuts.size() && isSelected; icut++) isSelected = cuts[icut]->IsSelected(obj);
+      if(isSelected) stepMasks[iobj] |= bit;
+    }
+  }
+}
+
 //_____________________________________________________________________________
 Bool_t AliCFManager::CheckEventCuts(Int_t isel, TObject *obj, const TString  &selcuts) const{
   //
@@ -126,12 +170,9 @@ Bool_t AliCFManager::CheckEventCuts(Int_t isel, TObject *obj, const TString  &se
       return kTRUE;
   }
   if(!fEvtCutList[isel])return kTRUE;
-  TObjArrayIter iter(fEvtCutList[isel]);
-  AliCFCutBase *cut = 0;
-  while ( (cut = (AliCFCutBase*)iter.Next()) ) {
-    TString cutName=cut->GetName();
-    Bool_t checkCut=CompareStrings(cutName,selcuts);
-    if(checkCut && !cut->IsSelected(obj)) return kFALSE;   
+  const std::vector<AliCFCutBase*> &cuts = GetSelectedCuts(fEvtCutList,fNStepEvt,isel,selcuts,fEvtSelCache,fEvtNCuts);
+  for (UInt_t icut=0; icut<cuts.size(); icut++) {
+    if(!cuts[icut]->IsSelected(obj)) return kFALSE;
   }
   return kTRUE;
 }
@@ -222,6 +263,36 @@ Bool_t AliCFManager::CompareStrings(const TString  &cutname,const TString  &selc
 }
 
 
+//_____________________________________________________________________________
+const std::vector<AliCFCutBase*>& AliCFManager::GetSelectedCuts(TObjArray **cutList, Int_t nstep, Int_t isel, const TString &selcuts,
+								 SelCutsCache_t &cache, std::vector<Int_t> &nCuts) const {
+  //
+  // cuts of step isel selected by selcuts (same order as in the list).
+  // The selection string is compared to the cut names once for all the
+  // steps; the cache is rebuilt when the size of a cut list changes
+  //
+
+  if((Int_t)nCuts.size()!=nstep || nCuts[isel]!=cutList[isel]->GetEntriesFast()){
+    cache.clear();
+    nCuts.resize(nstep);
+    for (Int_t istep=0; istep<nstep; istep++) nCuts[istep] = cutList[istep] ? cutList[istep]->GetEntriesFast() : -1;
+  }
+  SelCutsCache_t::iterator it = cache.find(selcuts);
+  if(it==cache.end()){
+    std::vector<std::vector<AliCFCutBase*> > stepCuts(nstep);
+    for (Int_t istep=0; istep<nstep; istep++) {
+      if(!cutList[istep])continue;
+      TObjArrayIter iter(cutList[istep]);
+      AliCFCutBase *cut = 0;
+      while ( (cut = (AliCFCutBase*)iter.Next()) ) {
+	if(CompareStrings(cut->GetName(),selcuts)) stepCuts[istep].push_back(cut);
+      }
+    }
+    it = cache.insert(std::make_pair(selcuts,stepCuts)).first;
+  }
+  return it->second[isel];
+}
+
 //_____________________________________________________________________________
 void AliCFManager::SetEventCutsList(Int_t isel, TObjArray* array) {
   //
@@ -243,6 +314,7 @@ void AliCFManager::SetEventCutsList(Int_t isel, TObjArray* array) {
     return;
   }
   fEvtCutList[isel] = array;
+  fEvtSelCache.clear();
 }
 
 //_____________________________________________________________________________
@@ -267,4 +339,5 @@ void AliCFManager::SetParticleCutsList(Int_t isel, TObjArray* array) {
     return;
   }
   fPartCutList[isel] = array;
+  fPartSelCache.clear();
 }
@@ -24,10 +24,15 @@
 // now the number of steps are fixed by the particle/event containers themselves.
 //
 
+#include <map>
+#include <vector>
 #include "TNamed.h"
 #include "AliCFContainer.h"
 #include "AliLog.h"
 
+class TArrayI;
+class AliCFCutBase;
+
 //____________________________________________________________________________
 class AliCFManager : public TNamed 
 {
@@ -116,6 +121,10 @@ class AliCFManager : public TNamed
   virtual Bool_t CheckEventCuts(Int_t isel, TObject *obj, const TString &selcuts="all") const;
   virtual Bool_t CheckParticleCuts(Int_t isel, TObject *obj, const TString &selcuts="all") const;
 
+  //Batch checker: for each object in objs, bit isel of stepMasks is set if the
+  //object passes particle-level selection isel (first 32 steps)
+  virtual void CheckParticleCuts(const TObjArray *objs, TArrayI &stepMasks, const TString &selcuts="all") const;
+
  private:
   
   //number of steps
@@ -132,7 +141,16 @@ class AliCFManager : public TNamed
 
   Bool_t CompareStrings(const TString  &cutname,const TString  &selcuts) const;
 
-  ClassDef(AliCFManager,2);
+  //cuts of each step selected by a selcuts string, resolved once per string
+  typedef std::map<TString, std::vector<std::vector<AliCFCutBase*> > > SelCutsCache_t;
+  const std::vector<AliCFCutBase*>& GetSelectedCuts(TObjArray **cutList, Int_t nstep, Int_t isel, const TString &selcuts,
+						     SelCutsCache_t &cache, std::vector<Int_t> &nCuts) const;
+  mutable SelCutsCache_t fEvtSelCache;   //! selected event-level cuts per step, for each selcuts string
+  mutable SelCutsCache_t fPartSelCache;  //! selected particle-level cuts per step, for each selcuts string
+  mutable std::vector<Int_t> fEvtNCuts;  //! size of the event-level cut lists when the cache was built
+  mutable std::vector<Int_t> fPartNCuts; //! size of the particle-level cut lists when the cache was built
+
+  ClassDef(AliCFManager,3);
 };
 
 
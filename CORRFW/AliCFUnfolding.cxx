@@ -57,6 +57,10 @@
 // found in AliCFUnfolding::CalculateCorrelatedErrors()                //
 // Author: marta.verweij@cern.ch                                       //
 //                                                                     //
+// For large responses, ::SetUseDenseResponse runs the iterations on  //
+// flat arrays, and ::SetNThreads runs the randomized unfoldings of    //
+// the error calculation in parallel (see AliCFUnfolding::UnfoldDense) //
+//                                                                     //
 // An optional possibility is to smooth the unfolded spectrum at the   //
 // end of each iteration, either using a fit function                  //
 // (only if #dimensions <=3)                                           //
@@ -93,9 +97,198 @@
 #include "TH3D.h"
 #include "TRandom3.h"
 
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <utility>
+
 
 ClassImp(AliCFUnfolding)
 
+namespace {
+
+  //
+  // Helpers of the dense path (AliCFUnfolding::UnfoldDense)
+  // The N-dim spectra are flat arrays indexed by a global cell number (under/overflow included),
+  // the response is the list of its filled cells in the THnSparse bin order.
+  // Values are rounded to the storage type of the THnSparse they stand for, and all loops
+  // follow the THnSparse bin order, so that the bin contents are the same as with the THnSparse path.
+  //
+
+  Bool_t   IsFloat(const THnSparse* h)            {return h->InheritsFrom(THnSparseF::Class());}
+  Double_t Store(Double_t value, Bool_t isFloat) {return isFloat ? (Double_t)(Float_t)value : value;}
+
+  struct DenseCells { // cell numbering of N axes
+    std::vector<Int_t>    fNBins;  // bins per axis, under/overflow included
+    std::vector<Long64_t> fStride;
+    Long64_t              fNCells;
+
+    Bool_t Set(const THnSparse* h, Int_t firstAxis, Int_t nAxes, Long64_t maxCells) {
+      fNBins.resize(nAxes);
+      fStride.resize(nAxes);
+      fNCells = 1;
+      for (Int_t i=0; i<nAxes; i++) {
+	fNBins[i]  = h->GetAxis(firstAxis+i)->GetNbins() + 2;
+	fStride[i] = fNCells;
+	fNCells   *= fNBins[i];
+	if (fNCells > maxCells) return kFALSE;
+      }
+      return kTRUE;
+    }
+    Bool_t Matches(const THnSparse* h, Int_t firstAxis) const {
+      for (UInt_t i=0; i<fNBins.size(); i++) if (h->GetAxis(firstAxis+i)->GetNbins() + 2 != fNBins[i]) return kFALSE;
+      return kTRUE;
+    }
+    Long64_t Cell(const Int_t* coord) const {
+      Long64_t cell = 0;
+      for (UInt_t i=0; i<fNBins.size(); i++) cell += coord[i] * fStride[i];
+      return cell;
+    }
+    void Coordinates(Long64_t cell, Int_t* coord) const {
+      for (UInt_t i=0; i<fNBins.size(); i++) {
+	coord[i] = cell % fNBins[i];
+	cell    /= fNBins[i];
+      }
+    }
+  };
+
+  struct DenseProblem { // read-only during the iterations, shared by the threads
+    DenseCells            fM;          // measured space
+    DenseCells            fT;          // true space
+    Bool_t                fFloatPrior; // storage type of prior and unfolded
+    Bool_t                fFloatEff;   // storage type of efficiency
+    Bool_t                fFloatMeas;  // storage type of measured and measured estimate
+    Bool_t                fFloatResp;  // storage type of inverse response
+    std::vector<Long64_t> fRespM;      // measured cell of each filled response bin (fConditional order)
+    std::vector<Long64_t> fRespT;      // true cell of each filled response bin
+    std::vector<Double_t> fCond;       // conditional probability of each filled response bin
+  };
+
+  struct DenseState { // what Unfold() keeps in fPrior, fUnfolded, fMeasuredEstimate and fInverseResponse
+    std::vector<Double_t> fPrior, fUnfolded, fEst, fInv;
+    std::vector<Long64_t> fPriorOrder, fUnfoldedOrder, fEstOrder; // filled cells, in THnSparse bin order
+    std::vector<Char_t>   fUnfoldedSet, fEstSet;
+
+    void Init(const DenseProblem& p) {
+      fPrior      .assign(p.fT.fNCells,0.);
+      fUnfolded   .assign(p.fT.fNCells,0.);
+      fUnfoldedSet.assign(p.fT.fNCells,0);
+      fEst        .assign(p.fM.fNCells,0.);
+      fEstSet     .assign(p.fM.fNCells,0);
+    }
+    void SetPrior(const std::vector<Double_t>& prior, const std::vector<Long64_t>& order) {
+      for (UInt_t i=0; i<fPriorOrder.size(); i++) fPrior[fPriorOrder[i]] = 0.;
+      for (UInt_t i=0; i<order.size(); i++)       fPrior[order[i]] = prior[order[i]];
+      fPriorOrder = order;
+    }
+    void UpdatePrior() { // prior <- unfolded
+      std::swap(fPrior,fUnfolded);
+      std::swap(fPriorOrder,fUnfoldedOrder);
+      for (UInt_t i=0; i<fPriorOrder.size(); i++) fUnfoldedSet[fPriorOrder[i]] = 0;
+    }
+  };
+
+  struct DenseInput { // filled bins of an input spectrum
+    std::vector<Long64_t> fCell;
+    std::vector<Double_t> fValue, fError;
+  };
+
+  void ReadDense(const THnSparse* h, const DenseCells& cells, Int_t* coord, std::vector<Double_t>& values, std::vector<Long64_t>& order) {
+    values.assign(cells.fNCells,0.);
+    order.clear();
+    for (Long64_t iBin=0; iBin<h->GetNbins(); iBin++) {
+      Double_t value = h->GetBinContent(iBin,coord);
+      Long64_t cell  = cells.Cell(coord);
+      values[cell] = value;
+      order.push_back(cell);
+    }
+  }
+
+  void ReadInput(const THnSparse* h, const DenseCells& cells, Int_t* coord, DenseInput& input) {
+    for (Long64_t iBin=0; iBin<h->GetNbins(); iBin++) {
+      input.fValue.push_back(h->GetBinContent(iBin,coord));
+      input.fError.push_back(h->GetBinError(iBin));
+      input.fCell .push_back(cells.Cell(coord));
+    }
+  }
+
+  void WriteDense(THnSparse* h, const std::vector<Double_t>& values, const std::vector<Long64_t>& order, const DenseCells& cells, Int_t* coord) {
+    h->Reset();
+    for (UInt_t i=0; i<order.size(); i++) {
+      cells.Coordinates(order[i],coord);
+      h->SetBinContent(coord,values[order[i]]);
+      h->SetBinError  (coord,0.);
+    }
+  }
+
+  void DenseIteration(const DenseProblem& p, const Double_t* eff, const Double_t* meas, DenseState& s) {
+    //
+    // one bayes iteration : CreateEstMeasured(), CreateInvResponse() and CreateUnfolded()
+    //
+    const Long64_t nResp = p.fCond.size();
+
+    for (UInt_t i=0; i<s.fEstOrder.size(); i++) {
+      s.fEst   [s.fEstOrder[i]] = 0.;
+      s.fEstSet[s.fEstOrder[i]] = 0;
+    }
+    s.fEstOrder.clear();
+    for (Long64_t iBin=0; iBin<nResp; iBin++) {
+      Long64_t iT = p.fRespT[iBin];
+      Double_t fill = p.fCond[iBin] * Store(s.fPrior[iT] * eff[iT],p.fFloatPrior);
+      if (fill>0.) {
+	Long64_t iM = p.fRespM[iBin];
+	if (!s.fEstSet[iM]) {
+	  s.fEstSet[iM] = 1;
+	  s.fEstOrder.push_back(iM);
+	}
+	s.fEst[iM] = Store(s.fEst[iM] + fill,p.fFloatMeas);
+      }
+    }
+
+    for (Long64_t iBin=0; iBin<nResp; iBin++) {
+      Long64_t iT = p.fRespT[iBin];
+      Double_t estMeasuredValue = s.fEst[p.fRespM[iBin]];
+      Double_t fill = (estMeasuredValue>0. ? p.fCond[iBin] * Store(s.fPrior[iT] * eff[iT],p.fFloatPrior) / estMeasuredValue : 0.);
+      if (fill>0. || s.fInv[iBin]>0.) s.fInv[iBin] = Store(fill,p.fFloatResp);
+    }
+
+    for (UInt_t i=0; i<s.fUnfoldedOrder.size(); i++) {
+      s.fUnfolded   [s.fUnfoldedOrder[i]] = 0.;
+      s.fUnfoldedSet[s.fUnfoldedOrder[i]] = 0;
+    }
+    s.fUnfoldedOrder.clear();
+    for (Long64_t iBin=0; iBin<nResp; iBin++) {
+      Long64_t iT = p.fRespT[iBin];
+      Double_t effValue = eff[iT];
+      Double_t fill = (effValue>0. ? s.fInv[iBin] * meas[p.fRespM[iBin]] / effValue : 0.);
+      if (fill>0.) {
+	if (!s.fUnfoldedSet[iT]) {
+	  s.fUnfoldedSet[iT] = 1;
+	  s.fUnfoldedOrder.push_back(iT);
+	}
+	s.fUnfolded[iT] = Store(s.fUnfolded[iT] + fill,p.fFloatPrior);
+      }
+    }
+  }
+
+  Double_t DenseConvergence(const DenseState& s, Int_t& nNonPositive) {
+    //
+    // same as AliCFUnfolding::GetConvergence(), counts the prior bins <= 0
+    //
+    Double_t convergence = 0.;
+    nNonPositive = 0;
+    for (UInt_t i=0; i<s.fPriorOrder.size(); i++) {
+      Double_t priorValue   = s.fPrior   [s.fPriorOrder[i]];
+      Double_t currentValue = s.fUnfolded[s.fPriorOrder[i]];
+      if (priorValue > 0.)
+	convergence += ((priorValue-currentValue)/priorValue)*((priorValue-currentValue)/priorValue);
+      else
+	nNonPositive++;
+    }
+    return convergence;
+  }
+}
+
 //______________________________________________________________
 
 AliCFUnfolding::AliCFUnfolding() :
@@ -130,7 +323,11 @@ AliCFUnfolding::AliCFUnfolding() :
   fDeltaUnfoldedP(0x0),
   fDeltaUnfoldedN(0x0),
   fNCalcCorrErrors(0),
-  fRandomSeed(0)
+  fRandomSeed(0),
+  fUseDenseResponse(kFALSE),
+  fMaxDenseCells(10000000),
+  fNThreads(1),
+  fIndependentRandomStreams(kFALSE)
 {
   //
   // default constructor
@@ -174,7 +371,11 @@ AliCFUnfolding::AliCFUnfolding(const Char_t* name, const Char_t* title, const In
   fDeltaUnfoldedP(0x0),
   fDeltaUnfoldedN(0x0),
   fNCalcCorrErrors(0),
-  fRandomSeed(randomSeed)
+  fRandomSeed(randomSeed),
+  fUseDenseResponse(kFALSE),
+  fMaxDenseCells(10000000),
+  fNThreads(1),
+  fIndependentRandomStreams(kFALSE)
 {
   //
   // named constructor
@@ -350,6 +551,9 @@ void AliCFUnfolding::Unfold() {
   // several iterations are performed until a reasonable chi2 or convergence criterion is reached
   //
 
+  // first call with SetUseDenseResponse() or SetNThreads() : flat arrays and threaded error calculation
+  if (fNCalcCorrErrors == 0 && (fUseDenseResponse || fNThreads != 1) && UnfoldDense()) return;
+
   Int_t iIterBayes     = 0 ;
   Double_t convergence = 0.;
 
@@ -410,6 +614,217 @@ void AliCFUnfolding::Unfold() {
 
 //______________________________________________________________
 
+Bool_t AliCFUnfolding::UnfoldDense() {
+  //
+  // Unfold() on flat arrays (see SetUseDenseResponse()), followed by the correlated error calculation
+  // in which the randomized unfoldings run on fNThreads threads.
+  // By default the randomized spectra are drawn from fRandom3 in the order of CreateRandomizedDist(),
+  // including the randomized response which is not used (the conditional matrix is created once in Init()),
+  // so that the random numbers are the same as on the THnSparse path. They are drawn in the main thread,
+  // for a batch of unfoldings at a time, and the unfoldings of the batch run in parallel.
+  // With SetIndependentRandomStreams() each randomized unfolding i draws its spectra in its thread from
+  // its own TRandom3, seeded with the i-th number of fRandom3.
+  // In both cases the deltas are merged in the order of i, so the errors do not depend on the number of threads.
+  // The randomized unfoldings only work on arrays : fPrior, fInverseResponse, fMeasuredEstimate and fUnfolded
+  // keep the values of the final unfolding, where the THnSparse path leaves those of the last randomized one.
+  // Returns kFALSE, without modifying anything, if the dense path cannot be used.
+  //
+
+  if (fUseSmoothing) {
+    AliWarning("Smoothing is not available with the dense response, using THnSparse (single thread)");
+    return kFALSE;
+  }
+
+  DenseProblem p;
+  if (!p.fM.Set(fMeasured,0,fNVariables,fMaxDenseCells) || !p.fT.Set(fPrior,0,fNVariables,fMaxDenseCells)) {
+    AliWarning(Form("Measured or true space has more than %lld cells, using THnSparse (single thread)",fMaxDenseCells));
+    return kFALSE;
+  }
+  if (!p.fT.Matches(fEfficiency,0) || !p.fM.Matches(fConditional,0) || !p.fT.Matches(fConditional,fNVariables)) {
+    AliWarning("Binnings of response, efficiency, measured and prior differ, using THnSparse (single thread)");
+    return kFALSE;
+  }
+  p.fFloatPrior = IsFloat(fPrior);
+  p.fFloatEff   = IsFloat(fEfficiency);
+  p.fFloatMeas  = IsFloat(fMeasured);
+  p.fFloatResp  = IsFloat(fInverseResponse);
+
+  const Long64_t nResp = fConditional->GetNbins();
+  DenseState s;
+  s.Init(p);
+  p.fRespM.resize(nResp);
+  p.fRespT.resize(nResp);
+  p.fCond .resize(nResp);
+  s.fInv  .resize(nResp);
+  for (Long64_t iBin=0; iBin<nResp; iBin++) {
+    p.fCond[iBin] = fConditional->GetBinContent(iBin,fCoordinates2N);
+    GetCoordinates();
+    p.fRespM[iBin] = p.fM.Cell(fCoordinatesN_M);
+    p.fRespT[iBin] = p.fT.Cell(fCoordinatesN_T);
+    Long64_t invBin = fInverseResponse->GetBin(fCoordinates2N,kFALSE);
+    s.fInv[iBin] = (invBin<0 ? 0. : fInverseResponse->GetBinContent(invBin));
+  }
+  const std::vector<Double_t> invInit(s.fInv);
+
+  std::vector<Double_t> eff, meas;
+  std::vector<Long64_t> order;
+  ReadDense(fEfficiency,p.fT,fCoordinatesN_T,eff,order);
+  ReadDense(fMeasured,p.fM,fCoordinatesN_M,meas,order);
+  ReadDense(fPrior,p.fT,fCoordinatesN_T,s.fPrior,s.fPriorOrder);
+
+  //
+  // bayes iterations, as in Unfold()
+  //
+  Int_t iIterBayes     = 0 ;
+  Double_t convergence = 0.;
+  Bool_t priorUpdated  = kFALSE;
+  for (iIterBayes=0; iIterBayes<fMaxNumIterations; iIterBayes++) {
+    DenseIteration(p,&eff[0],&meas[0],s);
+
+    Int_t nNonPositive = 0;
+    convergence = DenseConvergence(s,nNonPositive);
+    if (nNonPositive) AliWarning(Form("%d bins with priorValue <= 0. Adding 0 to convergence criterion.",nNonPositive));
+    AliDebug(0,Form("convergence at iteration %d is %e",iIterBayes,convergence));
+
+    if (fMaxConvergence>0. && convergence<fMaxConvergence) {
+      fNRandomIterations = iIterBayes;
+      AliDebug(0,Form("convergence is met at iteration %d",iIterBayes));
+      break;
+    }
+    s.UpdatePrior();
+    priorUpdated = kTRUE;
+  }
+
+  // back to the THnSparse objects
+  if (fMaxNumIterations>0) {
+    // without convergence break the last unfolded spectrum has been swapped into the prior
+    if (iIterBayes==fMaxNumIterations) WriteDense(fUnfolded,s.fPrior,s.fPriorOrder,p.fT,fCoordinatesN_T);
+    else                               WriteDense(fUnfolded,s.fUnfolded,s.fUnfoldedOrder,p.fT,fCoordinatesN_T);
+    WriteDense(fMeasuredEstimate,s.fEst,s.fEstOrder,p.fM,fCoordinatesN_M);
+    if (priorUpdated) WriteDense(fPrior,s.fPrior,s.fPriorOrder,p.fT,fCoordinatesN_T);
+    for (Long64_t iBin=0; iBin<nResp; iBin++) {
+      if (s.fInv[iBin] == invInit[iBin]) continue;
+      p.fM.Coordinates(p.fRespM[iBin],fCoordinates2N);
+      p.fT.Coordinates(p.fRespT[iBin],fCoordinates2N+fNVariables);
+      fInverseResponse->SetBinContent(fCoordinates2N,s.fInv[iBin]);
+      fInverseResponse->SetBinError  (fCoordinates2N,0.);
+    }
+  }
+  fUnfoldedFinal = (THnSparse*) fUnfolded->Clone() ;
+
+  AliInfo("\n================================================\nFinished bayes iteration, now calculating errors...\n================================================\n");
+  fNCalcCorrErrors = 1;
+
+  //
+  // randomized unfoldings
+  //
+  const Long64_t nFinal = fUnfoldedFinal->GetNbins();
+  std::vector<Long64_t> finalCell(nFinal);
+  std::vector<Double_t> finalValue(nFinal);
+  for (Long64_t iBin=0; iBin<nFinal; iBin++) {
+    finalValue[iBin] = fUnfoldedFinal->GetBinContent(iBin,fCoordinatesN_T);
+    finalCell [iBin] = p.fT.Cell(fCoordinatesN_T);
+  }
+  DenseInput effInput, measInput;
+  ReadInput(fEfficiencyOrig,p.fT,fCoordinatesN_T,effInput);
+  ReadInput(fMeasuredOrig,p.fM,fCoordinatesN_M,measInput);
+  std::vector<Double_t> priorOrig;
+  std::vector<Long64_t> priorOrigOrder;
+  ReadDense(fPriorOrig,p.fT,fCoordinatesN_T,priorOrig,priorOrigOrder);
+
+  const Int_t nRandom = TMath::Max(fNRandomIterations,0);
+  std::vector<UInt_t> seeds;
+  std::vector<Double_t> respValue, respError; // randomized response of the THnSparse path, drawn but not used
+  if (fIndependentRandomStreams) {
+    seeds.resize(nRandom);
+    for (Int_t i=0; i<nRandom; i++) seeds[i] = 1 + fRandom3->Integer(kMaxUInt);
+  }
+  else {
+    for (Long64_t iBin=0; iBin<fResponseOrig->GetNbins(); iBin++) {
+      respValue.push_back(fResponseOrig->GetBinContent(iBin,fCoordinates2N));
+      respError.push_back(fResponseOrig->GetBinError(fCoordinates2N));
+    }
+  }
+
+  Int_t nThreads = (fNThreads>0 ? fNThreads : (Int_t)std::thread::hardware_concurrency());
+  if (nThreads > nRandom) nThreads = nRandom;
+  if (nThreads < 1)       nThreads = 1;
+  std::vector<TRandom3*> randoms(nThreads,(TRandom3*)0x0);
+  if (fIndependentRandomStreams)
+    for (Int_t iThread=0; iThread<nThreads; iThread++) randoms[iThread] = new TRandom3(1); // reseeded for each unfolding
+
+  // unfoldings drawn from fRandom3 at a time
+  const Int_t nBatch = (fIndependentRandomStreams ? nRandom : 4*nThreads);
+  std::vector< std::vector<Double_t> > effDrawn(fIndependentRandomStreams ? 0 : nBatch), measDrawn(fIndependentRandomStreams ? 0 : nBatch);
+
+  std::vector< std::vector<Double_t> > deltas(nRandom);
+  std::atomic<Int_t> nextRandom(0);
+  Int_t lastRandom = 0;
+  auto randomUnfoldings = [&](Int_t iThread) {
+    TRandom3* random = randoms[iThread];
+    DenseState r;
+    r.Init(p);
+    std::vector<Double_t> effR(p.fT.fNCells,0.), measR(p.fM.fNCells,0.);
+    for (Int_t i = nextRandom++; i<lastRandom; i = nextRandom++) {
+      if (random) {
+	random->SetSeed(seeds[i]);
+	for (UInt_t iBin=0; iBin<effInput.fCell.size(); iBin++)
+	  effR[effInput.fCell[iBin]]   = Store(random->Gaus(effInput.fValue[iBin],effInput.fError[iBin]),p.fFloatEff);
+	for (UInt_t iBin=0; iBin<measInput.fCell.size(); iBin++)
+	  measR[measInput.fCell[iBin]] = Store(random->Gaus(measInput.fValue[iBin],measInput.fError[iBin]),p.fFloatMeas);
+      }
+      else {
+	const std::vector<Double_t>& effI  = effDrawn [i%nBatch];
+	const std::vector<Double_t>& measI = measDrawn[i%nBatch];
+	for (UInt_t iBin=0; iBin<effInput.fCell.size(); iBin++)  effR [effInput.fCell[iBin]]  = effI[iBin];
+	for (UInt_t iBin=0; iBin<measInput.fCell.size(); iBin++) measR[measInput.fCell[iBin]] = measI[iBin];
+      }
+      r.SetPrior(priorOrig,priorOrigOrder);
+      r.fInv = s.fInv;
+      for (Int_t iIter=0; iIter<fMaxNumIterations; iIter++) { // no convergence check for randomized spectra
+	DenseIteration(p,&effR[0],&measR[0],r);
+	r.UpdatePrior();
+      }
+      const std::vector<Double_t>& unfolded = (fMaxNumIterations>0 ? r.fPrior : s.fUnfolded);
+      deltas[i].resize(nFinal);
+      for (Long64_t iBin=0; iBin<nFinal; iBin++) deltas[i][iBin] = finalValue[iBin] - unfolded[finalCell[iBin]];
+    }
+  };
+  for (Int_t first=0; first<nRandom; first+=nBatch) {
+    lastRandom = TMath::Min(first+nBatch,nRandom);
+    if (!fIndependentRandomStreams) {
+      // same random numbers, in the same order, as CreateRandomizedDist()
+      for (Int_t i=first; i<lastRandom; i++) {
+	for (UInt_t iBin=0; iBin<respValue.size(); iBin++) fRandom3->Gaus(respValue[iBin],respError[iBin]);
+	std::vector<Double_t>& effI  = effDrawn [i%nBatch];
+	std::vector<Double_t>& measI = measDrawn[i%nBatch];
+	effI .resize(effInput.fCell.size());
+	measI.resize(measInput.fCell.size());
+	for (UInt_t iBin=0; iBin<effI.size(); iBin++)  effI[iBin]  = Store(fRandom3->Gaus(effInput.fValue[iBin],effInput.fError[iBin]),p.fFloatEff);
+	for (UInt_t iBin=0; iBin<measI.size(); iBin++) measI[iBin] = Store(fRandom3->Gaus(measInput.fValue[iBin],measInput.fError[iBin]),p.fFloatMeas);
+      }
+    }
+    nextRandom = first;
+    if (nThreads == 1) randomUnfoldings(0);
+    else {
+      std::vector<std::thread> threads;
+      for (Int_t iThread=0; iThread<nThreads; iThread++) threads.push_back(std::thread(randomUnfoldings,iThread));
+      for (UInt_t iThread=0; iThread<threads.size(); iThread++) threads[iThread].join();
+    }
+  }
+  for (Int_t iThread=0; iThread<nThreads; iThread++) delete randoms[iThread];
+
+  for (Int_t i=0; i<nRandom; i++) if (nFinal>0) FillDeltaUnfoldedProfile(&deltas[i][0]);
+  SetUnfoldedErrors();
+  fNCalcCorrErrors = 2;
+
+  AliInfo(Form("%d randomized unfoldings done with %d thread(s)",nRandom,nThreads));
+  AliInfo(Form("\n\n=======================\nFinished at iteration %d : convergence is %e and you required it to be < %e\n=======================\n\n",iIterBayes,convergence,fMaxConvergence));
+  return kTRUE;
+}
+
+//______________________________________________________________
+
 void AliCFUnfolding::CreateUnfolded() {
   //
   // Creates the unfolded (T) spectrum from the measured spectrum (M) and the inverse response matrix (INV)
@@ -483,8 +898,18 @@ void AliCFUnfolding::CalculateCorrelatedErrors() {
     FillDeltaUnfoldedProfile();
   }
 
+  SetUnfoldedErrors();
+
+  // now errors are calculated
+  fNCalcCorrErrors = 2;
+}
+
+//______________________________________________________________
+void AliCFUnfolding::SetUnfoldedErrors() {
+  //
   // Get statistical errors for final unfolded spectrum
   // ie. spread of each pt bin in fDeltaUnfoldedP
+  //
   Double_t meanx2 = 0.;
   Double_t mean = 0.;
   Double_t checksigma = 0.;
@@ -499,9 +924,6 @@ void AliCFUnfolding::CalculateCorrelatedErrors() {
     //AliDebug(2,Form("filling error %e\n",sigma));
     fUnfoldedFinal->SetBinError(fCoordinatesN_M,checksigma);
   }
-
-  // now errors are calculated
-  fNCalcCorrErrors = 2;
 }
 
 //______________________________________________________________
@@ -545,14 +967,26 @@ void AliCFUnfolding::FillDeltaUnfoldedProfile() {
   //  mean_{n+1} = (n*mean_n + value_{n+1}) / (n+1)
   // sigma_{n+1} = sqrt { 1/(n+1) * [ n*sigma_n^2 + (n^2+n)*(mean_{n+1}-mean_n)^2 ] }    (can this be optimized?)
 
+  std::vector<Double_t> delta(fUnfoldedFinal->GetNbins());
+  for (Long_t iBin=0; iBin<fUnfoldedFinal->GetNbins(); iBin++) {
+    delta[iBin] = fUnfoldedFinal->GetBinContent(iBin,fCoordinatesN_M) - fUnfolded->GetBinContent(fCoordinatesN_M);
+    //AliDebug(2,Form("%e %e ==> delta = %e\n",fUnfoldedFinal->GetBinContent(iBin,fCoordinatesN_M),fUnfolded->GetBinContent(iBin),delta[iBin]));
+  }
+  if (!delta.empty()) FillDeltaUnfoldedProfile(&delta[0]);
+}
+
+//______________________________________________________________
+void AliCFUnfolding::FillDeltaUnfoldedProfile(const Double_t* delta) {
+  //
+  // Updates the profile with the deltas of one randomized unfolding,
+  // given for each bin of fUnfoldedFinal (in its bin order)
+  //
+
   for (Long_t iBin=0; iBin<fUnfoldedFinal->GetNbins(); iBin++) {
-    Double_t deltaInBin   = fUnfoldedFinal->GetBinContent(iBin,fCoordinatesN_M) - fUnfolded->GetBinContent(fCoordinatesN_M);
+    fUnfoldedFinal->GetBinContent(iBin,fCoordinatesN_M);
+    Double_t deltaInBin   = delta[iBin];
     Double_t entriesInBin = fDeltaUnfoldedN->GetBinContent(fCoordinatesN_M);
-    //AliDebug(2,Form("%e %e ==> delta = %e\n",fUnfoldedFinal->GetBinContent(iBin,fCoordinatesN_M),fUnfolded->GetBinContent(iBin),deltaInBin));
 
-    //printf("deltaInBin %f\n",deltaInBin);
-    //printf("pt %f\n",ptaxis->GetBinCenter(iBin+1));
-    
     Double_t mean_n = fDeltaUnfoldedP->GetBinContent(fCoordinatesN_M) ;
     Double_t mean_nplus1 = mean_n ;
     mean_nplus1 *= entriesInBin ;
@@ -37,6 +37,26 @@ class AliCFUnfolding : public TNamed {
 
   void SetNRandomIterations(Int_t n = 100) {fNRandomIterations = n;};
 
+  // Dense bayes iterations : the N-dim spectra are held in flat arrays and the response in the list
+  // of its filled cells, so that each iteration is a set of matrix-vector products (same bin contents
+  // as the THnSparse path). Used if each of the measured and true spaces has at most maxCells cells
+  // (under/overflow included) and no smoothing is requested.
+  // After the error calculation the two paths leave different intermediate objects : the THnSparse path
+  // reuses them for each randomized unfolding, so GetInverseResponse(), GetEstMeasured() and GetPrior()
+  // hold the last randomized one, while the dense path keeps them at the final unfolding of the measured
+  // spectrum. GetUnfolded() and GetDeltaUnfoldedProfile() are the same in both paths.
+  void SetUseDenseResponse(Bool_t b = kTRUE, Long64_t maxCells = 10000000) {fUseDenseResponse = b; fMaxDenseCells = maxCells;}
+  // Number of threads for the randomized unfoldings of the error calculation (0 = number of cores).
+  // Any value other than 1 implies SetUseDenseResponse(). Only the dense path is threaded : if it cannot
+  // be used (a space with more than maxCells cells, smoothing, different binnings) the THnSparse path
+  // runs on a single thread, with a warning. The results do not depend on the number of threads.
+  void SetNThreads(Int_t n = 0) {fNThreads = n;}
+  // By default the dense path draws the randomized spectra from the same random sequence as the THnSparse
+  // path (in the main thread), so that both give the same errors for the same seed. With independent
+  // streams each randomized unfolding has its own generator, seeded from the constructor seed, and draws
+  // in its thread; the errors are then statistically equivalent but not equal to the THnSparse ones.
+  void SetIndependentRandomStreams(Bool_t b = kTRUE) {fIndependentRandomStreams = b;}
+
   void UseSmoothing(TF1* fcn=0x0, Option_t* opt="iremn") { // if fcn=0x0 then smooth using neighbouring bins 
     fUseSmoothing=kTRUE;                                   // this function must NOT be used if fNVariables > 3
     fSmoothFunction=fcn;                                   // the option "opt" is used if "fcn" is specified
@@ -111,10 +131,15 @@ class AliCFUnfolding : public TNamed {
   THnSparse     *fDeltaUnfoldedN;    // Entries of the delta-unfolded distribution (count for each bin)
   Short_t        fNCalcCorrErrors;   // Book-keeping to prevend infinite loop
   UInt_t         fRandomSeed;        // Random seed
+  Bool_t         fUseDenseResponse;  // Bayes iterations on flat arrays instead of THnSparse lookups
+  Long64_t       fMaxDenseCells;     // Max. number of cells of the measured or true space for the dense path
+  Int_t          fNThreads;          // Threads for the randomized unfoldings (dense path only, 0 = number of cores)
+  Bool_t         fIndependentRandomStreams; // One random generator per randomized unfolding on the dense path
 
 
   // functions
   void     Init();                  // initialisation of the internal settings
+  Bool_t   UnfoldDense();           // Unfold() on flat arrays, returns kFALSE if the dense path cannot be used
   void     GetCoordinates();        // gets a cell coordinates in Measured and True space
   void     CreateConditional();     // creates the conditional matrix from the response matrix
   void     CreateEstMeasured();     // creates the measured spectrum estimation from the conditional matrix and the prior distribution
@@ -130,9 +155,11 @@ class AliCFUnfolding : public TNamed {
   void     CalculateCorrelatedErrors(); // Calculates correlated errors for the final unfolded spectrum
   void     CreateRandomizedDist();      // Create randomized dist from measured distribution
   void     FillDeltaUnfoldedProfile();  // Fills the fDeltaUnfoldedP profile
+  void     FillDeltaUnfoldedProfile(const Double_t* delta); // Fills the fDeltaUnfoldedP profile given the deltas of each fUnfoldedFinal bin
+  void     SetUnfoldedErrors();         // Sets the errors of fUnfoldedFinal from the spread of fDeltaUnfoldedP
   void     SetMaxConvergencePerDOF (Double_t val);
 
-  ClassDef(AliCFUnfolding,1);
+  ClassDef(AliCFUnfolding,2);
 };
 
 #endif
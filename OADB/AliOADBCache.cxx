@@ -0,0 +1,214 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TKey.h"
+
+#include "AliLog.h"
+#include "AliOADBContainer.h"
+
+#include "AliOADBCache.h"
+
+ClassImp(AliOADBCache)
+
+//______________________________________________________________________________
+AliOADBCache::AliOADBCache() :
+  TObject(),
+  fFiles(),
+  fEntries(),
+  fLRU(),
+  fMutex(),
+  fMaxMemory(0),
+  fMemory(0),
+  fContainerHits(0),
+  fContainerMisses(0),
+  fObjectHits(0),
+  fObjectMisses(0),
+  fFileOpens(0),
+  fEvictions(0)
+{
+}
+
+//______________________________________________________________________________
+AliOADBCache::~AliOADBCache()
+{
+  Reset();
+}
+
+//______________________________________________________________________________
+AliOADBCache& AliOADBCache::Instance()
+{
+  // never deleted: ROOT closes the files itself at the end of the process
+  static AliOADBCache* instance = new AliOADBCache();
+  return *instance;
+}
+
+//______________________________________________________________________________
+Bool_t AliOADBCache::HasFile(const char* fileName)
+{
+  // opens the file if it is not yet, to tell a missing file from a missing container
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  return OpenFile(fileName) != 0x0;
+}
+
+//______________________________________________________________________________
+AliOADBCache::ContainerHandle AliOADBCache::GetContainer(const char* fileName, const char* containerName)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  Entry* entry = FindOrLoad(fileName, containerName);
+  if (!entry) return ContainerHandle();
+  return entry->fContainer;
+}
+
+//______________________________________________________________________________
+AliOADBCache::ObjectHandle AliOADBCache::GetObject(const char* fileName, const char* containerName, Int_t run,
+                                                   const char* defaultName/* = ""*/, const char* passName/* = ""*/)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  Entry* entry = FindOrLoad(fileName, containerName);
+  if (!entry) return ObjectHandle();
+
+  const std::string key = std::to_string(run) + '/' + defaultName + '/' + passName;
+  const TObject* object = 0x0;
+  std::map<std::string, const TObject*>::const_iterator found = entry->fObjects.find(key);
+  if (found != entry->fObjects.end()) {
+    ++fObjectHits;
+    object = found->second;
+  }
+  else {
+    ++fObjectMisses;
+    object = entry->fContainer->GetObject(run, defaultName, passName);
+    entry->fObjects[key] = object;
+  }
+  if (!object) return ObjectHandle();
+
+  // the handle shares the ownership of the container which owns the object
+  return ObjectHandle(entry->fContainer, object);
+}
+
+//______________________________________________________________________________
+void AliOADBCache::SetMaxMemory(Long64_t bytes)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  fMaxMemory = bytes;
+  Evict("");
+}
+
+//______________________________________________________________________________
+void AliOADBCache::Reset()
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  // containers still in use are deleted with their last handle
+  fEntries.clear();
+  fLRU.clear();
+  fMemory = 0;
+
+  for (std::map<std::string, TFile*>::iterator it = fFiles.begin(); it != fFiles.end(); ++it) {
+    if (it->second) it->second->Close();
+    delete it->second;
+  }
+  fFiles.clear();
+}
+
+//______________________________________________________________________________
+void AliOADBCache::Print(Option_t* /*option*/) const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  Printf("AliOADBCache: %zu containers from %zu files, %.1f MB", fEntries.size(), fFiles.size(), fMemory/1048576.);
+  if (fMaxMemory > 0) Printf("  memory limit:  %.1f MB, %lld evictions", fMaxMemory/1048576., fEvictions);
+  Printf("  containers:    %lld hits, %lld misses", fContainerHits, fContainerMisses);
+  Printf("  run objects:   %lld hits, %lld misses", fObjectHits, fObjectMisses);
+  Printf("  files opened:  %lld", fFileOpens);
+}
+
+//______________________________________________________________________________
+TFile* AliOADBCache::OpenFile(const std::string& fileName)
+{
+  std::map<std::string, TFile*>::iterator found = fFiles.find(fileName);
+  if (found != fFiles.end()) return found->second;
+
+  // keep the current directory of the caller
+  TDirectory::TContext context;
+  TFile* file = TFile::Open(fileName.c_str(), "read");
+  ++fFileOpens;
+  if (file && file->IsZombie()) {
+    delete file;
+    file = 0x0;
+  }
+  if (!file) AliErrorF("Cannot open OADB file %s", fileName.c_str());
+
+  // failures are remembered as well, not to retry at every call
+  fFiles[fileName] = file;
+  return file;
+}
+
+//______________________________________________________________________________
+AliOADBCache::Entry* AliOADBCache::FindOrLoad(const std::string& fileName, const std::string& containerName)
+{
+  const std::string key = fileName + '#' + containerName;
+
+  std::map<std::string, Entry>::iterator found = fEntries.find(key);
+  if (found != fEntries.end()) {
+    ++fContainerHits;
+    fLRU.splice(fLRU.begin(), fLRU, found->second.fLRU);
+    return &found->second;
+  }
+
+  ++fContainerMisses;
+  TFile* file = OpenFile(fileName);
+  if (!file) return 0x0;
+
+  TDirectory::TContext context;
+  AliOADBContainer* container = dynamic_cast<AliOADBContainer*>(file->Get(containerName.c_str()));
+  if (!container) {
+    AliErrorF("No OADB container %s in %s", containerName.c_str(), fileName.c_str());
+    return 0x0;
+  }
+  container->SetOwner(kTRUE);
+
+  const TKey* fileKey = file->GetKey(containerName.c_str());
+
+  Entry& entry = fEntries[key];
+  entry.fContainer.reset(container);
+  entry.fSize = fileKey ? fileKey->GetObjlen() : 0;
+  fLRU.push_front(key);
+  entry.fLRU = fLRU.begin();
+  fMemory += entry.fSize;
+
+  Evict(key);
+  return &entry;
+}
+
+//______________________________________________________________________________
+void AliOADBCache::Evict(const std::string& keep)
+{
+  if (fMaxMemory <= 0) return;
+
+  // drop the least recently used containers, but never the one just requested
+  while (fMemory > fMaxMemory && !fLRU.empty() && fLRU.back() != keep) {
+    std::map<std::string, Entry>::iterator it = fEntries.find(fLRU.back());
+    fMemory -= it->second.fSize;
+    fEntries.erase(it);
+    fLRU.pop_back();
+    ++fEvictions;
+  }
+}
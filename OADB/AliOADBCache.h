@@ -0,0 +1,100 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+#ifndef ALIOADBCACHE_H
+#define ALIOADBCACHE_H
+
+/// \file AliOADBCache.h
+/// \brief Process-wide cache of OADB containers and of their per-run objects
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "TObject.h"
+
+class TFile;
+class AliOADBContainer;
+
+/// \class AliOADBCache
+/// \brief Process-wide cache of OADB containers and of their per-run objects
+///
+/// Wagons that read the same OADB file no longer open it and deserialise the
+/// container each on their own at every run change: the cache opens each file once,
+/// reads each container once and keeps the per-run lookups.
+///
+/// The objects are shared by all users and must be treated as read only: clone what
+/// has to be modified or handed over to an owner. The handles are shared pointers,
+/// an object stays valid as long as a handle to it (or to its container) exists,
+/// also when the container is evicted from the cache.
+///
+/// Usage:
+///   `AliOADBCache::ObjectHandle obj = AliOADBCache::Instance().GetObject(fileName, "AliEMCALRecalib", run);`
+///   `const TObjArray* recal = static_cast<const TObjArray*>(obj.get());`
+///
+/// With SetMaxMemory() the cache drops the least recently used containers when the
+/// total (uncompressed) size of the containers exceeds the limit.
+class AliOADBCache : public TObject {
+  public:
+    typedef std::shared_ptr<const AliOADBContainer> ContainerHandle;
+    typedef std::shared_ptr<const TObject> ObjectHandle;
+
+    static AliOADBCache& Instance();
+
+    Bool_t          HasFile(const char* fileName);
+    ContainerHandle GetContainer(const char* fileName, const char* containerName);
+    ObjectHandle    GetObject(const char* fileName, const char* containerName, Int_t run,
+                              const char* defaultName = "", const char* passName = "");
+
+    void     SetMaxMemory(Long64_t bytes);
+    Long64_t GetMaxMemory()  const { return fMaxMemory; }
+    Long64_t GetMemory()     const { return fMemory; }
+
+    Long64_t GetContainerHits()   const { return fContainerHits; }
+    Long64_t GetContainerMisses() const { return fContainerMisses; }
+    Long64_t GetObjectHits()      const { return fObjectHits; }
+    Long64_t GetObjectMisses()    const { return fObjectMisses; }
+    Long64_t GetFileOpens()       const { return fFileOpens; }
+    Long64_t GetEvictions()       const { return fEvictions; }
+
+    void Reset();
+    virtual void Print(Option_t* option = "") const;
+
+    virtual ~AliOADBCache();
+
+  private:
+    AliOADBCache();
+    AliOADBCache(const AliOADBCache&);
+    AliOADBCache& operator= (const AliOADBCache&);
+
+    /// a container read from file, with its per-run lookups
+    struct Entry {
+      std::shared_ptr<AliOADBContainer> fContainer;    ///< shared container
+      Long64_t fSize;                                  ///< uncompressed size on file
+      std::map<std::string, const TObject*> fObjects; ///< per-run lookups, by run/default/pass
+      std::list<std::string>::iterator fLRU;           ///< position in the LRU list
+    };
+
+    TFile* OpenFile(const std::string& fileName);
+    Entry* FindOrLoad(const std::string& fileName, const std::string& containerName);
+    void   Evict(const std::string& keep);
+
+    std::map<std::string, TFile*> fFiles;  //!< open files, by name
+    std::map<std::string, Entry> fEntries; //!< containers, by file and container name
+    std::list<std::string> fLRU;           //!< container keys, most recently used first
+    mutable std::mutex fMutex;             //!< lock for concurrent users
+
+    Long64_t fMaxMemory;        ///< memory limit in bytes, 0 for no limit
+    Long64_t fMemory;           ///< size of the cached containers
+    Long64_t fContainerHits;    ///< containers found in the cache
+    Long64_t fContainerMisses;  ///< containers read from file
+    Long64_t fObjectHits;       ///< per-run lookups found in the cache
+    Long64_t fObjectMisses;     ///< per-run lookups done in the container
+    Long64_t fFileOpens;        ///< files opened
+    Long64_t fEvictions;        ///< containers dropped to stay below the memory limit
+
+    ClassDef(AliOADBCache, 0)
+};
+
+#endif
@@ -20,7 +20,7 @@
 #include "AliVEvent.h"
 #include "AliVEventHandler.h"
 #include "AliAnalysisManager.h"
-#include "AliOADBContainer.h"
+#include "AliOADBCache.h"
 
 #include "AliTimeRangeCut.h"
 
@@ -70,10 +70,13 @@ void AliTimeRangeCut::InitFromRunNumber(const Int_t run)
   printf("pass: %s\n", passName.Data());
 
   // ===| Get the AliTimeRangeMasking object |===
-  AliOADBContainer cont("TimeRangeMasking");
-  cont.InitFromFile(Form("%s/COMMON/PHYSICSSELECTION/data/TimeRangeMasking.root", fOADBPath.Data()), "TimeRangeMasking");
+  // the container is read once per process and shared by all instances
+  fTimeRangeMaskingHandle = AliOADBCache::Instance().GetObject(Form("%s/COMMON/PHYSICSSELECTION/data/TimeRangeMasking.root", fOADBPath.Data()),
+                                                               "TimeRangeMasking", run, "", passName);
+  fTimeRangeMasking = (const AliTimeRangeMasking<ULong64_t, UShort_t>*)fTimeRangeMaskingHandle.get();
 
-  fTimeRangeMasking = (AliTimeRangeMasking<ULong64_t, UShort_t>*)cont.GetObject(run, "", passName);
+  // the object may be shared between threads, build its lookup index right away
+  if (fTimeRangeMasking) fTimeRangeMasking->BuildIndex();
 
 }
 
@@ -93,10 +96,8 @@ UShort_t AliTimeRangeCut::GetMask(const AliVEvent* event) const
 //______________________________________________________________________________
 UShort_t AliTimeRangeCut::GetMask(const ULong64_t gid) const
 {
-  AliTimeRangeMask<ULong64_t, UShort_t>* range = fTimeRangeMasking->FindTimeRangeMask(gid);
-
-  if (!range) return 0;
-  return range->GetMaskReasons();
+  if (!fTimeRangeMasking) return 0;
+  return fTimeRangeMasking->GetMaskReasons(gid);
 }
 
 //______________________________________________________________________________
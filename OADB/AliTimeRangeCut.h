@@ -7,6 +7,8 @@
 /// \brief A class for cutting on AliTimeRangeMasking definitions
 /// \author Jens Wiechula, jens.wiechula@ikf.uni-frankfurt.de
 
+#include <memory>
+
 #include "TString.h"
 
 #include "AliTimeRangeMasking.h"
@@ -33,12 +35,14 @@ class AliVEvent;
 ///     for the bit definitions see [AliTimeRangeMask](@ref AliTimeRangeMask)
 class AliTimeRangeCut : public TObject {
   public:
-    AliTimeRangeCut() : fOADBPath(), fTimeRangeMasking(0x0), fLastRun(-1) {}
-    ~AliTimeRangeCut() { delete fTimeRangeMasking; }
+    AliTimeRangeCut() : fOADBPath(), fTimeRangeMaskingHandle(), fTimeRangeMasking(0x0), fLastRun(-1) {}
+    ~AliTimeRangeCut() {}
 
     void InitFromEvent(const AliVEvent* event); 
     void InitFromRunNumber(const Int_t run);
 
+    /// mask reasons of the event: the OR over all masked ranges containing it
+    /// (before the lookup index only the first matching range was used)
     UShort_t GetMask(const AliVEvent* event) const;
     UShort_t GetMask(const ULong64_t gid) const;
 
@@ -54,7 +58,8 @@ class AliTimeRangeCut : public TObject {
     AliTimeRangeCut& operator= (const AliTimeRangeCut&);
 
     TString fOADBPath; ///< OADB path
-    AliTimeRangeMasking<ULong64_t, UShort_t>* fTimeRangeMasking; //!< Time Range masksking object
+    std::shared_ptr<const TObject> fTimeRangeMaskingHandle; //!< keeps the shared OADB object alive
+    const AliTimeRangeMasking<ULong64_t, UShort_t>* fTimeRangeMasking; //!< Time Range masksking object, owned by the AliOADBCache
     Int_t fLastRun; //!< last set run number
 
     ClassDef(AliTimeRangeCut, 1)
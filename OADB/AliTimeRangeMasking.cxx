@@ -13,7 +13,10 @@
  * provided "as is" without express or implied warranty.                  *
  **************************************************************************/
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <mutex>
 
 #include "AliLog.h"
 
@@ -88,7 +91,12 @@ templateClassImp(AliTimeRangeMasking)
 template<typename time_type, typename bitmap_type>
 AliTimeRangeMasking<time_type, bitmap_type>::AliTimeRangeMasking()
   : TObject(),
-    fArrTimeRanges("AliTimeRangeMask<ULong64_t, UShort_t>", 10)
+    fArrTimeRanges("AliTimeRangeMask<ULong64_t, UShort_t>", 10),
+    fSegmentStart(),
+    fSegmentEnd(),
+    fSegmentMask(),
+    fSegmentRange(),
+    fIndexValid(kFALSE)
 {
 }
 
@@ -96,25 +104,38 @@ AliTimeRangeMasking<time_type, bitmap_type>::AliTimeRangeMasking()
 template<typename time_type, typename bitmap_type>
 AliTimeRangeMask<time_type, bitmap_type>* AliTimeRangeMasking<time_type, bitmap_type>::AddTimeRangeMask(time_type start, time_type end, bitmap_type reasons)
 {
-  if ( const auto* range = FindTimeRangeMask(start))  {
+  // while ranges are being added the index is out of date; scan the ranges
+  // instead of rebuilding it for every new one, it is built at the first query
+  if ( const auto* range = (fIndexValid ? FindTimeRangeMask(start) : ScanTimeRangeMask(start)))  {
     const std::string reasonsString = range->CollectMaskReasonNames();
     AliErrorF("Start time %llu already in range [%llu, %llu]: %s", 
         start, range->GetStart(), range->GetEnd(), reasonsString.data());
     return nullptr;
   }
 
-  if ( const auto* range = FindTimeRangeMask(end))  {
+  if ( const auto* range = (fIndexValid ? FindTimeRangeMask(end) : ScanTimeRangeMask(end)))  {
     const std::string reasonsString= range->CollectMaskReasonNames();
     AliErrorF("End time %llu already in range [%llu, %llu]: %s", 
         end, range->GetStart(), range->GetEnd(), reasonsString.data());
     return nullptr;
   }
 
+  fIndexValid = kFALSE;
   return new(fArrTimeRanges[fArrTimeRanges.GetEntriesFast()]) AliTimeRangeMask<time_type, bitmap_type>(start, end, reasons);
 }
 
 template<typename time_type, typename bitmap_type>
 AliTimeRangeMask<time_type, bitmap_type>* AliTimeRangeMasking<time_type, bitmap_type>::FindTimeRangeMask(time_type time) const
+{
+  const Int_t segment = FindSegment(time);
+  if (segment < 0) return nullptr;
+  return (AliTimeRangeMask<time_type, bitmap_type>*)fArrTimeRanges.UncheckedAt(fSegmentRange[segment]);
+}
+
+/// Linear search of the first range (in insertion order) containing time,
+/// does not need the index
+template<typename time_type, typename bitmap_type>
+AliTimeRangeMask<time_type, bitmap_type>* AliTimeRangeMasking<time_type, bitmap_type>::ScanTimeRangeMask(time_type time) const
 {
   for (auto o : fArrTimeRanges) {
     auto const val = (AliTimeRangeMask<time_type, bitmap_type>*)o;
@@ -123,6 +144,120 @@ AliTimeRangeMask<time_type, bitmap_type>* AliTimeRangeMasking<time_type, bitmap_
   return nullptr;
 }
 
+/// OR of the reasons of all ranges containing time. For nested ranges this
+/// differs from FindTimeRangeMask(time)->GetMaskReasons(), which only has the
+/// reasons of the first range.
+template<typename time_type, typename bitmap_type>
+bitmap_type AliTimeRangeMasking<time_type, bitmap_type>::GetMaskReasons(time_type time) const
+{
+  const Int_t segment = FindSegment(time);
+  if (segment < 0) return bitmap_type();
+  return fSegmentMask[segment];
+}
+
+/// Mask reasons for many times at once, e.g. the event times of a chunk.
+/// For times sorted in increasing order the index is traversed only once,
+/// the sweep restarts with a binary search where the order is broken.
+template<typename time_type, typename bitmap_type>
+void AliTimeRangeMasking<time_type, bitmap_type>::GetMaskReasons(const time_type* times, Int_t nTimes, bitmap_type* masks) const
+{
+  if (!fIndexValid) BuildIndex();
+
+  const size_t nSegments = fSegmentStart.size();
+  size_t segment = 0;
+  for (Int_t iTime = 0; iTime < nTimes; ++iTime) {
+    const time_type time = times[iTime];
+    if (iTime > 0 && time < times[iTime - 1])
+      segment = std::lower_bound(fSegmentEnd.begin(), fSegmentEnd.end(), time) - fSegmentEnd.begin();
+    while (segment < nSegments && fSegmentEnd[segment] < time) ++segment;
+    masks[iTime] = (segment < nSegments && fSegmentStart[segment] <= time) ? fSegmentMask[segment] : bitmap_type();
+  }
+}
+
+template<typename time_type, typename bitmap_type>
+std::vector<bitmap_type> AliTimeRangeMasking<time_type, bitmap_type>::GetMaskReasons(const std::vector<time_type>& times) const
+{
+  std::vector<bitmap_type> masks(times.size());
+  if (!times.empty()) GetMaskReasons(times.data(), times.size(), masks.data());
+  return masks;
+}
+
+namespace {
+  /// serialises the index building of objects shared between threads
+  std::mutex gTimeRangeIndexMutex;
+}
+
+/// Build the lookup index. It is built on the first query otherwise; call it
+/// explicitly before an object is used from several threads.
+template<typename time_type, typename bitmap_type>
+void AliTimeRangeMasking<time_type, bitmap_type>::BuildIndex() const
+{
+  std::lock_guard<std::mutex> lock(gTimeRangeIndexMutex);
+  if (fIndexValid) return;
+
+  // segment boundaries: range starts and the times following range ends
+  const Int_t nRanges = fArrTimeRanges.GetEntriesFast();
+  const time_type maxTime = std::numeric_limits<time_type>::max();
+  std::vector<time_type> bounds;
+  bounds.reserve(2 * nRanges);
+  for (Int_t iRange = 0; iRange < nRanges; ++iRange) {
+    const auto range = (const AliTimeRangeMask<time_type, bitmap_type>*)fArrTimeRanges.UncheckedAt(iRange);
+    if (range->GetEnd() < range->GetStart()) continue;
+    bounds.push_back(range->GetStart());
+    if (range->GetEnd() != maxTime) bounds.push_back(range->GetEnd() + 1);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+  // reasons and first covering range of each elementary segment
+  const size_t nBounds = bounds.size();
+  std::vector<bitmap_type> mask(nBounds, bitmap_type());
+  std::vector<Int_t> first(nBounds, -1);
+  for (Int_t iRange = 0; iRange < nRanges; ++iRange) {
+    const auto range = (const AliTimeRangeMask<time_type, bitmap_type>*)fArrTimeRanges.UncheckedAt(iRange);
+    if (range->GetEnd() < range->GetStart()) continue;
+    size_t iBound = std::lower_bound(bounds.begin(), bounds.end(), range->GetStart()) - bounds.begin();
+    for (; iBound < nBounds && (range->GetEnd() == maxTime || bounds[iBound] <= range->GetEnd()); ++iBound) {
+      mask[iBound] |= range->GetMaskReasons();
+      if (first[iBound] < 0) first[iBound] = iRange;
+    }
+  }
+
+  // keep the covered segments, merging neighbours with the same content
+  fSegmentStart.clear();
+  fSegmentEnd.clear();
+  fSegmentMask.clear();
+  fSegmentRange.clear();
+  for (size_t iBound = 0; iBound < nBounds; ++iBound) {
+    if (first[iBound] < 0) continue;
+    const time_type end = (iBound + 1 < nBounds) ? bounds[iBound + 1] - 1 : maxTime;
+    if (!fSegmentStart.empty() && fSegmentEnd.back() + 1 == bounds[iBound] &&
+        fSegmentMask.back() == mask[iBound] && fSegmentRange.back() == first[iBound]) {
+      fSegmentEnd.back() = end;
+      continue;
+    }
+    fSegmentStart.push_back(bounds[iBound]);
+    fSegmentEnd.push_back(end);
+    fSegmentMask.push_back(mask[iBound]);
+    fSegmentRange.push_back(first[iBound]);
+  }
+
+  fIndexValid = kTRUE;
+}
+
+/// Binary search of the segment containing time, -1 if time is not masked
+template<typename time_type, typename bitmap_type>
+Int_t AliTimeRangeMasking<time_type, bitmap_type>::FindSegment(time_type time) const
+{
+  if (!fIndexValid) BuildIndex();
+
+  const auto next = std::upper_bound(fSegmentStart.begin(), fSegmentStart.end(), time);
+  if (next == fSegmentStart.begin()) return -1;
+  const Int_t segment = (next - fSegmentStart.begin()) - 1;
+  if (fSegmentEnd[segment] < time) return -1;
+  return segment;
+}
+
 template<typename time_type, typename bitmap_type>
 void AliTimeRangeMasking<time_type, bitmap_type>::Print(Option_t* option) const
 {
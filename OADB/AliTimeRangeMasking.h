@@ -80,14 +80,37 @@ class AliTimeRangeMasking : public TObject {
     AliTimeRangeMask<time_type, bitmap_type>* AddTimeRangeMask(time_type start, time_type end, bitmap_type reasons = {});
 
 
+    /// first range (in insertion order) containing time
     AliTimeRangeMask<time_type, bitmap_type>* FindTimeRangeMask(time_type time) const;
 
+    /// OR of the reasons of all ranges containing time. Ranges added with
+    /// AddTimeRangeMask cannot overlap at their start or end times, but a range
+    /// may be nested inside another one; then the reasons of both are returned,
+    /// not only those of the first range as FindTimeRangeMask(time) gives.
+    bitmap_type GetMaskReasons(time_type time) const;
+    void GetMaskReasons(const time_type* times, Int_t nTimes, bitmap_type* masks) const;
+    std::vector<bitmap_type> GetMaskReasons(const std::vector<time_type>& times) const;
+
+    void BuildIndex() const;
+
     virtual void Print(Option_t* option = "") const;
 
   private:
+    Int_t FindSegment(time_type time) const;
+    AliTimeRangeMask<time_type, bitmap_type>* ScanTimeRangeMask(time_type time) const;
+
     TClonesArray fArrTimeRanges;
 
-    ClassDef(AliTimeRangeMasking, 1);
+    /// Lookup index, built from fArrTimeRanges at the first query (or by BuildIndex()).
+    /// The ranges are cut into disjoint segments, sorted in time, in which the set of
+    /// covering ranges does not change; adjacent segments with the same content are merged.
+    mutable std::vector<time_type> fSegmentStart;    //!< first time of each segment
+    mutable std::vector<time_type> fSegmentEnd;      //!< last time of each segment
+    mutable std::vector<bitmap_type> fSegmentMask;   //!< OR of the reasons of the ranges covering the segment
+    mutable std::vector<Int_t> fSegmentRange;        //!< first range (in insertion order) covering the segment
+    mutable Bool_t fIndexValid;                      //!< index is up to date
+
+    ClassDef(AliTimeRangeMasking, 2);
 };
 
 #endif
@@ -28,12 +28,82 @@
 #include "TFile.h"
 #include "TStopwatch.h"
 #include "TArrayL64.h"
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
 
 ClassImp(AliMultSelectionCalibrator);
 
+namespace {
+    //Boundaries of one floating point estimator in one run (range), single pass engine
+    struct AliMultCalibBoundaryJob {
+        std::vector<Float_t> *fValues; //estimator values, reordered by the selection
+        Bool_t   fUseAnchor;
+        Double_t fAnchorThreshold;     //anchor point, as used in the legacy TTree::Draw condition
+        Double_t fAnchorPercentile;
+        Long64_t fAccepted;            //output: values above the anchor point
+        std::vector<Double_t> fBoundaries; //output: raw boundaries, index as lDesiredBoundaries
+    };
+
+    void FindBoundaries( AliMultCalibBoundaryJob &lJob, const Double_t *lDesiredBoundaries, Long_t lNDesiredBoundaries ){
+        std::vector<Float_t> &lValues = *lJob.fValues;
+        const Long64_t ntot = lValues.size();
+        lJob.fAccepted = 0;
+        lJob.fBoundaries.assign( lNDesiredBoundaries, 0. );
+        if( ntot < 1 ) return;
+        if( lJob.fUseAnchor ){
+            for( Long64_t iEntry=0; iEntry<ntot; iEntry++) if( lValues[iEntry] > lJob.fAnchorThreshold ) lJob.fAccepted++;
+        }
+
+        //Same positions as in the legacy engine, in the decreasing order of TMath::Sort
+        std::vector< std::pair<Long64_t,Long_t> > lPositions;
+        for( Long_t lB=1; lB<lNDesiredBoundaries; lB++) {
+            Long64_t position = (Long64_t) ( 0.01 * ((Double_t)(ntot)* lDesiredBoundaries[lB] ) );
+            if( lJob.fUseAnchor ){
+                Double_t lFractionAccepted = (((Double_t) lJob.fAccepted )/((Double_t) ntot));
+                Double_t lScalingFactor    = lFractionAccepted/((0.01)*lJob.fAnchorPercentile);
+                position = (Long64_t) ( ( 0.01 * ((Double_t)(ntot)* lDesiredBoundaries[lB] ) ) * lScalingFactor );
+                if(position > ntot-1 ) position = ntot-1; //protection !
+            }
+            if( position < 0 || position >= ntot ) position = 0; //as TArrayL64 out of bounds
+            lPositions.push_back( std::make_pair(position, lB) );
+        }
+
+        //Partial selection: each boundary only partitions what is left after the previous one
+        std::sort( lPositions.begin(), lPositions.end() );
+        Long64_t lFirst = 0;
+        for( size_t iPos=0; iPos<lPositions.size(); iPos++) {
+            const Long64_t position = lPositions[iPos].first;
+            std::nth_element( lValues.begin()+lFirst, lValues.begin()+position, lValues.end(), std::greater<Float_t>() );
+            lJob.fBoundaries[ lPositions[iPos].second ] = lValues[position];
+            lFirst = position;
+        }
+    }
+
+    void FindAllBoundaries( std::vector<AliMultCalibBoundaryJob> &lJobs, const Double_t *lDesiredBoundaries, Long_t lNDesiredBoundaries, Int_t lNThreads ){
+        if( lNThreads > (Int_t) lJobs.size() ) lNThreads = lJobs.size();
+        if( lNThreads <= 1 ){
+            for( size_t iJob=0; iJob<lJobs.size(); iJob++) FindBoundaries( lJobs[iJob], lDesiredBoundaries, lNDesiredBoundaries );
+            return;
+        }
+        std::atomic<size_t> lNextJob(0);
+        std::vector<std::thread> lThreads;
+        for( Int_t iThread=0; iThread<lNThreads; iThread++) {
+            lThreads.push_back( std::thread( [&]() {
+                for( size_t iJob = lNextJob++; iJob<lJobs.size(); iJob = lNextJob++ )
+                    FindBoundaries( lJobs[iJob], lDesiredBoundaries, lNDesiredBoundaries );
+            } ) );
+        }
+        for( size_t iThread=0; iThread<lThreads.size(); iThread++) lThreads[iThread].join();
+    }
+}
+
 AliMultSelectionCalibrator::AliMultSelectionCalibrator() : TNamed(),
 fInput(0), fSelection(0), lDesiredBoundaries(0), lNDesiredBoundaries(0),
 fRunToUseAsDefault(-1), fMaxEventsPerRun(1e+9), fCheckTriggerType(kFALSE), fTrigType(AliVEvent::kAny), fPrefilterOnly(kFALSE),
+fUseLegacyEngine(kFALSE), fNThreads(1),
 fNRunRanges(0), fRunRangesMap(), fMultSelectionList(0),
 fInputFileName(""), fBufferFileName("buffer.root"),
 fOutputFileName(""), fMultSelectionCuts(0), fCalibHists(0)
@@ -63,6 +133,7 @@ AliMultSelectionCalibrator::AliMultSelectionCalibrator(const char * name, const
     TNamed(name,title),
 fInput(0), fSelection(0), lDesiredBoundaries(0), lNDesiredBoundaries(0),
 fRunToUseAsDefault(-1), fMaxEventsPerRun(1e+9), fCheckTriggerType(kFALSE), fTrigType(AliVEvent::kAny), fPrefilterOnly(kFALSE),
+fUseLegacyEngine(kFALSE), fNThreads(1),
 fNRunRanges(0), fRunRangesMap(), fMultSelectionList(0),
 fInputFileName(""), fBufferFileName("buffer.root"),
 fOutputFileName(""), fMultSelectionCuts(0), fCalibHists(0)
@@ -287,6 +358,22 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
         }
     }
 
+    //Single pass engine: estimators are evaluated while reading the input
+    //and kept in memory as one column per run (range) and estimator
+    Long64_t lNEventsRun[lMax];
+    for( Int_t ix=0; ix<lMax;ix++) lNEventsRun[ix] = 0;
+    std::vector< std::vector< std::vector<Float_t> > > lColumns;
+    if( !fUseLegacyEngine ){
+        cout<<"Single pass engine, estimators evaluated on the fly..."<<endl;
+        lColumns.resize( lNTrees );
+        for(Int_t iRun=0; iRun<lNTrees; iRun++) {
+            AliMultSelection *lSel = lAutoDiscover ? fSelection : (AliMultSelection*) fMultSelectionList->At(iRun);
+            if( !lAutoDiscover ) lSel->Setup ( fInput );
+            lColumns[iRun].resize( lSel->GetNEstimators() );
+        }
+        if( lAutoDiscover ) fSelection->Setup ( fInput );
+    }
+
     //const int lNEstimators = fSelection->GetNEstimators();
 
     const int lNEstimators = 50; //this is the MAX VALUE!
@@ -389,26 +476,36 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
             }
         }
         if ( lSaveThisEvent ) {
-            if( sTree[lIndex]->GetEntries()<fMaxEventsPerRun ){
-                sTree [ lIndex ] -> Fill();
+            if( lNEventsRun[lIndex]<fMaxEventsPerRun ){
+                lNEventsRun[lIndex]++;
+                if( fUseLegacyEngine || fPrefilterOnly ) sTree [ lIndex ] -> Fill();
+                if( !fUseLegacyEngine ){
+                    AliMultSelection *lSel = lAutoDiscover ? fSelection : (AliMultSelection*) fMultSelectionList->At(lIndex);
+                    lSel->Evaluate ( fInput );
+                    for(Int_t iEst=0; iEst<lSel->GetNEstimators(); iEst++)
+                        lColumns[lIndex][iEst].push_back( lSel->GetEstimator(iEst)->GetValue() );
+                }
             }
         }
 
     }
 
+    timer->Stop();
+    cout<<"(2) Input read in "<<timer->RealTime()<<" s"<<endl;
+
     //Write buffer to file
     for(Int_t iRun=0; iRun<lNRuns; iRun++) sTree[iRun]->Write();
 
     if(!lAutoDiscover){
     cout<<"(3) Inspect Run Ranges and corresponding statistics: "<<endl;
     for(Int_t iRun = 0; iRun<fNRunRanges; iRun++) {
-        cout<<" --- Range #"<<iRun<<", ("<<fFirstRun[iRun]<<" - "<<fLastRun[iRun]<<"), N(events) = "<<sTree[iRun]->GetEntries()<<endl;
+        cout<<" --- Range #"<<iRun<<", ("<<fFirstRun[iRun]<<" - "<<fLastRun[iRun]<<"), N(events) = "<<lNEventsRun[iRun]<<endl;
     }
     cout<<endl;
     }else{
         cout<<"(3) Inspect Runs and corresponding statistics: "<<endl;
         for(Int_t iRun = 0; iRun<fNRunRanges; iRun++) {
-            cout<<" --- Run #"<<iRun<<", (#"<<lRunNumbers[iRun]<<"), N(events) = "<<sTree[iRun]->GetEntries()<<endl;
+            cout<<" --- Run #"<<iRun<<", (#"<<lRunNumbers[iRun]<<"), N(events) = "<<lNEventsRun[iRun]<<endl;
         }
         cout<<endl;
     }
@@ -447,20 +544,24 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
 
         const Int_t lNEstimatorsThis = fSelection->GetNEstimators();
 
-        const Long64_t ntot = (Long64_t) sTree[iRun]->GetEntries();
+        const Long64_t ntot = lNEventsRun[iRun];
         if ( !lAutoDiscover ){
             cout<<"--- Processing run range "<<fFirstRun[iRun]<<"-"<<fLastRun[iRun]<<" ("<<iRun<<"/"<<fNRunRanges<<"), with "<<ntot<<" events..."<<endl;
         }else{
             cout<<"--- Processing run "<<lRunNumbers[iRun]<<" ("<<iRun<<"/"<<fNRunRanges<<"), with "<<ntot<<" events..."<<endl;
         }
-        sTree[iRun]->SetEstimate(ntot+1);
+        if( fUseLegacyEngine ) sTree[iRun]->SetEstimate(ntot+1);
         //Cast Run Number into drawing conditions
         for(Int_t iEst=0; iEst<lNEstimatorsThis; iEst++) {
-            lRunStats[iRun] = sTree[iRun]->Draw(fSelection->GetEstimator(iEst)->GetDefinition(),"","goff");
-            lValues = sTree[iRun]->GetV1();
+            if( fUseLegacyEngine ){
+                lRunStats[iRun] = sTree[iRun]->Draw(fSelection->GetEstimator(iEst)->GetDefinition(),"","goff");
+                lValues = sTree[iRun]->GetV1();
+            }else{
+                lRunStats[iRun] = ntot;
+            }
             cout<<"--- Calculating averages: "<<flush;
             for( Long64_t iEntry=0; iEntry<ntot; iEntry++) {
-                Float_t lThisVal = lValues[iEntry]; //Test
+                Float_t lThisVal = fUseLegacyEngine ? lValues[iEntry] : lColumns[iRun][iEst][iEntry]; //Test
                 lAvEst[iEst][iRun] += lThisVal;
                 if( lThisVal < lMinEst[iEst][iRun] ) {
                     lMinEst[iEst][iRun] = lThisVal;
@@ -469,10 +570,10 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
                     lMaxEst[iEst][iRun] = lThisVal;
                 }
             }
-            if( sTree[iRun]->GetEntries() < 1 ) {
+            if( ntot < 1 ) {
                 lAvEst[iEst][iRun] = -1;
             } else {
-                lAvEst[iEst][iRun] /= ( (Double_t) (sTree[iRun]->GetEntries()) );
+                lAvEst[iEst][iRun] /= ( (Double_t) (ntot) );
             }
             cout<<" Min = "<<lMinEst[iEst][iRun]<<", Max = "<<lMaxEst[iEst][iRun]<<", Av = "<<lAvEst[iEst][iRun]<<endl;
 
@@ -485,6 +586,31 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
     //might be needed
     Long64_t lAcceptedEvents;
 
+    //Single pass engine: all boundaries located at once, in parallel over runs and estimators
+    std::vector<AliMultCalibBoundaryJob> lJobs;
+    std::vector< std::vector<Int_t> > lJobIndex( fNRunRanges );
+    if( !fUseLegacyEngine ){
+        timer->Start ( kTRUE );
+        for(Int_t iRun=0; iRun<fNRunRanges; iRun++) {
+            AliMultSelection *lSel = lAutoDiscover ? fSelection : (AliMultSelection*) fMultSelectionList->At(iRun);
+            lJobIndex[iRun].assign( lSel->GetNEstimators(), -1 );
+            for(Int_t iEst=0; iEst<lSel->GetNEstimators(); iEst++) {
+                if( lSel->GetEstimator(iEst)->IsInteger() ) continue;
+                AliMultCalibBoundaryJob lJob;
+                lJob.fValues           = &lColumns[iRun][iEst];
+                lJob.fUseAnchor        = lSel->GetEstimator(iEst)->GetUseAnchor();
+                lJob.fAnchorThreshold  = atof( Form("%.10f",lSel->GetEstimator(iEst)->GetAnchorPoint() ) );
+                lJob.fAnchorPercentile = (Double_t) lSel->GetEstimator(iEst)->GetAnchorPercentile();
+                lJob.fAccepted         = 0;
+                lJobIndex[iRun][iEst]  = lJobs.size();
+                lJobs.push_back( lJob );
+            }
+        }
+        FindAllBoundaries( lJobs, lDesiredBoundaries, lNDesiredBoundaries, fNThreads );
+        timer->Stop();
+        cout<<"(4) Boundaries of "<<lJobs.size()<<" estimators located in "<<timer->RealTime()<<" s ("<<fNThreads<<" threads)"<<endl;
+    }
+
     //=========================================
     // Determine Calibration Information
     //=========================================
@@ -511,33 +637,43 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
 
         const Int_t lNEstimatorsThis = fSelection->GetNEstimators();
 
-        const Long64_t ntot = (Long64_t) sTree[iRun]->GetEntries();
+        const Long64_t ntot = lNEventsRun[iRun];
         if ( !lAutoDiscover ){
             cout<<"--- Processing run range "<<fFirstRun[iRun]<<"-"<<fLastRun[iRun]<<" ("<<iRun<<"/"<<fNRunRanges<<"), with "<<ntot<<" events..."<<endl;
         }else{
             cout<<"--- Processing run "<<lRunNumbers[iRun]<<" ("<<iRun<<"/"<<fNRunRanges<<"), with "<<ntot<<" events..."<<endl;
         }
-        sTree[iRun]->SetEstimate(ntot+1);
+        if( fUseLegacyEngine ) sTree[iRun]->SetEstimate(ntot+1);
         // Memory allocation: don't repeat it per estimator! only per run
-        TArrayL64 index(ntot);
+        TArrayL64 index(fUseLegacyEngine ? ntot : 0);
         //Cast Run Number into drawing conditions
         for(Int_t iEst=0; iEst<lNEstimatorsThis; iEst++) {
             if( ! ( fSelection->GetEstimator(iEst)->IsInteger() ) ) {
                 //==== Floating Point Calibration Engine ====
-                lRunStats[iRun] = sTree[iRun]->Draw(fSelection->GetEstimator(iEst)->GetDefinition(),"","goff");
-                cout<<"--- Sorting estimator "<<fSelection->GetEstimator(iEst)->GetName()<<"..."<<flush;
+                const AliMultCalibBoundaryJob *lJob = fUseLegacyEngine ? 0x0 : &lJobs[ lJobIndex[iRun][iEst] ];
+                if( fUseLegacyEngine ){
+                    lRunStats[iRun] = sTree[iRun]->Draw(fSelection->GetEstimator(iEst)->GetDefinition(),"","goff");
+                    cout<<"--- Sorting estimator "<<fSelection->GetEstimator(iEst)->GetName()<<"..."<<flush;
 
-                TMath::Sort(ntot,sTree[iRun]->GetV1(), index.GetArray() );
-                cout<<" Done! Getting Boundaries... "<<flush;
+                    TMath::Sort(ntot,sTree[iRun]->GetV1(), index.GetArray() );
+                    cout<<" Done! Getting Boundaries... "<<flush;
+                }else{
+                    lRunStats[iRun] = ntot;
+                    cout<<"--- Estimator "<<fSelection->GetEstimator(iEst)->GetName()<<"..."<<flush;
+                }
 
                 //Special override in case anchored estimator
                 if( fSelection->GetEstimator(iEst)->GetUseAnchor() ){
                     cout<<"Anchoring... "<<flush;
                     //Require determination of index after which values are to be discarded
                     //Count fraction of accepted
-                    TString lCondition = fSelection->GetEstimator(iEst)->GetDefinition();
-                    lCondition.Append(Form("> %.10f",fSelection->GetEstimator(iEst)->GetAnchorPoint() ) );
-                    lAcceptedEvents = sTree[iRun]->Draw(fSelection->GetEstimator(iEst)->GetDefinition(),lCondition.Data(),"goff");
+                    if( fUseLegacyEngine ){
+                        TString lCondition = fSelection->GetEstimator(iEst)->GetDefinition();
+                        lCondition.Append(Form("> %.10f",fSelection->GetEstimator(iEst)->GetAnchorPoint() ) );
+                        lAcceptedEvents = sTree[iRun]->Draw(fSelection->GetEstimator(iEst)->GetDefinition(),lCondition.Data(),"goff");
+                    }else{
+                        lAcceptedEvents = lJob->fAccepted;
+                    }
                     lRunStats[iRun] = lAcceptedEvents;
                 }
                 lNrawBoundaries[0] = 0.0; //Defined OK even if anchored
@@ -548,6 +684,11 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
                 }
 
                 for( Long_t lB=1; lB<lNDesiredBoundaries; lB++) {
+                    if( !fUseLegacyEngine ){
+                        //Located in FindAllBoundaries with the same positions
+                        lNrawBoundaries[lB] = lJob->fBoundaries[lB];
+                        continue;
+                    }
                     Long64_t position = (Long64_t) ( 0.01 * ((Double_t)(ntot)* lDesiredBoundaries[lB] ) );
 
                     if( fSelection->GetEstimator(iEst)->GetUseAnchor() && ntot != 0 ){
@@ -616,14 +757,19 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
                 Float_t lLowEdge = lMinEst[iEst][iRun]-0.5;
                 Float_t lHighEdge= lMaxEst[iEst][iRun]+0.5;
                 cout<<"Inspect: "<<lNBins<<", low "<<lLowEdge<<", high "<<lHighEdge<<endl;
-                if( sTree[iRun]->GetEntries() < 1 ) {
+                if( ntot < 1 ) {
                     //Case of an empty run!
                     hCalib[iRun][iEst] = new TH1F(Form("hCalib_%i_%s",lRunNumbers[iRun],fSelection->GetEstimator(iEst)->GetName()),"",1,0,1);
                     hCalib[iRun][iEst]->SetDirectory(0);
                 } else {
                     TH1F *hTemporary = new TH1F("hTemporary", "", lNBins, lMinEst[iEst][iRun]-0.5, lMaxEst[iEst][iRun]+0.5 );
                     //hTemporary->SetDirectory(0);
-                    lRunStats[iRun] = sTree[iRun]->Draw(Form("%s>>hTemporary",fSelection->GetEstimator(iEst)->GetDefinition().Data()),"","goff");
+                    if( fUseLegacyEngine ){
+                        lRunStats[iRun] = sTree[iRun]->Draw(Form("%s>>hTemporary",fSelection->GetEstimator(iEst)->GetDefinition().Data()),"","goff");
+                    }else{
+                        for( Long64_t iEntry=0; iEntry<ntot; iEntry++) hTemporary->Fill( lColumns[iRun][iEst][iEntry] );
+                        lRunStats[iRun] = ntot;
+                    }
                     cout<<"entries = "<<lRunStats[iRun]<<endl;
                     //In memory now: histogram with content, please normalize to unity
                     hTemporary->Scale(1./((double)(lRunStats[iRun])));
@@ -765,6 +911,93 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
     return kTRUE;
 }
 //________________________________________________________________
+Bool_t AliMultSelectionCalibrator::CompareCalibrations( TString lFileA, TString lFileB, Double_t lTolerance ) {
+    // Bin-by-bin comparison of the calibration histograms and estimator means
+    // stored in two OADB files, e.g. produced with the single pass and the
+    // legacy engine from the same input. Returns kTRUE if all agree within
+    // lTolerance (absolute).
+    TFile *lFA = TFile::Open( lFileA.Data(), "READ");
+    TFile *lFB = TFile::Open( lFileB.Data(), "READ");
+    if( !lFA || !lFB ){
+        cout<<"CompareCalibrations: cannot open "<<lFileA.Data()<<" or "<<lFileB.Data()<<endl;
+        return kFALSE;
+    }
+    AliOADBContainer *lContA = (AliOADBContainer*) lFA->Get("MultSel");
+    AliOADBContainer *lContB = (AliOADBContainer*) lFB->Get("MultSel");
+    if( !lContA || !lContB ){
+        cout<<"CompareCalibrations: MultSel container not found!"<<endl;
+        return kFALSE;
+    }
+    if( lContA->GetNumberOfEntries() != lContB->GetNumberOfEntries() ){
+        cout<<"CompareCalibrations: "<<lContA->GetNumberOfEntries()<<" vs "<<lContB->GetNumberOfEntries()<<" entries"<<endl;
+        return kFALSE;
+    }
+
+    Long_t lNDifferences = 0;
+    Long_t lNBinsChecked = 0;
+    const Int_t lNEntries = lContA->GetNumberOfEntries();
+    //Last comparison (index lNEntries) is the default object
+    for( Int_t iEntry=0; iEntry<=lNEntries; iEntry++) {
+        AliOADBMultSelection *lOA = 0x0, *lOB = 0x0;
+        TString lLabel = "Default";
+        if( iEntry < lNEntries ){
+            lOA = (AliOADBMultSelection*) lContA->GetObjectByIndex(iEntry);
+            lOB = (AliOADBMultSelection*) lContB->GetObjectByIndex(iEntry);
+            lLabel = Form("%i-%i", lContA->LowerLimit(iEntry), lContA->UpperLimit(iEntry));
+            if( lContA->LowerLimit(iEntry) != lContB->LowerLimit(iEntry) || lContA->UpperLimit(iEntry) != lContB->UpperLimit(iEntry) ){
+                cout<<"CompareCalibrations: run ranges differ for entry "<<iEntry<<endl;
+                lNDifferences++;
+                continue;
+            }
+        }else{
+            lOA = (AliOADBMultSelection*) lContA->GetDefaultObject("Default");
+            lOB = (AliOADBMultSelection*) lContB->GetDefaultObject("Default");
+        }
+        if( !lOA || !lOB ){
+            if( lOA != lOB ){
+                cout<<"CompareCalibrations: "<<lLabel.Data()<<" missing in one of the files"<<endl;
+                lNDifferences++;
+            }
+            continue;
+        }
+        if( lOA->GetNEstimators() != lOB->GetNEstimators() ){
+            cout<<"CompareCalibrations: "<<lLabel.Data()<<" has a different number of estimators"<<endl;
+            lNDifferences++;
+            continue;
+        }
+        for( Long_t iEst=0; iEst<lOA->GetNEstimators(); iEst++) {
+            AliMultEstimator *lEstA = lOA->GetMultSelection()->GetEstimator(iEst);
+            AliMultEstimator *lEstB = lOB->GetMultSelection()->GetEstimator(iEst);
+            if( TMath::Abs( lEstA->GetMean() - lEstB->GetMean() ) > lTolerance ){
+                cout<<"CompareCalibrations: "<<lLabel.Data()<<", "<<lEstA->GetName()<<": mean "<<lEstA->GetMean()<<" vs "<<lEstB->GetMean()<<endl;
+                lNDifferences++;
+            }
+            TH1F *hA = lOA->GetCalibHisto(iEst);
+            TH1F *hB = lOB->GetCalibHisto(iEst);
+            if( !hA || !hB || hA->GetNbinsX() != hB->GetNbinsX() ){
+                cout<<"CompareCalibrations: "<<lLabel.Data()<<", "<<lEstA->GetName()<<": histograms differ in binning"<<endl;
+                lNDifferences++;
+                continue;
+            }
+            for( Int_t ibin=0; ibin<=hA->GetNbinsX()+1; ibin++) {
+                lNBinsChecked++;
+                const Bool_t lSameEdge    = TMath::Abs( hA->GetXaxis()->GetBinLowEdge(ibin) - hB->GetXaxis()->GetBinLowEdge(ibin) ) <= lTolerance;
+                const Bool_t lSameContent = TMath::Abs( hA->GetBinContent(ibin) - hB->GetBinContent(ibin) ) <= lTolerance;
+                if( !lSameEdge || !lSameContent ){
+                    cout<<"CompareCalibrations: "<<lLabel.Data()<<", "<<lEstA->GetName()<<", bin "<<ibin<<": edge "
+                    <<hA->GetXaxis()->GetBinLowEdge(ibin)<<" vs "<<hB->GetXaxis()->GetBinLowEdge(ibin)<<", content "
+                    <<hA->GetBinContent(ibin)<<" vs "<<hB->GetBinContent(ibin)<<endl;
+                    lNDifferences++;
+                }
+            }
+        }
+    }
+    cout<<"CompareCalibrations: "<<lNBinsChecked<<" bins checked, "<<lNDifferences<<" differences"<<endl;
+    lFA->Close();
+    lFB->Close();
+    return lNDifferences == 0;
+}
+//________________________________________________________________
 Float_t AliMultSelectionCalibrator::MinVal( Float_t A, Float_t B ) {
     if( A < B ) {
         return A;
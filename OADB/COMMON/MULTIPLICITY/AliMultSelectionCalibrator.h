@@ -72,12 +72,21 @@ public:
     //Filter only flag
     void SetFilterOnly(Bool_t lOpt = kTRUE){ fPrefilterOnly = lOpt; }
     
+    //Calibration engine: single pass over the input (default) or
+    //run-by-run buffer trees processed with TTree::Draw (legacy)
+    void SetUseLegacyEngine(Bool_t lOpt = kTRUE){ fUseLegacyEngine = lOpt; }
+    //Number of threads used to locate the boundaries (single pass engine)
+    void SetNThreads(Int_t lNThreads){ fNThreads = lNThreads; }
+    
     //Master Function in this Class: To be called once filenames are set
     Bool_t Calibrate();
     
     //Helper
     Float_t MinVal( Float_t A, Float_t B );
     
+    //Bin-by-bin comparison of the calibration histograms of two OADB files
+    static Bool_t CompareCalibrations( TString lFileA, TString lFileB, Double_t lTolerance = 0. );
+    
 private:
     AliMultInput     *fInput;     //Object for all input
     AliMultSelection *fSelection; //(current) transient pointer object
@@ -93,6 +102,8 @@ private:
     Bool_t fCheckTriggerType; 
     AliVEvent::EOfflineTriggerTypes fTrigType; // trigger type to calibrate
     Bool_t fPrefilterOnly; //stop before calibrating stuff
+    Bool_t fUseLegacyEngine; //use run-by-run buffer trees and TTree::Draw
+    Int_t fNThreads; //threads for the boundary determination
     
     //Run Ranges map - master storage
     Long_t fNRunRanges;
@@ -112,10 +123,11 @@ private:
     // TList object for storing histograms
     TList *fCalibHists; 
 
-    ClassDef(AliMultSelectionCalibrator, 2);
+    ClassDef(AliMultSelectionCalibrator, 3);
     //(this classdef is only for bookkeeping, class will not usually
     // be streamed according to current workflow except in very specific
     // tests!) 
     //2 - Adjustments of extra event selections
+    //3 - Single pass calibration engine
 };
 #endif
@@ -16,6 +16,8 @@
 // --- ROOT system ---
 #include <TObjArray.h>
 
+#include <algorithm>
+
 // --- AliRoot system ---
 #include "AliCaloTrackParticleCorrelation.h"
 #include "AliEMCALGeometry.h"
@@ -52,6 +54,7 @@ fNeutralOverChargedRatio(0),
 fDebug(0),           fMomentum(),                   fTrackVector(),
 fEMCEtaSize(-1),     fEMCPhiMin(-1),                fEMCPhiMax(-1),
 fTPCEtaSize(-1),     fTPCPhiSize(-1),
+fUseConeGrid(0),     fConeGridCellSize(0.1),        fGridSelected(),
 // Histograms
 fHistoRanges(0),
 fhPtInCone(0),       
@@ -91,6 +94,16 @@ fhConeSumPtUEBandSubClustervsTrack(0),
 fhBandClustervsTrack(0),                    fhBandNormClustervsTrack(0),             
 fhConeSumPtTrackSubVsNoSub(0),              fhConeSumPtClusterSubVsNoSub(0)  
 {
+  for(Int_t igrid = 0; igrid < kNGrids; igrid++)
+  {
+    fGridList       [igrid] = 0x0;
+    fGridEventNumber[igrid] = -1;
+    fGridNEntries   [igrid] = -1;
+    fGridEtaMin     [igrid] = 0;
+    fGridNEta       [igrid] = 0;
+    fGridNPhi       [igrid] = 0;
+  }
+  
   InitParameters();
 }
 
@@ -177,11 +190,36 @@ void AliIsolationCut::CalculateCaloSignalInCone
   TObjArray * refclusters  = 0x0;
   Int_t       nclusterrefs = 0;
   
+  // Restrict the loop to the clusters in the grid cells overlapping
+  // the cone and the UE bands, not possible when all are histogrammed
+  //
+  Bool_t useGrid = fUseConeGrid && !bgCls && !useRefs && !(fFillHistograms && fFillEtaPhiHistograms);
+  Int_t  nSelected = plNe->GetEntries();
+  if ( useGrid )
+  {
+    FillConeGrid(kGridCluster, plNe, reader);
+    
+    fGridSelected.clear();
+    SelectConeGridParticles(kGridCluster, etaC-fConeSize, etaC+fConeSize, phiC-fConeSize, phiC+fConeSize);
+    if ( fICMethod >= kSumBkgSubIC )
+    {
+      SelectConeGridParticles(kGridCluster, etaC-fConeSize, etaC+fConeSize, 0, TMath::TwoPi());
+      SelectConeGridParticles(kGridCluster, -1e10, 1e10, phiC-fConeSize, phiC+fConeSize);
+    }
+    
+    // Keep the original order, for the sums and the references
+    std::sort(fGridSelected.begin(), fGridSelected.end());
+    fGridSelected.erase(std::unique(fGridSelected.begin(), fGridSelected.end()), fGridSelected.end());
+    nSelected = fGridSelected.size();
+  }
+  
   // Get the clusters
   //
   //printf("Loop calo\n");
-  for(Int_t ipr = 0;ipr < plNe->GetEntries() ; ipr ++ )
+  for(Int_t isel = 0; isel < nSelected; isel++ )
   {
+    Int_t ipr = useGrid ? fGridSelected[isel] : isel;
+    
     AliVCluster * calo = dynamic_cast<AliVCluster *>(plNe->At(ipr)) ;
     
     if ( calo )
@@ -489,13 +527,47 @@ void AliIsolationCut::CalculateTrackSignalInCone
   
   TObjArray * reftracks  = 0x0;
   Int_t       ntrackrefs = 0;
+  
+  // Restrict the loop to the tracks in the grid cells overlapping
+  // the cone, the UE bands and the perpendicular cones, not possible
+  // when all are histogrammed
+  //
+  Bool_t useGrid = fUseConeGrid && !bgTrk && !useRefs && !(fFillHistograms && fFillEtaPhiHistograms);
+  Int_t  nSelected = plCTS->GetEntries();
+  if ( useGrid )
+  {
+    FillConeGrid(kGridTrack, plCTS, reader);
     
+    fGridSelected.clear();
+    SelectConeGridParticles(kGridTrack, etaTrig-fConeSize, etaTrig+fConeSize, phiTrig-fConeSize, phiTrig+fConeSize);
+    if ( fICMethod >= kSumBkgSubIC )
+    {
+      SelectConeGridParticles(kGridTrack, etaTrig-fConeSize, etaTrig+fConeSize, 
+                              phiTrig-TMath::PiOver2(), phiTrig+TMath::PiOver2());
+      SelectConeGridParticles(kGridTrack, -1e10, 1e10, phiTrig-fConeSize, phiTrig+fConeSize);
+    }
+    if ( fICMethod == kSumBkgSubIC )
+    {
+      SelectConeGridParticles(kGridTrack, etaTrig-fConeSize, etaTrig+fConeSize, 
+                              phiTrig+TMath::PiOver2()-fConeSize, phiTrig+TMath::PiOver2()+fConeSize);
+      SelectConeGridParticles(kGridTrack, etaTrig-fConeSize, etaTrig+fConeSize, 
+                              phiTrig-TMath::PiOver2()-fConeSize, phiTrig-TMath::PiOver2()+fConeSize);
+    }
+    
+    // Keep the original order, for the sums and the references
+    std::sort(fGridSelected.begin(), fGridSelected.end());
+    fGridSelected.erase(std::unique(fGridSelected.begin(), fGridSelected.end()), fGridSelected.end());
+    nSelected = fGridSelected.size();
+  }
+  
   //-----------------------------------------------------------
   // Get the tracks in cone
   //
   //-----------------------------------------------------------
-  for(Int_t ipr = 0;ipr < plCTS->GetEntries() ; ipr ++ )
+  for(Int_t isel = 0; isel < nSelected; isel++ )
   {
+    Int_t ipr = useGrid ? fGridSelected[isel] : isel;
+    
     AliVTrack* track = dynamic_cast<AliVTrack*>(plCTS->At(ipr)) ;
     
     if(track)
@@ -750,6 +822,143 @@ void AliIsolationCut::CalculateTrackSignalInCone
   if ( bFillAOD && reftracks ) pCandidate->AddObjArray(reftracks);  
 }
 
+//_________________________________________________________________________________________________________________________________
+/// Bin the tracks or clusters of the event in an eta-phi grid, done once per event and list.
+/// The kinematics are calculated as in the cone loops, entries that can not be
+/// interpreted are kept in an extra cell always selected.
+///
+/// \param grid: kGridTrack or kGridCluster.
+/// \param list: array of tracks or clusters of the reader.
+/// \param reader: pointer to AliCaloTrackReader. Needed to access event info.
+//_________________________________________________________________________________________________________________________________
+void AliIsolationCut::FillConeGrid(Int_t grid, TObjArray * list, AliCaloTrackReader * reader)
+{
+  Int_t nEntries = list->GetEntries();
+  
+  if ( fGridList[grid] == list && fGridEventNumber[grid] == reader->GetEventNumber() && 
+       fGridNEntries[grid] == nEntries ) return ;
+  
+  fGridList       [grid] = list;
+  fGridEventNumber[grid] = reader->GetEventNumber();
+  fGridNEntries   [grid] = nEntries;
+  
+  Float_t cellSize = fConeGridCellSize > 0 ? fConeGridCellSize : 0.1;
+  
+  std::vector<Float_t> etaEntry(nEntries, 0);
+  std::vector<Float_t> phiEntry(nEntries, 0);
+  std::vector<Bool_t>  binned  (nEntries, kFALSE);
+  
+  Float_t etaMin =  1e10;
+  Float_t etaMax = -1e10;
+  for(Int_t ipr = 0; ipr < nEntries; ipr++ )
+  {
+    Float_t eta = -100. ;
+    Float_t phi = -100. ;
+    
+    AliVTrack   * track = 0x0;
+    AliVCluster * calo  = 0x0;
+    if      ( grid == kGridTrack   && (track = dynamic_cast<AliVTrack*>  (list->At(ipr))) )
+    {
+      fTrackVector.SetXYZ(track->Px(),track->Py(),track->Pz());
+      eta = fTrackVector.Eta();
+      phi = fTrackVector.Phi();
+    }
+    else if ( grid == kGridCluster && (calo  = dynamic_cast<AliVCluster*>(list->At(ipr))) )
+    {
+      Int_t evtIndex = 0 ;
+      if ( reader->GetMixedEvent() )
+        evtIndex=reader->GetMixedEvent()->EventIndexForCaloCluster(calo->GetID()) ;
+      
+      calo->GetMomentum(fMomentum,reader->GetVertex(evtIndex)) ;
+      eta = fMomentum.Eta() ;
+      phi = fMomentum.Phi() ;
+    }
+    else continue ;
+    
+    if ( phi < 0 ) phi+=TMath::TwoPi();
+    
+    if ( eta != eta || phi != phi ) continue ; // NaN, leave it unbinned
+    
+    etaEntry[ipr] = eta;
+    phiEntry[ipr] = phi;
+    binned  [ipr] = kTRUE;
+    
+    if ( eta < etaMin ) etaMin = eta;
+    if ( eta > etaMax ) etaMax = eta;
+  }
+  
+  if ( etaMax < etaMin ) { etaMin = 0; etaMax = 0; }
+  
+  // Very large eta from particles along the beam axis are kept in the border cells
+  etaMin = TMath::Max(etaMin, -10.f);
+  etaMax = TMath::Min(etaMax,  10.f);
+  
+  fGridEtaMin[grid] = etaMin;
+  fGridNEta  [grid] = TMath::Max(1, TMath::CeilNint((etaMax-etaMin)/cellSize));
+  fGridNPhi  [grid] = TMath::Max(1, TMath::CeilNint(TMath::TwoPi()/cellSize));
+  
+  Int_t nCells = fGridNEta[grid]*fGridNPhi[grid];
+  
+  std::vector<Int_t> cellEntry(nEntries, nCells); // last cell for the unbinned entries
+  for(Int_t ipr = 0; ipr < nEntries; ipr++ )
+  {
+    if ( !binned[ipr] ) continue ;
+    
+    Int_t ieta = TMath::Min(TMath::Max(TMath::FloorNint((etaEntry[ipr]-etaMin)/cellSize), 0), fGridNEta[grid]-1);
+    Int_t iphi = TMath::Min(TMath::Max(TMath::FloorNint( phiEntry[ipr]        /cellSize), 0), fGridNPhi[grid]-1);
+    cellEntry[ipr] = ieta*fGridNPhi[grid]+iphi;
+  }
+  
+  // Counting sort of the entries, keeping the list order inside each cell
+  fGridCellStart[grid].assign(nCells+2, 0);
+  for(Int_t ipr = 0; ipr < nEntries; ipr++ ) fGridCellStart[grid][cellEntry[ipr]+1]++;
+  for(Int_t icell = 0; icell <= nCells; icell++ ) fGridCellStart[grid][icell+1] += fGridCellStart[grid][icell];
+  
+  fGridCellEntries[grid].assign(nEntries, 0);
+  std::vector<Int_t> cellFill(fGridCellStart[grid].begin(), fGridCellStart[grid].end()-1);
+  for(Int_t ipr = 0; ipr < nEntries; ipr++ ) fGridCellEntries[grid][cellFill[cellEntry[ipr]]++] = ipr;
+  
+  AliDebug(1,Form("Grid %d: %d entries in %d x %d cells",grid,nEntries,fGridNEta[grid],fGridNPhi[grid]));
+}
+
+//_________________________________________________________________________________________________________________________________
+/// Add to fGridSelected the index of the grid entries in the cells overlapping
+/// the eta-phi window, plus the unbinned entries. Phi is not wrapped, as in the
+/// comparisons of the cone loops. The window is enlarged by one cell to be safe
+/// against rounding at the cell borders, the exact selection is done in the loops.
+///
+/// \param grid: kGridTrack or kGridCluster.
+/// \param etaMin: lower eta edge of the window.
+/// \param etaMax: upper eta edge of the window.
+/// \param phiMin: lower phi edge of the window.
+/// \param phiMax: upper phi edge of the window.
+//_________________________________________________________________________________________________________________________________
+void AliIsolationCut::SelectConeGridParticles(Int_t grid, Float_t etaMin, Float_t etaMax, Float_t phiMin, Float_t phiMax)
+{
+  Float_t cellSize = fConeGridCellSize > 0 ? fConeGridCellSize : 0.1;
+  Int_t   nEta     = fGridNEta[grid];
+  Int_t   nPhi     = fGridNPhi[grid];
+  
+  Int_t ietaMin = TMath::Max(TMath::FloorNint((TMath::Max(etaMin,-20.f)-fGridEtaMin[grid])/cellSize)-1, 0);
+  Int_t ietaMax = TMath::Min(TMath::FloorNint((TMath::Min(etaMax, 20.f)-fGridEtaMin[grid])/cellSize)+1, nEta-1);
+  Int_t iphiMin = TMath::Max(TMath::FloorNint( TMath::Max(phiMin,-10.f)                   /cellSize)-1, 0);
+  Int_t iphiMax = TMath::Min(TMath::FloorNint( TMath::Min(phiMax, 20.f)                   /cellSize)+1, nPhi-1);
+  
+  const std::vector<Int_t> & cellStart   = fGridCellStart  [grid];
+  const std::vector<Int_t> & cellEntries = fGridCellEntries[grid];
+  
+  for(Int_t ieta = ietaMin; ieta <= ietaMax && iphiMin <= iphiMax; ieta++)
+  {
+    // Cells of consecutive phi are contiguous
+    Int_t first = cellStart[ieta*nPhi+iphiMin  ];
+    Int_t last  = cellStart[ieta*nPhi+iphiMax+1];
+    fGridSelected.insert(fGridSelected.end(), cellEntries.begin()+first, cellEntries.begin()+last);
+  }
+  
+  // Unbinned entries
+  fGridSelected.insert(fGridSelected.end(), cellEntries.begin()+cellStart[nEta*nPhi], cellEntries.end());
+}
+
 //_________________________________________________________________________________________________________________________________
 /// Get normalization of cluster background band.
 //_________________________________________________________________________________________________________________________________
@@ -1779,6 +1988,8 @@ TString AliIsolationCut::GetICParametersList()
   parList+=onePar ;
   snprintf(onePar,buffersize,"fFillHistograms=%d,fFillEtaPhiHistograms=%d;",fFillHistograms,fFillEtaPhiHistograms) ;
   parList+=onePar ;
+  snprintf(onePar,buffersize,"fUseConeGrid=%d,fConeGridCellSize=%1.2f;",fUseConeGrid,fConeGridCellSize) ;
+  parList+=onePar ;
   
   return parList;
 }
@@ -1802,6 +2013,8 @@ void AliIsolationCut::InitParameters()
   fDistMinToTrigger     = -1.; // no effect
   fNeutralOverChargedRatio = 0.363; // Based on pPb analysis, to be confirmed on other systems. 
                                     // Use eta band for charged and neutrals for estimation.
+  fUseConeGrid          = kFALSE;
+  fConeGridCellSize     = 0.1;
 }
 
 //________________________________________________________________________________
@@ -2253,6 +2466,7 @@ void AliIsolationCut::Print(const Option_t * opt) const
   printf("using fraction for high pt leading instead of frac ? %i\n",fFracIsThresh);
   printf("minimum distance to candidate, R>%1.2f\n",fDistMinToTrigger);
   printf("correct cone excess = %d \n",fMakeConeExcessCorr);
+  printf("use eta-phi grid = %d, cell size %1.2f \n",fUseConeGrid,fConeGridCellSize);
   printf("    \n") ;
 }
 
@@ -23,6 +23,7 @@
 class TObjArray ;
 class TList   ;
 #include <TLorentzVector.h>
+#include <vector>
 
 // --- ANALYSIS system ---
 class AliCaloTrackParticleCorrelation ;
@@ -58,6 +59,11 @@ class AliIsolationCut : public TObject {
                     kOnlyCharged       = 2   ///< Consider tracks in cone for isolation decission.
                   } ;
 
+  enum coneGrid   { kGridTrack   = 0,        ///< Eta-phi grid of the event tracks.
+                    kGridCluster = 1,        ///< Eta-phi grid of the event clusters.
+                    kNGrids      = 2
+                  } ;
+
   // Main Methods
   
   void       InitParameters() ;
@@ -122,6 +128,12 @@ class AliIsolationCut : public TObject {
                                                  Float_t   etaUEptsumTrack,       Float_t   phiUEptsumTrack    , 
                                                  Float_t & etaUEptsumTrackNorm,   Float_t & phiUEptsumTrackNorm) const ;
 
+  // Event eta-phi grid of tracks and clusters
+
+  void       FillConeGrid(Int_t grid, TObjArray * list, AliCaloTrackReader * reader) ;
+
+  void       SelectConeGridParticles(Int_t grid, Float_t etaMin, Float_t etaMax, Float_t phiMin, Float_t phiMax) ;
+
   void 	     GetCoeffNormBadCell(AliCaloTrackParticleCorrelation * pCandidate,
                                  AliCaloTrackReader * reader,
                                  Float_t & coneBadCellsCoeff,
@@ -163,6 +175,10 @@ class AliIsolationCut : public TObject {
  
   void       SwitchOnConeExcessCorrectionHistograms ()         { fMakeConeExcessCorr = kTRUE  ; }
   void       SwitchOffConeExcessCorrectionHistograms()         { fMakeConeExcessCorr = kFALSE ; }
+
+  void       SwitchOnConeGrid ()                               { fUseConeGrid = kTRUE  ; }
+  void       SwitchOffConeGrid()                               { fUseConeGrid = kFALSE ; }
+  void       SetConeGridCellSize(Float_t size)                 { fConeGridCellSize = size ; }
   
  private:
 
@@ -206,6 +222,19 @@ class AliIsolationCut : public TObject {
   Float_t    fEMCPhiMax;         ///< Maximum Phi limit of Calo
   Float_t    fTPCEtaSize;        ///< Eta size of TPC
   Float_t    fTPCPhiSize;        ///< Phi size of TPC, it is 360 degrees, but here set to half.
+
+  Bool_t     fUseConeGrid;       ///< Visit only the tracks/clusters in the eta-phi grid cells overlapping the cone and UE regions.
+  Float_t    fConeGridCellSize;  ///< Size in eta and phi of the grid cells.
+
+  TObjArray *          fGridList       [kNGrids]; //!<! List of tracks or clusters binned in the grid.
+  Int_t                fGridEventNumber[kNGrids]; //!<! Event number of the binned list.
+  Int_t                fGridNEntries   [kNGrids]; //!<! Number of entries of the binned list.
+  Float_t              fGridEtaMin     [kNGrids]; //!<! Lower eta edge of the grid.
+  Int_t                fGridNEta       [kNGrids]; //!<! Number of eta cells.
+  Int_t                fGridNPhi       [kNGrids]; //!<! Number of phi cells, covering 0 to 2 pi.
+  std::vector<Int_t>   fGridCellStart  [kNGrids]; //!<! Offset of each cell in fGridCellEntries, last cell holds the unbinned entries.
+  std::vector<Int_t>   fGridCellEntries[kNGrids]; //!<! Index in the list of the entries, ordered by cell.
+  std::vector<Int_t>   fGridSelected;             //!<! Index in the list of the entries selected for a candidate.
   
   // Histograms
   
@@ -302,7 +331,7 @@ class AliIsolationCut : public TObject {
   AliIsolationCut & operator = (const AliIsolationCut & g) ; 
 
   /// \cond CLASSIMP
-  ClassDef(AliIsolationCut,12) ;
+  ClassDef(AliIsolationCut,13) ;
   /// \endcond
 
 } ;
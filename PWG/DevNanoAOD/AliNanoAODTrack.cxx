@@ -34,6 +34,8 @@
 ClassImp(AliNanoAODTrack)
 
 Int_t AliNanoAODTrack::fgPIDIndexes[ENanoPIDResponse::kLAST][AliPID::kSPECIESC] = { -1 };
+Int_t AliNanoAODTrack::fgVarOffsets[AliNanoAODTrack::kNVars] = { -1 };
+Bool_t AliNanoAODTrack::fgVarOffsetsResolved = kFALSE;
   
 //______________________________________________________________________________
 AliNanoAODTrack::AliNanoAODTrack() : 
@@ -339,18 +341,18 @@ template <typename T> void AliNanoAODTrack::SetP(const T *p, const Bool_t cartes
       Double_t pt2 = p[0]*p[0] + p[1]*p[1];
       Double_t pp  = TMath::Sqrt(pt2 + p[2]*p[2]);
         
-      SetVar(AliNanoAODTrackMapping::GetInstance()->GetPt() ,TMath::Sqrt(pt2)); // pt
-      SetVar(AliNanoAODTrackMapping::GetInstance()->GetPhi() , (pt2 != 0.) ? TMath::Pi()+TMath::ATan2(-p[1], -p[0]) : -999); // phi
-      SetVar(AliNanoAODTrackMapping::GetInstance()->GetTheta() , (pp != 0.) ? TMath::ACos(p[2] / pp) : -999.); // theta
+      SetVar(GetVarOffset(kVarPt) ,TMath::Sqrt(pt2)); // pt
+      SetVar(GetVarOffset(kVarPhi) , (pt2 != 0.) ? TMath::Pi()+TMath::ATan2(-p[1], -p[0]) : -999); // phi
+      SetVar(GetVarOffset(kVarTheta) , (pp != 0.) ? TMath::ACos(p[2] / pp) : -999.); // theta
     } else {
-      SetVar(AliNanoAODTrackMapping::GetInstance()->GetPt()      , p[0]);  
-      SetVar(AliNanoAODTrackMapping::GetInstance()->GetPhi()     , p[1]);  
-      SetVar(AliNanoAODTrackMapping::GetInstance()->GetTheta()   , p[2]);  
+      SetVar(GetVarOffset(kVarPt)      , p[0]);  
+      SetVar(GetVarOffset(kVarPhi)     , p[1]);  
+      SetVar(GetVarOffset(kVarTheta)   , p[2]);  
     }
   } else {
-      SetVar(AliNanoAODTrackMapping::GetInstance()->GetPt()      , p[0]);  
-      SetVar(AliNanoAODTrackMapping::GetInstance()->GetPhi()     , p[1]);  
-      SetVar(AliNanoAODTrackMapping::GetInstance()->GetTheta()   , p[2]);  
+      SetVar(GetVarOffset(kVarPt)      , p[0]);  
+      SetVar(GetVarOffset(kVarPhi)     , p[1]);  
+      SetVar(GetVarOffset(kVarTheta)   , p[2]);  
   }
 }
 
@@ -388,8 +390,8 @@ void AliNanoAODTrack::SetDCA(Double_t d, Double_t z)
 {
   // set the dca 
 
-  SetVar(AliNanoAODTrackMapping::GetInstance()->GetDCA(), d);
-  SetVar(AliNanoAODTrackMapping::GetInstance()->GetPosDCAz(), z);
+  SetVar(GetVarOffset(kVarDCA), d);
+  SetVar(GetVarOffset(kVarPosDCAz), z);
 }
 
 //______________________________________________________________________________
@@ -421,7 +423,7 @@ Bool_t AliNanoAODTrack::PropagateToDCA(const AliVVertex *vtx,
   // return kFALSE is something went wrong
 
   // allowed only for tracks inside the beam pipe
-  Float_t xstart2 = GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosX())*GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosX())+GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosY())*GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosY());
+  Float_t xstart2 = GetVar(GetVarOffset(kVarPosX))*GetVar(GetVarOffset(kVarPosX))+GetVar(GetVarOffset(kVarPosY))*GetVar(GetVarOffset(kVarPosY));
 
   if(xstart2 > 3.*3.) { // outside beampipe radius
     AliError("This method can be used only for propagation inside the beam pipe");
@@ -472,12 +474,12 @@ Bool_t AliNanoAODTrack::GetXYZAt(Double_t x, Double_t b, Double_t *r) const
   //maybe some of this code can be moved to AliVTrack to avoid code duplication
   const double kSafe = 1e-5;
   Double_t alpha=0.0;
-  Double_t radPos2 = GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosX())*GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosX())+GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosY())*GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosY());
+  Double_t radPos2 = GetVar(GetVarOffset(kVarPosX))*GetVar(GetVarOffset(kVarPosX))+GetVar(GetVarOffset(kVarPosY))*GetVar(GetVarOffset(kVarPosY));
   Double_t radMax  = 45.; // approximately ITS outer radius
   if (radPos2 < radMax*radMax) { // inside the ITS     
     alpha = TMath::ATan2(Py(),Px());
   } else { // outside the ITS
-    Float_t phiPos = TMath::Pi()+TMath::ATan2(-GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosY()), -GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosX()));
+    Float_t phiPos = TMath::Pi()+TMath::ATan2(-GetVar(GetVarOffset(kVarPosY)), -GetVar(GetVarOffset(kVarPosX)));
      alpha = 
      TMath::DegToRad()*(20*((((Int_t)(phiPos*TMath::RadToDeg()))/20))+10);
   }
@@ -496,7 +498,7 @@ Bool_t AliNanoAODTrack::GetXYZAt(Double_t x, Double_t b, Double_t *r) const
   }
   
   // Get the vertex of origin and the momentum
-  TVector3 ver(GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosX()), GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosY()), GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosZ()));
+  TVector3 ver(GetVar(GetVarOffset(kVarPosX)), GetVar(GetVarOffset(kVarPosY)), GetVar(GetVarOffset(kVarPosZ)));
   TVector3 mom(Px(),Py(),Pz());
   //
   // avoid momenta along axis
@@ -571,6 +573,64 @@ Bool_t AliNanoAODTrack::InitPIDIndex()
   return anyFilled;
 }
 
+//_______________________________________________________
+const Int_t* AliNanoAODTrack::ResolveVarOffsets()
+{
+  // Copy the storage indices from the mapping; the mapping is set up once per
+  // process (from the first file or the filtering task) and does not change
+  // afterwards. Call again to pick up a different mapping.
+  AliNanoAODTrackMapping* mapping = AliNanoAODTrackMapping::GetInstance();
+
+  fgVarOffsets[kVarPt]               = mapping->GetPt();
+  fgVarOffsets[kVarPhi]              = mapping->GetPhi();
+  fgVarOffsets[kVarTheta]            = mapping->GetTheta();
+  fgVarOffsets[kVarChi2PerNDF]       = mapping->GetChi2PerNDF();
+  fgVarOffsets[kVarPosX]             = mapping->GetPosX();
+  fgVarOffsets[kVarPosY]             = mapping->GetPosY();
+  fgVarOffsets[kVarPosZ]             = mapping->GetPosZ();
+  fgVarOffsets[kVarPDCAX]            = mapping->GetPDCAX();
+  fgVarOffsets[kVarPDCAY]            = mapping->GetPDCAY();
+  fgVarOffsets[kVarPDCAZ]            = mapping->GetPDCAZ();
+  fgVarOffsets[kVarPosDCAx]          = mapping->GetPosDCAx();
+  fgVarOffsets[kVarPosDCAy]          = mapping->GetPosDCAy();
+  fgVarOffsets[kVarPosDCAz]          = mapping->GetPosDCAz();
+  fgVarOffsets[kVarDCA]              = mapping->GetDCA();
+  fgVarOffsets[kVarRAtAbsorberEnd]   = mapping->GetRAtAbsorberEnd();
+  fgVarOffsets[kVarTPCncls]          = mapping->GetTPCncls();
+  fgVarOffsets[kVarID]               = mapping->GetID();
+  fgVarOffsets[kVarTPCnclsF]         = mapping->GetTPCnclsF();
+  fgVarOffsets[kVarTPCNCrossedRows]  = mapping->GetTPCNCrossedRows();
+  fgVarOffsets[kVarTrackPhiOnEMCal]  = mapping->GetTrackPhiOnEMCal();
+  fgVarOffsets[kVarTrackEtaOnEMCal]  = mapping->GetTrackEtaOnEMCal();
+  fgVarOffsets[kVarTrackPtOnEMCal]   = mapping->GetTrackPtOnEMCal();
+  fgVarOffsets[kVarITSsignal]        = mapping->GetITSsignal();
+  fgVarOffsets[kVarTPCsignal]        = mapping->GetTPCsignal();
+  fgVarOffsets[kVarTPCsignalTuned]   = mapping->GetTPCsignalTuned();
+  fgVarOffsets[kVarTPCsignalN]       = mapping->GetTPCsignalN();
+  fgVarOffsets[kVarTPCmomentum]      = mapping->GetTPCmomentum();
+  fgVarOffsets[kVarTPCTgl]           = mapping->GetTPCTgl();
+  fgVarOffsets[kVarTOFsignal]        = mapping->GetTOFsignal();
+  fgVarOffsets[kVarIntegratedLength] = mapping->GetintegratedLength();
+  fgVarOffsets[kVarTOFsignalTuned]   = mapping->GetTOFsignalTuned();
+  fgVarOffsets[kVarHMPIDsignal]      = mapping->GetHMPIDsignal();
+  fgVarOffsets[kVarHMPIDoccupancy]   = mapping->GetHMPIDoccupancy();
+  fgVarOffsets[kVarTRDsignal]        = mapping->GetTRDsignal();
+  fgVarOffsets[kVarTRDChi2]          = mapping->GetTRDChi2();
+  fgVarOffsets[kVarTRDnSlices]       = mapping->GetTRDnSlices();
+  fgVarOffsets[kVarTRDntrackletsPID] = mapping->GetTRDntrackletsPID();
+  fgVarOffsets[kVarTRDnClusters]     = mapping->GetTRDnClusters();
+  fgVarOffsets[kVarTPCnclsS]         = mapping->GetTPCnclsS();
+  fgVarOffsets[kVarFilterMap]        = mapping->GetFilterMap();
+  fgVarOffsets[kVarTOFBunchCrossing] = mapping->GetTOFBunchCrossing();
+  fgVarOffsets[kVarTOFchi2]          = mapping->GetTOFchi2();
+  fgVarOffsets[kVarTOFsignalDz]      = mapping->GetTOFsignalDz();
+  fgVarOffsets[kVarTOFsignalDx]      = mapping->GetTOFsignalDx();
+  fgVarOffsets[kVarStatus]           = mapping->GetStatus();
+
+  fgVarOffsetsResolved = kTRUE;
+  return fgVarOffsets;
+}
+
 //_______________________________________________________
 void  AliNanoAODTrack::GetImpactParameters(Float_t &xy,Float_t &z) const {
   xy = DCA();
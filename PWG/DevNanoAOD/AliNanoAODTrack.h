@@ -62,6 +62,56 @@ public:
     kIsDCA
   };
   
+  /// Standard variables, see AliNanoAODTrackMapping
+  enum ENanoVar {
+    kVarPt = 0,
+    kVarPhi,
+    kVarTheta,
+    kVarChi2PerNDF,
+    kVarPosX,
+    kVarPosY,
+    kVarPosZ,
+    kVarPDCAX,
+    kVarPDCAY,
+    kVarPDCAZ,
+    kVarPosDCAx,
+    kVarPosDCAy,
+    kVarPosDCAz,
+    kVarDCA,
+    kVarRAtAbsorberEnd,
+    kVarTPCncls,
+    kVarID,
+    kVarTPCnclsF,
+    kVarTPCNCrossedRows,
+    kVarTrackPhiOnEMCal,
+    kVarTrackEtaOnEMCal,
+    kVarTrackPtOnEMCal,
+    kVarITSsignal,
+    kVarTPCsignal,
+    kVarTPCsignalTuned,
+    kVarTPCsignalN,
+    kVarTPCmomentum,
+    kVarTPCTgl,
+    kVarTOFsignal,
+    kVarIntegratedLength,
+    kVarTOFsignalTuned,
+    kVarHMPIDsignal,
+    kVarHMPIDoccupancy,
+    kVarTRDsignal,
+    kVarTRDChi2,
+    kVarTRDnSlices,
+    kVarTRDntrackletsPID,
+    kVarTRDnClusters,
+    kVarTPCnclsS,
+    kVarFilterMap,
+    kVarTOFBunchCrossing,
+    kVarTOFchi2,
+    kVarTOFsignalDz,
+    kVarTOFsignalDx,
+    kVarStatus,
+    kNVars
+  };
+  
   UInt_t GetNanoFlags() const { return fNanoFlags; }
   virtual Short_t  Charge() const { return TESTBIT(fNanoFlags, kNanoCharge) ? 1 : -1; }
   Bool_t HasTOFPID() { return TESTBIT(fNanoFlags, kNanoHasTOFPID); }
@@ -83,13 +133,13 @@ public:
   
   // kinematics
   virtual Double_t OneOverPt() const { return (Pt() != 0.) ? 1./Pt() : -999.; }
-  virtual Double_t Phi()       const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetPhi());   }
-  virtual Double_t Theta()     const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTheta()); }
+  virtual Double_t Phi()       const { return GetVar(GetVarOffset(kVarPhi));   }
+  virtual Double_t Theta()     const { return GetVar(GetVarOffset(kVarTheta)); }
   
   virtual Double_t Px() const { return Pt() * TMath::Cos(Phi()); }
   virtual Double_t Py() const { return Pt() * TMath::Sin(Phi()); }
   virtual Double_t Pz() const { return Pt() / TMath::Tan(Theta()); }
-  virtual Double_t Pt() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetPt()); }
+  virtual Double_t Pt() const { return GetVar(GetVarOffset(kVarPt)); }
   virtual Double_t P()  const { return TMath::Sqrt(Pt()*Pt()+Pz()*Pz()); }
   virtual Bool_t   PxPyPz(Double_t p[3]) const { p[0] = Px(); p[1] = Py(); p[2] = Pz(); return kTRUE; }
 
@@ -98,8 +148,8 @@ public:
   virtual Double_t Zv() const { return GetProdVertex() ? GetProdVertex()->GetZ() : -999.; }
   virtual Bool_t   XvYvZv(Double_t x[3]) const { x[0] = Xv(); x[1] = Yv(); x[2] = Zv(); return kTRUE; }
 
-  Double_t Chi2perNDF()  const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetChi2PerNDF()); }  
-  virtual UShort_t GetTPCncls(Int_t /*row0*/=0, Int_t /*row1*/=159)  const { return GetVarInt(AliNanoAODTrackMapping::GetInstance()->GetTPCncls()); }
+  Double_t Chi2perNDF()  const { return GetVar(GetVarOffset(kVarChi2PerNDF)); }  
+  virtual UShort_t GetTPCncls(Int_t /*row0*/=0, Int_t /*row1*/=159)  const { return GetVarInt(GetVarOffset(kVarTPCncls)); }
   virtual UShort_t GetTPCNcls()  const { return GetTPCncls(); }
 
   virtual Double_t M() const { AliFatal("Not Implemented"); return -1; }
@@ -118,10 +168,10 @@ public:
 
 
   // Bool_t IsOn(Int_t mask) const {return (fFlags&mask)>0;}
-  ULong64_t GetStatus() const { return (ULong64_t(GetVarInt(AliNanoAODTrackMapping::GetInstance()->GetStatus())) << 32) + GetVarInt(AliNanoAODTrackMapping::GetInstance()->GetStatus()+1); }
+  ULong64_t GetStatus() const { return (ULong64_t(GetVarInt(GetVarOffset(kVarStatus))) << 32) + GetVarInt(GetVarOffset(kVarStatus)+1); }
   // ULong_t GetFlags() const { return fFlags; }
 
-  Int_t   GetID() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetID()); }
+  Int_t   GetID() const { return GetVar(GetVarOffset(kVarID)); }
   Int_t   GetLabel() const { return fLabel; }  // 
   // void    GetTOFLabel(Int_t *p) const;
 
@@ -147,7 +197,7 @@ public:
 
   
   template <typename T> Bool_t GetPosition(T *x) const {
-    x[0]=GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosX()); x[1]=GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosY()); x[2]=GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosZ());
+    x[0]=GetVar(GetVarOffset(kVarPosX)); x[1]=GetVar(GetVarOffset(kVarPosY)); x[2]=GetVar(GetVarOffset(kVarPosZ));
     return TESTBIT(fNanoFlags, ENanoFlags::kIsDCA);}
 
   // FIXME: only allocate if listed?
@@ -172,21 +222,21 @@ public:
 
   Bool_t IsMuonTrack() const { return TESTBIT(fNanoFlags, kIsMuonTrack); }
 
-  Double_t XAtDCA() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosDCAx()); }
-  Double_t YAtDCA() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosDCAy()); }
-  Double_t ZAtDCA() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetPosDCAz()); }
+  Double_t XAtDCA() const { return GetVar(GetVarOffset(kVarPosDCAx)); }
+  Double_t YAtDCA() const { return GetVar(GetVarOffset(kVarPosDCAy)); }
+  Double_t ZAtDCA() const { return GetVar(GetVarOffset(kVarPosDCAz)); }
 
   Bool_t   XYZAtDCA(Double_t x[3]) const { x[0] = XAtDCA(); x[1] = YAtDCA(); x[2] = ZAtDCA(); return kTRUE; }
   
-  Double_t DCA() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetDCA()); }
+  Double_t DCA() const { return GetVar(GetVarOffset(kVarDCA)); }
   
-  Double_t PxAtDCA() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetPDCAX()); }
-  Double_t PyAtDCA() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetPDCAY()); }
-  Double_t PzAtDCA() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetPDCAZ()); }
+  Double_t PxAtDCA() const { return GetVar(GetVarOffset(kVarPDCAX)); }
+  Double_t PyAtDCA() const { return GetVar(GetVarOffset(kVarPDCAY)); }
+  Double_t PzAtDCA() const { return GetVar(GetVarOffset(kVarPDCAZ)); }
   Double_t PAtDCA() const { return TMath::Sqrt(PxAtDCA()*PxAtDCA() + PyAtDCA()*PyAtDCA() + PzAtDCA()*PzAtDCA()); }
   Bool_t   PxPyPzAtDCA(Double_t p[3]) const { p[0] = PxAtDCA(); p[1] = PyAtDCA(); p[2] = PzAtDCA(); return kTRUE; }
   
-  Double_t GetRAtAbsorberEnd() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetRAtAbsorberEnd()); }
+  Double_t GetRAtAbsorberEnd() const { return GetVar(GetVarOffset(kVarRAtAbsorberEnd)); }
   
   // For this whole block of cluster maps I could simply define a cluster map in the int array. For the moment comment all maps. Maybe not neede 
   UChar_t  GetITSClusterMap() const       { AliFatal("Not Implemented. Use HasPointOnITSLayer!"); return 0;};
@@ -198,7 +248,7 @@ public:
    Bool_t  TestFilterBit(UInt_t filterBit) const {return (Bool_t) ((filterBit & GetFilterMap()) != 0);}
   // Bool_t  TestFilterMask(UInt_t filterMask) const {return (Bool_t) ((filterMask & fFilterMap) == filterMask);}
   // void    SetFilterMap(UInt_t i){fFilterMap = i;}
-   UInt_t  GetFilterMap() const {return GetVarInt(AliNanoAODTrackMapping::GetInstance()->GetFilterMap());}
+   UInt_t  GetFilterMap() const {return GetVarInt(GetVarOffset(kVarFilterMap));}
 
   // const TBits& GetTPCClusterMap() const {return fTPCClusterMap;}
   // const TBits* GetTPCClusterMapPtr() const {return &fTPCClusterMap;}
@@ -213,12 +263,12 @@ public:
   // void    SetTPCSharedMap(const TBits amap) {fTPCSharedMap = amap;}
   // void    SetTPCFitMap(const TBits amap) {fTPCFitMap = amap;}
   // 
-  void    SetTPCPointsF(UShort_t  findable){fVars[AliNanoAODTrackMapping::GetInstance()->GetTPCnclsF()] = findable;}
-  void    SetTPCNCrossedRows(UInt_t n)     {fVars[AliNanoAODTrackMapping::GetInstance()->GetTPCNCrossedRows()] = n;}
+  void    SetTPCPointsF(UShort_t  findable){fVars[GetVarOffset(kVarTPCnclsF)] = findable;}
+  void    SetTPCNCrossedRows(UInt_t n)     {fVars[GetVarOffset(kVarTPCNCrossedRows)] = n;}
 
-  UShort_t GetTPCNclsF() const { return GetVarInt(AliNanoAODTrackMapping::GetInstance()->GetTPCnclsF());}  
-  UShort_t GetTPCnclsS() const { return GetVarInt(AliNanoAODTrackMapping::GetInstance()->GetTPCnclsS());}  
-  UShort_t GetTPCNCrossedRows()  const { return GetVarInt(AliNanoAODTrackMapping::GetInstance()->GetTPCNCrossedRows());}  
+  UShort_t GetTPCNclsF() const { return GetVarInt(GetVarOffset(kVarTPCnclsF));}  
+  UShort_t GetTPCnclsS() const { return GetVarInt(GetVarOffset(kVarTPCnclsS));}  
+  UShort_t GetTPCNCrossedRows()  const { return GetVarInt(GetVarOffset(kVarTPCNCrossedRows));}  
   Float_t  GetTPCFoundFraction() const { return GetTPCNCrossedRows()>0 ? float(GetTPCNcls())/GetTPCNCrossedRows() : 0;}
 
   // Calorimeter Cluster
@@ -227,11 +277,11 @@ public:
   // void SetEMCALcluster(Int_t index) {fCaloIndex=index;}
   // Bool_t IsEMCAL() const {return fFlags&kEMCALmatch;}
 
-  Double_t GetTrackPhiOnEMCal() const {return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTrackPhiOnEMCal());}
-  Double_t GetTrackEtaOnEMCal() const {return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTrackEtaOnEMCal());}
-  Double_t GetTrackPtOnEMCal() const  {return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTrackPtOnEMCal());}
+  Double_t GetTrackPhiOnEMCal() const {return GetVar(GetVarOffset(kVarTrackPhiOnEMCal));}
+  Double_t GetTrackEtaOnEMCal() const {return GetVar(GetVarOffset(kVarTrackEtaOnEMCal));}
+  Double_t GetTrackPtOnEMCal() const  {return GetVar(GetVarOffset(kVarTrackPtOnEMCal));}
   Double_t GetTrackPOnEMCal() const {return TMath::Abs(GetTrackEtaOnEMCal()) < 1 ? GetTrackPtOnEMCal()*TMath::CosH(GetTrackEtaOnEMCal()) : -999;}
-  void SetTrackPhiEtaPtOnEMCal(Double_t phi,Double_t eta,Double_t pt) {fVars[AliNanoAODTrackMapping::GetInstance()->GetTrackPhiOnEMCal()]=phi;fVars[AliNanoAODTrackMapping::GetInstance()->GetTrackEtaOnEMCal()]=eta;fVars[AliNanoAODTrackMapping::GetInstance()->GetTrackPtOnEMCal()]=pt;}
+  void SetTrackPhiEtaPtOnEMCal(Double_t phi,Double_t eta,Double_t pt) {fVars[GetVarOffset(kVarTrackPhiOnEMCal)]=phi;fVars[GetVarOffset(kVarTrackEtaOnEMCal)]=eta;fVars[GetVarOffset(kVarTrackPtOnEMCal)]=pt;}
 
   //  Int_t GetPHOScluster() const {return fCaloIndex;} // TODO: int array
   //  void SetPHOScluster(Int_t index) {fCaloIndex=index;}
@@ -239,21 +289,21 @@ public:
 
   //pid signal interface
   //TODO you can remove the PID object
-  Double_t  GetITSsignal()       const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetITSsignal());}
-  Double_t  GetTPCsignal()       const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTPCsignal());}
-  Double_t  GetTPCsignalTunedOnData() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTPCsignalTuned());}
-  void      SetTPCsignalTunedOnData(Double_t signal) {fVars[AliNanoAODTrackMapping::GetInstance()->GetTPCsignalTuned()] = signal;}
-  UShort_t  GetTPCsignalN()      const { return GetVarInt(AliNanoAODTrackMapping::GetInstance()->GetTPCsignalN());}// FIXME: what is this? 
+  Double_t  GetITSsignal()       const { return GetVar(GetVarOffset(kVarITSsignal));}
+  Double_t  GetTPCsignal()       const { return GetVar(GetVarOffset(kVarTPCsignal));}
+  Double_t  GetTPCsignalTunedOnData() const { return GetVar(GetVarOffset(kVarTPCsignalTuned));}
+  void      SetTPCsignalTunedOnData(Double_t signal) {fVars[GetVarOffset(kVarTPCsignalTuned)] = signal;}
+  UShort_t  GetTPCsignalN()      const { return GetVarInt(GetVarOffset(kVarTPCsignalN));}// FIXME: what is this? 
   //  virtual AliTPCdEdxInfo* GetTPCdEdxInfo() const {return fDetPid?fDetPid->GetTPCdEdxInfo():0;} // FIXME: is this needed?
-  Double_t  GetTPCmomentum()     const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTPCmomentum()); }
-  Double_t  GetTPCTgl()          const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTPCTgl());      } // FIXME: what is this?
-  Double_t  GetTOFsignal()       const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTOFsignal());   } 
-  Double_t  GetIntegratedLength() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetintegratedLength()); } 
+  Double_t  GetTPCmomentum()     const { return GetVar(GetVarOffset(kVarTPCmomentum)); }
+  Double_t  GetTPCTgl()          const { return GetVar(GetVarOffset(kVarTPCTgl));      } // FIXME: what is this?
+  Double_t  GetTOFsignal()       const { return GetVar(GetVarOffset(kVarTOFsignal));   } 
+  Double_t  GetIntegratedLength() const { return GetVar(GetVarOffset(kVarIntegratedLength)); } 
   void      SetIntegratedLength(Double_t/* l*/) {AliFatal("Not implemented");}
-  Double_t  GetTOFsignalTunedOnData() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTOFsignalTuned());}
-  void      SetTOFsignalTunedOnData(Double_t signal) {fVars[AliNanoAODTrackMapping::GetInstance()->GetTOFsignalTuned()] = signal;}
-  Double_t  GetHMPIDsignal()      const {return GetVar(AliNanoAODTrackMapping::GetInstance()->GetHMPIDsignal());}; 
-  Double_t  GetHMPIDoccupancy()  const {return GetVar(AliNanoAODTrackMapping::GetInstance()->GetHMPIDoccupancy());}; 
+  Double_t  GetTOFsignalTunedOnData() const { return GetVar(GetVarOffset(kVarTOFsignalTuned));}
+  void      SetTOFsignalTunedOnData(Double_t signal) {fVars[GetVarOffset(kVarTOFsignalTuned)] = signal;}
+  Double_t  GetHMPIDsignal()      const {return GetVar(GetVarOffset(kVarHMPIDsignal));}; 
+  Double_t  GetHMPIDoccupancy()  const {return GetVar(GetVarOffset(kVarHMPIDoccupancy));}; 
   
       
   
@@ -267,16 +317,16 @@ public:
   //  Bool_t GetOuterHmpPxPyPz(Double_t *p) const;
   //  Int_t     GetHMPIDcluIdx()     const;// FIXME: array of ints?
   //   void      GetITSdEdxSamples(Double_t s[4]) const; // FIXME: To be reimplemented. Use one kin var for each sample
-  Int_t   GetTOFBunchCrossing (Double_t /*b=0*/, Bool_t /*tpcPIDonly=kFALSE*/) const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTOFBunchCrossing()); }  
+  Int_t   GetTOFBunchCrossing (Double_t /*b=0*/, Bool_t /*tpcPIDonly=kFALSE*/) const { return GetVar(GetVarOffset(kVarTOFBunchCrossing)); }  
   UChar_t   GetTRDncls(Int_t /*layer*/)                           const {AliFatal("Not Implemented"); return 0;}; 
   Double_t  GetTRDslice(Int_t /*plane*/, Int_t /*slice*/)         const {AliFatal("Not Implemented"); return 0;};
   Double_t  GetTRDmomentum(Int_t /*plane*/, Double_t */*sp*/=0x0) const {AliFatal("Not Implemented"); return 0;};
   // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
 
-  Double_t  GetTRDsignal()         const {return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTRDsignal());}
-  Double_t  GetTRDchi2()           const {return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTRDChi2());}
+  Double_t  GetTRDsignal()         const {return GetVar(GetVarOffset(kVarTRDsignal));}
+  Double_t  GetTRDchi2()           const {return GetVar(GetVarOffset(kVarTRDChi2));}
   UChar_t   GetTRDncls()           const {return GetTRDncls(-1);}
-  Int_t     GetNumberOfTRDslices() const { return GetVar(AliNanoAODTrackMapping::GetInstance()->GetTRDnSlices()); }  
+  Int_t     GetNumberOfTRDslices() const { return GetVar(GetVarOffset(kVarTRDnSlices)); }  
 
   const AliAODEvent* GetAODEvent() const {return fAODEvent;}// FIXME: change to special event type
   void SetAODEvent(const AliAODEvent* ptr){fAODEvent = ptr;}
@@ -309,18 +359,18 @@ public:
 
 
 
-  void SetOneOverPt(Double_t oneOverPt) { fVars[AliNanoAODTrackMapping::GetInstance()->GetPt()] = 1. / oneOverPt; }
-  void SetPt(Double_t pt) { fVars[AliNanoAODTrackMapping::GetInstance()->GetPt()] = pt; };
-  void SetPhi(Double_t phi) { fVars[AliNanoAODTrackMapping::GetInstance()->GetPhi()] = phi; }
-  void SetTheta(Double_t theta) { fVars[AliNanoAODTrackMapping::GetInstance()->GetTheta()] = theta; }
+  void SetOneOverPt(Double_t oneOverPt) { fVars[GetVarOffset(kVarPt)] = 1. / oneOverPt; }
+  void SetPt(Double_t pt) { fVars[GetVarOffset(kVarPt)] = pt; };
+  void SetPhi(Double_t phi) { fVars[GetVarOffset(kVarPhi)] = phi; }
+  void SetTheta(Double_t theta) { fVars[GetVarOffset(kVarTheta)] = theta; }
   template <typename T> void SetP(const T *p, Bool_t cartesian = kTRUE);// TODO: WHAT IS THIS FOR?
   void SetP() {AliFatal("Not Implemented");}
 
-  void SetXYAtDCA(Double_t x, Double_t y) {fVars[AliNanoAODTrackMapping::GetInstance()->GetPosDCAx()] = x;  fVars[AliNanoAODTrackMapping::GetInstance()->GetPosDCAy()]= y;}
-  void SetPxPyPzAtDCA(Double_t pX, Double_t pY, Double_t pZ) {fVars[AliNanoAODTrackMapping::GetInstance()->GetPDCAX()] = pX; fVars[AliNanoAODTrackMapping::GetInstance()->GetPDCAY()] = pY; fVars[AliNanoAODTrackMapping::GetInstance()->GetPDCAZ()] = pZ;}
+  void SetXYAtDCA(Double_t x, Double_t y) {fVars[GetVarOffset(kVarPosDCAx)] = x;  fVars[GetVarOffset(kVarPosDCAy)]= y;}
+  void SetPxPyPzAtDCA(Double_t pX, Double_t pY, Double_t pZ) {fVars[GetVarOffset(kVarPDCAX)] = pX; fVars[GetVarOffset(kVarPDCAY)] = pY; fVars[GetVarOffset(kVarPDCAZ)] = pZ;}
   
-  void SetRAtAbsorberEnd(Double_t r) { fVars[AliNanoAODTrackMapping::GetInstance()->GetRAtAbsorberEnd()] = r; }
-  void SetChi2perNDF(Double_t chi2perNDF) { fVars[AliNanoAODTrackMapping::GetInstance()->GetChi2PerNDF()] = chi2perNDF; }
+  void SetRAtAbsorberEnd(Double_t r) { fVars[GetVarOffset(kVarRAtAbsorberEnd)] = r; }
+  void SetChi2perNDF(Double_t chi2perNDF) { fVars[GetVarOffset(kVarChi2PerNDF)] = chi2perNDF; }
 
   // void SetITSClusterMap(UChar_t itsClusMap)                 { fITSMuonClusterMap = (fITSMuonClusterMap&0xffffff00)|(((UInt_t)itsClusMap)&0xff); }
   // void SetHitsPatternInTrigCh(UShort_t hitsPatternInTrigCh) { fITSMuonClusterMap = (fITSMuonClusterMap&0xffff00ff)|((((UInt_t)hitsPatternInTrigCh)&0xff)<<8); }
@@ -345,7 +395,7 @@ public:
   virtual const AliDetectorPID* GetDetectorPID() const { return fDetectorPID; }
 
   //  needed  to inherit from VTrack, but not implemented
-  virtual UChar_t  GetTRDntrackletsPID() const  { return GetVarInt(AliNanoAODTrackMapping::GetInstance()->GetTRDntrackletsPID()); }; 
+  virtual UChar_t  GetTRDntrackletsPID() const  { return GetVarInt(GetVarOffset(kVarTRDntrackletsPID)); }; 
   virtual void      GetHMPIDpid(Double_t */*p*/) const  {AliFatal("Not Implemented"); return;}; 
   virtual Double_t GetBz() const  {AliFatal("Not Implemented"); return 0;}; 
   virtual void     GetBxByBz(Double_t [3]/*b[3]*/) const  {AliFatal("Not Implemented"); return;}; 
@@ -356,6 +406,11 @@ public:
 
   virtual void GetImpactParameters(Float_t &xy,Float_t &z) const;  
 
+  // Storage index of the standard variables (-1 if not in the file), resolved from
+  // AliNanoAODTrackMapping once rather than at each access
+  static Int_t GetVarOffset(ENanoVar var) { return fgVarOffsetsResolved ? fgVarOffsets[var] : ResolveVarOffsets()[var]; }
+  static const Int_t* ResolveVarOffsets();
+
   // PID access functions
   static Int_t GetPIDIndex(ENanoPIDResponse r, AliPID::EParticleType p)  { return fgPIDIndexes[r][p]; }
   static const char* GetPIDVarName(ENanoPIDResponse r, AliPID::EParticleType p) {  return Form("PID.%d.%s", r, AliPID::ParticleShortName(p)); }
@@ -380,6 +435,8 @@ private :
   mutable const AliDetectorPID* fDetectorPID; //!<! transient object to cache calibrated PID information
 
   static Int_t fgPIDIndexes[ENanoPIDResponse::kLAST][AliPID::kSPECIESC];
+  static Int_t fgVarOffsets[kNVars];      // storage index of the standard variables
+  static Bool_t fgVarOffsetsResolved;     // fgVarOffsets filled from the mapping
   
   const AliAODEvent* fAODEvent;     //! 
 
@@ -417,22 +474,22 @@ void AliNanoAODTrack::SetPosition(const T *x, const Bool_t dca)
     if (!dca) {
       fNanoFlags &= ~ENanoFlags::kIsDCA;
 
-      fVars[AliNanoAODTrackMapping::GetInstance()->GetPosX()] = x[0];
-      fVars[AliNanoAODTrackMapping::GetInstance()->GetPosY()] = x[1];
-      fVars[AliNanoAODTrackMapping::GetInstance()->GetPosZ()] = x[2];
+      fVars[GetVarOffset(kVarPosX)] = x[0];
+      fVars[GetVarOffset(kVarPosY)] = x[1];
+      fVars[GetVarOffset(kVarPosZ)] = x[2];
     } else {
       fNanoFlags |= ENanoFlags::kIsDCA;
       // don't know any better yet
-      fVars[AliNanoAODTrackMapping::GetInstance()->GetPosX()] = -999.;
-      fVars[AliNanoAODTrackMapping::GetInstance()->GetPosY()] = -999.;
-      fVars[AliNanoAODTrackMapping::GetInstance()->GetPosZ()] = -999.;
+      fVars[GetVarOffset(kVarPosX)] = -999.;
+      fVars[GetVarOffset(kVarPosY)] = -999.;
+      fVars[GetVarOffset(kVarPosZ)] = -999.;
     }
   } else {
     fNanoFlags &= ~ENanoFlags::kIsDCA;
 
-    fVars[AliNanoAODTrackMapping::GetInstance()->GetPosX()] = -999.;
-    fVars[AliNanoAODTrackMapping::GetInstance()->GetPosY()] = -999.;
-    fVars[AliNanoAODTrackMapping::GetInstance()->GetPosZ()] = -999.;
+    fVars[GetVarOffset(kVarPosX)] = -999.;
+    fVars[GetVarOffset(kVarPosY)] = -999.;
+    fVars[GetVarOffset(kVarPosZ)] = -999.;
   }
 }
 
@@ -0,0 +1,156 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+#include "TMath.h"
+#include "TObjArray.h"
+#include "TObjString.h"
+
+#include "AliLog.h"
+#include "AliVEvent.h"
+
+#include "AliNanoAODTrack.h"
+#include "AliNanoAODTrackMapping.h"
+#include "AliNanoAODTrackColumns.h"
+
+ClassImp(AliNanoAODTrackColumns)
+
+//______________________________________________________________________________
+AliNanoAODTrackColumns::AliNanoAODTrackColumns(const char* vars) :
+  fNames(),
+  fTypes(),
+  fIndices(),
+  fColumns(),
+  fResolved(kFALSE),
+  fNTracks(0)
+{
+  // ctor, vars is a comma separated list of variables
+
+  TObjArray* tokens = TString(vars).Tokenize(",");
+  for (Int_t i = 0; i < tokens->GetEntriesFast(); i++)
+    AddColumn(((TObjString*) tokens->UncheckedAt(i))->GetString().Strip(TString::kBoth, ' '));
+  delete tokens;
+}
+
+//______________________________________________________________________________
+Int_t AliNanoAODTrackColumns::AddColumn(const char* var)
+{
+  // Book a variable, returns its column
+
+  Int_t column = FindColumn(var);
+  if (column >= 0)
+    return column;
+
+  TString name(var);
+  Int_t type = kDouble;
+  if (name == "eta")
+    type = kEta;
+  else if (name == "charge")
+    type = kCharge;
+  else if (name == "TPCncls" || name == "TPCnclsF" || name == "TPCNCrossedRows" || name == "TPCsignalN" ||
+           name == "TRDntrackletsPID" || name == "TRDnClusters" || name == "TPCnclsS" || name == "FilterMap")
+    type = kInt;
+  else if (name == "Status")
+    AliFatalGeneral("AliNanoAODTrackColumns", "Status is 64 bit, use AliNanoAODTrack::GetStatus()");
+
+  fNames.push_back(name);
+  fTypes.push_back(type);
+  fIndices.push_back(-1);
+  fColumns.push_back(std::vector<Double_t>());
+  fResolved = kFALSE;
+  return fNames.size() - 1;
+}
+
+//______________________________________________________________________________
+Int_t AliNanoAODTrackColumns::FindColumn(const char* var) const
+{
+  for (UInt_t i = 0; i < fNames.size(); i++)
+    if (fNames[i] == var)
+      return i;
+  return -1;
+}
+
+//______________________________________________________________________________
+const Double_t* AliNanoAODTrackColumns::GetColumn(const char* var) const
+{
+  Int_t column = FindColumn(var);
+  if (column < 0) {
+    AliErrorGeneral("AliNanoAODTrackColumns", Form("Variable %s not booked", var));
+    return 0;
+  }
+  return GetColumn(column);
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::Fill(const AliVEvent* event)
+{
+  // Copy the booked variables of all tracks of the event
+
+  // only the variable list is streamed, the arrays are rebuilt after reading
+  if (fColumns.size() != fNames.size()) {
+    fIndices.assign(fNames.size(), -1);
+    fColumns.resize(fNames.size());
+    fResolved = kFALSE;
+  }
+
+  fNTracks = event->GetNumberOfTracks();
+  if (fNTracks == 0) {
+    for (UInt_t i = 0; i < fColumns.size(); i++)
+      fColumns[i].clear();
+    return;
+  }
+
+  if (!dynamic_cast<const AliNanoAODTrack*>(event->GetTrack(0)))
+    AliFatalGeneral("AliNanoAODTrackColumns", "The event does not contain NanoAOD tracks");
+
+  // the mapping is known once the first NanoAOD track is there
+  if (!fResolved) {
+    for (UInt_t i = 0; i < fNames.size(); i++) {
+      if (fTypes[i] == kEta)
+        fIndices[i] = AliNanoAODTrack::GetVarOffset(AliNanoAODTrack::kVarTheta);
+      else if (fTypes[i] != kCharge)
+        fIndices[i] = AliNanoAODTrackMapping::GetInstance()->GetVarIndex(fNames[i]);
+    }
+    fResolved = kTRUE;
+  }
+
+  std::vector<const AliNanoAODTrack*> tracks(fNTracks);
+  for (Int_t iTrack = 0; iTrack < fNTracks; iTrack++)
+    tracks[iTrack] = static_cast<const AliNanoAODTrack*>(event->GetTrack(iTrack));
+
+  // one variable at a time; GetVar and GetVarInt report variables missing in the file
+  for (UInt_t i = 0; i < fNames.size(); i++) {
+    std::vector<Double_t>& column = fColumns[i];
+    column.resize(fNTracks);
+    const Int_t index = fIndices[i];
+    switch (fTypes[i]) {
+      case kDouble:
+        for (Int_t iTrack = 0; iTrack < fNTracks; iTrack++)
+          column[iTrack] = tracks[iTrack]->GetVar(index);
+        break;
+      case kInt:
+        for (Int_t iTrack = 0; iTrack < fNTracks; iTrack++)
+          column[iTrack] = tracks[iTrack]->GetVarInt(index);
+        break;
+      case kEta:
+        for (Int_t iTrack = 0; iTrack < fNTracks; iTrack++)
+          column[iTrack] = -TMath::Log(TMath::Tan(0.5 * tracks[iTrack]->GetVar(index)));
+        break;
+      case kCharge:
+        for (Int_t iTrack = 0; iTrack < fNTracks; iTrack++)
+          column[iTrack] = tracks[iTrack]->Charge();
+        break;
+    }
+  }
+}
@@ -0,0 +1,67 @@
+#ifndef ALINANOAODTRACKCOLUMNS_H
+#define ALINANOAODTRACKCOLUMNS_H
+
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+//-------------------------------------------------------------------------
+//     Columnar view of the NanoAOD tracks of an event
+//
+//     The requested variables of all tracks are copied into contiguous
+//     arrays, one per variable, for consumers which loop over one
+//     variable at a time (vectorised cuts, histogram filling in bulk).
+//     Variables are given by their NanoAOD name (as in the filter
+//     variable list, including custom "cst..." variables) plus
+//       "eta"    computed from theta
+//       "charge" from the nano flags
+//     A variable which is not in the file gives the same error as the
+//     corresponding AliNanoAODTrack getter as soon as it is filled.
+//
+//     Usage:
+//       AliNanoAODTrackColumns columns("pt,eta,phi,FilterMap");  // in the task
+//       columns.Fill(InputEvent());                             // in UserExec
+//       const Double_t* pt = columns.GetPt();
+//       for (Int_t i = 0; i < columns.GetNTracks(); i++) ... pt[i] ...
+//-------------------------------------------------------------------------
+
+#include <vector>
+
+#include "Rtypes.h"
+#include "TString.h"
+
+class AliVEvent;
+
+class AliNanoAODTrackColumns
+{
+ public:
+  AliNanoAODTrackColumns(const char* vars = "pt,eta,phi");
+  virtual ~AliNanoAODTrackColumns() {}
+
+  Int_t AddColumn(const char* var);
+  void  Fill(const AliVEvent* event);
+
+  Int_t GetNTracks()  const { return fNTracks; }
+  Int_t GetNColumns() const { return fNames.size(); }
+  Int_t FindColumn(const char* var) const;
+  const Double_t* GetColumn(Int_t column) const { return fColumns[column].data(); }
+  const Double_t* GetColumn(const char* var) const;
+
+  const Double_t* GetPt()     const { return GetColumn("pt");     }
+  const Double_t* GetEta()    const { return GetColumn("eta");    }
+  const Double_t* GetPhi()    const { return GetColumn("phi");    }
+  const Double_t* GetCharge() const { return GetColumn("charge"); }
+
+ private:
+  enum EColumnType { kDouble, kInt, kEta, kCharge };
+
+  std::vector<TString> fNames;                  ///< variable names
+  std::vector<Int_t> fTypes;                    ///< how the column is filled (EColumnType)
+  std::vector<Int_t> fIndices;                  //!<! storage index in the track, resolved at the first fill
+  std::vector<std::vector<Double_t> > fColumns; //!<! one array per variable
+  Bool_t fResolved;                             //!<! storage indices resolved
+  Int_t fNTracks;                               //!<! number of tracks of the last event
+
+  ClassDef(AliNanoAODTrackColumns, 1); // Columnar view of the NanoAOD tracks
+};
+
+#endif
@@ -2,9 +2,9 @@
 //
 
 #include <TObjArray.h>
-#include <TFile.h>
 #include "AliEMCALGeometry.h"
 #include "AliOADBContainer.h"
+#include "AliOADBCache.h"
 #include "AliEMCALRecoUtils.h"
 #include "AliAODEvent.h"
 #include "AliDataFile.h"
@@ -143,68 +143,52 @@ Int_t AliEmcalCorrectionCellEnergy::InitRecalib()
   
   Int_t runRC = fEventManager.InputEvent()->GetRunNumber();
   
-  std::unique_ptr<AliOADBContainer> contRF;
-  std::unique_ptr<TFile> recalibFile;
+  // the recalibration containers are shared by all components of the process
+  TString recalibFileName;
   if (fBasePath!="")
   { //if fBasePath specified
     AliInfo(Form("Loading Recalib OADB from given path %s",fBasePath.Data()));
-
-    recalibFile = std::unique_ptr<TFile>(TFile::Open(Form("%s/EMCALRecalib.root",fBasePath.Data()),"read"));
-    if (!recalibFile || recalibFile->IsZombie())
-    {
-      AliFatal(Form("EMCALRecalib.root not found in %s",fBasePath.Data()));
-      return 0;
-    }
-    
-    contRF = std::unique_ptr<AliOADBContainer>(static_cast<AliOADBContainer *>(recalibFile->Get("AliEMCALRecalib")));
+    recalibFileName = Form("%s/EMCALRecalib.root",fBasePath.Data());
   }
   else if (fCustomRecalibFilePath!="")
   { //if custom recalib requested
     AliInfo(Form("Loading custom Recalib OADB from given path %s",fCustomRecalibFilePath.Data()));
-        
-    recalibFile = std::unique_ptr<TFile>(TFile::Open(Form("%s",fCustomRecalibFilePath.Data()),"read"));
-    if (!recalibFile || recalibFile->IsZombie())
-    {
-      AliFatal(Form("Recalibration file not found. Provided path was: %s",fCustomRecalibFilePath.Data()));
-      return 0;
-    }
-    
-    contRF = std::unique_ptr<AliOADBContainer>(static_cast<AliOADBContainer *>(recalibFile->Get("AliEMCALRecalib")));
+    recalibFileName = fCustomRecalibFilePath;
   }
   else
   { // Else choose the one in the $ALICE_PHYSICS directory
     AliInfo("Loading Recalib OADB from OADB/EMCAL");
-    
-    recalibFile = std::unique_ptr<TFile>(TFile::Open(AliDataFile::GetFileNameOADB("EMCAL/EMCALRecalib.root").data(),"read"));
-    if (!recalibFile || recalibFile->IsZombie())
-    {
-      AliFatal("OADB/EMCAL/EMCALRecalib.root was not found");
-      return 0;
-    }
-    
-    contRF = std::unique_ptr<AliOADBContainer>(static_cast<AliOADBContainer *>(recalibFile->Get("AliEMCALRecalib")));
+    recalibFileName = AliDataFile::GetFileNameOADB("EMCAL/EMCALRecalib.root").data();
   }
+
+  if (!AliOADBCache::Instance().HasFile(recalibFileName))
+  {
+    AliFatal(Form("Recalibration file %s not found",recalibFileName.Data()));
+    return 0;
+  }
+
+  AliOADBCache::ContainerHandle contRF = AliOADBCache::Instance().GetContainer(recalibFileName, "AliEMCALRecalib");
   if(!contRF) {
     AliError("No OADB container found");
     return 0;
   }
-  contRF->SetOwner(true);
-  
-  TObjArray *recal=(TObjArray*)contRF->GetObject(runRC);
+
+  AliOADBCache::ObjectHandle recalHandle = AliOADBCache::Instance().GetObject(recalibFileName, "AliEMCALRecalib", runRC);
+  const TObjArray *recal=(const TObjArray*)recalHandle.get();
   if (!recal)
   {
     AliError(Form("No Objects for run: %d",runRC));
     return 2;
   }
   
-  TObjArray *recalpass=(TObjArray*)recal->FindObject(fFilepass);
+  const TObjArray *recalpass=(const TObjArray*)recal->FindObject(fFilepass);
   if (!recalpass)
   {
     AliError(Form("No Objects for run: %d - %s",runRC,fFilepass.Data()));
     return 2;
   }
   
-  TObjArray *recalib=(TObjArray*)recalpass->FindObject("Recalib");
+  const TObjArray *recalib=(const TObjArray*)recalpass->FindObject("Recalib");
   if (!recalib)
   {
     AliError(Form("No Recalib histos found for  %d - %s",runRC,fFilepass.Data()));
@@ -219,12 +203,14 @@ Int_t AliEmcalCorrectionCellEnergy::InitRecalib()
     TH2F *h = fRecoUtils->GetEMCALChannelRecalibrationFactors(i);
     if (h)
       delete h;
-    h = (TH2F*)recalib->FindObject(Form("EMCALRecalFactors_SM%d",i));
-    if (!h)
+    const TH2F *hOADB = (const TH2F*)recalib->FindObject(Form("EMCALRecalFactors_SM%d",i));
+    if (!hOADB)
     {
       AliError(Form("Could not load EMCALRecalFactors_SM%d",i));
       continue;
     }
+    // the OADB histogram is shared, the reco utils get their own copy
+    h = (TH2F*)hOADB->Clone();
     h->SetDirectory(0);
     fRecoUtils->SetEMCALChannelRecalibrationFactors(i,h);
   }
@@ -252,62 +238,46 @@ Int_t AliEmcalCorrectionCellEnergy::InitRunDepRecalib()
     AliInfo("Initialising New recalibration factors");
 
     // two files and two OADB containers are needed for the correction factor
-    std::unique_ptr<AliOADBContainer> contTemperature;
-    std::unique_ptr<AliOADBContainer> contParams;
-    std::unique_ptr<TFile> runDepTemperatureFile;
-    std::unique_ptr<TFile> temperatureCalibParamFile;
-
+    TString runDepTemperatureFileName;
+    TString temperatureCalibParamFileName;
     if (fBasePath!="")
     { //if fBasePath specified in the ->SetBasePath()
-      runDepTemperatureFile = std::unique_ptr<TFile>(TFile::Open(Form("%s/EMCALTemperatureCalibSM.root",fBasePath.Data()),"read"));
-      if (!runDepTemperatureFile || runDepTemperatureFile->IsZombie()) {
-        AliFatal(Form("EMCALTemperatureCalibSM.root not found in %s",fBasePath.Data()));
-        return 0;
-      }
-
-      temperatureCalibParamFile = std::unique_ptr<TFile>(TFile::Open(Form("%s/EMCALTemperatureCalibParam.root",fBasePath.Data()),"read"));
-      if (!temperatureCalibParamFile || temperatureCalibParamFile->IsZombie()) {
-        AliFatal(Form("EMCALTemperatureCalibParam.root not found in %s",fBasePath.Data()));
-        return 0;
-      }
-
-      contTemperature = std::unique_ptr<AliOADBContainer>(static_cast<AliOADBContainer *>(runDepTemperatureFile->Get("AliEMCALTemperatureCalibSM")));
-      contParams = std::unique_ptr<AliOADBContainer>(static_cast<AliOADBContainer *>(temperatureCalibParamFile->Get("AliEMCALTemperatureCalibParam")));
+      runDepTemperatureFileName = Form("%s/EMCALTemperatureCalibSM.root",fBasePath.Data());
+      temperatureCalibParamFileName = Form("%s/EMCALTemperatureCalibParam.root",fBasePath.Data());
     }
     else
     { // Else choose the one in the $ALICE_PHYSICS directory or on EOS via the wrapper function
-      runDepTemperatureFile = std::unique_ptr<TFile>(TFile::Open(AliDataFile::GetFileNameOADB("EMCAL/EMCALTemperatureCalibSM.root").data(),"read"));
-      if (!runDepTemperatureFile || runDepTemperatureFile->IsZombie()) {
-        AliFatal("OADB/EMCAL/EMCALTemperatureCalibSM.root was not found");
-        return 0;
-      }
-
-      temperatureCalibParamFile = std::unique_ptr<TFile>(TFile::Open(AliDataFile::GetFileNameOADB("EMCAL/EMCALTemperatureCalibParam.root").data(),"read"));
-      if (!temperatureCalibParamFile || temperatureCalibParamFile->IsZombie()) {
-        AliFatal("OADB/EMCAL/EMCALTemperatureCalibParam.root was not found");
-        return 0;
-      }
+      runDepTemperatureFileName = AliDataFile::GetFileNameOADB("EMCAL/EMCALTemperatureCalibSM.root").data();
+      temperatureCalibParamFileName = AliDataFile::GetFileNameOADB("EMCAL/EMCALTemperatureCalibParam.root").data();
+    }
 
-      contTemperature = std::unique_ptr<AliOADBContainer>(static_cast<AliOADBContainer *>(runDepTemperatureFile->Get("AliEMCALTemperatureCalibSM")));
-      contParams = std::unique_ptr<AliOADBContainer>(static_cast<AliOADBContainer *>(temperatureCalibParamFile->Get("AliEMCALTemperatureCalibParam")));
+    AliOADBCache& oadbCache = AliOADBCache::Instance();
+    if (!oadbCache.HasFile(runDepTemperatureFileName)) {
+      AliFatal(Form("%s not found",runDepTemperatureFileName.Data()));
+      return 0;
+    }
+    if (!oadbCache.HasFile(temperatureCalibParamFileName)) {
+      AliFatal(Form("%s not found",temperatureCalibParamFileName.Data()));
+      return 0;
     }
 
-    if(!contTemperature || !contParams) {
+    if(!oadbCache.GetContainer(runDepTemperatureFileName, "AliEMCALTemperatureCalibSM") ||
+       !oadbCache.GetContainer(temperatureCalibParamFileName, "AliEMCALTemperatureCalibParam")) {
       AliError("Temperature or parametrization OADB container not found");
       return 0;
     }
-    contTemperature->SetOwner(true);
-    contParams->SetOwner(true);
 
-    TObjArray *arrayParams=(TObjArray*)contParams->GetObject(runRC);
+    AliOADBCache::ObjectHandle paramsHandle = oadbCache.GetObject(temperatureCalibParamFileName, "AliEMCALTemperatureCalibParam", runRC);
+    const TObjArray *arrayParams=(const TObjArray*)paramsHandle.get();
     if (!arrayParams)
     {
       AliError(Form("No temperature calibration parameters can be found for run number: %d", runRC));
       return 0;
     }
-    TH1D *hRundepTemp = (TH1D*)contTemperature->GetObject(runRC);
-    TH1F *hSlopeParam = (TH1F*)arrayParams->FindObject("hParamSlope");
-    TH1F *hA0Param = (TH1F*)arrayParams->FindObject("hParamA0");
+    AliOADBCache::ObjectHandle temperatureHandle = oadbCache.GetObject(runDepTemperatureFileName, "AliEMCALTemperatureCalibSM", runRC);
+    const TH1D *hRundepTemp = (const TH1D*)temperatureHandle.get();
+    const TH1F *hSlopeParam = (const TH1F*)arrayParams->FindObject("hParamSlope");
+    const TH1F *hA0Param = (const TH1F*)arrayParams->FindObject("hParamA0");
 
     if (!hRundepTemp || !hSlopeParam || !hA0Param)
     {
@@ -347,41 +317,32 @@ Int_t AliEmcalCorrectionCellEnergy::InitRunDepRecalib()
     }
     AliInfo("Initialising Run1 recalibration factors");
 
-    std::unique_ptr<AliOADBContainer> contRF;
-    std::unique_ptr<TFile> runDepRecalibFile;
+    TString runDepRecalibFileName;
     if (fBasePath!="")
     { //if fBasePath specified in the ->SetBasePath()
       AliInfo(Form("Loading Recalib OADB from given path %s",fBasePath.Data()));
-
-      runDepRecalibFile = std::unique_ptr<TFile>(TFile::Open(Form("%s/EMCALTemperatureCorrCalib.root",fBasePath.Data()),"read"));
-      if (!runDepRecalibFile || runDepRecalibFile->IsZombie())
-      {
-        AliFatal(Form("EMCALTemperatureCorrCalib.root not found in %s",fBasePath.Data()));
-        return 0;
-      }
-
-      contRF = std::unique_ptr<AliOADBContainer>(static_cast<AliOADBContainer *>(runDepRecalibFile->Get("AliEMCALRunDepTempCalibCorrections")));
+      runDepRecalibFileName = Form("%s/EMCALTemperatureCorrCalib.root",fBasePath.Data());
     }
     else
     { // Else choose the one in the $ALICE_PHYSICS directory or on EOS via the wrapper function
       AliInfo("Loading Recalib OADB from OADB/EMCAL");
+      runDepRecalibFileName = AliDataFile::GetFileNameOADB("EMCAL/EMCALTemperatureCorrCalib.root").data();
+    }
 
-      runDepRecalibFile = std::unique_ptr<TFile>(TFile::Open(AliDataFile::GetFileNameOADB("EMCAL/EMCALTemperatureCorrCalib.root").data(),"read"));
-      if (!runDepRecalibFile || runDepRecalibFile->IsZombie())
-      {
-        AliFatal("OADB/EMCAL/EMCALTemperatureCorrCalib.root was not found");
-        return 0;
-      }
-
-      contRF = std::unique_ptr<AliOADBContainer>(static_cast<AliOADBContainer *>(runDepRecalibFile->Get("AliEMCALRunDepTempCalibCorrections")));
+    if (!AliOADBCache::Instance().HasFile(runDepRecalibFileName))
+    {
+      AliFatal(Form("%s not found",runDepRecalibFileName.Data()));
+      return 0;
     }
+
+    AliOADBCache::ContainerHandle contRF = AliOADBCache::Instance().GetContainer(runDepRecalibFileName, "AliEMCALRunDepTempCalibCorrections");
     if(!contRF) {
       AliError("No OADB container found");
       return 0;
     }
-    contRF->SetOwner(true);
 
-    TH1S *rundeprecal=(TH1S*)contRF->GetObject(runRC);
+    AliOADBCache::ObjectHandle rundeprecalHandle = AliOADBCache::Instance().GetObject(runDepRecalibFileName, "AliEMCALRunDepTempCalibCorrections", runRC);
+    const TH1S *rundeprecal=(const TH1S*)rundeprecalHandle.get();
 
     if (!rundeprecal)
     {
@@ -403,7 +364,7 @@ Int_t AliEmcalCorrectionCellEnergy::InitRunDepRecalib()
       }
 
       AliWarning(Form("TemperatureCorrCalib Objects found closest id %d from run: %d", closest, contRF->LowerLimit(closest)));
-      rundeprecal = (TH1S*) contRF->GetObjectByIndex(closest);
+      rundeprecal = (const TH1S*) contRF->GetObjectByIndex(closest);
     }
 
     Int_t nSM = fGeom->GetEMCGeometry()->GetNumberOfSuperModules();
@@ -32,6 +32,11 @@
 #include <TFile.h>
 #include <TTree.h>
 #include <TF1.h>
+#include <TRandom3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "AliGlauberNucleon.h"
 #include "AliGlauberNucleus.h"
@@ -172,7 +177,13 @@ AliGlauberMC::AliGlauberMC(Option_t* NA, Option_t* NB, Double_t xsect) :
   fOmega(0),
   fSig0(0),
   fLambda(0),
-  fSigFluc(0)
+  fSigFluc(0),
+  fUseCellList(kTRUE),
+  fNThreads(1),
+  fRandom(0),
+  fCellStart(),
+  fCellIndex(),
+  fCellPartners()
 {
   //ctor
   for (UInt_t i=0; i<(sizeof(fdNdEtaParam)/sizeof(fdNdEtaParam[0])); i++)
@@ -322,7 +333,13 @@ AliGlauberMC::AliGlauberMC(const AliGlauberMC& in):
   fOmega(in.fOmega),
   fSig0(in.fSig0),
   fLambda(in.fLambda),
-  fSigFluc(in.fSigFluc)
+  fSigFluc(in.fSigFluc),
+  fUseCellList(in.fUseCellList),
+  fNThreads(in.fNThreads),
+  fRandom(0),
+  fCellStart(),
+  fCellIndex(),
+  fCellPartners()
 {
   //copy ctor
   memcpy(fdNdEtaParam,in.fdNdEtaParam,sizeof(fdNdEtaParam));
@@ -453,6 +470,8 @@ AliGlauberMC& AliGlauberMC::operator=(const AliGlauberMC& in)
   fSxyCom=in.fSxyCom;
   fX=in.fX;
   fNpp=in.fNpp;
+  fUseCellList=in.fUseCellList;
+  fNThreads=in.fNThreads;
   return *this;
 }
 
@@ -511,13 +530,8 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
   Double_t Nco   = 0;
   Double_t Ncohc = 0; // hard core
 
-  // for each of the A nucleons in nucleus B
-  for (Int_t i = 0; i<fBN; i++)
+  auto collide = [&](AliGlauberNucleon *nucleonB, AliGlauberNucleon *nucleonA)
   {
-    AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
-    for (Int_t j = 0 ; j < fAN ; j++)
-    {
-      AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
       Double_t dx = nucleonB->GetX()-nucleonA->GetX();
       Double_t dy = nucleonB->GetY()-nucleonA->GetY();
       Double_t dij = dx*dx+dy*dy;
@@ -536,6 +550,85 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
 	if (dij<d2/4)
 	  ++Ncohc;
       }
+  };
+
+  if (fUseCellList && fAN*fBN>=1024 && fAN>0 && fBN>0)
+  {
+    // nucleons of A binned in the transverse plane, with cells at least as large as
+    // the largest interaction distance: the partners of a nucleon of B are then in
+    // the 3x3 cells around it. The candidates are tested in the order of the double
+    // loop below, so that the sums and the collision flags are the same.
+    Double_t d2Max = d2;
+    if (fDoFluc) {
+      Double_t sigMax = 0;
+      for (Int_t j = 0; j<fAN; j++) sigMax = TMath::Max(sigMax,((AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j)))->GetSigNN());
+      for (Int_t i = 0; i<fBN; i++) sigMax = TMath::Max(sigMax,((AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i)))->GetSigNN());
+      d2Max = sigMax/(TMath::Pi()*10);
+    }
+    Double_t xMin = 1e30, xMax = -1e30, yMin = 1e30, yMax = -1e30;
+    for (Int_t j = 0; j<fAN; j++)
+    {
+      AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
+      xMin = TMath::Min(xMin,nucleonA->GetX()); xMax = TMath::Max(xMax,nucleonA->GetX());
+      yMin = TMath::Min(yMin,nucleonA->GetY()); yMax = TMath::Max(yMax,nucleonA->GetY());
+    }
+    // no more cells than a few per nucleon, for very small cross sections
+    Double_t cell = TMath::Max(TMath::Sqrt(d2Max)*(1+1e-9),1e-3);
+    Int_t nx = 0, ny = 0;
+    while (1) {
+      nx = Int_t((xMax-xMin)/cell)+1;
+      ny = Int_t((yMax-yMin)/cell)+1;
+      if (nx*ny<=4*fAN+16) break;
+      cell *= 2;
+    }
+
+    fCellStart.assign(nx*ny+1,0);
+    fCellIndex.resize(fAN);
+    for (Int_t j = 0; j<fAN; j++)
+    {
+      AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
+      Int_t ix = Int_t((nucleonA->GetX()-xMin)/cell);
+      Int_t iy = Int_t((nucleonA->GetY()-yMin)/cell);
+      fCellStart[ix*ny+iy+1]++;
+    }
+    for (Int_t c = 0; c<nx*ny; c++) fCellStart[c+1] += fCellStart[c];
+    std::vector<Int_t> fill(fCellStart.begin(),fCellStart.end()-1);
+    for (Int_t j = 0; j<fAN; j++)
+    {
+      AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
+      Int_t ix = Int_t((nucleonA->GetX()-xMin)/cell);
+      Int_t iy = Int_t((nucleonA->GetY()-yMin)/cell);
+      fCellIndex[fill[ix*ny+iy]++] = j;
+    }
+
+    for (Int_t i = 0; i<fBN; i++)
+    {
+      AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
+      Int_t ix = TMath::FloorNint((nucleonB->GetX()-xMin)/cell);
+      Int_t iy = TMath::FloorNint((nucleonB->GetY()-yMin)/cell);
+      Int_t ixLow = TMath::Max(ix-1,0), ixHigh = TMath::Min(ix+1,nx-1);
+      Int_t iyLow = TMath::Max(iy-1,0), iyHigh = TMath::Min(iy+1,ny-1);
+      if (ixLow>ixHigh || iyLow>iyHigh) continue;
+      fCellPartners.clear();
+      for (Int_t jx = ixLow; jx<=ixHigh; jx++)
+        fCellPartners.insert(fCellPartners.end(),fCellIndex.begin()+fCellStart[jx*ny+iyLow],fCellIndex.begin()+fCellStart[jx*ny+iyHigh+1]);
+      std::sort(fCellPartners.begin(),fCellPartners.end());
+      for (UInt_t k = 0; k<fCellPartners.size(); k++)
+        collide(nucleonB,(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(fCellPartners[k])));
+    }
+    // fXSect as left by the last pair of the double loop
+    if (fDoFluc)
+      fXSect = TMath::Max(((AliGlauberNucleon*)(fNucleonsA->UncheckedAt(fAN-1)))->GetSigNN(),
+                          ((AliGlauberNucleon*)(fNucleonsB->UncheckedAt(fBN-1)))->GetSigNN());
+  }
+  else
+  {
+    // for each of the A nucleons in nucleus B
+    for (Int_t i = 0; i<fBN; i++)
+    {
+      AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
+      for (Int_t j = 0 ; j < fAN ; j++)
+        collide(nucleonB,(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j)));
     }
   }
 
@@ -1267,7 +1360,7 @@ Int_t AliGlauberMC::NegativeBinomialRandom(Int_t k, Double_t nmean) const
   {
     array[i] = NegativeBinomialDistribution(i,k,nmean) + array[i-1];
   }
-  Double_t r = gRandom->Uniform(0,1);
+  Double_t r = Rand()->Uniform(0,1);
   return TMath::BinarySearch(fMaxPlot,array,r)+2;
 
 }
@@ -1278,7 +1371,7 @@ Int_t AliGlauberMC::NegativeBinomialRandomSV(Double_t k, Double_t nbar) const
   // negative binomial distribution generator, S. Voloshin, 09-May-2007
   Double_t sum=0.;
   Int_t i=0;
-  Double_t ran=gRandom->Rndm();
+  Double_t ran=Rand()->Rndm();
   Double_t trm=1./pow(1.+nbar/k,k);
   if (trm==0.)
   {
@@ -1308,7 +1401,7 @@ Int_t AliGlauberMC::DoubleNegativeBinomialRandom( Int_t k,
   {
     array[i] = alpha*NegativeBinomialDistribution(i,k,nmean)+(1-alpha)*NegativeBinomialDistribution(i,k2,nmean2) + array[i-1];
   }
-  Double_t r = gRandom->Uniform(0,1);
+  Double_t r = Rand()->Uniform(0,1);
   return TMath::BinarySearch(fMaxPlot,array,r)+2;
 }
 
@@ -1506,7 +1599,7 @@ Bool_t AliGlauberMC::NextEvent(Double_t bgen)
   {
     if(bgen<0||!succes) //get impactparameter
     {
-      bgen = TMath::Sqrt((fBMax*fBMax-fBMin*fBMin)*gRandom->Rndm()+fBMin*fBMin);
+      bgen = TMath::Sqrt((fBMax*fBMax-fBMin*fBMin)*Rand()->Rndm()+fBMin*fBMin);
     }
     if ( (succes=CalcEvent(bgen)) ) break; //ends if we have particparts
   }
@@ -1681,6 +1774,73 @@ Double_t AliGlauberMC::GetPsi4m2() const
   return (TMath::Cos(4*(((TMath::ATan2(fMeanr4Sin4Phi,fMeanr4Cos4Phi)+TMath::Pi())/4)-((TMath::ATan2(fMeanr2Sin2Phi,fMeanr2Cos2Phi)+TMath::Pi())/2))));
 }
 */
+//______________________________________________________________________________
+void AliGlauberMC::GetNtupleRow(Float_t *v) const
+{
+  //values of the current event, in the order of the ntuple variables
+  v[0]  = GetNpart();
+  v[1]  = GetNcoll();
+  v[2]  = fBMC;
+  v[3]  = fMeanXParts;
+  v[4]  = fMeanYParts;
+  v[5]  = fMeanX2Parts;
+  v[6]  = fMeanY2Parts;
+  v[7]  = fMeanXYParts;
+  v[8]  = fSx2Parts;
+  v[9]  = fSy2Parts;
+  v[10] = fSxyParts;
+  v[11] = fMeanXSystem;
+  v[12] = fMeanYSystem;
+  v[13] = fMeanXA;
+  v[14] = fMeanYA;
+  v[15] = fMeanXB;
+  v[16] = fMeanYB;
+  v[17] = GetEccentricity();
+  v[18] = GetStoa();
+  v[19] = GetEccentricityColl();
+  v[20] = GetEccentricityCom();
+  v[21] = GetEccentricityPart();
+  v[22] = GetEccentricityPartColl();
+  v[23] = GetEccentricityPartCom();
+  if (fDoPartProd)
+  {
+    v[24] = GetdNdEta();
+    v[25] = GetdNdEta();
+    v[26] = v[24]+v[25];
+  }
+  else
+  {
+    v[24] = 0;
+    v[25] = 0;
+    v[26] = 0;
+  }
+  v[27]=fXSect;
+
+  Float_t mytAA=-999;
+  if (GetNcoll()>0) mytAA=GetNcoll()/fXSect;
+  v[28]=mytAA;
+  //_____________epsilon2,3,4,4_______
+  v[29] = GetEpsilon2Part();
+  v[30] = GetEpsilon3Part();
+  v[31] = GetEpsilon4Part();
+  v[32] = GetEpsilon5Part();
+  v[33] = GetEpsilon2Coll();
+  v[34] = GetEpsilon3Coll();
+  v[35] = GetEpsilon4Coll();
+  v[36] = GetEpsilon5Coll();
+  v[37] = GetEpsilon2Com();
+  v[38] = GetEpsilon3Com();
+  v[39] = GetEpsilon4Com();
+  v[40] = GetEpsilon5Com();
+  v[41] = GetPsi2();
+  v[42] = GetPsi3();
+  v[43] = GetPsi4();
+  v[44] = GetPsi5();
+  v[45] = fBNN;
+  v[46] = fXSect;
+  v[47] = fNcollw;
+}
+
 //______________________________________________________________________________
 void AliGlauberMC::Run(Int_t nevents)
 {
@@ -1694,6 +1854,20 @@ void AliGlauberMC::Run(Int_t nevents)
                       "Npart:Ncoll:B:MeanX:MeanY:MeanX2:MeanY2:MeanXY:VarX:VarY:VarXY:MeanXSystem:MeanYSystem:MeanXA:MeanYA:MeanXB:MeanYB:VarE:Stoa:VarEColl:VarECom:VarEPart:VarEPartColl:VarEPartCom:dNdEta:dNdEtaGBW:dNdEtaTwoNBD:xsect:tAA:Epsl2:Epsl3:Epsl4:Epsl5:E2Coll:E3Coll:E4Coll:E5Coll:E2Com:E3Com:E4Com:E5Com:Psi2:Psi3:Psi4:Psi5:BNN:signn:Ncollw");
     fnt->SetDirectory(0);
   }
+
+  Int_t nThreads = (fNThreads>0 ? fNThreads : (Int_t)std::thread::hardware_concurrency());
+  if (nThreads>1 && fDoFluc)
+  {
+    // the fluctuating cross section is thrown with TF1::GetRandom, which uses gRandom
+    cout << "Fluctuating cross section: generating the events in one thread" << endl;
+    nThreads = 1;
+  }
+  if (nThreads>1)
+  {
+    RunParallel(nevents,nThreads);
+    return;
+  }
+
   Int_t q = 0;
   Int_t u = 0;
   for (Int_t i = 0; i<nevents; i++)
@@ -1706,68 +1880,8 @@ void AliGlauberMC::Run(Int_t nevents)
     }
 
     q++;
-    Float_t v[48];
-    v[0]  = GetNpart();
-    v[1]  = GetNcoll();
-    v[2]  = fBMC;
-    v[3]  = fMeanXParts;
-    v[4]  = fMeanYParts;
-    v[5]  = fMeanX2Parts;
-    v[6]  = fMeanY2Parts;
-    v[7]  = fMeanXYParts;
-    v[8]  = fSx2Parts;
-    v[9]  = fSy2Parts;
-    v[10] = fSxyParts;
-    v[11] = fMeanXSystem;
-    v[12] = fMeanYSystem;
-    v[13] = fMeanXA;
-    v[14] = fMeanYA;
-    v[15] = fMeanXB;
-    v[16] = fMeanYB;
-    v[17] = GetEccentricity();
-    v[18] = GetStoa();
-    v[19] = GetEccentricityColl();
-    v[20] = GetEccentricityCom();
-    v[21] = GetEccentricityPart();
-    v[22] = GetEccentricityPartColl();
-    v[23] = GetEccentricityPartCom();
-    if (fDoPartProd)
-    {
-      v[24] = GetdNdEta();
-      v[25] = GetdNdEta();
-      v[26] = v[24]+v[25];
-    }
-    else
-    {
-      v[24] = 0;
-      v[25] = 0;
-      v[26] = 0;
-    }
-    v[27]=fXSect;
-
-    Float_t mytAA=-999;
-    if (GetNcoll()>0) mytAA=GetNcoll()/fXSect;
-    v[28]=mytAA;
-    //_____________epsilon2,3,4,4_______
-    v[29] = GetEpsilon2Part();
-    v[30] = GetEpsilon3Part();
-    v[31] = GetEpsilon4Part();
-    v[32] = GetEpsilon5Part();
-    v[33] = GetEpsilon2Coll();
-    v[34] = GetEpsilon3Coll();
-    v[35] = GetEpsilon4Coll();
-    v[36] = GetEpsilon5Coll();
-    v[37] = GetEpsilon2Com();
-    v[38] = GetEpsilon3Com();
-    v[39] = GetEpsilon4Com();
-    v[40] = GetEpsilon5Com();
-    v[41] = GetPsi2();
-    v[42] = GetPsi3();
-    v[43] = GetPsi4();
-    v[44] = GetPsi5();
-    v[45] = fBNN;
-    v[46] = fXSect;
-    v[47] = fNcollw;
+    Float_t v[kNtupleVars];
+    GetNtupleRow(v);
 
     //always at the end
     fnt->Fill(v);
@@ -1777,6 +1891,106 @@ void AliGlauberMC::Run(Int_t nevents)
   std::cout << "Generating Event # " << nevents << "... \r" << endl << "Done! Succesfull events:  " << q << "  discarded events:  " << u <<"."<< endl;
 }
 
+//______________________________________________________________________________
+AliGlauberMC *AliGlauberMC::MakeWorker() const
+{
+  //generator with the settings of this one, for RunParallel
+  AliGlauberMC *w = new AliGlauberMC(fANucleus.GetName(),fBNucleus.GetName(),fXSect);
+  AliGlauberNucleus *nuc[2]  = {&w->fANucleus,&w->fBNucleus};
+  const AliGlauberNucleus *in[2] = {&fANucleus,&fBNucleus};
+  for (Int_t k = 0; k<2; k++)
+  {
+    nuc[k]->SetR(in[k]->GetR());
+    nuc[k]->SetA(in[k]->GetA());
+    nuc[k]->SetW(in[k]->GetW());
+    nuc[k]->SetMinDist(in[k]->GetMinDist());
+    nuc[k]->FillRadiusTable();
+  }
+  w->fBMin = fBMin;
+  w->fBMax = fBMax;
+  w->fMultType = fMultType;
+  memcpy(w->fdNdEtaParam,fdNdEtaParam,sizeof(fdNdEtaParam));
+  w->fX = fX;
+  w->fNpp = fNpp;
+  w->fDoPartProd = fDoPartProd;
+  w->fUseCellList = fUseCellList;
+
+  // allocate the nucleons here rather than in the worker threads
+  TRandom3 rnd(1);
+  w->SetRandom(&rnd);
+  w->fANucleus.ThrowNucleons();
+  w->fBNucleus.ThrowNucleons();
+  w->SetRandom(0);
+  return w;
+}
+
+//______________________________________________________________________________
+void AliGlauberMC::RunParallel(Int_t nevents, Int_t nThreads)
+{
+  //Run with the events shared among threads. The events are generated in blocks
+  //with their own TRandom3, seeded from gRandom, and the ntuple is filled in the
+  //order of the blocks: the output depends on the gRandom seed, not on nThreads.
+  const Int_t blockSize = 1000;
+  const Int_t nBlocks = (nevents+blockSize-1)/blockSize;
+  std::vector<UInt_t> seeds(nBlocks);
+  for (Int_t b = 0; b<nBlocks; b++) seeds[b] = 1 + gRandom->Integer(kMaxInt);
+
+  std::vector<AliGlauberMC*> workers(nThreads);
+  for (Int_t t = 0; t<nThreads; t++) workers[t] = MakeWorker();
+
+  const Int_t blocksPerRound = 4*nThreads;
+  Int_t q = 0;
+  Int_t u = 0;
+  for (Int_t first = 0; first<nBlocks; first += blocksPerRound)
+  {
+    Int_t last = TMath::Min(first+blocksPerRound,nBlocks);
+    std::vector<std::vector<Float_t> > rows(last-first);
+    std::vector<Int_t> discarded(last-first,0);
+    std::atomic<Int_t> next(first);
+    auto generate = [&](AliGlauberMC *w)
+    {
+      for (Int_t b = next++; b<last; b = next++)
+      {
+        TRandom3 rnd(seeds[b]);
+        w->SetRandom(&rnd);
+        Int_t nev = TMath::Min(blockSize,nevents-b*blockSize);
+        for (Int_t i = 0; i<nev; i++)
+        {
+          if (!w->NextEvent())
+          {
+            discarded[b-first]++;
+            continue;
+          }
+          std::vector<Float_t> &r = rows[b-first];
+          r.resize(r.size()+kNtupleVars);
+          w->GetNtupleRow(&r[r.size()-kNtupleVars]);
+        }
+        w->SetRandom(0);
+      }
+    };
+    std::vector<std::thread> threads;
+    for (Int_t t = 0; t<nThreads; t++) threads.push_back(std::thread(generate,workers[t]));
+    for (Int_t t = 0; t<nThreads; t++) threads[t].join();
+
+    for (Int_t b = 0; b<last-first; b++)
+    {
+      for (UInt_t k = 0; k<rows[b].size(); k += kNtupleVars) fnt->Fill(&rows[b][k]);
+      q += rows[b].size()/kNtupleVars;
+      u += discarded[b];
+    }
+    std::cout << "Generating Event # " << TMath::Min(last*blockSize,nevents) << "... \r" << flush;
+  }
+
+  for (Int_t t = 0; t<nThreads; t++)
+  {
+    fEvents += workers[t]->fEvents;
+    fTotalEvents += workers[t]->fTotalEvents;
+    fMaxNpartFound = TMath::Max(fMaxNpartFound,workers[t]->fMaxNpartFound);
+    delete workers[t];
+  }
+  std::cout << "Generating Event # " << nevents << "... \r" << endl << "Done! Succesfull events:  " << q << "  discarded events:  " << u <<"."<< endl;
+}
+
 //---------------------------------------------------------------------------------
 void AliGlauberMC::RunAndSaveNtuple( Int_t n,
                                      const Option_t *sysA,
@@ -1785,13 +1999,15 @@ void AliGlauberMC::RunAndSaveNtuple( Int_t n,
                                      Double_t mind,
                                      Double_t r,
                                      Double_t a,
-                                     const char *fname)
+                                     const char *fname,
+                                     Int_t nThreads)
 {
   //example run
   AliGlauberMC mcg(sysA,sysB,signn);
   mcg.SetMinDistance(mind);
   mcg.Setr(r);
   mcg.Seta(a);
+  mcg.SetNThreads(nThreads);
   mcg.Run(n);
   TNtuple  *nt=mcg.GetNtuple();
   TFile out(fname,"recreate",fname,9);
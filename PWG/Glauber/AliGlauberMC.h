@@ -16,6 +16,8 @@
 #include "AliGlauberNucleus.h"
 #include <Riostream.h>
 #include <TNamed.h>
+#include <TRandom.h>
+#include <vector>
 
 class TObjArray;
 class TNtuple;
@@ -100,6 +102,9 @@ public:
    void   Seta(Double_t a)  {fANucleus.SetA(a); fBNucleus.SetA(a);}
    void   SetDoFluc(Double_t omega, Double_t sig0, Double_t lam, Bool_t on=kTRUE) 
             {fDoFluc=on;fOmega=omega;fSig0=sig0;fLambda=lam;}
+   void   SetUseCellList(Bool_t b=kTRUE) { fUseCellList = b; }
+   void   SetNThreads(Int_t n=0)      {fNThreads = n;}
+   void   SetRandom(TRandom *rnd)     {fRandom=rnd; fANucleus.SetRandom(rnd); fBNucleus.SetRandom(rnd);}
    static void       PrintVersion()         {cout << "AliGlauberMC " << Version() << endl;}
    static const char *Version()             {return "v1.2";}
    static void       RunAndSaveNtuple( Int_t n,
@@ -109,7 +114,8 @@ public:
                                        Double_t mind=0.4,
 				       Double_t r=6.62,
 				       Double_t a=0.546,
-                                       const char *fname="glau_pbpb_ntuple.root");
+                                       const char *fname="glau_pbpb_ntuple.root",
+                                       Int_t nThreads=1);
    void RunAndSaveNucleons( Int_t n,
                             const Option_t *sysA,
                             const Option_t *sysB,
@@ -251,9 +257,20 @@ private:
    Double_t     fSig0;           //regularization parameter 
    Double_t     fLambda;         //lambda parameter
    TF1         *fSigFluc;        //!parameterization for fluctuating sigNN
+   Bool_t       fUseCellList;    //=kTRUE then search the collisions in a 2D cell list
+   Int_t        fNThreads;       //number of threads for Run, 0 = number of cores
+   TRandom     *fRandom;         //!random generator, gRandom if not set
+   std::vector<Int_t> fCellStart;  //!first entry of each cell in fCellIndex
+   std::vector<Int_t> fCellIndex;  //!nucleons of A sorted by cell
+   std::vector<Int_t> fCellPartners; //!candidate partners of a nucleon of B
+   enum { kNtupleVars = 48 };
    Bool_t       CalcResults(Double_t bgen);
+   void         GetNtupleRow(Float_t *v) const;
+   AliGlauberMC *MakeWorker() const;
+   void         RunParallel(Int_t nevents, Int_t nThreads);
+   TRandom     *Rand() const     {return fRandom ? fRandom : gRandom;}
 
-   ClassDef(AliGlauberMC,4)
+   ClassDef(AliGlauberMC,5)
 };
 
 #endif
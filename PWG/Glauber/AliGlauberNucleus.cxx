@@ -49,7 +49,9 @@ AliGlauberNucleus::AliGlauberNucleus(Option_t* iname, Int_t iN, Double_t iR, Dou
   fF(0),
   fTrials(0),
   fFunction(ifunc),
-  fNucleons(NULL)
+  fNucleons(NULL),
+  fRandom(NULL),
+  fRadiusTable()
 {
    if (fN==0) {
       cout << "Setting up nucleus " << iname << endl;
@@ -77,7 +79,9 @@ AliGlauberNucleus::AliGlauberNucleus(const AliGlauberNucleus& in):
   fF(in.fF),
   fTrials(in.fTrials),
   fFunction(in.fFunction),
-  fNucleons(NULL)
+  fNucleons(NULL),
+  fRandom(NULL),
+  fRadiusTable(in.fRadiusTable)
 {
   //copy ctor
   if (in.fNucleons)
@@ -97,6 +101,7 @@ AliGlauberNucleus& AliGlauberNucleus::operator=(const AliGlauberNucleus& in)
   fF=in.fF;
   fTrials=in.fTrials;
   fFunction=in.fFunction;
+  fRadiusTable=in.fRadiusTable;
   delete fNucleons;
   fNucleons=static_cast<TObjArray*>((in.fNucleons)->Clone());
   fNucleons->SetOwner();
@@ -177,6 +182,7 @@ void AliGlauberNucleus::Lookup(Option_t* name)
 void AliGlauberNucleus::SetR(Double_t ir)
 {
    fR = ir;
+   fRadiusTable.clear();
    switch (fF)
    {
       case 0: // Proton
@@ -195,6 +201,7 @@ void AliGlauberNucleus::SetR(Double_t ir)
 void AliGlauberNucleus::SetA(Double_t ia)
 {
    fA = ia;
+   fRadiusTable.clear();
    switch (fF)
    {
       case 0: // Proton
@@ -212,6 +219,7 @@ void AliGlauberNucleus::SetA(Double_t ia)
 void AliGlauberNucleus::SetW(Double_t iw)
 {
    fW = iw;
+   fRadiusTable.clear();
    switch (fF)
    {
       case 0: // Proton
@@ -225,6 +233,55 @@ void AliGlauberNucleus::SetW(Double_t iw)
    }
 }
 
+//______________________________________________________________________________
+void AliGlauberNucleus::FillRadiusTable(Int_t nBins)
+{
+   // Tabulate the inverse of the cumulative of rho(r), so that radii can be thrown
+   // with fRandom without TF1::GetRandom (which uses gRandom and is not thread safe).
+   // The cumulative is integrated with the trapezoidal rule on a 10 times finer grid.
+   fRadiusTable.clear();
+   if (!fFunction || nBins<1) return;
+   Double_t xmin = fFunction->GetXmin();
+   Double_t xmax = fFunction->GetXmax();
+   Int_t nFine = 10*nBins;
+   Double_t dx = (xmax-xmin)/nFine;
+   std::vector<Double_t> cumul(nFine+1,0.);
+   Double_t f0 = TMath::Max(fFunction->Eval(xmin),0.);
+   for (Int_t i = 1; i<=nFine; i++) {
+      Double_t f1 = TMath::Max(fFunction->Eval(xmin+i*dx),0.);
+      cumul[i] = cumul[i-1] + 0.5*(f0+f1)*dx;
+      f0 = f1;
+   }
+   if (cumul[nFine]<=0) return;
+
+   fRadiusTable.resize(nBins+1);
+   fRadiusTable[0] = xmin;
+   Int_t j = 0;
+   for (Int_t i = 1; i<nBins; i++) {
+      Double_t c = cumul[nFine]*i/nBins;
+      while (cumul[j+1]<c) j++;
+      fRadiusTable[i] = xmin + (j + (c-cumul[j])/(cumul[j+1]-cumul[j]))*dx;
+   }
+   fRadiusTable[nBins] = xmax;
+}
+
+//______________________________________________________________________________
+Double_t AliGlauberNucleus::Rndm() const
+{
+   return fRandom ? fRandom->Rndm() : gRandom->Rndm();
+}
+
+//______________________________________________________________________________
+Double_t AliGlauberNucleus::ThrowRadius() const
+{
+   // radius distributed according to rho(r), from the table if it was filled
+   if (fRadiusTable.empty()) return fFunction->GetRandom();
+   Int_t nBins = fRadiusTable.size()-1;
+   Double_t u = Rndm()*nBins;
+   Int_t i = TMath::Min(Int_t(u),nBins-1);
+   return fRadiusTable[i] + (u-i)*(fRadiusTable[i+1]-fRadiusTable[i]);
+}
+
 //______________________________________________________________________________
 void AliGlauberNucleus::ThrowNucleons(Double_t xshift)
 {
@@ -246,9 +303,9 @@ void AliGlauberNucleus::ThrowNucleons(Double_t xshift)
    Bool_t hulthen = (TString(GetName())=="dh");
    if (fN==2 && hulthen) { //special treatmeant for Hulten
 
-      Double_t r = fFunction->GetRandom()/2;
-      Double_t phi = gRandom->Rndm() * 2 * TMath::Pi() ;
-      Double_t ctheta = 2*gRandom->Rndm() - 1 ;
+      Double_t r = ThrowRadius()/2;
+      Double_t phi = Rndm() * 2 * TMath::Pi() ;
+      Double_t ctheta = 2*Rndm() - 1 ;
       Double_t stheta = sqrt(1-ctheta*ctheta);
      
       AliGlauberNucleon *nucleon1=(AliGlauberNucleon*)(fNucleons->UncheckedAt(0));
@@ -270,9 +327,9 @@ void AliGlauberNucleus::ThrowNucleons(Double_t xshift)
       nucleon->Reset();
       while(1) {
          fTrials++;
-         Double_t r = fFunction->GetRandom();
-         Double_t phi = gRandom->Rndm() * 2 * TMath::Pi() ;
-         Double_t ctheta = 2*gRandom->Rndm() - 1 ;
+         Double_t r = ThrowRadius();
+         Double_t phi = Rndm() * 2 * TMath::Pi() ;
+         Double_t ctheta = 2*Rndm() - 1 ;
          Double_t stheta = TMath::Sqrt(1-ctheta*ctheta);
          Double_t x = r * stheta * cos(phi) + xshift;
          Double_t y = r * stheta * sin(phi);      
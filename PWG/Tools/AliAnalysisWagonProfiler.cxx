@@ -0,0 +1,380 @@
+/**************************************************************************
+ * Copyright(c) 1998-2020, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <TBufferFile.h>
+#include <TChain.h>
+#include <TSystem.h>
+
+#include "AliAnalysisDataContainer.h"
+#include "AliAnalysisManager.h"
+#include "AliLog.h"
+#include "AliAnalysisWagonProfiler.h"
+
+ClassImp(AliAnalysisWagonProbe)
+ClassImp(AliAnalysisWagonProfiler)
+
+namespace {
+  /// Heap in use, from the allocator statistics (glibc only), -1 if not available
+  Long64_t HeapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return Long64_t(info.uordblks + info.hblkhd);
+#elif defined(__GLIBC__)
+    // the fields are int, good up to 4 GB when read as unsigned
+    struct mallinfo info = mallinfo();
+    return Long64_t((unsigned int)info.uordblks) + Long64_t((unsigned int)info.hblkhd);
+#else
+    return -1;
+#endif
+  }
+}
+
+AliAnalysisWagonProbe::AliAnalysisWagonProbe() :
+  AliAnalysisTask(),
+  fProfiler(0),
+  fIndex(-1)
+{
+
+}
+
+AliAnalysisWagonProbe::AliAnalysisWagonProbe(const char *name, AliAnalysisWagonProfiler *profiler, Int_t index) :
+  AliAnalysisTask(name, name),
+  fProfiler(profiler),
+  fIndex(index)
+{
+  DefineInput(0, TChain::Class());
+}
+
+void AliAnalysisWagonProbe::Exec(Option_t *){
+  if(fProfiler) fProfiler->MarkExec(fIndex);
+}
+
+void AliAnalysisWagonProbe::FinishTaskOutput(){
+  if(!fProfiler) return;
+  fProfiler->MarkFinish(fIndex);
+  // the last probe runs after all wagons have finished their output
+  if(fIndex == fProfiler->GetNWagons()) fProfiler->Report();
+}
+
+AliAnalysisWagonProfiler::WagonStats::WagonStats() :
+  fNExec(0),
+  fWall(0.),
+  fCPU(0.),
+  fMaxWall(0.),
+  fFinishWall(0.),
+  fFinishCPU(0.),
+  fFirstResidentGrowth(0),
+  fFirstHeapGrowth(0),
+  fNSampled(0),
+  fResidentGrowth(0),
+  fMaxResidentGrowth(0),
+  fHeapGrowth(0),
+  fMaxHeapGrowth(0),
+  fOutputBytes(-1)
+{
+
+}
+
+AliAnalysisWagonProfiler::AliAnalysisWagonProfiler() :
+  TNamed(),
+  fWagons(),
+  fProbes(),
+  fActive(kTRUE),
+  fMemorySampling(100),
+  fOutputFileName("WagonProfile.json"),
+  fMeasureOutputSize(kFALSE),
+  fStats(),
+  fLast(),
+  fLastProbe(-1),
+  fLastFinishProbe(-1),
+  fSampleEvent(kFALSE),
+  fNEvents(0),
+  fReported(kFALSE)
+{
+
+}
+
+AliAnalysisWagonProfiler::AliAnalysisWagonProfiler(const char *name) :
+  TNamed(name, name),
+  fWagons(),
+  fProbes(),
+  fActive(kTRUE),
+  fMemorySampling(100),
+  fOutputFileName("WagonProfile.json"),
+  fMeasureOutputSize(kFALSE),
+  fStats(),
+  fLast(),
+  fLastProbe(-1),
+  fLastFinishProbe(-1),
+  fSampleEvent(kFALSE),
+  fNEvents(0),
+  fReported(kFALSE)
+{
+
+}
+
+AliAnalysisWagonProfiler *AliAnalysisWagonProfiler::Instrument(AliAnalysisManager *mgr, const char *name){
+  if(!mgr) mgr = AliAnalysisManager::GetAnalysisManager();
+  if(!mgr){
+    AliErrorGeneral("AliAnalysisWagonProfiler::Instrument", "No analysis manager found");
+    return 0;
+  }
+  AliAnalysisDataContainer *input = mgr->GetCommonInputContainer();
+  if(!input){
+    AliErrorGeneral("AliAnalysisWagonProfiler::Instrument", "No common input container, add the input handler first");
+    return 0;
+  }
+
+  // instrument only once
+  TIter nextTask(mgr->GetTasks());
+  while(TObject *obj = nextTask()){
+    AliAnalysisWagonProbe *probe = dynamic_cast<AliAnalysisWagonProbe *>(obj);
+    if(probe) return probe->GetProfiler();
+  }
+
+  // the wagons are the tasks reading the common input
+  TObjArray *topTasks = mgr->GetTopTasks();
+  TObjArray *consumers = input->GetConsumers();
+  TObjArray *source = (topTasks && topTasks->GetEntriesFast()) ? topTasks : consumers;
+  if(!source || !source->GetEntriesFast()){
+    AliErrorGeneral("AliAnalysisWagonProfiler::Instrument", "No wagons to profile, call it after all the AddTask macros");
+    return 0;
+  }
+
+  AliAnalysisWagonProfiler *profiler = new AliAnalysisWagonProfiler(name);
+  TIter nextWagon(source);
+  while(TObject *obj = nextWagon()){
+    AliAnalysisTask *wagon = dynamic_cast<AliAnalysisTask *>(obj);
+    if(wagon) profiler->fWagons.Add(wagon);
+  }
+  const Int_t nWagons = profiler->fWagons.GetEntriesFast();
+  for(Int_t iprobe = 0; iprobe <= nWagons; iprobe++){
+    AliAnalysisWagonProbe *probe = new AliAnalysisWagonProbe(Form("%s_probe%d", name, iprobe), profiler, iprobe);
+    mgr->AddTask(probe);
+    mgr->ConnectInput(probe, 0, input);
+    profiler->fProbes.Add(probe);
+  }
+
+  // each wagon right after its probe, in all lists the manager runs the tasks from
+  InsertProbes(mgr->GetTasks(), profiler->fWagons, profiler->fProbes);
+  InsertProbes(topTasks, profiler->fWagons, profiler->fProbes);
+  InsertProbes(consumers, profiler->fWagons, profiler->fProbes);
+
+  AliInfoGeneral("AliAnalysisWagonProfiler::Instrument", Form("Profiling %d wagons", nWagons));
+  return profiler;
+}
+
+void AliAnalysisWagonProfiler::InsertProbes(TObjArray *list, const TObjArray &wagons, const TObjArray &probes){
+  if(!list || !list->GetEntriesFast()) return;
+  TObjArray ordered(list->GetEntriesFast() + probes.GetEntriesFast());
+  TIter next(list);
+  while(TObject *obj = next()){
+    if(probes.FindObject(obj)) continue;
+    Int_t iwagon = wagons.IndexOf(obj);
+    if(iwagon >= 0) ordered.Add(probes.At(iwagon));
+    ordered.Add(obj);
+  }
+  ordered.Add(probes.Last());
+  // the tasks are only moved, never deleted
+  const Bool_t owner = list->IsOwner();
+  list->SetOwner(kFALSE);
+  list->Clear();
+  TIter nextOrdered(&ordered);
+  while(TObject *obj = nextOrdered()) list->Add(obj);
+  list->SetOwner(owner);
+}
+
+void AliAnalysisWagonProfiler::TakeSnapshot(Snapshot &snapshot, Bool_t memory) const {
+  snapshot.fWall = std::chrono::duration<Double_t>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  snapshot.fCPU = Double_t(std::clock()) / CLOCKS_PER_SEC;
+  snapshot.fResident = -1;
+  snapshot.fHeap = -1;
+  if(memory){
+    ProcInfo_t info;
+    gSystem->GetProcInfo(&info);
+    snapshot.fResident = Long64_t(info.fMemResident) * 1024;
+    snapshot.fHeap = HeapInUse();
+  }
+}
+
+void AliAnalysisWagonProfiler::ResetStats(){
+  fStats.assign(fWagons.GetEntriesFast(), WagonStats());
+  fLastProbe = -1;
+  fLastFinishProbe = -1;
+  fNEvents = 0;
+  fReported = kFALSE;
+}
+
+void AliAnalysisWagonProfiler::MarkExec(Int_t probe){
+  if(!fActive) return;
+  const Int_t nWagons = fWagons.GetEntriesFast();
+  if(Int_t(fStats.size()) != nWagons) ResetStats();
+  if(probe < 0 || probe > nWagons) return;
+
+  if(probe == 0){
+    // the first event is read as well, but kept apart from the sampled ones
+    fSampleEvent = fMemorySampling > 0 && (fNEvents % fMemorySampling) == 0;
+    fNEvents++;
+  }
+  Snapshot now;
+  TakeSnapshot(now, fSampleEvent);
+
+  // the interval since the previous probe belongs to the wagon in between
+  if(probe > 0 && fLastProbe == probe - 1){
+    WagonStats &stats = fStats[probe - 1];
+    const Double_t wall = now.fWall - fLast.fWall;
+    stats.fNExec++;
+    stats.fWall += wall;
+    stats.fCPU += now.fCPU - fLast.fCPU;
+    if(wall > stats.fMaxWall) stats.fMaxWall = wall;
+    if(fSampleEvent && now.fResident >= 0 && fLast.fResident >= 0){
+      const Long64_t growth = now.fResident - fLast.fResident;
+      const Long64_t heapGrowth = (now.fHeap >= 0 && fLast.fHeap >= 0) ? now.fHeap - fLast.fHeap : 0;
+      if(fNEvents == 1){
+        stats.fFirstResidentGrowth = growth;
+        stats.fFirstHeapGrowth = heapGrowth;
+      }
+      else {
+        stats.fNSampled++;
+        stats.fResidentGrowth += growth;
+        stats.fHeapGrowth += heapGrowth;
+        if(growth > stats.fMaxResidentGrowth) stats.fMaxResidentGrowth = growth;
+        if(heapGrowth > stats.fMaxHeapGrowth) stats.fMaxHeapGrowth = heapGrowth;
+      }
+    }
+  }
+  fLast = now;
+  fLastProbe = probe;
+}
+
+void AliAnalysisWagonProfiler::MarkFinish(Int_t probe){
+  if(!fActive) return;
+  const Int_t nWagons = fWagons.GetEntriesFast();
+  if(Int_t(fStats.size()) != nWagons) ResetStats();
+  if(probe < 0 || probe > nWagons) return;
+
+  Snapshot now;
+  TakeSnapshot(now, kFALSE);
+  if(probe > 0 && fLastFinishProbe == probe - 1){
+    WagonStats &stats = fStats[probe - 1];
+    stats.fFinishWall += now.fWall - fLast.fWall;
+    stats.fFinishCPU += now.fCPU - fLast.fCPU;
+  }
+  fLast = now;
+  fLastFinishProbe = probe;
+  fLastProbe = -1;
+}
+
+Long64_t AliAnalysisWagonProfiler::OutputSize(AliAnalysisTask *task){
+  // one object at a time, the buffer is released before the next one is streamed
+  Long64_t size = 0;
+  for(Int_t islot = 0; islot < task->GetNoutputs(); islot++){
+    TObject *output = task->GetOutputData(islot);
+    if(!output) continue;
+    TBufferFile buffer(TBuffer::kWrite);
+    buffer.WriteObject(output);
+    size += buffer.Length();
+  }
+  return size;
+}
+
+TString AliAnalysisWagonProfiler::JSONString(const char *text){
+  TString escaped;
+  for(const char *c = text; c && *c; c++){
+    switch(*c){
+      case '"':  escaped += "\\\""; break;
+      case '\\': escaped += "\\\\"; break;
+      case '\n': escaped += "\\n"; break;
+      case '\t': escaped += "\\t"; break;
+      default:
+        if((unsigned char)*c < 0x20) escaped += Form("\\u%04x", (unsigned char)*c);
+        else escaped += *c;
+    }
+  }
+  return escaped;
+}
+
+void AliAnalysisWagonProfiler::Report(){
+  if(!fActive || fReported) return;
+  const Int_t nWagons = fWagons.GetEntriesFast();
+  if(Int_t(fStats.size()) != nWagons) ResetStats();
+  fReported = kTRUE;
+
+  if(fMeasureOutputSize){
+    for(Int_t iwagon = 0; iwagon < nWagons; iwagon++){
+      AliAnalysisTask *wagon = static_cast<AliAnalysisTask *>(fWagons.At(iwagon));
+      fStats[iwagon].fOutputBytes = OutputSize(wagon);
+    }
+  }
+  Print();
+
+  std::ofstream out(fOutputFileName.Data());
+  if(!out){
+    AliErrorF("Cannot write the wagon profile to %s", fOutputFileName.Data());
+    return;
+  }
+  out << "{\n  \"events\": " << fNEvents << ",\n  \"memorySampling\": " << fMemorySampling << ",\n  \"wagons\": [";
+  for(Int_t iwagon = 0; iwagon < nWagons; iwagon++){
+    const WagonStats &stats = fStats[iwagon];
+    out << (iwagon ? ",\n" : "\n")
+        << "    {\"name\": \"" << JSONString(fWagons.At(iwagon)->GetName()) << "\""
+        << ", \"class\": \"" << JSONString(fWagons.At(iwagon)->ClassName()) << "\""
+        << ", \"nExec\": " << stats.fNExec
+        << ", \"wallExec\": " << stats.fWall
+        << ", \"cpuExec\": " << stats.fCPU
+        << ", \"maxWallExec\": " << stats.fMaxWall
+        << ", \"wallFinish\": " << stats.fFinishWall
+        << ", \"cpuFinish\": " << stats.fFinishCPU
+        << ", \"firstResidentGrowth\": " << stats.fFirstResidentGrowth
+        << ", \"firstHeapGrowth\": " << stats.fFirstHeapGrowth
+        << ", \"nSampled\": " << stats.fNSampled
+        << ", \"residentGrowth\": " << stats.fResidentGrowth
+        << ", \"maxResidentGrowth\": " << stats.fMaxResidentGrowth
+        << ", \"heapGrowth\": " << stats.fHeapGrowth
+        << ", \"maxHeapGrowth\": " << stats.fMaxHeapGrowth
+        << ", \"outputBytes\": " << stats.fOutputBytes << "}";
+  }
+  out << "\n  ]\n}\n";
+  AliInfoF("Wagon profile written to %s", fOutputFileName.Data());
+}
+
+void AliAnalysisWagonProfiler::Print(Option_t *) const {
+  const Int_t nWagons = fWagons.GetEntriesFast();
+  Printf("Wagon profile of %s: %lld events, memory read every %d events", GetName(), fNEvents, fMemorySampling);
+  Printf("Memory growth: in the first event, and summed (largest step) over the other sampled events, not extrapolated");
+  Printf("%-40s %10s %10s %10s %10s %10s %12s %12s %18s %18s %12s",
+         "wagon", "events", "wall [s]", "cpu [s]", "cpu/ev[ms]", "finish [s]", "1st rss[MB]", "1st heap[MB]",
+         "rss [MB] (max)", "heap [MB] (max)", "output [MB]");
+  Double_t totWall = 0., totCPU = 0.;
+  for(Int_t iwagon = 0; iwagon < nWagons && iwagon < Int_t(fStats.size()); iwagon++){
+    const WagonStats &stats = fStats[iwagon];
+    Printf("%-40.40s %10lld %10.2f %10.2f %10.3f %10.2f %12.1f %12.1f %9.1f (%6.1f) %9.1f (%6.1f) %12s",
+           fWagons.At(iwagon)->GetName(), stats.fNExec, stats.fWall, stats.fCPU,
+           stats.fNExec ? 1000. * stats.fCPU / stats.fNExec : 0., stats.fFinishWall,
+           stats.fFirstResidentGrowth / 1048576., stats.fFirstHeapGrowth / 1048576.,
+           stats.fResidentGrowth / 1048576., stats.fMaxResidentGrowth / 1048576.,
+           stats.fHeapGrowth / 1048576., stats.fMaxHeapGrowth / 1048576.,
+           stats.fOutputBytes >= 0 ? Form("%.1f", stats.fOutputBytes / 1048576.) : "-");
+    totWall += stats.fWall + stats.fFinishWall;
+    totCPU += stats.fCPU + stats.fFinishCPU;
+  }
+  Printf("Total in the wagons: wall %.2f s, cpu %.2f s", totWall, totCPU);
+}
@@ -0,0 +1,151 @@
+#ifndef ALIANALYSISWAGONPROFILER_H
+#define ALIANALYSISWAGONPROFILER_H
+/* Copyright(c) 1998-2020, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+#include <vector>
+
+#include <TNamed.h>
+#include <TObjArray.h>
+#include <TString.h>
+
+#include "AliAnalysisTask.h"
+
+class AliAnalysisManager;
+class AliAnalysisWagonProfiler;
+
+/**
+ * \class AliAnalysisWagonProbe
+ * \brief Marker task run before each wagon of a train, see AliAnalysisWagonProfiler
+ */
+class AliAnalysisWagonProbe : public AliAnalysisTask {
+public:
+  AliAnalysisWagonProbe();
+  AliAnalysisWagonProbe(const char *name, AliAnalysisWagonProfiler *profiler, Int_t index);
+  virtual ~AliAnalysisWagonProbe() {}
+
+  virtual void ConnectInputData(Option_t *) {}
+  virtual void CreateOutputObjects() {}
+  virtual void Exec(Option_t *);
+  virtual void FinishTaskOutput();
+  virtual void Terminate(Option_t *) {}
+
+  AliAnalysisWagonProfiler *GetProfiler() const { return fProfiler; }
+  Int_t GetIndex() const { return fIndex; }
+
+private:
+  AliAnalysisWagonProbe(const AliAnalysisWagonProbe &);
+  AliAnalysisWagonProbe &operator=(const AliAnalysisWagonProbe &);
+
+  AliAnalysisWagonProfiler *fProfiler;  ///< Profiler collecting the measurements
+  Int_t                     fIndex;     ///< Index of the wagon following the probe (number of wagons for the last probe)
+
+  ClassDef(AliAnalysisWagonProbe, 1);
+};
+
+/**
+ * \class AliAnalysisWagonProfiler
+ * \brief Per-wagon CPU, time and memory profile of an analysis train
+ *
+ * Instrument() places a probe task before each top task (wagon) of the analysis
+ * manager and one after the last, in all the lists the manager runs the tasks from.
+ * The time between two probes is the time spent in the wagon in between,
+ * including the event selection done by AliAnalysisTaskSE::Exec around UserExec.
+ * Measured per wagon:
+ *  - wall and CPU time per event, and in FinishTaskOutput
+ *  - growth of the resident memory and of the heap in use (glibc only) in the
+ *    first event, where the wagons do their lazy initialisation, and separately
+ *    summed over one event every SetMemorySampling() events after it, with the
+ *    largest step; the sum is not extrapolated to the unsampled events
+ *  - optionally (SetMeasureOutputSize()) the streamed size of the output objects
+ *    at the end of the job; each object is streamed into a temporary buffer, which
+ *    briefly needs as much memory as the largest output object
+ *
+ * At the end of the job (FinishTaskOutput of the last probe) a summary table is
+ * printed and the same numbers are written as JSON to SetOutputFileName().
+ * Without Instrument() nothing is added to the train; the per-event cost once
+ * instrumented is two clock readings per wagon, plus the memory readings on
+ * the sampled events.
+ *
+ * Usage, after all the other AddTask macros:
+ *   `AliAnalysisWagonProfiler *prof = AliAnalysisWagonProfiler::Instrument();`
+ *   `prof->SetMemorySampling(100);`
+ */
+class AliAnalysisWagonProfiler : public TNamed {
+public:
+  AliAnalysisWagonProfiler();
+  AliAnalysisWagonProfiler(const char *name);
+  virtual ~AliAnalysisWagonProfiler() {}
+
+  static AliAnalysisWagonProfiler *Instrument(AliAnalysisManager *mgr = 0, const char *name = "WagonProfiler");
+
+  void SetActive(Bool_t active = kTRUE) { fActive = active; }
+  void SetMemorySampling(Int_t nEvents) { fMemorySampling = nEvents; }
+  void SetOutputFileName(const char *name) { fOutputFileName = name; }
+  void SetMeasureOutputSize(Bool_t measure = kTRUE) { fMeasureOutputSize = measure; }
+
+  Bool_t      IsActive() const { return fActive; }
+  Int_t       GetNWagons() const { return fWagons.GetEntriesFast(); }
+  const char *GetOutputFileName() const { return fOutputFileName.Data(); }
+
+  void MarkExec(Int_t probe);
+  void MarkFinish(Int_t probe);
+  void Report();
+  virtual void Print(Option_t *option = "") const;
+
+private:
+  AliAnalysisWagonProfiler(const AliAnalysisWagonProfiler &);
+  AliAnalysisWagonProfiler &operator=(const AliAnalysisWagonProfiler &);
+
+  /// Clocks and memory at one probe
+  struct Snapshot {
+    Double_t fWall;       ///< Wall time [s]
+    Double_t fCPU;        ///< CPU time of the process [s]
+    Long64_t fResident;   ///< Resident memory [bytes], -1 if not read
+    Long64_t fHeap;       ///< Heap in use [bytes], -1 if not read or not available
+  };
+
+  /// Accumulated measurements of one wagon
+  struct WagonStats {
+    WagonStats();
+    Long64_t fNExec;              ///< Number of events
+    Double_t fWall;               ///< Wall time in Exec [s]
+    Double_t fCPU;                ///< CPU time in Exec [s]
+    Double_t fMaxWall;            ///< Slowest event [s]
+    Double_t fFinishWall;         ///< Wall time in FinishTaskOutput [s]
+    Double_t fFinishCPU;          ///< CPU time in FinishTaskOutput [s]
+    Long64_t fFirstResidentGrowth; ///< Resident memory growth in the first event [bytes]
+    Long64_t fFirstHeapGrowth;    ///< Heap growth in the first event [bytes]
+    Long64_t fNSampled;           ///< Number of events with memory readings, the first event excluded
+    Long64_t fResidentGrowth;     ///< Resident memory growth summed over the sampled events [bytes]
+    Long64_t fMaxResidentGrowth;  ///< Largest resident memory growth in one sampled event [bytes]
+    Long64_t fHeapGrowth;         ///< Heap growth summed over the sampled events [bytes]
+    Long64_t fMaxHeapGrowth;      ///< Largest heap growth in one sampled event [bytes]
+    Long64_t fOutputBytes;        ///< Streamed size of the output objects [bytes], -1 if not measured
+  };
+
+  void TakeSnapshot(Snapshot &snapshot, Bool_t memory) const;
+  void ResetStats();
+  static Long64_t OutputSize(AliAnalysisTask *task);
+  static void InsertProbes(TObjArray *list, const TObjArray &wagons, const TObjArray &probes);
+  static TString JSONString(const char *text);
+
+  TObjArray       fWagons;          ///< Profiled wagons, in execution order (not owned)
+  TObjArray       fProbes;          ///< Probes, fProbes[i] runs before fWagons[i], the last one after all wagons (not owned)
+  Bool_t          fActive;          ///< Switch for the measurements
+  Int_t           fMemorySampling;  ///< Read the memory every that many events, 0 to never read it
+  TString         fOutputFileName;  ///< Name of the JSON file written at the end of the job
+  Bool_t          fMeasureOutputSize; ///< Stream the output objects at the end of the job to measure their size
+
+  std::vector<WagonStats> fStats;        //!<! Measurements, one entry per wagon
+  Snapshot        fLast;                 //!<! Snapshot at the last probe
+  Int_t           fLastProbe;            //!<! Index of the last probe in Exec, -1 if none
+  Int_t           fLastFinishProbe;      //!<! Index of the last probe in FinishTaskOutput, -1 if none
+  Bool_t          fSampleEvent;          //!<! Memory is read in the current event
+  Long64_t        fNEvents;              //!<! Number of events seen
+  Bool_t          fReported;             //!<! Report already done
+
+  ClassDef(AliAnalysisWagonProfiler, 2);
+};
+
+#endif /* ALIANALYSISWAGONPROFILER_H */
@@ -25,6 +25,7 @@
 #include "AliUEHistograms.h"
 
 #include "AliCFContainer.h"
+#include "AliTHn.h"
 #include "AliBasicParticle.h"
 #include "AliVParticle.h"
 #include "AliAODTrack.h"
@@ -36,6 +37,12 @@
 #include "TH3F.h"
 #include "TMath.h"
 #include "TLorentzVector.h"
+#include "THnSparse.h"
+#include "TArray.h"
+
+#include <algorithm>
+#include <complex>
+#include <vector>
 
 ClassImp(AliUEHistograms)
 
@@ -85,6 +92,8 @@ AliUEHistograms::AliUEHistograms(const char* name, const char* histograms, const
   fPtOrder(kTRUE),
   fTwoTrackCutMinRadius(0.8),
   fCheckEventNumberInCorrelation(kFALSE),
+  fBinnedCorrelations(kFALSE),
+  fBinnedOversampling(4),
   fRunNumber(0),
   fMergeCount(1)
 {
@@ -266,6 +275,8 @@ AliUEHistograms::AliUEHistograms(const AliUEHistograms &c) :
   fPtOrder(kTRUE),
   fTwoTrackCutMinRadius(0.8),
   fCheckEventNumberInCorrelation(kFALSE),
+  fBinnedCorrelations(kFALSE),
+  fBinnedOversampling(4),
   fRunNumber(0),
   fMergeCount(1)
 {
@@ -634,6 +645,16 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       }
     }
     
+    // binned mode: only possible if no pair-level cut is requested
+    Bool_t binned = kFALSE;
+    if (fBinnedCorrelations && !twoTrackEfficiencyCut && fSelectCharge == 0 && !fEtaOrdering && fRejectResonanceDaughters <= 0 && !fCheckEventNumberInCorrelation &&
+        fCutConversionsV <= 0 && fCutK0sV <= 0 && fCutLambdaV <= 0 && fCutPhiV <= 0 && fCutRhoV <= 0 && fCutCustomMass <= 0)
+      binned = FillCorrelationsBinned(centrality, zVtx, step, particles, mixed, weight, applyEfficiency, triggerWeighting);
+    
+    // the correlations are filled already, the loop below then only fills the trigger particles
+    if (binned)
+      jMax = 0;
+    
     // identify K, Lambda candidates and flag those particles
     // a TObject bit is used for this
     const UInt_t kResonanceDaughterFlag = 1 << 14;
@@ -1082,6 +1103,542 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
   fCentralityCorrelation->Fill(centrality, particles->GetEntriesFast());
   FillEvent(centrality, step);
 }
+
+//____________________________________________________________________
+namespace
+{
+  // helpers for AliUEHistograms::FillCorrelationsBinned
+  
+  typedef std::complex<Double_t> Complex;
+  
+  struct BinnedParticle
+  {
+    Int_t fPtBin;     // pT bin in the track histogram
+    Int_t fIndex;     // index in the input array
+    Int_t fEtaCell;   // cell in eta
+    Int_t fPhiCell;   // cell in phi
+    Float_t fEta;
+    Double_t fPhi;
+    Double_t fPt;
+    Double_t fWeight; // weight of this particle in the pair weight
+  };
+  
+  Bool_t LessPtBin(const BinnedParticle& a, const BinnedParticle& b) { return a.fPtBin < b.fPtBin; }
+  
+  Bool_t IsUniform(const TAxis* axis)
+  {
+    // the default delta phi binnings are given with 6 digits, their bin widths differ by 1e-5 relative
+    const Double_t width = axis->GetBinWidth(1);
+    for (Int_t i=2; i<=axis->GetNbins(); i++)
+      if (TMath::Abs(axis->GetBinWidth(i) - width) > 1e-4 * width)
+        return kFALSE;
+    return kTRUE;
+  }
+  
+  Int_t SmoothFFTSize(Int_t n)
+  {
+    // smallest size >= n which only has the factors 2, 3 and 5
+    for (Int_t size = (n > 1) ? n : 1; ; size++)
+    {
+      Int_t rest = size;
+      while (rest % 2 == 0) rest /= 2;
+      while (rest % 3 == 0) rest /= 3;
+      while (rest % 5 == 0) rest /= 5;
+      if (rest == 1)
+        return size;
+    }
+  }
+  
+  void FillTwiddle(std::vector<Complex>& twiddle, Int_t n)
+  {
+    twiddle.resize(n);
+    for (Int_t i=0; i<n; i++)
+      twiddle[i] = std::polar(1.0, -TMath::TwoPi() * i / n);
+  }
+  
+  void FFT1D(const Complex* in, Int_t stride, Complex* out, Int_t n, const Complex* twiddle, Int_t twiddleStep)
+  {
+    // mixed radix FFT (decimation in time) of the n values in[0], in[stride], ... into out[0..n-1]
+    // twiddle[i * twiddleStep] = exp(-2 pi i / n); other prime factors than 2, 3, 5 fall back to a plain DFT
+    if (n == 1)
+    {
+      out[0] = in[0];
+      return;
+    }
+    
+    Int_t p = n;
+    if (n % 2 == 0)
+      p = 2;
+    else if (n % 3 == 0)
+      p = 3;
+    else if (n % 5 == 0)
+      p = 5;
+    const Int_t m = n / p;
+    
+    for (Int_t r=0; r<p; r++)
+      FFT1D(in + r * stride, stride * p, out + r * m, m, twiddle, twiddleStep * p);
+    
+    std::vector<Complex> tmp(p);
+    for (Int_t k=0; k<m; k++)
+    {
+      for (Int_t r=0; r<p; r++)
+        tmp[r] = out[r * m + k] * twiddle[r * k * twiddleStep];
+      for (Int_t q=0; q<p; q++)
+      {
+        Complex sum = tmp[0];
+        for (Int_t r=1; r<p; r++)
+          sum += tmp[r] * twiddle[((r * q * m) % n) * twiddleStep];
+        out[k + q * m] = sum;
+      }
+    }
+  }
+  
+  void FFT2D(Complex* data, Int_t nRows, Int_t nCols, Int_t nFilledRows, const std::vector<Complex>& rowTwiddle, const std::vector<Complex>& colTwiddle, std::vector<Complex>& buffer)
+  {
+    // in-place forward FFT of a row-major nRows x nCols array of which only the first nFilledRows rows are non-0
+    for (Int_t i=0; i<nFilledRows; i++)
+    {
+      FFT1D(data + i * nCols, 1, &buffer[0], nCols, &rowTwiddle[0], 1);
+      std::copy(buffer.begin(), buffer.begin() + nCols, data + i * nCols);
+    }
+    for (Int_t j=0; j<nCols; j++)
+    {
+      FFT1D(data + j, nCols, &buffer[0], nRows, &colTwiddle[0], 1);
+      for (Int_t i=0; i<nRows; i++)
+        data[i * nCols + j] = buffer[i];
+    }
+  }
+  
+  void FillWithSumw2(AliCFContainer* container, const Double_t* vars, Int_t step, Double_t value, Double_t sumw2)
+  {
+    // fills value into the bin of vars as one entry, but with sumw2 instead of value^2 added to the sum of the squared weights
+    container->Fill(vars, step, value);
+    
+    const Double_t correction = sumw2 - value * value;
+    if (correction == 0)
+      return;
+    
+    AliTHnBase* thn = dynamic_cast<AliTHnBase*> (container);
+    if (thn)
+    {
+      // without sumw2 array only weights 1 have been filled so far, a fill with weight 0 creates it
+      if (!thn->GetSumw2(step))
+        thn->Fill(vars, step, 0);
+      
+      // global bin index of AliTHn: no under/overflow bins, the bins of vars are in range
+      Long64_t bin = 0;
+      for (Int_t i=0; i<container->GetNVar(); i++)
+        bin = bin * container->GetNBins(i) + container->GetAxis(i, 0)->FindBin(vars[i]) - 1;
+      TArray* array = thn->GetSumw2(step);
+      array->SetAt(array->GetAt(bin) + correction, bin);
+    }
+    else
+    {
+      THnSparse* grid = container->GetGrid(step)->GetGrid();
+      if (!grid->GetCalculateErrors())
+        return;
+      Long64_t bin = grid->GetBin(vars, kFALSE);
+      if (bin >= 0)
+        grid->SetBinError2(bin, grid->GetBinError2(bin) + correction);
+    }
+  }
+}
+
+//____________________________________________________________________
+Bool_t AliUEHistograms::FillCorrelationsBinned(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, TObjArray* particles, TObjArray* mixed, Float_t weight, Bool_t applyEfficiency, TH1* triggerWeighting)
+{
+  // fills the correlations of FillCorrelations from binned (eta, phi) densities instead of the explicit pair loop
+  //
+  // trigger and associated particles are filled into (eta, phi) grids, per trigger pT and associated pT bin of the track histogram
+  // (centrality and zVtx are fixed within an event). The delta eta, delta phi distribution of a pair of pT bins is then the
+  // cross-correlation of the two grids (circular in phi, zero-padded in eta) which is calculated with FFTs.
+  // The grids have fBinnedOversampling cells per delta eta and delta phi bin. The binning smears delta eta and delta phi by up to one cell,
+  // a lag which coincides with a bin edge is shared equally between the two bins.
+  // The weights of the pairs factorize into trigger and associated weights (efficiency, fWeightPerEvent, pT for weight < 0).
+  //
+  // with fPtOrder, pT bin pairs where pT,a < pT,t does not hold or fail for all pairs are filled with the pair loop
+  // sumw2 receives the sum of the squared pair weights (correlation of the grids of the squared weights), as in the pair loop
+  //
+  // the result is not bin-identical to the pair loop: the lag of a pair differs from its delta eta (delta phi) by less than 1.25 cells,
+  // therefore only pairs which lie within 1.25 cells of a bin edge can be filled into the neighbouring bin instead; the total
+  // is unchanged as long as the delta eta axis covers all pairs with a margin of 1.25 cells. See PWGCF/Correlations/macros/dphicorrelations/testBinnedCorrelations.C
+  //
+  // returns kFALSE if the binning does not allow this mode, then the pair loop of FillCorrelations is used
+  
+  AliCFContainer* trackHist = fNumberDensityPhi->GetTrackHist(AliUEHist::kToward);
+  TAxis* axisDeltaEta = trackHist->GetAxis(0, 0);
+  TAxis* axisPtAssoc = trackHist->GetAxis(1, 0);
+  TAxis* axisPtTrig = trackHist->GetAxis(2, 0);
+  TAxis* axisDeltaPhi = trackHist->GetAxis(4, 0);
+  
+  if (!IsUniform(axisDeltaEta) || !IsUniform(axisDeltaPhi) || TMath::Abs(axisDeltaPhi->GetXmax() - axisDeltaPhi->GetXmin() - TMath::TwoPi()) > 1e-4)
+  {
+    AliWarning("Binned correlations need uniform delta eta and delta phi axes covering 2 pi in delta phi. Switching back to the pair loop.");
+    fBinnedCorrelations = kFALSE;
+    return kFALSE;
+  }
+  
+  // selection and weights of triggers and associated particles, as in the pair loop
+  std::vector<BinnedParticle> triggers;
+  std::vector<BinnedParticle> associated;
+  
+  for (Int_t i=0; i<particles->GetEntriesFast(); i++)
+  {
+    AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
+    
+    BinnedParticle entry;
+    entry.fEta = triggerParticle->Eta();
+    
+    if (fTriggerRestrictEta > 0 && TMath::Abs(entry.fEta) > fTriggerRestrictEta)
+      continue;
+    if (fOnlyOneEtaSide != 0 && fOnlyOneEtaSide * entry.fEta < 0)
+      continue;
+    if (fTriggerSelectCharge != 0 && triggerParticle->Charge() * fTriggerSelectCharge < 0)
+      continue;
+    
+    entry.fPt = triggerParticle->Pt();
+    entry.fPtBin = axisPtTrig->FindBin(entry.fPt);
+    // under/overflow is not filled by AliTHn
+    if (entry.fPtBin < 1 || entry.fPtBin > axisPtTrig->GetNbins())
+      continue;
+    
+    entry.fIndex = i;
+    entry.fPhi = triggerParticle->Phi();
+    entry.fWeight = 1;
+    if (applyEfficiency && fEfficiencyCorrectionTriggers)
+    {
+      Int_t effVars[4];
+      effVars[0] = fEfficiencyCorrectionTriggers->GetAxis(0)->FindBin(entry.fEta);
+      effVars[1] = fEfficiencyCorrectionTriggers->GetAxis(1)->FindBin(entry.fPt);
+      effVars[2] = fEfficiencyCorrectionTriggers->GetAxis(2)->FindBin(centrality);
+      effVars[3] = fEfficiencyCorrectionTriggers->GetAxis(3)->FindBin(zVtx);
+      entry.fWeight *= fEfficiencyCorrectionTriggers->GetBinContent(effVars);
+    }
+    if (fWeightPerEvent)
+      entry.fWeight /= triggerWeighting->GetBinContent(triggerWeighting->GetXaxis()->FindBin(entry.fPt));
+    
+    triggers.push_back(entry);
+  }
+  
+  TObjArray* input = (mixed) ? mixed : particles;
+  for (Int_t j=0; j<input->GetEntriesFast(); j++)
+  {
+    AliVParticle* particle = (AliVParticle*) input->UncheckedAt(j);
+    
+    BinnedParticle entry;
+    entry.fEta = particle->Eta();
+    
+    if (fAssociatedSelectCharge != 0 && particle->Charge() * fAssociatedSelectCharge < 0)
+      continue;
+    if (fOnlyOneAssocEtaSide != 0 && fOnlyOneAssocEtaSide * entry.fEta < 0)
+      continue;
+    
+    entry.fPt = particle->Pt();
+    entry.fPtBin = axisPtAssoc->FindBin(entry.fPt);
+    if (entry.fPtBin < 1 || entry.fPtBin > axisPtAssoc->GetNbins())
+      continue;
+    
+    entry.fIndex = j;
+    entry.fPhi = particle->Phi();
+    entry.fWeight = (weight < 0) ? entry.fPt : weight;
+    if (applyEfficiency && fEfficiencyCorrectionAssociated)
+    {
+      Int_t effVars[4];
+      effVars[0] = fEfficiencyCorrectionAssociated->GetAxis(0)->FindBin(entry.fEta);
+      effVars[1] = fEfficiencyCorrectionAssociated->GetAxis(1)->FindBin(entry.fPt);
+      effVars[2] = fEfficiencyCorrectionAssociated->GetAxis(2)->FindBin(centrality);
+      effVars[3] = fEfficiencyCorrectionAssociated->GetAxis(3)->FindBin(zVtx);
+      entry.fWeight *= fEfficiencyCorrectionAssociated->GetBinContent(effVars);
+    }
+    
+    associated.push_back(entry);
+  }
+  
+  if (triggers.size() == 0 || associated.size() == 0)
+    return kTRUE;
+  
+  // grid: fBinnedOversampling cells per bin; in eta it covers the particles of this event, the FFT size is padded to avoid wrap-around
+  const Int_t oversampling = (fBinnedOversampling > 0) ? fBinnedOversampling : 1;
+  const Int_t nBinsEta = axisDeltaEta->GetNbins();
+  const Int_t nBinsPhi = axisDeltaPhi->GetNbins();
+  const Double_t cellEta = axisDeltaEta->GetBinWidth(1) / oversampling;
+  const Int_t nCols = nBinsPhi * oversampling;
+  const Double_t cellPhi = TMath::TwoPi() / nCols;
+  
+  Float_t etaMin = triggers[0].fEta;
+  Float_t etaMax = triggers[0].fEta;
+  for (UInt_t i=0; i<triggers.size(); i++)
+  {
+    etaMin = TMath::Min(etaMin, triggers[i].fEta);
+    etaMax = TMath::Max(etaMax, triggers[i].fEta);
+  }
+  for (UInt_t j=0; j<associated.size(); j++)
+  {
+    etaMin = TMath::Min(etaMin, associated[j].fEta);
+    etaMax = TMath::Max(etaMax, associated[j].fEta);
+  }
+  const Int_t nCellsEta = Int_t((etaMax - etaMin) / cellEta) + 1;
+  const Int_t nRows = SmoothFFTSize(2 * nCellsEta - 1);
+  const Int_t gridSize = nRows * nCols;
+  
+  for (Int_t list=0; list<2; list++)
+  {
+    std::vector<BinnedParticle>& entries = (list == 0) ? triggers : associated;
+    for (UInt_t i=0; i<entries.size(); i++)
+    {
+      entries[i].fEtaCell = TMath::Min(Int_t((entries[i].fEta - etaMin) / cellEta), nCellsEta - 1);
+      Double_t phi = entries[i].fPhi - TMath::TwoPi() * TMath::Floor(entries[i].fPhi / TMath::TwoPi());
+      entries[i].fPhiCell = TMath::Min(Int_t(phi / cellPhi), nCols - 1);
+    }
+    // group by pT bin keeping the input order within a bin
+    std::stable_sort(entries.begin(), entries.end(), LessPtBin);
+  }
+  
+  // delta eta and delta phi bins of the lags; each lag is split in two halves at +- 1/4 cell
+  std::vector<Int_t> lagBinEta(2 * nRows, 0);
+  for (Int_t row=0; row<nRows; row++)
+  {
+    Int_t lag = (row < nCellsEta) ? row : row - nRows;
+    if (lag <= -nCellsEta)
+      continue;
+    for (Int_t half=0; half<2; half++)
+    {
+      Int_t bin = axisDeltaEta->FindBin((lag + ((half == 0) ? -0.25 : 0.25)) * cellEta);
+      if (bin >= 1 && bin <= nBinsEta)
+        lagBinEta[2 * row + half] = bin;
+    }
+  }
+  std::vector<Int_t> lagBinPhi(2 * nCols, 0);
+  for (Int_t col=0; col<nCols; col++)
+  {
+    for (Int_t half=0; half<2; half++)
+    {
+      Double_t deltaPhi = (col + ((half == 0) ? -0.25 : 0.25)) * cellPhi;
+      if (deltaPhi > 1.5 * TMath::Pi())
+        deltaPhi -= TMath::TwoPi();
+      if (deltaPhi < -0.5 * TMath::Pi())
+        deltaPhi += TMath::TwoPi();
+      Int_t bin = axisDeltaPhi->FindBin(deltaPhi);
+      if (bin >= 1 && bin <= nBinsPhi)
+        lagBinPhi[2 * col + half] = bin;
+    }
+  }
+  
+  // ranges of the pT bins in the sorted lists
+  const Int_t nPtTrig = axisPtTrig->GetNbins();
+  const Int_t nPtAssoc = axisPtAssoc->GetNbins();
+  std::vector<Int_t> firstTrigger(nPtTrig + 2, triggers.size());
+  std::vector<Int_t> firstAssociated(nPtAssoc + 2, associated.size());
+  for (Int_t i=triggers.size()-1; i>=0; i--)
+    firstTrigger[triggers[i].fPtBin] = i;
+  for (Int_t j=associated.size()-1; j>=0; j--)
+    firstAssociated[associated[j].fPtBin] = j;
+  for (Int_t bin=nPtTrig; bin>=1; bin--)
+    if (firstTrigger[bin] > firstTrigger[bin+1])
+      firstTrigger[bin] = firstTrigger[bin+1];
+  for (Int_t bin=nPtAssoc; bin>=1; bin--)
+    if (firstAssociated[bin] > firstAssociated[bin+1])
+      firstAssociated[bin] = firstAssociated[bin+1];
+  
+  // pairs which are excluded in the pair loop: the particle itself (same event), IsEqual (mixed event)
+  // IsEqual is either the identity (TObject) or compares the unique ID (AliBasicParticle), candidates are found by the unique ID
+  std::vector<std::pair<UInt_t, Int_t> > associatedIDs;
+  std::vector<Int_t> associatedOf;
+  if (mixed)
+  {
+    for (UInt_t j=0; j<associated.size(); j++)
+      associatedIDs.push_back(std::make_pair(input->UncheckedAt(associated[j].fIndex)->GetUniqueID(), (Int_t) j));
+    std::sort(associatedIDs.begin(), associatedIDs.end());
+  }
+  else
+  {
+    associatedOf.assign(particles->GetEntriesFast(), -1);
+    for (UInt_t j=0; j<associated.size(); j++)
+      associatedOf[associated[j].fIndex] = j;
+  }
+  
+  // FFT of the grids of each pT bin; the second set of grids holds the squared weights, whose correlation is the sum of the squared
+  // pair weights (sumw2). It is only needed if not all weights are 1, otherwise it is the same as the correlation of the weights.
+  Bool_t unitWeights = kTRUE;
+  for (UInt_t i=0; i<triggers.size(); i++)
+    if (triggers[i].fWeight != 1)
+      unitWeights = kFALSE;
+  for (UInt_t j=0; j<associated.size(); j++)
+    if (associated[j].fWeight != 1)
+      unitWeights = kFALSE;
+  const Int_t nPowers = (unitWeights) ? 1 : 2;
+  
+  std::vector<Complex> rowTwiddle;
+  std::vector<Complex> colTwiddle;
+  FillTwiddle(rowTwiddle, nCols);
+  FillTwiddle(colTwiddle, nRows);
+  std::vector<Complex> buffer(TMath::Max(nRows, nCols));
+  
+  std::vector<std::vector<Complex> > triggerGrid[2];
+  std::vector<std::vector<Complex> > associatedGrid[2];
+  std::vector<Double_t> triggerSum[2];
+  std::vector<Double_t> associatedSum[2];
+  for (Int_t power=0; power<nPowers; power++)
+  {
+    triggerGrid[power].resize(nPtTrig + 1);
+    associatedGrid[power].resize(nPtAssoc + 1);
+    triggerSum[power].assign(nPtTrig + 1, 0);
+    associatedSum[power].assign(nPtAssoc + 1, 0);
+    for (Int_t list=0; list<2; list++)
+    {
+      std::vector<BinnedParticle>& entries = (list == 0) ? triggers : associated;
+      std::vector<std::vector<Complex> >& grids = (list == 0) ? triggerGrid[power] : associatedGrid[power];
+      std::vector<Double_t>& sums = (list == 0) ? triggerSum[power] : associatedSum[power];
+      for (UInt_t i=0; i<entries.size(); i++)
+      {
+        std::vector<Complex>& grid = grids[entries[i].fPtBin];
+        if (grid.size() == 0)
+          grid.assign(gridSize, Complex(0, 0));
+        Double_t particleWeight = (power == 0) ? entries[i].fWeight : entries[i].fWeight * entries[i].fWeight;
+        grid[entries[i].fEtaCell * nCols + entries[i].fPhiCell] += particleWeight;
+        sums[entries[i].fPtBin] += TMath::Abs(particleWeight);
+      }
+      for (UInt_t bin=0; bin<grids.size(); bin++)
+        if (grids[bin].size() > 0)
+          FFT2D(&grids[bin][0], nRows, nCols, nCellsEta, rowTwiddle, colTwiddle, buffer);
+    }
+  }
+  
+  std::vector<Complex> product(gridSize);
+  std::vector<Double_t> target[2];
+  for (Int_t power=0; power<nPowers; power++)
+    target[power].resize((nBinsEta + 1) * (nBinsPhi + 1));
+  Double_t vars[6];
+  vars[3] = centrality;
+  vars[5] = zVtx;
+  
+  for (Int_t ptTrig=1; ptTrig<=nPtTrig; ptTrig++)
+  {
+    if (triggerGrid[0][ptTrig].size() == 0)
+      continue;
+    
+    for (Int_t ptAssoc=1; ptAssoc<=nPtAssoc; ptAssoc++)
+    {
+      if (associatedGrid[0][ptAssoc].size() == 0)
+        continue;
+      
+      if (fPtOrder)
+      {
+        // pT,a < pT,t fails for all pairs
+        if (axisPtAssoc->GetBinLowEdge(ptAssoc) >= axisPtTrig->GetBinUpEdge(ptTrig))
+          continue;
+        
+        // overlapping bins: pair loop
+        if (axisPtAssoc->GetBinUpEdge(ptAssoc) > axisPtTrig->GetBinLowEdge(ptTrig))
+        {
+          for (Int_t i=firstTrigger[ptTrig]; i<firstTrigger[ptTrig+1]; i++)
+          {
+            const BinnedParticle& trigger = triggers[i];
+            for (Int_t j=firstAssociated[ptAssoc]; j<firstAssociated[ptAssoc+1]; j++)
+            {
+              const BinnedParticle& assoc = associated[j];
+              if (assoc.fPt >= trigger.fPt)
+                continue;
+              if (!mixed && trigger.fIndex == assoc.fIndex)
+                continue;
+              if (mixed && particles->UncheckedAt(trigger.fIndex)->IsEqual(mixed->UncheckedAt(assoc.fIndex)))
+                continue;
+              
+              vars[0] = trigger.fEta - assoc.fEta;
+              vars[1] = assoc.fPt;
+              vars[2] = trigger.fPt;
+              vars[4] = trigger.fPhi - assoc.fPhi;
+              if (vars[4] > 1.5 * TMath::Pi()) 
+                vars[4] -= TMath::TwoPi();
+              if (vars[4] < -0.5 * TMath::Pi())
+                vars[4] += TMath::TwoPi();
+              
+              trackHist->Fill(vars, step, trigger.fWeight * assoc.fWeight);
+            }
+          }
+          continue;
+        }
+      }
+      
+      for (Int_t power=0; power<nPowers; power++)
+      {
+        // correlation = IFFT(FFT(trigger) * conj(FFT(assoc))), the inverse done as conj(FFT(conj(...)))
+        const std::vector<Complex>& triggerFFT = triggerGrid[power][ptTrig];
+        const std::vector<Complex>& associatedFFT = associatedGrid[power][ptAssoc];
+        for (Int_t k=0; k<gridSize; k++)
+          product[k] = std::conj(triggerFFT[k] * std::conj(associatedFFT[k]));
+        FFT2D(&product[0], nRows, nCols, nRows, rowTwiddle, colTwiddle, buffer);
+        
+        // remove the excluded pairs
+        for (Int_t i=firstTrigger[ptTrig]; i<firstTrigger[ptTrig+1]; i++)
+        {
+          const BinnedParticle& trigger = triggers[i];
+          if (!mixed)
+          {
+            Int_t j = associatedOf[trigger.fIndex];
+            if (j >= 0 && associated[j].fPtBin == ptAssoc)
+              product[0] -= TMath::Power(trigger.fWeight * associated[j].fWeight, power + 1) * gridSize;
+            continue;
+          }
+          
+          TObject* triggerParticle = particles->UncheckedAt(trigger.fIndex);
+          std::vector<std::pair<UInt_t, Int_t> >::const_iterator it = std::lower_bound(associatedIDs.begin(), associatedIDs.end(), std::make_pair(triggerParticle->GetUniqueID(), -1));
+          for (; it != associatedIDs.end() && it->first == triggerParticle->GetUniqueID(); ++it)
+          {
+            const BinnedParticle& assoc = associated[it->second];
+            if (assoc.fPtBin != ptAssoc || !triggerParticle->IsEqual(mixed->UncheckedAt(assoc.fIndex)))
+              continue;
+            Int_t row = (trigger.fEtaCell - assoc.fEtaCell + nRows) % nRows;
+            Int_t col = (trigger.fPhiCell - assoc.fPhiCell + nCols) % nCols;
+            product[row * nCols + col] -= TMath::Power(trigger.fWeight * assoc.fWeight, power + 1) * gridSize;
+          }
+        }
+        
+        // sum the lags into the delta eta, delta phi bins; values at the level of the FFT round-off are dropped
+        // the pairs of a lag which is split between bins are shared between them, for the contents and for sumw2
+        const Double_t threshold = 1e-9 * triggerSum[power][ptTrig] * associatedSum[power][ptAssoc];
+        std::fill(target[power].begin(), target[power].end(), 0.);
+        for (Int_t row=0; row<nRows; row++)
+        {
+          if (lagBinEta[2 * row] == 0 && lagBinEta[2 * row + 1] == 0)
+            continue;
+          for (Int_t col=0; col<nCols; col++)
+          {
+            Double_t value = product[row * nCols + col].real() / gridSize;
+            if (TMath::Abs(value) <= threshold)
+              continue;
+            for (Int_t halfEta=0; halfEta<2; halfEta++)
+              for (Int_t halfPhi=0; halfPhi<2; halfPhi++)
+              {
+                Int_t binEta = lagBinEta[2 * row + halfEta];
+                Int_t binPhi = lagBinPhi[2 * col + halfPhi];
+                if (binEta > 0 && binPhi > 0)
+                  target[power][binEta * (nBinsPhi + 1) + binPhi] += 0.25 * value;
+              }
+          }
+        }
+      }
+      
+      const Double_t threshold = 1e-9 * triggerSum[0][ptTrig] * associatedSum[0][ptAssoc];
+      vars[1] = axisPtAssoc->GetBinCenter(ptAssoc);
+      vars[2] = axisPtTrig->GetBinCenter(ptTrig);
+      for (Int_t binEta=1; binEta<=nBinsEta; binEta++)
+      {
+        vars[0] = axisDeltaEta->GetBinCenter(binEta);
+        for (Int_t binPhi=1; binPhi<=nBinsPhi; binPhi++)
+        {
+          Double_t value = target[0][binEta * (nBinsPhi + 1) + binPhi];
+          if (TMath::Abs(value) <= threshold)
+            continue;
+          vars[4] = axisDeltaPhi->GetBinCenter(binPhi);
+          FillWithSumw2(trackHist, vars, step, value, target[nPowers - 1][binEta * (nBinsPhi + 1) + binPhi]);
+        }
+      }
+    }
+  }
+  
+  return kTRUE;
+}
   
 //____________________________________________________________________
 void AliUEHistograms::FillTrackingEfficiency(TObjArray* mc, TObjArray* recoPrim, TObjArray* recoAll, TObjArray* recoPrimPID, TObjArray* recoAllPID, TObjArray* fake, Int_t particleType, Double_t centrality, Double_t zVtx)
@@ -1374,6 +1931,8 @@ void AliUEHistograms::Copy(TObject& c) const
   target.fPtOrder = fPtOrder;
   target.fTwoTrackCutMinRadius = fTwoTrackCutMinRadius;
   target.fCheckEventNumberInCorrelation = fCheckEventNumberInCorrelation;
+  target.fBinnedCorrelations = fBinnedCorrelations;
+  target.fBinnedOversampling = fBinnedOversampling;
 }
 
 //____________________________________________________________________
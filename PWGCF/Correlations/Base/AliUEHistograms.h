@@ -16,6 +16,7 @@
 class AliVParticle;
 
 class TList;
+class TH1;
 class TSeqCollection;
 class TObjArray;
 class TH1F;
@@ -106,6 +107,7 @@ class AliUEHistograms : public TNamed
   void SetTwoTrackCutMinRadius(Float_t min) { fTwoTrackCutMinRadius = min; }
 
   void SetCheckEventNumberInCorrelation(Bool_t val) { fCheckEventNumberInCorrelation = val; }
+  void SetBinnedCorrelations(Bool_t flag, Int_t oversampling = 4) { fBinnedCorrelations = flag; fBinnedOversampling = oversampling; }
   void ExtendTrackingEfficiency(Bool_t verbose = kFALSE);
   void Reset();
 
@@ -118,6 +120,7 @@ class AliUEHistograms : public TNamed
   
 protected:
   void FillRegion(AliUEHist::Region region, Float_t zVtx, AliUEHist::CFStep step, AliVParticle* leading, TList* list, Int_t multiplicity);
+  Bool_t FillCorrelationsBinned(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, TObjArray* particles, TObjArray* mixed, Float_t weight, Bool_t applyEfficiency, TH1* triggerWeighting);
   Int_t CountParticles(TList* list, Float_t ptMin);
   void DeleteContainers();
   inline Float_t GetInvMassSquared(Float_t pt1, Float_t eta1, Float_t phi1, Float_t pt2, Float_t eta2, Float_t phi2, Float_t m0_1, Float_t m0_2);
@@ -178,11 +181,14 @@ protected:
 
   Bool_t fCheckEventNumberInCorrelation; // do not correlate two particles from the same event (only works for AliBasicParticles)
 
+  Bool_t fBinnedCorrelations;    // fill correlations from binned (eta, phi) densities instead of the pair loop if no pair cut is requested, see FillCorrelationsBinned
+  Int_t fBinnedOversampling;     // number of grid cells per delta eta and delta phi bin in the binned mode
+
   Long64_t fRunNumber;           // run number that has been processed
   
   Int_t fMergeCount;		// counts how many objects have been merged together
   
-  ClassDef(AliUEHistograms, 33)  // underlying event histogram container
+  ClassDef(AliUEHistograms, 34)  // underlying event histogram container
 };
 
 Float_t AliUEHistograms::GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign)
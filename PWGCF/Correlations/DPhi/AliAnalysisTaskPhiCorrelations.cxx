@@ -197,6 +197,8 @@ fFillCorrelationsRapidity(kFALSE),
 fUseDoublePrecision(kFALSE),
 fUseNewCentralityFramework(kFALSE),
 fFillpT(kFALSE),
+fBinnedCorrelations(kFALSE),
+fBinnedOversampling(4),
 fJetBranchName("clustersAOD_ANTIKT04_B1_Filter00768_Cut00150_Skip00"),
 fTrackEtaMax(.9),
 fJetEtaMax(.9),
@@ -381,6 +383,9 @@ void  AliAnalysisTaskPhiCorrelations::CreateOutputObjects()
   fHistos->SetTwoTrackCutMinRadius(fTwoTrackCutMinRadius);
   fHistosMixed->SetTwoTrackCutMinRadius(fTwoTrackCutMinRadius);
   
+  fHistos->SetBinnedCorrelations(fBinnedCorrelations, fBinnedOversampling);
+  fHistosMixed->SetBinnedCorrelations(fBinnedCorrelations, fBinnedOversampling);
+  
   if (fEfficiencyCorrectionTriggers)
    {
     fHistos->SetEfficiencyCorrectionTriggers(fEfficiencyCorrectionTriggers);
@@ -633,6 +638,8 @@ void  AliAnalysisTaskPhiCorrelations::AddSettingsTree()
   settingsTree->Branch("fUseNewCentralityFramework", &fUseNewCentralityFramework,"fUseNewCentralityFramework/O");
   settingsTree->Branch("fTwoTrackEfficiencyCut", &fTwoTrackEfficiencyCut,"TwoTrackEfficiencyCut/D");
   settingsTree->Branch("fTwoTrackCutMinRadius", &fTwoTrackCutMinRadius,"TwoTrackCutMinRadius/D");
+  settingsTree->Branch("fBinnedCorrelations", &fBinnedCorrelations,"BinnedCorrelations/O");
+  settingsTree->Branch("fBinnedOversampling", &fBinnedOversampling,"BinnedOversampling/I");
   
   //fCustomBinning
   
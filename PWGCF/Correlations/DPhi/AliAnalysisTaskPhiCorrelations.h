@@ -142,6 +142,7 @@ public:
   void   SetWeightPerEvent(Bool_t flag = kTRUE)   { fWeightPerEvent = flag; }
   void   SetCustomBinning(const char* binningStr) { fCustomBinning = binningStr; }
   void   SetPtOrder(Bool_t flag) { fPtOrder = flag; }
+  void   SetBinnedCorrelations(Bool_t flag = kTRUE, Int_t oversampling = 4) { fBinnedCorrelations = flag; fBinnedOversampling = oversampling; }
   void   SetTriggersFromDetector(Int_t flag) { fTriggersFromDetector = flag; }
   void   SetAssociatedFromDetector(Int_t flag) { fAssociatedFromDetector = flag; }
   void   SetUseUncheckedCentrality(Bool_t flag) { fUseUncheckedCentrality = flag; }
@@ -324,6 +325,8 @@ private:
   Bool_t fUseNewCentralityFramework; // use the AliMultSelection framework
 
   Bool_t fFillpT;                // fill sum pT instead of number density
+  Bool_t fBinnedCorrelations;    // fill correlations from binned (eta, phi) densities if no pair cut is requested (see AliUEHistograms::FillCorrelationsBinned)
+  Int_t fBinnedOversampling;     // grid cells per delta eta and delta phi bin in the binned mode
 
   // configuration for tracks with jet removal
   TString fJetBranchName;        // name of jet branch for exclusion of in-jet tracks
@@ -342,7 +345,7 @@ private:
   Bool_t                      fUsePtBinnedEventPool; // uses event pool in pt bins
   Bool_t                      fCheckEventNumberInMixedEvent; // check event number before correlation in mixed event
 
-  ClassDef(AliAnalysisTaskPhiCorrelations, 62); // Analysis task for delta phi correlations
+  ClassDef(AliAnalysisTaskPhiCorrelations, 63); // Analysis task for delta phi correlations
 };
 
 #endif
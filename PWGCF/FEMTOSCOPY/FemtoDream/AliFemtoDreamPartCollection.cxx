@@ -70,6 +70,7 @@ void AliFemtoDreamPartCollection::SetEvent(
     itZVtx += bins[0];
     auto itMult = itZVtx->begin();
     itMult += bins[1];
+    itMult->SetCurrentEvent(Particles);
     itMult->PairParticlesSE(Particles, fResults, bins[1], cent);
     itMult->PairParticlesME(Particles, fResults, bins[1], cent);
     itMult->SetEvent(Particles);
@@ -6,19 +6,89 @@
  */
 
 #include <iostream>
+#include <utility>
 #include "AliFemtoDreamPartContainer.h"
 #include "TLorentzVector.h"
 #include "TVector3.h"
 ClassImp(AliFemtoDreamPartContainer)
+AliFemtoDreamPartContainer::Event::Event()
+    : fPx(),
+      fPy(),
+      fPz(),
+      fMCPx(),
+      fMCPy(),
+      fMCPz(),
+      fMCPDGCode(),
+      fPhi(),
+      fEta(),
+      fEtaStart(1, 0),
+      fPhiAtRad(),
+      fRadStart(1, 0),
+      fDaugStart(1, 0) {
+}
+
+void AliFemtoDreamPartContainer::Event::Clear() {
+  //clear() keeps the capacity, so that the arrays are not reallocated
+  //when the event slot is reused
+  fPx.clear();
+  fPy.clear();
+  fPz.clear();
+  fMCPx.clear();
+  fMCPy.clear();
+  fMCPz.clear();
+  fMCPDGCode.clear();
+  fPhi.clear();
+  fEta.clear();
+  fEtaStart.assign(1, 0);
+  fPhiAtRad.clear();
+  fRadStart.assign(1, 0);
+  fDaugStart.assign(1, 0);
+}
+
+void AliFemtoDreamPartContainer::Event::Add(const AliFemtoDreamBasePart &part) {
+  TVector3 mom = part.GetMomentum();
+  fPx.push_back(mom.X());
+  fPy.push_back(mom.Y());
+  fPz.push_back(mom.Z());
+  TVector3 momMC = part.GetMCMomentum();
+  fMCPx.push_back(momMC.X());
+  fMCPy.push_back(momMC.Y());
+  fMCPz.push_back(momMC.Z());
+  fMCPDGCode.push_back(part.GetMCPDGCode());
+  const std::vector<float> &phi = part.GetPhi();
+  fPhi.push_back(phi.size() > 0 ? phi[0] : 0.f);
+  const std::vector<float> &eta = part.GetEta();
+  fEta.insert(fEta.end(), eta.begin(), eta.end());
+  fEtaStart.push_back(fEta.size());
+  const std::vector<std::vector<float>> &phiAtRad = part.GetPhiAtRaidius();
+  for (auto itDaug = phiAtRad.begin(); itDaug != phiAtRad.end(); ++itDaug) {
+    fPhiAtRad.insert(fPhiAtRad.end(), itDaug->begin(), itDaug->end());
+    fRadStart.push_back(fPhiAtRad.size());
+  }
+  fDaugStart.push_back(fRadStart.size() - 1);
+}
+
+void AliFemtoDreamPartContainer::Event::SetParticles(
+    const std::vector<AliFemtoDreamBasePart> &Particles) {
+  Clear();
+  for (auto itPart = Particles.begin(); itPart != Particles.end(); ++itPart) {
+    Add(*itPart);
+  }
+}
+
 AliFemtoDreamPartContainer::AliFemtoDreamPartContainer()
-    : fPartBuffer(),
+    : fEvents(),
+      fFirstEvent(0),
+      fNEvents(0),
       fMixingDepth(0) {
 
 }
 
 AliFemtoDreamPartContainer::AliFemtoDreamPartContainer(int MixingDepth)
-    : fPartBuffer(),
-      fMixingDepth(MixingDepth) {
+    : fEvents(MixingDepth > 0 ? MixingDepth : 0),
+      fFirstEvent(0),
+      fNEvents(0),
+      fMixingDepth(MixingDepth > 0 ? MixingDepth : 0) {
 
 }
 
@@ -27,48 +97,55 @@ AliFemtoDreamPartContainer& AliFemtoDreamPartContainer::operator=(
   if (this == &obj) {
     return *this;
   }
-//  std::deque<std::deque<AliFemtoDreamBasePart>>::iterator copyIter;
-//  std::deque<std::deque<AliFemtoDreamBasePart>>::iterator objIter;
-//  for (objIter=obj.fPartBuffer.begin();objIter!=obj.fPartBuffer.end();
-//      ++objIter)
-//  {
-//
-//  }
+  this->fEvents = obj.fEvents;
+  this->fFirstEvent = obj.fFirstEvent;
+  this->fNEvents = obj.fNEvents;
   this->fMixingDepth = obj.fMixingDepth;
-  this->fPartBuffer = obj.fPartBuffer;
   return (*this);
 }
 
 AliFemtoDreamPartContainer::~AliFemtoDreamPartContainer() {
 }
 
+unsigned int AliFemtoDreamPartContainer::NextSlot() {
+  //once the buffer is full, the oldest event is overwritten
+  unsigned int slot;
+  if (fNEvents < fMixingDepth) {
+    slot = (fFirstEvent + fNEvents) % fMixingDepth;
+    ++fNEvents;
+  } else {
+    slot = fFirstEvent;
+    fFirstEvent = (fFirstEvent + 1) % fMixingDepth;
+  }
+  return slot;
+}
+
 void AliFemtoDreamPartContainer::SetEvent(
     std::vector<AliFemtoDreamBasePart> &Particles) {
-  if (!(fPartBuffer.size() < fMixingDepth)) {
-//    std::cout << "Popping Front" << std::endl;
-    fPartBuffer.pop_front();
+  if (fMixingDepth == 0) {
+    return;
   }
-  fPartBuffer.push_back(Particles);
-//  std::cout << "PartBuffer Size: "<<fPartBuffer.size()<<'\t'<<"Input Size: "
-//      << Particles.size() << '\n';
+  fEvents[NextSlot()].SetParticles(Particles);
+  return;
+}
+
+void AliFemtoDreamPartContainer::SetEvent(Event &evt) {
+  if (fMixingDepth == 0) {
+    return;
+  }
+  std::swap(fEvents[NextSlot()], evt);
+  evt.Clear();
   return;
 }
 
 void AliFemtoDreamPartContainer::PrintLastEvent() {
-  for (std::deque<std::vector<AliFemtoDreamBasePart>>::iterator itEvt =
-      fPartBuffer.begin(); itEvt != fPartBuffer.end(); ++itEvt) {
-    std::cout << "Printing Last Event with size: " << itEvt->size() << '\n';
-    for (std::vector<AliFemtoDreamBasePart>::iterator itPart = itEvt->begin();
-        itPart != itEvt->end(); ++itPart) {
-      TVector3 P(itPart->GetMomentum());
+  for (unsigned int iDepth = 0; iDepth < fNEvents; ++iDepth) {
+    const Event &evt = GetEvent(iDepth);
+    std::cout << "Printing Last Event with size: " << evt.GetSize() << '\n';
+    for (unsigned int iPart = 0; iPart < evt.GetSize(); ++iPart) {
+      TVector3 P(evt.GetMomentum(iPart));
       std::cout << "Px: " << P.X() << '\t' << "Py: " << P.Y() << '\t' << "Pz: "
                 << P.Z() << std::endl;
     }
   }
 }
-std::vector<AliFemtoDreamBasePart> &AliFemtoDreamPartContainer::GetEvent(
-    int Depth) {
-  std::deque<std::vector<AliFemtoDreamBasePart>>::iterator itEvt = fPartBuffer
-      .begin() + Depth;
-  return *itEvt;
-}
@@ -7,35 +7,111 @@
 
 #ifndef ALIFEMTODREAMPARTCONTAINER_H_
 #define ALIFEMTODREAMPARTCONTAINER_H_
-#include <deque>
 #include <vector>
 #include "Rtypes.h"
+#include "TVector3.h"
 
 #include "AliFemtoDreamBasePart.h"
 
 //Class Containing the Particles from previous Events up to a certain mixing
 //depth for one Particle Species and Mult/ZVtx Bin
 //ZVtx bin.
+//Only the quantities needed by the pair loops are kept, one array per
+//quantity (see AliFemtoDreamPartContainer::Event), in a ring buffer of
+//MixingDepth events whose arrays are reused from one event to the next.
 class AliFemtoDreamPartContainer {
  public:
+  //Particles of one event, slimmed to what the pair loops use and stored as
+  //one array per quantity. Quantities with one entry per daughter (eta, phi
+  //at radii) are flattened, with the start of each particle (or daughter)
+  //in an offset array.
+  class Event {
+   public:
+    Event();
+    void Clear();
+    void Add(const AliFemtoDreamBasePart &part);
+    void SetParticles(const std::vector<AliFemtoDreamBasePart> &Particles);
+    unsigned int GetSize() const {
+      return fPx.size();
+    }
+    ;
+    TVector3 GetMomentum(unsigned int i) const {
+      return TVector3(fPx[i], fPy[i], fPz[i]);
+    }
+    ;
+    TVector3 GetMCMomentum(unsigned int i) const {
+      return TVector3(fMCPx[i], fMCPy[i], fMCPz[i]);
+    }
+    ;
+    int GetMCPDGCode(unsigned int i) const {
+      return fMCPDGCode[i];
+    }
+    ;
+    //first entry of the phi of the particle
+    float GetPhi(unsigned int i) const {
+      return fPhi[i];
+    }
+    ;
+    const float *GetEta(unsigned int i) const {
+      return fEta.data() + fEtaStart[i];
+    }
+    ;
+    unsigned int GetNEta(unsigned int i) const {
+      return fEtaStart[i + 1] - fEtaStart[i];
+    }
+    ;
+    unsigned int GetNDaughters(unsigned int i) const {
+      return fDaugStart[i + 1] - fDaugStart[i];
+    }
+    ;
+    const float *GetPhiAtRadius(unsigned int i, unsigned int iDaug) const {
+      return fPhiAtRad.data() + fRadStart[fDaugStart[i] + iDaug];
+    }
+    ;
+    unsigned int GetNRadii(unsigned int i, unsigned int iDaug) const {
+      unsigned int iD = fDaugStart[i] + iDaug;
+      return fRadStart[iD + 1] - fRadStart[iD];
+    }
+    ;
+   private:
+    std::vector<double> fPx;
+    std::vector<double> fPy;
+    std::vector<double> fPz;
+    std::vector<double> fMCPx;
+    std::vector<double> fMCPy;
+    std::vector<double> fMCPz;
+    std::vector<int> fMCPDGCode;
+    std::vector<float> fPhi;
+    std::vector<float> fEta;
+    std::vector<unsigned int> fEtaStart;   //per particle, one more entry
+    std::vector<float> fPhiAtRad;
+    std::vector<unsigned int> fRadStart;   //per daughter, one more entry
+    std::vector<unsigned int> fDaugStart;  //per particle, one more entry
+  };
   AliFemtoDreamPartContainer();
   AliFemtoDreamPartContainer(int MixingDepth);
   AliFemtoDreamPartContainer& operator=(const AliFemtoDreamPartContainer& obj);
   virtual ~AliFemtoDreamPartContainer();
   void PrintLastEvent();
   void SetEvent(std::vector<AliFemtoDreamBasePart> &Particles);
-  std::deque<std::vector<AliFemtoDreamBasePart>> GetEventBuffer() const {
-    return fPartBuffer;
+  //Stores an already flattened event by swapping it with the slot it goes
+  //to, evt is left with the arrays of the overwritten event, cleared
+  void SetEvent(Event &evt);
+  //Depth 0 is the oldest event in the buffer
+  const Event &GetEvent(int Depth) const {
+    return fEvents[(fFirstEvent + Depth) % fMixingDepth];
   }
   ;
-  std::vector<AliFemtoDreamBasePart> &GetEvent(int Depth);
   unsigned int GetMixingDepth() const {
-    return fPartBuffer.size();
+    return fNEvents;
   }
   ;
  private:
-  std::deque<std::vector<AliFemtoDreamBasePart>> fPartBuffer;
-  unsigned int fMixingDepth;ClassDef(AliFemtoDreamPartContainer,2)
+  unsigned int NextSlot();
+  std::vector<Event> fEvents;    //! ring buffer of the stored events
+  unsigned int fFirstEvent;      //! position of the oldest event
+  unsigned int fNEvents;         //! number of stored events
+  unsigned int fMixingDepth;ClassDef(AliFemtoDreamPartContainer,3)
   ;
 };
 
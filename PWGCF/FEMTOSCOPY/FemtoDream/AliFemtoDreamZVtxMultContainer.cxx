@@ -21,7 +21,8 @@ AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer()
       fDeltaEtaMax(0.f),
       fDeltaPhiMax(0.f),
       fDeltaPhiEtaMax(0.f),
-      fDoDeltaEtaDeltaPhiCut(false) {
+      fDoDeltaEtaDeltaPhiCut(false),
+      fCurrentEvent() {
   TDatabasePDG::Instance()->AddParticle("deuteron", "deuteron", 1.8756134,
                                         kTRUE, 0.0, 1, "Nucleus", 1000010020);
   TDatabasePDG::Instance()->AddAntiParticle("anti-deuteron", -1000010020);
@@ -38,7 +39,8 @@ AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer(
       fDeltaPhiMax(conf->GetDeltaPhiMax()),
       fDeltaPhiEtaMax(
           fDeltaPhiMax * fDeltaPhiMax + fDeltaEtaMax * fDeltaEtaMax),
-      fDoDeltaEtaDeltaPhiCut(conf->GetDoDeltaEtaDeltaPhiCut()) {
+      fDoDeltaEtaDeltaPhiCut(conf->GetDoDeltaEtaDeltaPhiCut()),
+      fCurrentEvent() {
   TDatabasePDG::Instance()->AddParticle("deuteron", "deuteron", 1.8756134,
                                         kTRUE, 0.0, 1, "Nucleus", 1000010020);
   TDatabasePDG::Instance()->AddAntiParticle("anti-deuteron", -1000010020);
@@ -58,19 +60,25 @@ void AliFemtoDreamZVtxMultContainer::SetEvent(
   //        fParticleSpecies);
   //    AliFatal(errMessage.Data());
   //  } else {
-  std::vector<std::vector<AliFemtoDreamBasePart>>::iterator itInput = Particles
-      .begin();
-  std::vector<AliFemtoDreamPartContainer>::iterator itContainer = fPartContainer
-      .begin();
-  while (itContainer != fPartContainer.end()) {
-    if (itInput->size() > 0) {
-      itContainer->SetEvent(*itInput);
+  //The event flattened by SetCurrentEvent is moved into the buffers
+  for (unsigned int iSpec = 0; iSpec < fPartContainer.size(); ++iSpec) {
+    if (Particles[iSpec].size() > 0) {
+      fPartContainer[iSpec].SetEvent(fCurrentEvent[iSpec]);
     }
-    ++itInput;
-    ++itContainer;
   }
   //  }
 }
+
+void AliFemtoDreamZVtxMultContainer::SetCurrentEvent(
+    std::vector<std::vector<AliFemtoDreamBasePart>> &Particles) {
+  //The particles of the current event in the same layout as the mixing
+  //buffer, so that the same pair loop code works on both
+  fCurrentEvent.resize(Particles.size());
+  for (unsigned int iSpec = 0; iSpec < Particles.size(); ++iSpec) {
+    fCurrentEvent[iSpec].SetParticles(Particles[iSpec]);
+  }
+}
+
 void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamCorrHists *ResultsHist, int iMult, float cent) {
@@ -80,48 +88,45 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
   auto itPDGPar1 = fPDGParticleSpecies.begin();
   for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
       ++itSpec1) {
+    const AliFemtoDreamPartContainer::Event &Event1 = fCurrentEvent[itSpec1
+        - Particles.begin()];
     auto itPDGPar2 = fPDGParticleSpecies.begin();
     itPDGPar2 += itSpec1 - Particles.begin();
     for (auto itSpec2 = itSpec1; itSpec2 != Particles.end(); ++itSpec2) {
+      const AliFemtoDreamPartContainer::Event &Event2 = fCurrentEvent[itSpec2
+          - Particles.begin()];
       ResultsHist->FillPartnersSE(HistCounter, itSpec1->size(),
                                   itSpec2->size());
       //Now loop over the actual Particles and correlate them
       unsigned int DoThisPair = fWhichPairs.at(HistCounter);
       bool fillHists = DoThisPair > 0 ? true : false;
       bool CPR = fRejPairs.at(HistCounter);
-      for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
-          ++itPart1) {
-        AliFemtoDreamBasePart part1 = *itPart1;
-        std::vector<AliFemtoDreamBasePart>::iterator itPart2;
-        if (itSpec1 == itSpec2) {
-          itPart2 = itPart1 + 1;
-        } else {
-          itPart2 = itSpec2->begin();
-        }
-        while (itPart2 != itSpec2->end()) {
-          AliFemtoDreamBasePart part2 = *itPart2;
+      for (unsigned int iPart1 = 0; iPart1 < Event1.GetSize(); ++iPart1) {
+        TVector3 Mom1 = Event1.GetMomentum(iPart1);
+        unsigned int iPart2 = (itSpec1 == itSpec2) ? iPart1 + 1 : 0;
+        for (; iPart2 < Event2.GetSize(); ++iPart2) {
           // Delta eta - Delta phi* cut
           if (fDoDeltaEtaDeltaPhiCut && CPR) {
-            if (!RejectClosePairs(part1, part2)) {
-              ++itPart2;
+            if (!RejectClosePairs(Event1, iPart1, Event2, iPart2)) {
               continue;
             }
           }
-          RelativeK = RelativePairMomentum(itPart1->GetMomentum(), *itPDGPar1,
-                                           itPart2->GetMomentum(), *itPDGPar2);
+          TVector3 Mom2 = Event2.GetMomentum(iPart2);
+          RelativeK = RelativePairMomentum(Mom1, *itPDGPar1, Mom2, *itPDGPar2);
 
           if (fillHists && ResultsHist->GetEtaPhiPlots()) {
-            DeltaEtaDeltaPhi(HistCounter, part1, part2, true, ResultsHist,
-                             RelativeK);
+            DeltaEtaDeltaPhi(HistCounter, Event1, iPart1, Event2, iPart2, true,
+                             ResultsHist, RelativeK);
           }
           if (fillHists && ResultsHist->GetDodPhidEtaPlots()) {
-            float deta = itPart1->GetEta().at(0) - itPart2->GetEta().at(0);
-            float dphi = itPart1->GetPhi().at(0) - itPart2->GetPhi().at(0);
+            if (Event1.GetNEta(iPart1) == 0 || Event2.GetNEta(iPart2) == 0) {
+              AliFatal("Particle without eta");
+            }
+            float deta = Event1.GetEta(iPart1)[0] - Event2.GetEta(iPart2)[0];
+            float dphi = Event1.GetPhi(iPart1) - Event2.GetPhi(iPart2);
             float mT =
                 ResultsHist->GetDodPhidEtamTPlots() ?
-                    RelativePairmT(itPart1->GetMomentum(), *itPDGPar1,
-                                   itPart2->GetMomentum(), *itPDGPar2) :
-                    0;
+                    RelativePairmT(Mom1, *itPDGPar1, Mom2, *itPDGPar2) : 0;
             if (dphi < 0) {
               ResultsHist->FilldPhidEtaSE(HistCounter, dphi + 2 * TMath::Pi(),
                                           deta, mT);
@@ -141,29 +146,29 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
           if (fillHists && ResultsHist->GetDokTBinning()) {
             ResultsHist->FillSameEventkTDist(
                 HistCounter,
-                RelativePairkT(itPart1->GetMomentum(), *itPDGPar1,
-                               itPart2->GetMomentum(), *itPDGPar2),
+                RelativePairkT(Mom1, *itPDGPar1, Mom2, *itPDGPar2),
                 RelativeK, cent);
           }
           if (fillHists && ResultsHist->GetDomTBinning()) {
             ResultsHist->FillSameEventmTDist(
                 HistCounter,
-                RelativePairmT(itPart1->GetMomentum(), *itPDGPar1,
-                               itPart2->GetMomentum(), *itPDGPar2),
+                RelativePairmT(Mom1, *itPDGPar1, Mom2, *itPDGPar2),
                 RelativeK);
           }
+          //the QA needs the full particles, which are there for the same event
+          AliFemtoDreamBasePart &part1 = (*itSpec1)[iPart1];
+          AliFemtoDreamBasePart &part2 = (*itSpec2)[iPart2];
           if (fillHists && ResultsHist->GetDoPtQA()) {
-            ResultsHist->FillPtQADist(HistCounter, RelativeK, itPart1->GetPt(),
-                                      itPart2->GetPt());
+            ResultsHist->FillPtQADist(HistCounter, RelativeK, part1.GetPt(),
+                                      part2.GetPt());
           }
           if (fillHists && ResultsHist->GetDoMassQA()) {
             ResultsHist->FillMassQADist(HistCounter, RelativeK,
-                                        itPart1->GetInvMass(),
-                                        itPart2->GetInvMass());
+                                        part1.GetInvMass(),
+                                        part2.GetInvMass());
 	    ResultsHist->FillPairInvMassQAD(HistCounter, part1, part2);
 
           }
-          ++itPart2;
         }
       }
       ++HistCounter;
@@ -185,6 +190,7 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     //We dont want to correlate the particles twice. Mixed Event Dist. of
     //Particle1 + Particle2 == Particle2 + Particle 1
     int SkipPart = itSpec1 - Particles.begin();
+    const AliFemtoDreamPartContainer::Event &Event1 = fCurrentEvent[SkipPart];
     auto itPDGPar2 = fPDGParticleSpecies.begin() + SkipPart;
     for (auto itSpec2 = fPartContainer.begin() + SkipPart;
         itSpec2 != fPartContainer.end(); ++itSpec2) {
@@ -196,37 +202,35 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
       bool fillHists = DoThisPair > 0 ? true : false;
       bool CPR = fRejPairs.at(HistCounter);
       for (int iDepth = 0; iDepth < (int) itSpec2->GetMixingDepth(); ++iDepth) {
-        std::vector<AliFemtoDreamBasePart> ParticlesOfEvent = itSpec2->GetEvent(
+        const AliFemtoDreamPartContainer::Event &Event2 = itSpec2->GetEvent(
             iDepth);
         ResultsHist->FillPartnersME(HistCounter, itSpec1->size(),
-                                    ParticlesOfEvent.size());
-        for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
-            ++itPart1) {
-          AliFemtoDreamBasePart part1 = *itPart1;
-          for (auto itPart2 = ParticlesOfEvent.begin();
-              itPart2 != ParticlesOfEvent.end(); ++itPart2) {
-            AliFemtoDreamBasePart part2 = *itPart2;
+                                    Event2.GetSize());
+        for (unsigned int iPart1 = 0; iPart1 < Event1.GetSize(); ++iPart1) {
+          TVector3 Mom1 = Event1.GetMomentum(iPart1);
+          for (unsigned int iPart2 = 0; iPart2 < Event2.GetSize(); ++iPart2) {
             // Delta eta - Delta phi* cut
             if (fDoDeltaEtaDeltaPhiCut && CPR) {
-              if (!RejectClosePairs(part1, part2)) {
+              if (!RejectClosePairs(Event1, iPart1, Event2, iPart2)) {
                 continue;
               }
             }
-            RelativeK = RelativePairMomentum(itPart1->GetMomentum(), *itPDGPar1,
-                                             itPart2->GetMomentum(),
+            TVector3 Mom2 = Event2.GetMomentum(iPart2);
+            RelativeK = RelativePairMomentum(Mom1, *itPDGPar1, Mom2,
                                              *itPDGPar2);
             if (fillHists && ResultsHist->GetEtaPhiPlots()) {
-              DeltaEtaDeltaPhi(HistCounter, part1, part2, false, ResultsHist,
-                               RelativeK);
+              DeltaEtaDeltaPhi(HistCounter, Event1, iPart1, Event2, iPart2,
+                               false, ResultsHist, RelativeK);
             }
             if (fillHists && ResultsHist->GetDodPhidEtaPlots()) {
-              float deta = itPart1->GetEta().at(0) - itPart2->GetEta().at(0);
-              float dphi = itPart1->GetPhi().at(0) - itPart2->GetPhi().at(0);
+              if (Event1.GetNEta(iPart1) == 0 || Event2.GetNEta(iPart2) == 0) {
+                AliFatal("Particle without eta");
+              }
+              float deta = Event1.GetEta(iPart1)[0] - Event2.GetEta(iPart2)[0];
+              float dphi = Event1.GetPhi(iPart1) - Event2.GetPhi(iPart2);
               float mT =
                   ResultsHist->GetDodPhidEtamTPlots() ?
-                      RelativePairmT(itPart1->GetMomentum(), *itPDGPar1,
-                                     itPart2->GetMomentum(), *itPDGPar2) :
-                      0;
+                      RelativePairmT(Mom1, *itPDGPar1, Mom2, *itPDGPar2) : 0;
               if (dphi < 0) {
                 ResultsHist->FilldPhidEtaME(HistCounter, dphi + 2 * TMath::Pi(),
                                             deta, mT);
@@ -246,15 +250,13 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
             if (fillHists && ResultsHist->GetDokTBinning()) {
               ResultsHist->FillMixedEventkTDist(
                   HistCounter,
-                  RelativePairkT(itPart1->GetMomentum(), *itPDGPar1,
-                                 itPart2->GetMomentum(), *itPDGPar2),
+                  RelativePairkT(Mom1, *itPDGPar1, Mom2, *itPDGPar2),
                   RelativeK, cent);
             }
             if (fillHists && ResultsHist->GetDomTBinning()) {
               ResultsHist->FillMixedEventmTDist(
                   HistCounter,
-                  RelativePairmT(itPart1->GetMomentum(), *itPDGPar1,
-                                 itPart2->GetMomentum(), *itPDGPar2),
+                  RelativePairmT(Mom1, *itPDGPar1, Mom2, *itPDGPar2),
                   RelativeK);
             }
             if (fillHists && ResultsHist->GetObtainMomentumResolution()) {
@@ -263,12 +265,11 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
               //of the pairs does not change event by event.
               //Now we only want to use the momentum of particles we are after, hence
               //we check the PDG Code!
-              if ((*itPDGPar1 == TMath::Abs(itPart1->GetMCPDGCode()))
-                  && ((*itPDGPar2 == TMath::Abs(itPart2->GetMCPDGCode())))) {
-                float RelKTrue = RelativePairMomentum(itPart1->GetMCMomentum(),
-                                                      *itPDGPar1,
-                                                      itPart2->GetMCMomentum(),
-                                                      *itPDGPar2);
+              if ((*itPDGPar1 == TMath::Abs(Event1.GetMCPDGCode(iPart1)))
+                  && ((*itPDGPar2 == TMath::Abs(Event2.GetMCPDGCode(iPart2))))) {
+                float RelKTrue = RelativePairMomentum(
+                    Event1.GetMCMomentum(iPart1), *itPDGPar1,
+                    Event2.GetMCMomentum(iPart2), *itPDGPar2);
                 ResultsHist->FillMomentumResolution(HistCounter, RelKTrue,
                                                     RelativeK);
               }
@@ -360,8 +361,10 @@ float AliFemtoDreamZVtxMultContainer::RelativePairmT(TVector3 Part1Momentum,
 }
 
 void AliFemtoDreamZVtxMultContainer::DeltaEtaDeltaPhi(
-    int Hist, AliFemtoDreamBasePart &part1, AliFemtoDreamBasePart &part2,
-    bool SEorME, AliFemtoDreamCorrHists *ResultsHist, float relk) {
+    int Hist, const AliFemtoDreamPartContainer::Event &Event1,
+    unsigned int iPart1, const AliFemtoDreamPartContainer::Event &Event2,
+    unsigned int iPart2, bool SEorME, AliFemtoDreamCorrHists *ResultsHist,
+    float relk) {
   //used to check for track splitting/merging
   //this function only produces meaningful results for track with x Daughter
   //looking at this quantity makes only sense anyways for Track - Track not
@@ -373,32 +376,31 @@ void AliFemtoDreamZVtxMultContainer::DeltaEtaDeltaPhi(
     AliWarning("you are doing something wrong \n");
   }
   unsigned int nDaug2 = (unsigned int) DoThisPair % 10;
-  std::vector<float> eta1 = part1.GetEta();
-  std::vector<float> eta2 = part2.GetEta();
-  for (unsigned int iDaug1 = 0; iDaug1 < nDaug1; ++iDaug1) {
-    std::vector<float> PhiAtRad1 = part1.GetPhiAtRaidius().at(iDaug1);
-    float etaPar1;
-    if (nDaug1 == 1) {
-      etaPar1 = eta1.at(0);
-    } else {
-      etaPar1 = eta1.at(iDaug1 + 1);
+  const float *eta1 = Event1.GetEta(iPart1);
+  const float *eta2 = Event2.GetEta(iPart2);
+  for (unsigned int iDaug1 = 0;
+      iDaug1 < nDaug1 && iDaug1 < Event1.GetNDaughters(iPart1); ++iDaug1) {
+    const float *PhiAtRad1 = Event1.GetPhiAtRadius(iPart1, iDaug1);
+    const unsigned int nRad1 = Event1.GetNRadii(iPart1, iDaug1);
+    const unsigned int iEta1 = (nDaug1 == 1) ? 0 : iDaug1 + 1;
+    if (iEta1 >= Event1.GetNEta(iPart1)) {
+      AliFatal("Fewer eta entries than daughters");
     }
-    for (unsigned int iDaug2 = 0; iDaug2 < part2.GetPhiAtRaidius().size();
+    float etaPar1 = eta1[iEta1];
+    for (unsigned int iDaug2 = 0; iDaug2 < Event2.GetNDaughters(iPart2);
         ++iDaug2) {
-      std::vector<float> phiAtRad2 = part2.GetPhiAtRaidius().at(iDaug2);
-      float etaPar2;
-      if (nDaug2 == 1) {
-        etaPar2 = eta2.at(0);
-      } else {
-        etaPar2 = eta2.at(iDaug2 + 1);
+      const float *phiAtRad2 = Event2.GetPhiAtRadius(iPart2, iDaug2);
+      const unsigned int nRad2 = Event2.GetNRadii(iPart2, iDaug2);
+      const unsigned int iEta2 = (nDaug2 == 1) ? 0 : iDaug2 + 1;
+      if (iEta2 >= Event2.GetNEta(iPart2)) {
+        AliFatal("Fewer eta entries than daughters");
       }
+      float etaPar2 = eta2[iEta2];
       float deta = etaPar1 - etaPar2;
-      const int size =
-          (PhiAtRad1.size() > phiAtRad2.size()) ?
-              phiAtRad2.size() : PhiAtRad1.size();
+      const int size = (nRad1 > nRad2) ? nRad2 : nRad1;
       float dphiAvg = 0;
       for (int iRad = 0; iRad < size; ++iRad) {
-        float dphi = PhiAtRad1.at(iRad) - phiAtRad2.at(iRad);
+        float dphi = PhiAtRad1[iRad] - phiAtRad2[iRad];
         dphiAvg += dphi;
         if (dphi > piHi) {
           dphi += -piHi * 2;
@@ -448,39 +450,37 @@ float AliFemtoDreamZVtxMultContainer::ComputeDeltaPhi(
 }
 
 bool AliFemtoDreamZVtxMultContainer::RejectClosePairs(
-    AliFemtoDreamBasePart& part1, AliFemtoDreamBasePart& part2) {
+    const AliFemtoDreamPartContainer::Event &Event1, unsigned int iPart1,
+    const AliFemtoDreamPartContainer::Event &Event2, unsigned int iPart2) {
   bool outBool = true;
   //Method calculates the average separation between two tracks
   //at different radii within the TPC and rejects pairs which a
   //too low separation
-  unsigned int nDaug1 = part1.GetPhiAtRaidius().size();
-  unsigned int nDaug2 = part2.GetPhiAtRaidius().size();
+  unsigned int nDaug1 = Event1.GetNDaughters(iPart1);
+  unsigned int nDaug2 = Event2.GetNDaughters(iPart2);
   // if nDaug == 1 => Single Track, else decay
-  std::vector<float> eta1 = part1.GetEta();
-  std::vector<float> eta2 = part2.GetEta();
+  const float *eta1 = Event1.GetEta(iPart1);
+  const float *eta2 = Event2.GetEta(iPart2);
   for (unsigned int iDaug1 = 0; iDaug1 < nDaug1 && outBool; ++iDaug1) {
-    std::vector<float> PhiAtRad1 = part1.GetPhiAtRaidius().at(iDaug1);
-    float etaPar1;
-    if (nDaug1 == 1) {
-      etaPar1 = eta1.at(0);
-    } else {
-      etaPar1 = eta1.at(iDaug1 + 1);
+    const float *PhiAtRad1 = Event1.GetPhiAtRadius(iPart1, iDaug1);
+    const unsigned int nRad1 = Event1.GetNRadii(iPart1, iDaug1);
+    const unsigned int iEta1 = (nDaug1 == 1) ? 0 : iDaug1 + 1;
+    if (iEta1 >= Event1.GetNEta(iPart1)) {
+      AliFatal("Fewer eta entries than daughters");
     }
-    for (unsigned int iDaug2 = 0;
-        iDaug2 < part2.GetPhiAtRaidius().size() && outBool; ++iDaug2) {
-      std::vector<float> phiAtRad2 = part2.GetPhiAtRaidius().at(iDaug2);
-      float etaPar2;
-      if (nDaug2 == 1) {
-        etaPar2 = eta2.at(0);
-      } else {
-        etaPar2 = eta2.at(iDaug2 + 1);
+    float etaPar1 = eta1[iEta1];
+    for (unsigned int iDaug2 = 0; iDaug2 < nDaug2 && outBool; ++iDaug2) {
+      const float *phiAtRad2 = Event2.GetPhiAtRadius(iPart2, iDaug2);
+      const unsigned int nRad2 = Event2.GetNRadii(iPart2, iDaug2);
+      const unsigned int iEta2 = (nDaug2 == 1) ? 0 : iDaug2 + 1;
+      if (iEta2 >= Event2.GetNEta(iPart2)) {
+        AliFatal("Fewer eta entries than daughters");
       }
+      float etaPar2 = eta2[iEta2];
       float deta = etaPar1 - etaPar2;
-      const int size =
-          (PhiAtRad1.size() > phiAtRad2.size()) ?
-              phiAtRad2.size() : PhiAtRad1.size();
+      const int size = (nRad1 > nRad2) ? nRad2 : nRad1;
       for (int iRad = 0; iRad < size; ++iRad) {
-        float dphi = PhiAtRad1.at(iRad) - phiAtRad2.at(iRad);
+        float dphi = PhiAtRad1[iRad] - phiAtRad2[iRad];
         if (dphi > piHi) {
           dphi += -piHi * 2;
         } else if (dphi < -piHi) {
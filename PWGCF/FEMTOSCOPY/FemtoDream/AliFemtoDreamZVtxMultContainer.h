@@ -20,14 +20,21 @@ class AliFemtoDreamZVtxMultContainer {
   AliFemtoDreamZVtxMultContainer();
   AliFemtoDreamZVtxMultContainer(AliFemtoDreamCollConfig *conf);
   virtual ~AliFemtoDreamZVtxMultContainer();
+  //Flattens the particles of the event once, PairParticlesSE,
+  //PairParticlesME and SetEvent then work on it
+  void SetCurrentEvent(
+      std::vector<std::vector<AliFemtoDreamBasePart>> &Particles);
   void PairParticlesSE(
       std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
       AliFemtoDreamCorrHists *ResultsHist, int iMult, float cent);
   void PairParticlesME(
       std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
       AliFemtoDreamCorrHists *ResultsHist, int iMult, float cent);
-  void DeltaEtaDeltaPhi(int Hist, AliFemtoDreamBasePart &part1,
-                        AliFemtoDreamBasePart &part2, bool SEorME,
+  void DeltaEtaDeltaPhi(int Hist,
+                        const AliFemtoDreamPartContainer::Event &Event1,
+                        unsigned int iPart1,
+                        const AliFemtoDreamPartContainer::Event &Event2,
+                        unsigned int iPart2, bool SEorME,
                         AliFemtoDreamCorrHists *ResultsHist, float relk);
   float ComputeDeltaEta(AliFemtoDreamBasePart &part1,
                         AliFemtoDreamBasePart &part2);
@@ -45,8 +52,10 @@ class AliFemtoDreamZVtxMultContainer {
                        TVector3 Part2Momentum, int PDGPart2);
   float RelativePairmT(TVector3 Part1Momentum, int PDGPart1,
                        TVector3 Part2Momentum, int PDGPart2);
-  bool RejectClosePairs(AliFemtoDreamBasePart& part1,
-                        AliFemtoDreamBasePart& part2);
+  bool RejectClosePairs(const AliFemtoDreamPartContainer::Event &Event1,
+                        unsigned int iPart1,
+                        const AliFemtoDreamPartContainer::Event &Event2,
+                        unsigned int iPart2);
   std::vector<AliFemtoDreamPartContainer> fPartContainer;
   std::vector<int> fPDGParticleSpecies;
   std::vector<unsigned int> fWhichPairs;
@@ -55,8 +64,9 @@ class AliFemtoDreamZVtxMultContainer {
   float fDeltaPhiMax;
   float fDeltaPhiEtaMax;
   bool fDoDeltaEtaDeltaPhiCut;
+  std::vector<AliFemtoDreamPartContainer::Event> fCurrentEvent; //! particles of the event being paired
 
-ClassDef(AliFemtoDreamZVtxMultContainer, 4)
+ClassDef(AliFemtoDreamZVtxMultContainer, 5)
   ;
 };
 
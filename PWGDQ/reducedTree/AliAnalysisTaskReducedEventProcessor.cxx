@@ -134,8 +134,10 @@ void AliAnalysisTaskReducedEventProcessor::UserExec(Option_t *){
         fInputHandler = dynamic_cast<AliInputEventHandler *>(fMultiInputHandler->GetFirstInputEventHandler());
      
      AliReducedEventInputHandler* handler = dynamic_cast<AliReducedEventInputHandler *>(fInputHandler);
-     if(handler)
+     if(handler) {
+       if(!handler->IsEventSelected()) return;     // rejected by the input handler prefilter, arrays not read
        event = handler->GetReducedEvent();
+     }
   }
   
   if(!event) return;
@@ -3,11 +3,19 @@
 //     Author: Ionut-Cristian Arsene, iarsene@cern.ch, i.c.arsene@fys.uio.no
 //
 
+#include <iostream>
+#include <TString.h>
 #include <TTree.h>
 #include <TFile.h>
+#include <TBranch.h>
+#include <TObjArray.h>
 #include "AliReducedEventInputHandler.h"
 #include "AliReducedBaseEvent.h"
 #include "AliReducedEventInfo.h"
+#include "AliReducedInfoCut.h"
+
+using std::cout;
+using std::endl;
 
 ClassImp(AliReducedEventInputHandler)
 
@@ -15,7 +23,24 @@ ClassImp(AliReducedEventInputHandler)
 AliReducedEventInputHandler::AliReducedEventInputHandler() :
     AliInputEventHandler(),
     fEventInputOption(kReducedBaseEvent),
-    fReducedEvent(0)
+    fReducedEvent(0),
+    fUsePartialReading(kFALSE),
+    fRequiredComponents(-1),
+    fPrefilterCut(0x0),
+    fReadComponents(kAllComponents),
+    fEventSelected(kTRUE),
+    fCurrentTreeNumber(-1),
+    fHeaderBranches(),
+    fArrayBranches(),
+    fPrefilterValues(),
+    fNEventsRead(0),
+    fNEventsRejected(0),
+    fNBytesRead(0.),
+    fFileBytesStart(0),
+    fFileBytesEnd(0),
+    fTotBytesFull(0.),
+    fZipBytesFull(0.),
+    fEntriesFull(0)
 {
   // Default constructor
 }
@@ -24,7 +49,24 @@ AliReducedEventInputHandler::AliReducedEventInputHandler() :
 AliReducedEventInputHandler::AliReducedEventInputHandler(const char* name, const char* title):
   AliInputEventHandler(name, title),
   fEventInputOption(kReducedBaseEvent),
-  fReducedEvent(0)
+  fReducedEvent(0),
+  fUsePartialReading(kFALSE),
+  fRequiredComponents(-1),
+  fPrefilterCut(0x0),
+  fReadComponents(kAllComponents),
+  fEventSelected(kTRUE),
+  fCurrentTreeNumber(-1),
+  fHeaderBranches(),
+  fArrayBranches(),
+  fPrefilterValues(),
+  fNEventsRead(0),
+  fNEventsRejected(0),
+  fNBytesRead(0.),
+  fFileBytesStart(0),
+  fFileBytesEnd(0),
+  fTotBytesFull(0.),
+  fZipBytesFull(0.),
+  fEntriesFull(0)
  {
     // Constructor
 }
@@ -59,9 +101,115 @@ Bool_t AliReducedEventInputHandler::Init(TTree* tree, Option_t* opt)
     
     tree->SetBranchAddress("Event",&fReducedEvent);
     
+    SetupPartialReading();
+    
     return kTRUE;
 }
 
+//______________________________________________________________________________
+UInt_t AliReducedEventInputHandler::ComponentsFromUsedVars()
+{
+   //
+   // Sub-objects of the event needed to compute the variables flagged in AliReducedVarManager.
+   // Track and pair variables share the same range, so any of them requires all the track and pair arrays;
+   // use SetRequiredComponents() to select among them. The FMD array is not used by any variable.
+   //
+   UInt_t components = 0;
+   for(Int_t ivar=AliReducedVarManager::kTPCQvecXtree; ivar<AliReducedVarManager::kZDCnEnergyCh; ++ivar)
+      if(AliReducedVarManager::GetUsedVar((AliReducedVarManager::Variables)ivar)) components |= kEventPlane;
+   for(Int_t ivar=AliReducedVarManager::kRPXtpcXvzeroa; ivar<AliReducedVarManager::kRPdeltaVZEROCtpc+6; ++ivar)
+      if(AliReducedVarManager::GetUsedVar((AliReducedVarManager::Variables)ivar)) components |= kEventPlane;
+   for(Int_t ivar=AliReducedVarManager::kEMCALmatchedEnergy; ivar<AliReducedVarManager::kNTrackVars; ++ivar)
+      if(AliReducedVarManager::GetUsedVar((AliReducedVarManager::Variables)ivar)) components |= kCaloClusters;
+   for(Int_t ivar=AliReducedVarManager::kNEventVars; ivar<AliReducedVarManager::kNVars; ++ivar) {
+      if(!AliReducedVarManager::GetUsedVar((AliReducedVarManager::Variables)ivar)) continue;
+      if(ivar>AliReducedVarManager::kNTrackVars && ivar<AliReducedVarManager::kNEMCALvars) components |= kCaloClusters;
+      else components |= (kTracks | kTracks2 | kPairs);
+   }
+   return components;
+}
+
+//______________________________________________________________________________
+Int_t AliReducedEventInputHandler::ComponentOfBranch(const Char_t* name) const
+{
+   //
+   // Sub-object (EReducedEventComponents) stored in a sub-branch of the "Event" branch, 0 for the event header
+   //
+   TString member(name);
+   if(member.BeginsWith("Event.")) member.Remove(0,6);
+   Ssiz_t end = member.First('.');
+   if(end>=0) member.Remove(end);
+   end = member.First('[');
+   if(end>=0) member.Remove(end);
+   if(member.EqualTo("fTracks")) return kTracks;
+   if(member.EqualTo("fTracks2")) return kTracks2;
+   if(member.EqualTo("fCandidates")) return kPairs;
+   if(member.EqualTo("fCaloClusters")) return kCaloClusters;
+   if(member.EqualTo("fFMD")) return kFMD;
+   if(member.EqualTo("fEventPlane")) return kEventPlane;
+   return 0;
+}
+
+//______________________________________________________________________________
+void AliReducedEventInputHandler::SetupPartialReading()
+{
+   //
+   // Switch off the sub-branches of the event which are not needed by the analysis
+   //
+   fReadComponents = kAllComponents;
+   fCurrentTreeNumber = -1;
+   if(!fUsePartialReading) return;
+   
+   fReadComponents = ComponentsFromUsedVars();
+   if(fRequiredComponents>=0)
+      fReadComponents = (fReadComponents & (kCaloClusters | kEventPlane)) | UInt_t(fRequiredComponents);
+   // the polarization variables of the pairs are computed from the legs, taken from the track array
+   if((fReadComponents & kPairs) &&
+      (AliReducedVarManager::GetUsedVar(AliReducedVarManager::kPairThetaCS) || AliReducedVarManager::GetUsedVar(AliReducedVarManager::kPairThetaHE) ||
+       AliReducedVarManager::GetUsedVar(AliReducedVarManager::kPairPhiCS) || AliReducedVarManager::GetUsedVar(AliReducedVarManager::kPairPhiHE)))
+      fReadComponents |= kTracks;
+   
+   TBranch* eventBranch = fTree->GetBranch("Event");
+   if(!eventBranch || !eventBranch->GetListOfBranches()->GetEntries()) {
+      cout << "AliReducedEventInputHandler::SetupPartialReading(): WARNING The Event branch is not split, all the event is read" << endl;
+      fReadComponents = kAllComponents;
+      return;
+   }
+   TIter next(eventBranch->GetListOfBranches());
+   TString disabled = "";
+   while(TBranch* branch = (TBranch*)next()) {
+      Int_t component = ComponentOfBranch(branch->GetName());
+      if(!component || (fReadComponents & component)) continue;
+      fTree->SetBranchStatus(branch->GetName(), 0);
+      if(branch->GetListOfBranches()->GetEntries()) fTree->SetBranchStatus(Form("%s.*", branch->GetName()), 0);
+      disabled += Form(" %s", branch->GetName());
+   }
+   cout << "AliReducedEventInputHandler::SetupPartialReading(): Branches switched off:" << (disabled.IsNull() ? " none" : disabled.Data()) << endl;
+}
+
+//______________________________________________________________________________
+void AliReducedEventInputHandler::ConnectBranches()
+{
+   //
+   // Split the active sub-branches of the current tree into the ones needed by the prefilter (header)
+   // and the arrays, which are read only for selected events
+   //
+   fHeaderBranches.clear();
+   fArrayBranches.clear();
+   TTree* tree = fTree->GetTree();
+   TBranch* eventBranch = (tree ? tree->GetBranch("Event") : 0x0);
+   if(!eventBranch) return;
+   TIter next(eventBranch->GetListOfBranches());
+   while(TBranch* branch = (TBranch*)next()) {
+      Int_t component = ComponentOfBranch(branch->GetName());
+      if(component && !(fReadComponents & component)) continue;
+      if(component && component!=kEventPlane) fArrayBranches.push_back(branch);
+      else fHeaderBranches.push_back(branch);
+   }
+   // the whole event is read if the tree is not split
+   if(fHeaderBranches.empty() && fArrayBranches.empty()) fHeaderBranches.push_back(eventBranch);
+}
+
 
 //______________________________________________________________________________
 Bool_t AliReducedEventInputHandler::BeginEvent(Long64_t entry)
@@ -71,7 +219,38 @@ Bool_t AliReducedEventInputHandler::BeginEvent(Long64_t entry)
     if (prevRunNumber != fReducedEvent->RunNo() ) {
       prevRunNumber = fReducedEvent->RunNo();
     } 
-    fTree->GetEvent(entry);
+    if (!fNEventsRead) fFileBytesStart = TFile::GetFileBytesRead();
+    
+    Long64_t localEntry = fTree->LoadTree(entry);
+    if (localEntry<0) return kFALSE;
+    if (fTree->GetTreeNumber() != fCurrentTreeNumber) {
+      fCurrentTreeNumber = fTree->GetTreeNumber();
+      TTree* tree = fTree->GetTree();
+      fTotBytesFull += tree->GetTotBytes();
+      fZipBytesFull += tree->GetZipBytes();
+      fEntriesFull += tree->GetEntries();
+      if (fPrefilterCut) ConnectBranches();
+    }
+    
+    Int_t nBytes = 0;
+    fEventSelected = kTRUE;
+    if (!fPrefilterCut) nBytes = fTree->GetEvent(entry);
+    else {
+      // read the header, evaluate the prefilter and read the arrays only for selected events
+      for (UInt_t ib=0; ib<fHeaderBranches.size(); ++ib) nBytes += fHeaderBranches[ib]->GetEntry(localEntry);
+      // keep the run wise information update for the analysis call of FillEventInfo()
+      Int_t currentRun = AliReducedVarManager::GetCurrentRunNumber();
+      AliReducedVarManager::FillEventInfo(fReducedEvent, fPrefilterValues);
+      AliReducedVarManager::SetCurrentRunNumber(currentRun);
+      fEventSelected = fPrefilterCut->IsSelected(fReducedEvent, fPrefilterValues);
+      if (fEventSelected) {
+        for (UInt_t ib=0; ib<fArrayBranches.size(); ++ib) nBytes += fArrayBranches[ib]->GetEntry(localEntry);
+      }
+      else fNEventsRejected++;
+    }
+    fNBytesRead += nBytes;
+    fNEventsRead++;
+    fFileBytesEnd = TFile::GetFileBytesRead();
     
     // set transient pointer to event inside tracks
     // fEvent->ConnectTracks();
@@ -101,3 +280,36 @@ Bool_t AliReducedEventInputHandler::FinishEvent()
   if (fReducedEvent) fReducedEvent->ClearEvent();
   return kTRUE;
 }
+
+//______________________________________________________________________________
+Bool_t AliReducedEventInputHandler::TerminateIO()
+{
+  // Report the reading statistics
+  PrintReadingStatistics();
+  return kTRUE;
+}
+
+//______________________________________________________________________________
+void AliReducedEventInputHandler::PrintReadingStatistics() const
+{
+  //
+  // Bytes read per event, to be compared with the size of the full events in the visited trees.
+  // The compressed bytes are taken from TFile::GetFileBytesRead(), which counts all the files read in the process
+  //
+  if (!fNEventsRead) return;
+  const Char_t* componentNames[6] = {"tracks", "tracks2", "pairs", "calo clusters", "FMD", "event plane"};
+  TString components = "";
+  for (Int_t ic=0; ic<6; ++ic)
+    if (fReadComponents & (1<<ic)) components += Form(" %s", componentNames[ic]);
+  
+  cout << "AliReducedEventInputHandler: " << fNEventsRead << " events read";
+  if (fPrefilterCut) cout << ", " << fNEventsRejected << " rejected by the prefilter " << fPrefilterCut->GetName();
+  cout << endl;
+  cout << "   sub-objects read:" << (components.IsNull() ? " none" : components.Data()) << endl;
+  cout << "   uncompressed bytes per event: " << fNBytesRead/fNEventsRead;
+  if (fEntriesFull) cout << " (full event: " << fTotBytesFull/fEntriesFull << ")";
+  cout << endl;
+  cout << "   compressed bytes per event read from files: " << Double_t(fFileBytesEnd-fFileBytesStart)/fNEventsRead;
+  if (fEntriesFull) cout << " (full event: " << fZipBytesFull/fEntriesFull << ")";
+  cout << endl;
+}
@@ -6,10 +6,14 @@
 //     Author: Ionut-Cristian Arsene, iarsene@cern.ch, i.c.arsene@fys.uio.no
 //
 
+#include <vector>
 #include "AliInputEventHandler.h"
 #include "AliReducedBaseEvent.h"
 //#include "AliReducedEventInfo.h"
+#include "AliReducedVarManager.h"
 class TTree;
+class TBranch;
+class AliReducedInfoCut;
 
 class AliReducedEventInputHandler : public AliInputEventHandler {
   public:
@@ -17,6 +21,16 @@ class AliReducedEventInputHandler : public AliInputEventHandler {
    enum EReducedEventInputType {
       kReducedBaseEvent=0,     // minimal event information (AliReducedBaseEvent)
       kReducedEventInfo            // extended event information (AliReducedEventInfo)
+   };
+   // sub-objects of the event which can be left unread (partial reading)
+   enum EReducedEventComponents {
+      kTracks       = BIT(0),     // fTracks
+      kTracks2      = BIT(1),     // fTracks2
+      kPairs        = BIT(2),     // fCandidates
+      kCaloClusters = BIT(3),     // fCaloClusters (AliReducedEventInfo only)
+      kFMD          = BIT(4),     // fFMD (AliReducedEventInfo only)
+      kEventPlane   = BIT(5),     // fEventPlane (AliReducedEventInfo only)
+      kAllComponents = BIT(6)-1
    };
     AliReducedEventInputHandler();
     AliReducedEventInputHandler(const char* name, const char* title);
@@ -30,19 +44,57 @@ class AliReducedEventInputHandler : public AliInputEventHandler {
     virtual Bool_t                             Notify() { return AliVEventHandler::Notify();};
     virtual Bool_t                             Notify(const char* path);
     virtual Bool_t                             FinishEvent();
+    virtual Bool_t                             TerminateIO();
              
                  void                                SetInputEventType(Int_t type) {fEventInputOption = type;} ;
                  Int_t                               GetInputEventType() const {return fEventInputOption;};
                  
+                 // partial reading: only the sub-objects needed by the variables flagged in AliReducedVarManager
+                 // (plus the ones declared with SetRequiredComponents) are read from the tree;
+                 // the track array is always read with the pairs if the pair polarization variables are used
+                 void                                SetUsePartialReading(Bool_t flag=kTRUE) {fUsePartialReading = flag;}
+                 void                                SetRequiredComponents(UInt_t components) {fRequiredComponents = components;}
+                 void                                SetEventPrefilter(AliReducedInfoCut* cut) {fPrefilterCut = cut;}
+                 Bool_t                              GetUsePartialReading() const {return fUsePartialReading;}
+                 UInt_t                              GetReadComponents() const {return fReadComponents;}
+                 Bool_t                              IsEventSelected() const {return fEventSelected;}
+                 void                                PrintReadingStatistics() const;
+                 
+    static      UInt_t                              ComponentsFromUsedVars();
+                 
  private:
     AliReducedEventInputHandler(const AliReducedEventInputHandler& handler);             
     AliReducedEventInputHandler& operator=(const AliReducedEventInputHandler& handler);      
     
+    void   SetupPartialReading();
+    void   ConnectBranches();
+    Int_t  ComponentOfBranch(const Char_t* name) const;
+    
     Int_t  fEventInputOption;                          // one of the options listed in EReducedEventInputType
     AliReducedBaseEvent* fReducedEvent;   //! Pointer to the event
     //AliReducedEventInfo* fReducedEvent;   //! Pointer to the event
     
-    ClassDef(AliReducedEventInputHandler, 2);
+    Bool_t fUsePartialReading;                 // if true, switch off the branches of the sub-objects not needed by the analysis
+    Int_t  fRequiredComponents;                // sub-objects (EReducedEventComponents) read on top of the calo/event plane ones derived from the used variables; -1: derive all from the used variables
+    AliReducedInfoCut* fPrefilterCut;          // event cut evaluated on the event header before the arrays are read
+    
+    UInt_t fReadComponents;                    //! sub-objects currently read
+    Bool_t fEventSelected;                     //! result of the prefilter for the current event
+    Int_t  fCurrentTreeNumber;                 //! tree of the chain for which the branch lists below were built
+    std::vector<TBranch*> fHeaderBranches;     //! active branches read before the prefilter
+    std::vector<TBranch*> fArrayBranches;      //! active array branches, read only for prefilter selected events
+    Float_t fPrefilterValues[AliReducedVarManager::kNVars];   //! values used by the prefilter
+    
+    Long64_t fNEventsRead;                     //! number of events seen by BeginEvent()
+    Long64_t fNEventsRejected;                 //! number of events rejected by the prefilter
+    Double_t fNBytesRead;                      //! uncompressed bytes returned by GetEntry()
+    Long64_t fFileBytesStart;                  //! TFile::GetFileBytesRead() at the first event
+    Long64_t fFileBytesEnd;                    //! TFile::GetFileBytesRead() at the last event
+    Double_t fTotBytesFull;                    //! uncompressed size of the full events of the visited trees
+    Double_t fZipBytesFull;                    //! compressed size of the full events of the visited trees
+    Long64_t fEntriesFull;                     //! number of entries of the visited trees
+    
+    ClassDef(AliReducedEventInputHandler, 3);
 };
 
 #endif
@@ -2000,10 +2000,13 @@ void AliReducedVarManager::FillPairInfo(PAIR* p, Float_t* values) {
   Bool_t usePolarization=kFALSE;
   if(fgUsedVars[kPairThetaCS] || fgUsedVars[kPairThetaHE] || fgUsedVars[kPairPhiCS] || fgUsedVars[kPairPhiHE])
     usePolarization = kTRUE;
-  if(usePolarization)
-    GetThetaPhiCM(fgEvent->GetTrack(((AliReducedPairInfo*)p)->LegId(0)), 
-		  fgEvent->GetTrack(((AliReducedPairInfo*)p)->LegId(1)), 
-		  values[kPairThetaHE], values[kPairPhiHE], values[kPairThetaCS], values[kPairPhiCS], m1, m2);
+  if(usePolarization) {
+    // the legs are missing if the track array was not read (see AliReducedEventInputHandler::SetRequiredComponents())
+    BASETRACK* leg1 = fgEvent->GetTrack(((AliReducedPairInfo*)p)->LegId(0));
+    BASETRACK* leg2 = fgEvent->GetTrack(((AliReducedPairInfo*)p)->LegId(1));
+    if(leg1 && leg2)
+      GetThetaPhiCM(leg1, leg2, values[kPairThetaHE], values[kPairPhiHE], values[kPairThetaCS], values[kPairPhiCS], m1, m2);
+  }
 }
 
 
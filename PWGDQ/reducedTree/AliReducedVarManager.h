@@ -695,6 +695,9 @@ class AliReducedVarManager : public TObject {
   
   static void SetEvent(AliReducedBaseEvent* const ev) {fgEvent = ev;};
   static void SetEventPlane(AliReducedEventPlaneInfo* const ev) {fgEventPlane = ev;};
+  // run for which the run wise information was last updated in FillEventInfo()
+  static Int_t GetCurrentRunNumber() {return fgCurrentRunNumber;}
+  static void SetCurrentRunNumber(Int_t run) {fgCurrentRunNumber = run;}
   static void SetUseVariable(Variables var) {fgUsedVars[var] = kTRUE; SetVariableDependencies();}
   static void SetUseVars(Bool_t* usedVars) {
     for(Int_t i=0;i<kNVars;++i) {
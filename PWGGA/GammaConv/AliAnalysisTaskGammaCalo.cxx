@@ -457,7 +457,8 @@ AliAnalysisTaskGammaCalo::AliAnalysisTaskGammaCalo(): AliAnalysisTaskSE(),
   fAllowOverlapHeaders(kTRUE),
   fNCurrentClusterBasic(0),
   fTrackMatcherRunningMode(0),
-  fDoPi0Only(kFALSE)
+  fDoPi0Only(kFALSE),
+  fUseSubCutCache(kFALSE)
 {
 
 }
@@ -858,7 +859,8 @@ AliAnalysisTaskGammaCalo::AliAnalysisTaskGammaCalo(const char *name):
   fAllowOverlapHeaders(kTRUE),
   fNCurrentClusterBasic(0),
   fTrackMatcherRunningMode(0),
-  fDoPi0Only(kFALSE)
+  fDoPi0Only(kFALSE),
+  fUseSubCutCache(kFALSE)
 {
   // Define output slots here
   DefineOutput(1, TList::Class());
@@ -968,6 +970,12 @@ void AliAnalysisTaskGammaCalo::UserCreateOutputObjects(){
   fV0Reader=(AliV0ReaderV1*)AliAnalysisManager::GetAnalysisManager()->GetTask(fV0ReaderName.Data());
   if(!fV0Reader){printf("Error: No V0 Reader");return;} // GetV0Reader
 
+  if(fUseSubCutCache){
+    for(Int_t iCut = 0; iCut<fnCuts;iCut++){
+      ((AliCaloPhotonCuts*)fClusterCutArray->At(iCut))->SetUseSubCutCache(kTRUE);
+    }
+  }
+
   if(fDoMesonAnalysis){ //Same Jet Finder MUST be used within same trainconfig
     if( ((AliConversionMesonCuts*)fMesonCutArray->At(0))->DoJetAnalysis())  fDoJetAnalysis = kTRUE;
     if( ((AliConversionMesonCuts*)fMesonCutArray->At(0))->DoJetQA())        fDoJetQA       = kTRUE;
@@ -124,6 +124,7 @@ class AliAnalysisTaskGammaCalo : public AliAnalysisTaskSE {
     void SetTrackMatcherRunningMode(Int_t mode){fTrackMatcherRunningMode = mode;}
 
     void SetSoftAnalysis(Bool_t DoSoft)  {fDoSoftAnalysis = DoSoft;}
+    void SetUseSubCutCache(Bool_t flag) {fUseSubCutCache = flag;}
 
   protected:
     AliV0ReaderV1*        fV0Reader;                                            // basic photon Selection Task
@@ -545,11 +546,12 @@ class AliAnalysisTaskGammaCalo : public AliAnalysisTaskSE {
     Int_t                 fNCurrentClusterBasic;                                // current number of cluster without minE
     Int_t                 fTrackMatcherRunningMode;                             // CaloTrackMatcher running mode
     Bool_t                fDoPi0Only;                                           // switches ranges of histograms and binnings to pi0 specific analysis
+    Bool_t                fUseSubCutCache;                                      // share identical sub-selections of the cluster cuts between cut configurations
   private:
     AliAnalysisTaskGammaCalo(const AliAnalysisTaskGammaCalo&);                  // Prevent copy-construction
     AliAnalysisTaskGammaCalo &operator=(const AliAnalysisTaskGammaCalo&);       // Prevent assignment
 
-    ClassDef(AliAnalysisTaskGammaCalo, 70);
+    ClassDef(AliAnalysisTaskGammaCalo, 71);
 };
 
 #endif
@@ -452,7 +452,8 @@ AliAnalysisTaskGammaConvCalo::AliAnalysisTaskGammaConvCalo(): AliAnalysisTaskSE(
   fFileNameBroken(NULL),
   fAllowOverlapHeaders(kTRUE),
   fTrackMatcherRunningMode(0),
-  fDoHBTHistoOutput(kFALSE)
+  fDoHBTHistoOutput(kFALSE),
+  fUseSubCutCache(kFALSE)
 {
 
 }
@@ -849,7 +850,8 @@ AliAnalysisTaskGammaConvCalo::AliAnalysisTaskGammaConvCalo(const char *name):
   fFileNameBroken(NULL),
   fAllowOverlapHeaders(kTRUE),
   fTrackMatcherRunningMode(0),
-  fDoHBTHistoOutput(kFALSE)
+  fDoHBTHistoOutput(kFALSE),
+  fUseSubCutCache(kFALSE)
 {
   // Define output slots here
   DefineOutput(1, TList::Class());
@@ -1019,6 +1021,13 @@ void AliAnalysisTaskGammaConvCalo::UserCreateOutputObjects(){
   fV0Reader = (AliV0ReaderV1*)AliAnalysisManager::GetAnalysisManager()->GetTask(fV0ReaderName.Data());
   if(!fV0Reader){printf("Error: No V0 Reader");return;}// GetV0Reader
 
+  if(fUseSubCutCache){
+    for(Int_t iCut = 0; iCut<fnCuts;iCut++){
+      ((AliConversionPhotonCuts*)fCutArray->At(iCut))->SetUseSubCutCache(kTRUE);
+      ((AliCaloPhotonCuts*)fClusterCutArray->At(iCut))->SetUseSubCutCache(kTRUE);
+    }
+  }
+
   if(fDoMesonAnalysis){ //Same Jet Finder MUST be used within same trainconfig
     if( ((AliConversionMesonCuts*)fMesonCutArray->At(0))->DoJetAnalysis())  fDoJetAnalysis = kTRUE;
     if( ((AliConversionMesonCuts*)fMesonCutArray->At(0))->DoJetQA())        fDoJetQA       = kTRUE;
@@ -146,6 +146,7 @@ class AliAnalysisTaskGammaConvCalo : public AliAnalysisTaskSE {
     void SetEnableSortingOfMCClusLabels (Bool_t enableSort) { fEnableSortForClusMC   = enableSort;}
 
     void SetTrackMatcherRunningMode(Int_t mode){fTrackMatcherRunningMode = mode;}
+    void SetUseSubCutCache(Bool_t flag){fUseSubCutCache = flag;}
 
   protected:
     AliV0ReaderV1*                      fV0Reader;              // basic photon Selection Task
@@ -579,12 +580,13 @@ class AliAnalysisTaskGammaConvCalo : public AliAnalysisTaskSE {
     Bool_t                  fAllowOverlapHeaders;                               // enable overlapping headers for cluster selection
     Int_t                   fTrackMatcherRunningMode;                           // CaloTrackMatcher running mode
     Bool_t                  fDoHBTHistoOutput;                                  // switch for additional HBT output
+    Bool_t                  fUseSubCutCache;                                    // share identical sub-selections of the photon and cluster cuts between cut configurations
 
   private:
     AliAnalysisTaskGammaConvCalo(const AliAnalysisTaskGammaConvCalo&); // Prevent copy-construction
     AliAnalysisTaskGammaConvCalo &operator=(const AliAnalysisTaskGammaConvCalo&); // Prevent assignment
 
-    ClassDef(AliAnalysisTaskGammaConvCalo, 55);
+    ClassDef(AliAnalysisTaskGammaConvCalo, 56);
 };
 
 #endif
@@ -90,6 +90,11 @@ const char* AliCaloPhotonCuts::fgkCutNames[AliCaloPhotonCuts::kNCuts] = {
   "NLM"                   //18
 };
 
+std::map<TString,Int_t> AliCaloPhotonCuts::fgSubCutIds;
+std::map<std::pair<Int_t,Long_t>,std::pair<Bool_t,Float_t> > AliCaloPhotonCuts::fgSubCutCache;
+Long64_t          AliCaloPhotonCuts::fgSubCutCacheEntry = -1;
+const AliVEvent*  AliCaloPhotonCuts::fgSubCutCacheEvent = NULL;
+
 
 //________________________________________________________________________
 AliCaloPhotonCuts::AliCaloPhotonCuts(Int_t isMC, const char *name,const char *title) :
@@ -281,9 +286,12 @@ AliCaloPhotonCuts::AliCaloPhotonCuts(Int_t isMC, const char *name,const char *ti
   fHistMatchedTrackPClusETruePi0Clus(NULL),
   fNMaxDCalModules(8),
   fgkDCALCols(32),
-  fIsAcceptedForBasic(kFALSE)
+  fIsAcceptedForBasic(kFALSE),
+  fUseSubCutCache(kFALSE),
+  fSubCutEntry(-1)
 {
   for(Int_t jj=0;jj<kNCuts;jj++){fCuts[jj]=0;}
+  ResetSubCutIds();
   fCutString=new TObjString((GetCutNumber()).Data());
 
   fIsMC = isMC;
@@ -479,10 +487,13 @@ AliCaloPhotonCuts::AliCaloPhotonCuts(const AliCaloPhotonCuts &ref) :
   fHistMatchedTrackPClusETruePi0Clus(NULL),
   fNMaxDCalModules(ref.fNMaxDCalModules),
   fgkDCALCols(ref.fgkDCALCols),
-  fIsAcceptedForBasic(ref.fIsAcceptedForBasic)
+  fIsAcceptedForBasic(ref.fIsAcceptedForBasic),
+  fUseSubCutCache(ref.fUseSubCutCache),
+  fSubCutEntry(-1)
 {
   // Copy Constructor
   for(Int_t jj=0;jj<kNCuts;jj++){fCuts[jj]=ref.fCuts[jj];}
+  ResetSubCutIds();
   fCutString=new TObjString((GetCutNumber()).Data());
 
 }
@@ -1939,7 +1950,12 @@ Bool_t AliCaloPhotonCuts::ClusterQualityCuts(AliVCluster* cluster, AliVEvent *ev
 
   // exotic cluster cut
   Float_t energyStar      = 0;
-  if(fUseExoticCluster && IsExoticCluster(cluster, event, energyStar)){
+  Bool_t isExotic         = kFALSE;
+  if(fUseExoticCluster && !GetSubCutResult(kSubCutExotics, clusterID, isExotic, energyStar)){
+    isExotic              = IsExoticCluster(cluster, event, energyStar);
+    SetSubCutResult(kSubCutExotics, clusterID, isExotic, energyStar);
+  }
+  if(fUseExoticCluster && isExotic){
     if(fHistClusterIdentificationCuts)fHistClusterIdentificationCuts->Fill(cutIndex, cluster->E());//3
     if (fDoExoticsQA){
       // replay cuts
@@ -2986,13 +3002,22 @@ void AliCaloPhotonCuts::SplitEnergy(Int_t absCellId1, Int_t absCellId2,
 }
 
 //________________________________________________________________________
-Bool_t AliCaloPhotonCuts::CheckDistanceToBadChannel(AliVCluster* cluster, AliVEvent* event)
+void AliCaloPhotonCuts::InitializeBadChannelCheck(AliVEvent* event)
 {
-  if(fUseDistanceToBadChannel != 1 && fUseDistanceToBadChannel != 2) return kFALSE;
+  // calorimeter set-up needed by CheckDistanceToBadChannel
+  if(fUseDistanceToBadChannel != 1 && fUseDistanceToBadChannel != 2) return;
 
   if( (fClusterType == 1 || fClusterType == 3 || fClusterType == 4) && !fEMCALInitialized ) InitializeEMCAL(event);
   if( fClusterType == 2 && ( !fPHOSInitialized || (fPHOSCurrentRun != event->GetRunNumber()) ) ) InitializePHOS(event);
   if( fClusterType == 2 ) fGeomPHOS = AliPHOSGeometry::GetInstance();
+}
+
+//________________________________________________________________________
+Bool_t AliCaloPhotonCuts::CheckDistanceToBadChannel(AliVCluster* cluster, AliVEvent* event)
+{
+  if(fUseDistanceToBadChannel != 1 && fUseDistanceToBadChannel != 2) return kFALSE;
+
+  InitializeBadChannelCheck(event);
 
   Int_t largestCellID = FindLargestCellInCluster(cluster,event);
   if(largestCellID==-1) AliFatal("CheckDistanceToBadChannel: FindLargestCellInCluster found cluster with NCells<1?");
@@ -3159,6 +3184,7 @@ Bool_t AliCaloPhotonCuts::ClusterIsSelected(AliVCluster *cluster, AliVEvent * ev
   //Selection of Reconstructed photon clusters with Calorimeters
   fIsAcceptedForBasic               = kFALSE;
   FillClusterCutIndex(kPhotonIn);
+  UpdateSubCutCache(event);
 
 //  Double_t vertex[3] = {0,0,0};
 //  event->GetPrimaryVertex()->GetXYZ(vertex);
@@ -3200,7 +3226,7 @@ Bool_t AliCaloPhotonCuts::ClusterIsSelected(AliVCluster *cluster, AliVEvent * ev
   }
 
   // Acceptance Cuts
-  if(!AcceptanceCuts(cluster,event,weight)){
+  if(!AcceptanceCuts(cluster,event,weight,clusterID)){
     FillClusterCutIndex(kAcceptance);
     return kFALSE;
   }
@@ -3217,7 +3243,7 @@ Bool_t AliCaloPhotonCuts::ClusterIsSelected(AliVCluster *cluster, AliVEvent * ev
 
 
 //________________________________________________________________________
-Bool_t AliCaloPhotonCuts::AcceptanceCuts(AliVCluster *cluster, AliVEvent* event, Double_t weight)
+Bool_t AliCaloPhotonCuts::AcceptanceCuts(AliVCluster *cluster, AliVEvent* event, Double_t weight, Long_t clusterID)
 {
    // Exclude certain areas for photon reconstruction
 
@@ -3267,7 +3293,17 @@ Bool_t AliCaloPhotonCuts::AcceptanceCuts(AliVCluster *cluster, AliVEvent* event,
 
   // check distance to bad channel
   if (fUseDistanceToBadChannel>0){
-    if (CheckDistanceToBadChannel(cluster,event)){
+    Bool_t isCloseToBadChannel  = kFALSE;
+    Float_t dummy               = 0.;
+    if (GetSubCutResult(kSubCutBadChannel, clusterID, isCloseToBadChannel, dummy)){
+      // the check was done by another cut object, the calorimeter set-up it
+      // does on the way is still needed by this one
+      InitializeBadChannelCheck(event);
+    } else {
+      isCloseToBadChannel       = CheckDistanceToBadChannel(cluster,event);
+      SetSubCutResult(kSubCutBadChannel, clusterID, isCloseToBadChannel);
+    }
+    if (isCloseToBadChannel){
       if(fHistAcceptanceCuts)fHistAcceptanceCuts->Fill(cutIndex);
       return kFALSE;
     }
@@ -3701,6 +3737,7 @@ Bool_t AliCaloPhotonCuts::InitializeCutsFromCutString(const TString analysisCutS
 //________________________________________________________________________
 Bool_t AliCaloPhotonCuts::SetCut(cutIds cutID, const Int_t value) {
   ///Set individual cut ID
+  ResetSubCutIds();
 
   switch (cutID) {
 
@@ -7438,6 +7475,66 @@ TString AliCaloPhotonCuts::GetCutNumber(){
    return fCutStringRead;
 }
 
+//________________________________________________________________________
+// Canonical fingerprint of a sub-selection: two cut objects with the same
+// fingerprint take the same decision for this sub-selection on a given cluster.
+//________________________________________________________________________
+TString AliCaloPhotonCuts::GetSubCutFingerprint(subCutIds subCut){
+  switch (subCut) {
+    case kSubCutBadChannel:
+      // for clusterType 4 the phi cuts decide between the EMCal and DCal geometry
+      return Form("BadCh_%d_%d_%d_%.17g_%.17g_%.17g_%.17g_%.17g_%s", fCuts[kClusterType], fClusterType, fUseDistanceToBadChannel,
+                  fMinDistanceToBadChannel, fMinPhiCut, fMaxPhiCut, fMinPhiCutDMC, fMaxPhiCutDMC, fCorrTaskSetting.Data());
+    case kSubCutExotics:
+      return Form("Exo_%d_%d_%d_%.17g_%.17g_%s", fCuts[kClusterType], fClusterType, fCuts[kExoticCluster], fExoticEnergyFracCluster,
+                  fExoticMinEnergyCell, fCorrTaskSetting.Data());
+    default:
+      return "";
+  }
+}
+
+//________________________________________________________________________
+Bool_t AliCaloPhotonCuts::UpdateSubCutCache(AliVEvent* event){
+  // returns kTRUE if the shared sub-cut cache can be used for the current event and
+  // clears the shared results when a new event is processed. The fingerprints of this
+  // cut object are interned once after the cuts were set (they are transient, so this
+  // also happens once after the object was streamed to a worker)
+  if (!fUseSubCutCache || !event) return kFALSE;
+  AliAnalysisManager* mgr   = AliAnalysisManager::GetAnalysisManager();
+  if (!mgr) return kFALSE;
+  Long64_t entry            = mgr->GetCurrentEntry();
+  if (entry != fgSubCutCacheEntry || event != fgSubCutCacheEvent){
+    fgSubCutCache.clear();
+    fgSubCutCacheEntry      = entry;
+    fgSubCutCacheEvent      = event;
+  }
+  if (fSubCutId[0] < 0){
+    for (Int_t i = 0; i < kNSubCuts; i++){
+      std::pair<std::map<TString,Int_t>::iterator,Bool_t> id = fgSubCutIds.insert(std::make_pair(GetSubCutFingerprint((subCutIds)i),(Int_t)fgSubCutIds.size()));
+      fSubCutId[i]          = id.first->second;
+    }
+  }
+  fSubCutEntry              = entry;
+  return kTRUE;
+}
+
+//________________________________________________________________________
+Bool_t AliCaloPhotonCuts::GetSubCutResult(subCutIds subCut, Long_t clusterID, Bool_t &result, Float_t &value){
+  // look up the result of a sub-selection already evaluated in this event by a cut object with the same fingerprint
+  if (clusterID < 0 || !fUseSubCutCache || fSubCutEntry != fgSubCutCacheEntry || fSubCutId[subCut] < 0) return kFALSE;
+  std::map<std::pair<Int_t,Long_t>,std::pair<Bool_t,Float_t> >::const_iterator it = fgSubCutCache.find(std::make_pair(fSubCutId[subCut],clusterID));
+  if (it == fgSubCutCache.end()) return kFALSE;
+  result  = it->second.first;
+  value   = it->second.second;
+  return kTRUE;
+}
+
+//________________________________________________________________________
+void AliCaloPhotonCuts::SetSubCutResult(subCutIds subCut, Long_t clusterID, Bool_t result, Float_t value){
+  if (clusterID < 0 || !fUseSubCutCache || fSubCutEntry != fgSubCutCacheEntry || fSubCutId[subCut] < 0) return;
+  fgSubCutCache[std::make_pair(fSubCutId[subCut],clusterID)] = std::make_pair(result,value);
+}
+
 
 //___________________________________________________________________
 // Check if the cluster highest energy tower is exotic.
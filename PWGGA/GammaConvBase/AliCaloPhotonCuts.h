@@ -23,6 +23,7 @@
 #include "AliAnalysisManager.h"
 #include "AliCaloTrackMatcher.h"
 #include "AliPhotonIsolation.h"
+#include <map>
 #include <vector>
 
 
@@ -108,6 +109,13 @@ class AliCaloPhotonCuts : public AliAnalysisCuts {
       kPhotonOut
     };
 
+    // sub-selections of a cluster whose results are shared between cut objects
+    enum subCutIds {
+      kSubCutBadChannel=0,
+      kSubCutExotics,
+      kNSubCuts
+    };
+
     enum MCSet {
       // MC data sets
       kNoMC=0,
@@ -256,6 +264,7 @@ class AliCaloPhotonCuts : public AliAnalysisCuts {
 
     Bool_t      InitializeCutsFromCutString(const TString analysisCutSelection);
     TString     GetCutNumber();
+    TString     GetSubCutFingerprint(subCutIds subCut);
     Int_t       GetClusterType() {return fClusterType;}
     Int_t       GetMinNLMCut() {return fMinNLM;}
     Int_t       GetMaxNLMCut() {return fMaxNLM;}
@@ -331,7 +340,7 @@ class AliCaloPhotonCuts : public AliAnalysisCuts {
     Float_t     GetInvMassConversionRecovery()                  {return fMaxMGGRecConv;}
 
     // Cut functions
-    Bool_t      AcceptanceCuts(AliVCluster* cluster, AliVEvent *event, Double_t weight);
+    Bool_t      AcceptanceCuts(AliVCluster* cluster, AliVEvent *event, Double_t weight, Long_t clusterID = -1);
     Bool_t      ClusterQualityCuts(AliVCluster* cluster,AliVEvent *event, AliMCEvent *mcEvent, Int_t isMC, Double_t weight, Long_t clusterID);
 
     Bool_t      MatchConvPhotonToCluster(AliAODConversionPhoton* convPhoton, AliVCluster* cluster, AliVEvent* event, Double_t weight=1.);
@@ -346,6 +355,7 @@ class AliCaloPhotonCuts : public AliAnalysisCuts {
     Int_t       FindLargestCellInCluster(AliVCluster* cluster, AliVEvent* event);
     Int_t       FindSecondLargestCellInCluster(AliVCluster* cluster, AliVEvent* event);
     Bool_t      CheckDistanceToBadChannel(AliVCluster* cluster, AliVEvent* event);
+    void        InitializeBadChannelCheck(AliVEvent* event);
     Int_t       ClassifyClusterForTMEffi(AliVCluster* cluster, AliVEvent* event, AliMCEvent* mcEvent, Bool_t isESD);
 
     std::vector<Int_t> GetVectorMatchedTracksToCluster(AliVEvent* event, AliVCluster* cluster);
@@ -404,11 +414,16 @@ class AliCaloPhotonCuts : public AliAnalysisCuts {
     Bool_t      IsExoticCluster ( AliVCluster *cluster, AliVEvent *event, Float_t& energyStar );
     Float_t     GetECross ( Int_t absID, AliVCaloCells* cells );
     Bool_t      AcceptCellByBadChannelMap (Int_t absID );
-    void        SetExoticsMinCellEnergyCut(Double_t minE)       { fExoticMinEnergyCell = minE; return;}
+    void        SetExoticsMinCellEnergyCut(Double_t minE)       { fExoticMinEnergyCell = minE; ResetSubCutIds(); return;}
     void        SetExoticsQA(Bool_t enable)                     { fDoExoticsQA         = enable; return;}
 
+    // share the results of identical sub-selections between cut objects within one event,
+    // requires that all users of the cut objects pass the cluster index in the event as clusterID
+    void        SetUseSubCutCache(Bool_t enable)                { fUseSubCutCache      = enable; return;}
+    Bool_t      GetUseSubCutCache()                             { return fUseSubCutCache;}
+
     // Function to set correction task setting
-    void SetCorrectionTaskSetting(TString setting) {fCorrTaskSetting = setting;}
+    void SetCorrectionTaskSetting(TString setting) {fCorrTaskSetting = setting; ResetSubCutIds();}
 
     AliEMCALGeometry* GetGeomEMCAL(){return fGeomEMCAL;}
     AliPHOSGeometry*  GetGeomPHOS() {return fGeomPHOS;}
@@ -630,9 +645,23 @@ class AliCaloPhotonCuts : public AliAnalysisCuts {
     Int_t      fgkDCALCols;                             // Number of columns in DCal
     Bool_t     fIsAcceptedForBasic;                     // basic counting
 
+    // sharing of sub-selection results between cut objects
+    Bool_t     fUseSubCutCache;                         // flag for using the event-wise sub-cut cache
+    Int_t      fSubCutId[kNSubCuts];                    //! index of the sub-cut fingerprints in fgSubCutIds, -1 until computed
+    Long64_t   fSubCutEntry;                            //! entry for which the shared cache was last updated
+
   private:
+    void        ResetSubCutIds()                                { for(Int_t i=0;i<kNSubCuts;i++) fSubCutId[i] = -1;}
+    Bool_t      UpdateSubCutCache(AliVEvent* event);
+    Bool_t      GetSubCutResult(subCutIds subCut, Long_t clusterID, Bool_t &result, Float_t &value);
+    void        SetSubCutResult(subCutIds subCut, Long_t clusterID, Bool_t result, Float_t value = 0.);
+
+    static std::map<TString,Int_t> fgSubCutIds;         // index of each distinct sub-cut fingerprint
+    static std::map<std::pair<Int_t,Long_t>,std::pair<Bool_t,Float_t> > fgSubCutCache; // results of the sub-selections for the current event
+    static Long64_t           fgSubCutCacheEntry;        // entry for which fgSubCutCache was filled
+    static const AliVEvent*   fgSubCutCacheEvent;        // event for which fgSubCutCache was filled
 
-    ClassDef(AliCaloPhotonCuts,89)
+    ClassDef(AliCaloPhotonCuts,91)
 };
 
 #endif
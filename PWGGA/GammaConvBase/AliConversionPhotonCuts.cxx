@@ -67,6 +67,10 @@ using namespace std;
 ClassImp(AliConversionPhotonCuts)
 /// \endcond
 
+std::set<std::pair<Int_t,Int_t> > AliConversionPhotonCuts::fgAODV0TrackIDs;
+Long64_t                          AliConversionPhotonCuts::fgAODV0Entry = -1;
+const AliVEvent*                  AliConversionPhotonCuts::fgAODV0Event = NULL;
+
 const char* AliConversionPhotonCuts::fgkCutNames[AliConversionPhotonCuts::kNCuts] = {
   "V0FinderType",           // 0
   "EtaCut",                 // 1
@@ -249,7 +253,8 @@ AliConversionPhotonCuts::AliConversionPhotonCuts(const char *name,const char *ti
   fBadRegionCMax(0),
   fBadRegionAMax(0),
   fExcludeMinR(180.),
-  fExcludeMaxR(250.)
+  fExcludeMaxR(250.),
+  fUseSubCutCache(kFALSE)
 {
   InitPIDResponse();
   for(Int_t jj=0;jj<kNCuts;jj++){fCuts[jj]=0;}
@@ -419,7 +424,8 @@ AliConversionPhotonCuts::AliConversionPhotonCuts(const AliConversionPhotonCuts &
   fBadRegionCMax(ref.fBadRegionCMax),
   fBadRegionAMax(ref.fBadRegionAMax),
   fExcludeMinR(ref.fExcludeMinR),
-  fExcludeMaxR(ref.fExcludeMaxR)
+  fExcludeMaxR(ref.fExcludeMaxR),
+  fUseSubCutCache(ref.fUseSubCutCache)
 {
   // Copy Constructor
   for(Int_t jj=0;jj<kNCuts;jj++){fCuts[jj]=ref.fCuts[jj];}
@@ -1296,19 +1302,7 @@ Bool_t AliConversionPhotonCuts::PhotonIsSelected(AliConversionPhotonBase *photon
   if(event->IsA()==AliAODEvent::Class() && fPreSelCut && ( fIsHeavyIon != 1 || (fIsHeavyIon == 1 && fProcessAODCheck) )) {
     AliAODEvent* aodEvent = dynamic_cast<AliAODEvent*>(event);
 
-    Bool_t bFound = kFALSE;
-    Int_t v0PosID = posTrack->GetID();
-    Int_t v0NegID = negTrack->GetID();
-    AliAODv0* v0 = NULL;
-    for(Int_t iV=0; iV<aodEvent->GetNumberOfV0s(); iV++){
-      v0 = aodEvent->GetV0(iV);
-      if(!v0) continue;
-      if( (v0PosID == v0->GetPosID() && v0NegID == v0->GetNegID()) || (v0PosID == v0->GetNegID() && v0NegID == v0->GetPosID()) ){
-        bFound = kTRUE;
-        break;
-      }
-    }
-    if(!bFound){
+    if(!IsV0InAOD(aodEvent, posTrack->GetID(), negTrack->GetID())){
       FillPhotonCutIndex(kNoV0);
       return kFALSE;
     }
@@ -1341,6 +1335,38 @@ Bool_t AliConversionPhotonCuts::PhotonIsSelected(AliConversionPhotonBase *photon
   return kTRUE;
 }
 
+///________________________________________________________________________
+Bool_t AliConversionPhotonCuts::IsV0InAOD(AliAODEvent* aodEvent, Int_t posID, Int_t negID){
+  // check if a V0 with the given daughter track IDs exists in the AOD event, in either
+  // charge assignment. With the sub-cut cache the track ID pairs are collected once per
+  // event and shared by all cut objects, instead of looping over the V0s for every photon.
+  if(!aodEvent) return kFALSE;
+
+  AliAnalysisManager* mgr = AliAnalysisManager::GetAnalysisManager();
+  if(fUseSubCutCache && mgr){
+    if(mgr->GetCurrentEntry() != fgAODV0Entry || aodEvent != fgAODV0Event){
+      fgAODV0TrackIDs.clear();
+      for(Int_t iV=0; iV<aodEvent->GetNumberOfV0s(); iV++){
+        AliAODv0* v0 = aodEvent->GetV0(iV);
+        if(!v0) continue;
+        fgAODV0TrackIDs.insert(std::make_pair(v0->GetPosID(),v0->GetNegID()));
+      }
+      fgAODV0Entry = mgr->GetCurrentEntry();
+      fgAODV0Event = aodEvent;
+    }
+    return fgAODV0TrackIDs.count(std::make_pair(posID,negID)) || fgAODV0TrackIDs.count(std::make_pair(negID,posID));
+  }
+
+  for(Int_t iV=0; iV<aodEvent->GetNumberOfV0s(); iV++){
+    AliAODv0* v0 = aodEvent->GetV0(iV);
+    if(!v0) continue;
+    if( (posID == v0->GetPosID() && negID == v0->GetNegID()) || (posID == v0->GetNegID() && negID == v0->GetPosID()) ){
+      return kTRUE;
+    }
+  }
+  return kFALSE;
+}
+
 ///________________________________________________________________________
 Bool_t AliConversionPhotonCuts::ArmenterosQtCut(AliConversionPhotonBase *photon){   // Armenteros Qt Cut
   if(fDo2DQt){
@@ -17,6 +17,8 @@
 #include "AliAnalysisManager.h"
 #include "AliDalitzAODESDMC.h"
 #include "AliDalitzEventMC.h"
+#include <set>
+#include <utility>
 
 
 class AliESDEvent;
@@ -179,6 +181,8 @@ class AliConversionPhotonCuts : public AliAnalysisCuts {
 
     void SetV0ReaderName(TString name){fV0ReaderName = name; return;}
     void SetProcessAODCheck(Bool_t flag){fProcessAODCheck = flag; return;}
+    /// share the event-wise lookups (e.g. the V0 track pairs of the AOD check) between cut objects
+    void SetUseSubCutCache(Bool_t flag){fUseSubCutCache = flag; return;}
 
     AliVTrack * GetTrack(AliVEvent * event, Int_t label);
     AliESDtrack *GetESDTrack(AliESDEvent * event, Int_t label);
@@ -420,10 +424,17 @@ class AliConversionPhotonCuts : public AliAnalysisCuts {
     Double_t          fBadRegionAMax;                       ///<
     Double_t          fExcludeMinR;                         ///< r cut exclude region
     Double_t          fExcludeMaxR;                         ///< r cut exclude region
+    Bool_t            fUseSubCutCache;                      ///< Flag for sharing the event-wise lookups between cut objects
 
   private:
+    Bool_t IsV0InAOD(AliAODEvent* aodEvent, Int_t posID, Int_t negID);
+
+    static std::set<std::pair<Int_t,Int_t> > fgAODV0TrackIDs;   ///< track ID pairs of the V0s in the current AOD event
+    static Long64_t                          fgAODV0Entry;      ///< entry for which fgAODV0TrackIDs was filled
+    static const AliVEvent*                  fgAODV0Event;      ///< event for which fgAODV0TrackIDs was filled
+
     /// \cond CLASSIMP
-    ClassDef(AliConversionPhotonCuts,27)
+    ClassDef(AliConversionPhotonCuts,28)
     /// \endcond
 };
 
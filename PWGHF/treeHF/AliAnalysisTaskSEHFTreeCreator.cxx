@@ -244,7 +244,10 @@ fDoJetSubstructure(false),
 fEnableNsigmaTPCDataCorr(false),
 fSystemForNsigmaTPCDataCorr(AliAODPidHF::kNone),
 fCorrNtrVtx(false),
-fCorrV0MVtx(false)
+fCorrV0MVtx(false),
+fFillCandPerEvent(false),
+fFloat16PIDAndImpPar(false),
+fFloat16Nbits(10)
 {
   fParticleCollArray.SetOwner(kTRUE);
   fJetCollArray.SetOwner(kTRUE);
@@ -531,6 +534,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
     fTreeHandlerD0->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
     fTreeHandlerD0->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
     fVariablesTreeD0 = (TTree*)fTreeHandlerD0->BuildTree(nameoutput,nameoutput);
+    fVariablesTreeD0 = ApplyTreeStorageOptions(fTreeHandlerD0);
     fVariablesTreeD0->SetMaxVirtualSize(1.e+8/nEnabledTrees);
     fTreeEvChar->AddFriend(fVariablesTreeD0);
     
@@ -543,6 +547,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
       fTreeHandlerGenD0->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
       fTreeHandlerGenD0->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
       fGenTreeD0 = (TTree*)fTreeHandlerGenD0->BuildTreeMCGen(nameoutput,nameoutput);
+      fGenTreeD0 = ApplyTreeStorageOptions(fTreeHandlerGenD0);
       fGenTreeD0->SetMaxVirtualSize(1.e+8/nEnabledTrees);
       fTreeEvChar->AddFriend(fGenTreeD0);
     }
@@ -560,6 +565,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
     fTreeHandlerDs->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
     fTreeHandlerDs->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
     fVariablesTreeDs = (TTree*)fTreeHandlerDs->BuildTree(nameoutput,nameoutput);
+    fVariablesTreeDs = ApplyTreeStorageOptions(fTreeHandlerDs);
     fVariablesTreeDs->SetMaxVirtualSize(1.e+8/nEnabledTrees);
     fTreeEvChar->AddFriend(fVariablesTreeDs);
     
@@ -572,6 +578,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
       fTreeHandlerGenDs->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
       fTreeHandlerGenDs->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
       fGenTreeDs = (TTree*)fTreeHandlerGenDs->BuildTreeMCGen(nameoutput,nameoutput);
+      fGenTreeDs = ApplyTreeStorageOptions(fTreeHandlerGenDs);
       fGenTreeDs->SetMaxVirtualSize(1.e+8/nEnabledTrees);
       fTreeEvChar->AddFriend(fGenTreeDs);
     }
@@ -588,6 +595,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
     fTreeHandlerDplus->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
     fTreeHandlerDplus->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
     fVariablesTreeDplus = (TTree*)fTreeHandlerDplus->BuildTree(nameoutput,nameoutput);
+    fVariablesTreeDplus = ApplyTreeStorageOptions(fTreeHandlerDplus);
     fVariablesTreeDplus->SetMaxVirtualSize(1.e+8/nEnabledTrees);
     fTreeEvChar->AddFriend(fVariablesTreeDplus);
     if(fFillMCGenTrees && fReadMC) {
@@ -599,6 +607,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
       fTreeHandlerGenDplus->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
       fTreeHandlerGenDplus->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
       fGenTreeDplus = (TTree*)fTreeHandlerGenDplus->BuildTreeMCGen(nameoutput,nameoutput);
+      fGenTreeDplus = ApplyTreeStorageOptions(fTreeHandlerGenDplus);
       fGenTreeDplus->SetMaxVirtualSize(1.e+8/nEnabledTrees);
       fTreeEvChar->AddFriend(fGenTreeDplus);
     }
@@ -615,6 +624,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
     fTreeHandlerLctopKpi->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
     fTreeHandlerLctopKpi->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
     fVariablesTreeLctopKpi = (TTree*)fTreeHandlerLctopKpi->BuildTree(nameoutput,nameoutput);
+    fVariablesTreeLctopKpi = ApplyTreeStorageOptions(fTreeHandlerLctopKpi);
     fVariablesTreeLctopKpi->SetMaxVirtualSize(1.e+8/nEnabledTrees);
     fTreeEvChar->AddFriend(fVariablesTreeLctopKpi);
     if(fFillMCGenTrees && fReadMC) {
@@ -626,7 +636,8 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
       fTreeHandlerGenLctopKpi->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
       fTreeHandlerGenLctopKpi->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
       fGenTreeLctopKpi = (TTree*)fTreeHandlerGenLctopKpi->BuildTreeMCGen(nameoutput,nameoutput);
-      fTreeHandlerGenLctopKpi->AddBranchResonantDecay(fGenTreeLctopKpi);
+      fTreeHandlerGenLctopKpi->AddBranchResonantDecay(fGenTreeLctopKpi); //before the storage options, which rebuild the tree with all its branches
+      fGenTreeLctopKpi = ApplyTreeStorageOptions(fTreeHandlerGenLctopKpi);
       fGenTreeLctopKpi->SetMaxVirtualSize(1.e+8/nEnabledTrees);
       fTreeEvChar->AddFriend(fGenTreeLctopKpi);
     }
@@ -643,6 +654,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
     fTreeHandlerBplus->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
     fTreeHandlerBplus->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
     fVariablesTreeBplus = (TTree*)fTreeHandlerBplus->BuildTree(nameoutput,nameoutput);
+    fVariablesTreeBplus = ApplyTreeStorageOptions(fTreeHandlerBplus);
     fVariablesTreeBplus->SetMaxVirtualSize(1.e+8/nEnabledTrees);
     fTreeEvChar->AddFriend(fVariablesTreeBplus);
     if(fFillMCGenTrees && fReadMC) {
@@ -654,6 +666,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
       fTreeHandlerGenBplus->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
       fTreeHandlerGenBplus->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
       fGenTreeBplus = (TTree*)fTreeHandlerGenBplus->BuildTreeMCGen(nameoutput,nameoutput);
+      fGenTreeBplus = ApplyTreeStorageOptions(fTreeHandlerGenBplus);
       fGenTreeBplus->SetMaxVirtualSize(1.e+8/nEnabledTrees);
       fTreeEvChar->AddFriend(fGenTreeBplus);
     }
@@ -670,6 +683,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
     fTreeHandlerDstar->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
     fTreeHandlerDstar->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
     fVariablesTreeDstar = (TTree*)fTreeHandlerDstar->BuildTree(nameoutput,nameoutput);
+    fVariablesTreeDstar = ApplyTreeStorageOptions(fTreeHandlerDstar);
     fVariablesTreeDstar->SetMaxVirtualSize(1.e+8/nEnabledTrees);
     fTreeEvChar->AddFriend(fVariablesTreeDstar);
     if(fFillMCGenTrees && fReadMC) {
@@ -681,6 +695,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
       fTreeHandlerGenDstar->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
       fTreeHandlerGenDstar->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
       fGenTreeDstar = (TTree*)fTreeHandlerGenDstar->BuildTreeMCGen(nameoutput,nameoutput);
+      fGenTreeDstar = ApplyTreeStorageOptions(fTreeHandlerGenDstar);
       fGenTreeDstar->SetMaxVirtualSize(1.e+8/nEnabledTrees);
       fTreeEvChar->AddFriend(fGenTreeDstar);
     }
@@ -698,6 +713,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
     fTreeHandlerLc2V0bachelor->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
     fTreeHandlerLc2V0bachelor->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
     fVariablesTreeLc2V0bachelor = (TTree*)fTreeHandlerLc2V0bachelor->BuildTree(nameoutput,nameoutput);
+    fVariablesTreeLc2V0bachelor = ApplyTreeStorageOptions(fTreeHandlerLc2V0bachelor);
     fVariablesTreeLc2V0bachelor->SetMaxVirtualSize(1.e+8/nEnabledTrees);
     fTreeEvChar->AddFriend(fVariablesTreeLc2V0bachelor);
     if(fFillMCGenTrees && fReadMC) {
@@ -709,6 +725,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
       fTreeHandlerGenLc2V0bachelor->SetJetProperties(fJetRadius,fJetAlgorithm,fMinJetPt);
       fTreeHandlerGenLc2V0bachelor->SetSubJetProperties(fSubJetRadius,fSubJetAlgorithm);
       fGenTreeLc2V0bachelor = (TTree*)fTreeHandlerGenLc2V0bachelor->BuildTreeMCGen(nameoutput,nameoutput);
+      fGenTreeLc2V0bachelor = ApplyTreeStorageOptions(fTreeHandlerGenLc2V0bachelor);
       fGenTreeLc2V0bachelor->SetMaxVirtualSize(1.e+8/nEnabledTrees);
       fTreeEvChar->AddFriend(fGenTreeLc2V0bachelor);
     }
@@ -833,6 +850,32 @@ void AliAnalysisTaskSEHFTreeCreator::UserCreateOutputObjects()
   return;
 }
 
+//________________________________________________________________________
+TTree* AliAnalysisTaskSEHFTreeCreator::ApplyTreeStorageOptions(AliHFTreeHandler* handler) {
+  /// Storage options of the candidate trees, to be applied after BuildTree/BuildTreeMCGen
+  
+  handler->SetFillPerEvent(fFillCandPerEvent);
+  if(fFloat16PIDAndImpPar) {
+    //truncated mantissa, keeps the default values of the missing PID information
+    handler->AddFloat16Branches("nsig",fFloat16Nbits);
+    handler->AddFloat16Branches("imp_par",fFloat16Nbits);
+  }
+  return handler->ApplyStorageOptions();
+}
+
+//________________________________________________________________________
+void AliAnalysisTaskSEHFTreeCreator::FlushTreeHandlers() {
+  /// One entry per event in the candidate trees, aligned with the event tree
+  
+  AliHFTreeHandler* handlers[] = {fTreeHandlerD0, fTreeHandlerGenD0, fTreeHandlerDs, fTreeHandlerGenDs,
+    fTreeHandlerDplus, fTreeHandlerGenDplus, fTreeHandlerLctopKpi, fTreeHandlerGenLctopKpi,
+    fTreeHandlerBplus, fTreeHandlerGenBplus, fTreeHandlerDstar, fTreeHandlerGenDstar,
+    fTreeHandlerLc2V0bachelor, fTreeHandlerGenLc2V0bachelor};
+  for(AliHFTreeHandler* handler : handlers) {
+    if(handler) handler->FlushEvent(fRunNumber,fEventID);
+  }
+}
+
 //________________________________________________________________________
 void AliAnalysisTaskSEHFTreeCreator::FillJetTree() {
   
@@ -1170,6 +1213,7 @@ void AliAnalysisTaskSEHFTreeCreator::UserExec(Option_t */*option*/)
   if(fWriteVariableTreeDstar) ProcessDstar(arrayDstar,aod,mcArray,aod->GetMagneticField());
   if(fWriteVariableTreeLc2V0bachelor) ProcessCasc(arrayCasc,aod,mcArray,aod->GetMagneticField());
   if(fFillMCGenTrees && fReadMC) ProcessMCGen(mcArray);
+  if(fFillCandPerEvent) FlushTreeHandlers();
   
   // Fill the jet tree
   if (fWriteNJetTrees > 0 || fFillParticleTree) {
@@ -119,6 +119,8 @@ public:
     void SetPIDoptDstarTree(Int_t opt){fPIDoptDstar=opt;}
     void SetPIDoptLc2V0bachelorTree(Int_t opt){fPIDoptLc2V0bachelor=opt;}
     void SetFillMCGenTrees(Bool_t fillMCgen) {fFillMCGenTrees=fillMCgen;}
+    void SetFillCandidatesPerEvent(bool opt=true) {fFillCandPerEvent=opt;}
+    void SetUseFloat16PIDAndImpPar(bool opt=true, int nbits=10) {fFloat16PIDAndImpPar=opt; fFloat16Nbits=nbits;}
   
     void SetMinJetPtCorr(double pt) { fMinJetPtCorr = pt; }
     void SetFillJetEtaPhi(bool b) { fFillJetEtaPhi = b; }
@@ -153,6 +155,8 @@ public:
     void ProcessDstar(TClonesArray *arrayDstar, AliAODEvent *aod, TClonesArray *arrMC, Float_t bfield);
     void ProcessCasc(TClonesArray *arrayCasc, AliAODEvent *aod, TClonesArray *arrMC, Float_t bfield);
     void ProcessMCGen(TClonesArray *mcarray);
+    TTree* ApplyTreeStorageOptions(AliHFTreeHandler* handler);
+    void FlushTreeHandlers();
   
     Bool_t CheckDaugAcc(TClonesArray* arrayMC,Int_t nProng, Int_t *labDau);
     AliAODVertex* ReconstructBplusVertex(const AliVVertex *primary, TObjArray *tracks, Double_t bField, Double_t dispersion);
@@ -380,8 +384,12 @@ private:
     bool fCorrNtrVtx;
     bool fCorrV0MVtx;
 
+    bool fFillCandPerEvent; /// flag to store one entry per event in the candidate trees, with one array per variable
+    bool fFloat16PIDAndImpPar; /// flag to store the PID and impact parameter variables as Float16_t
+    int fFloat16Nbits; /// number of mantissa bits of the Float16_t variables
+
     /// \cond CLASSIMP
-    ClassDef(AliAnalysisTaskSEHFTreeCreator,15);
+    ClassDef(AliAnalysisTaskSEHFTreeCreator,16);
     /// \endcond
 };
 
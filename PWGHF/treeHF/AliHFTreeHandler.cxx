@@ -21,12 +21,15 @@
 
 #include <cmath>
 #include <limits>
+#include <cstring>
 #include "AliHFTreeHandler.h"
 #include "AliPID.h"
 #include "AliAODRecoDecayHF.h"
 #include "AliPIDResponse.h"
 #include "AliESDtrack.h"
 #include "TMath.h"
+#include "TBranch.h"
+#include "TLeaf.h"
 
 /// \cond CLASSIMP
 ClassImp(AliHFTreeHandler);
@@ -95,7 +98,17 @@ AliHFTreeHandler::AliHFTreeHandler():
   fSubJetRadius(0.2),
   fJetAlgorithm(0),
   fSubJetAlgorithm(2),
-  fMinJetPt(0.0)
+  fMinJetPt(0.0),
+  fFillPerEvent(false),
+  fNCandEvent(0),
+  fFloat16Prefix(),
+  fFloat16Nbits(),
+  fFloat16Min(),
+  fFloat16Max(),
+  fColumnSource(),
+  fColumnSize(),
+  fColumnBranch(),
+  fColumnBuffer()
 {
   //
   // Default constructor
@@ -196,7 +209,17 @@ AliHFTreeHandler::AliHFTreeHandler(int PIDopt):
   fSubJetRadius(0.2),
   fJetAlgorithm(0),
   fSubJetAlgorithm(2),
-  fMinJetPt(0.0)
+  fMinJetPt(0.0),
+  fFillPerEvent(false),
+  fNCandEvent(0),
+  fFloat16Prefix(),
+  fFloat16Nbits(),
+  fFloat16Min(),
+  fFloat16Max(),
+  fColumnSource(),
+  fColumnSize(),
+  fColumnBranch(),
+  fColumnBuffer()
 {
   //
   // Standard constructor
@@ -268,6 +291,120 @@ TTree* AliHFTreeHandler::BuildTreeMCGen(TString name, TString title) {
   return fTreeVar;
 }
 
+//________________________________________________________________
+void AliHFTreeHandler::AddFloat16Branches(TString prefix, int nbits, float min, float max) {
+  
+  //float branches whose name starts with prefix are stored as Float16_t with nbits
+  //in [min,max], or with a mantissa truncated to nbits if min==max (keeps the default values, e.g. -999)
+  fFloat16Prefix.push_back(prefix);
+  fFloat16Nbits.push_back(nbits);
+  fFloat16Min.push_back(min);
+  fFloat16Max.push_back(max);
+}
+
+//________________________________________________________________
+int AliHFTreeHandler::GetFloat16Option(TString branchname) const {
+  
+  for(unsigned int iOpt=0; iOpt<fFloat16Prefix.size(); iOpt++) {
+    if(branchname.BeginsWith(fFloat16Prefix[iOpt])) return iOpt;
+  }
+  return -1;
+}
+
+//________________________________________________________________
+TTree* AliHFTreeHandler::ApplyStorageOptions() {
+  
+  //rebuild the tree created in BuildTree/BuildTreeMCGen with the same variables and the requested
+  //storage options: Float16_t branches and/or one entry per event with one array of n_cand elements
+  //per variable (run_number and ev_id stay scalars). Returns the tree to be written in output
+  if(!fTreeVar || (!fFillPerEvent && fFloat16Prefix.empty())) return fTreeVar;
+
+  TTree* treeCand = fTreeVar;
+  fTreeVar = new TTree(treeCand->GetName(),treeCand->GetTitle());
+  fColumnSource.clear();
+  fColumnSize.clear();
+  fColumnBranch.clear();
+  fColumnBuffer.clear();
+  fNCandEvent = 0;
+  if(fFillPerEvent) fTreeVar->Branch("n_cand",&fNCandEvent,"n_cand/i");
+
+  TIter next(treeCand->GetListOfBranches());
+  while(TBranch* branch = (TBranch*)next()) {
+    TString name = branch->GetName();
+    TLeaf* leaf = (TLeaf*)branch->GetListOfLeaves()->At(0);
+    TString type = leaf->GetTypeName();
+    char code = 0;
+    if(type=="Float_t") code = 'F';
+    else if(type=="Double_t") code = 'D';
+    else if(type=="Int_t") code = 'I';
+    else if(type=="UInt_t") code = 'i';
+    else if(type=="Short_t") code = 'S';
+    else if(type=="UShort_t") code = 's';
+    else if(type=="Char_t") code = 'B';
+    else if(type=="UChar_t") code = 'b';
+    else if(type=="Long64_t") code = 'L';
+    else if(type=="ULong64_t") code = 'l';
+    else if(type=="Bool_t") code = 'O';
+    if(!code || leaf->GetLen()!=1 || branch->GetListOfLeaves()->GetEntriesFast()!=1) {
+      AliWarning(Form("Branch %s of type %s cannot be converted, storage options not applied",name.Data(),type.Data()));
+      delete fTreeVar;
+      fTreeVar = treeCand;
+      fColumnSource.clear();
+      fColumnSize.clear();
+      fColumnBranch.clear();
+      fColumnBuffer.clear();
+      return fTreeVar;
+    }
+
+    bool isColumn = fFillPerEvent && name!="run_number" && name!="ev_id";
+    TString leaflist = isColumn ? TString::Format("%s[n_cand]",name.Data()) : name;
+    int iOpt = (code=='F') ? GetFloat16Option(name) : -1;
+    if(iOpt>=0) leaflist += Form("/f[%g,%g,%d]",fFloat16Min[iOpt],fFloat16Max[iOpt],fFloat16Nbits[iOpt]);
+    else leaflist += Form("/%c",code);
+
+    if(isColumn) {
+      fColumnSource.push_back(branch->GetAddress());
+      fColumnSize.push_back(leaf->GetLenType());
+      fColumnBuffer.push_back(vector<char>(leaf->GetLenType()*16));
+      fColumnBranch.push_back(fTreeVar->Branch(name.Data(),fColumnBuffer.back().data(),leaflist.Data()));
+    }
+    else fTreeVar->Branch(name.Data(),branch->GetAddress(),leaflist.Data());
+  }
+  delete treeCand;
+  
+  return fTreeVar;
+}
+
+//________________________________________________________________
+void AliHFTreeHandler::AppendCandidate() {
+  
+  //copy the variables of the current candidate at the end of the per-event columns
+  for(unsigned int iCol=0; iCol<fColumnSource.size(); iCol++) {
+    vector<char> &buffer = fColumnBuffer[iCol];
+    unsigned int offset = fNCandEvent*fColumnSize[iCol];
+    if(buffer.size()<offset+fColumnSize[iCol]) buffer.resize(2*(offset+fColumnSize[iCol]));
+    memcpy(&buffer[offset],fColumnSource[iCol],fColumnSize[iCol]);
+  }
+  fNCandEvent++;
+}
+
+//________________________________________________________________
+void AliHFTreeHandler::FlushEvent(int runnumber, unsigned int eventID) {
+  
+  //one tree entry with all the candidates of the event, also for events without candidates (n_cand=0)
+  //so that the entries stay aligned with the ones of the event tree
+  if(!fFillPerEvent || fColumnBranch.empty()) return;
+
+  //run_number and ev_id are scalars of the entry: set them also when no candidate of this event was filled
+  fRunNumber = runnumber;
+  fEvID = eventID;
+
+  //buffers can have been reallocated while appending candidates
+  for(unsigned int iCol=0; iCol<fColumnBranch.size(); iCol++) fColumnBranch[iCol]->SetAddress(fColumnBuffer[iCol].data());
+  fTreeVar->Fill();
+  fNCandEvent = 0;
+}
+
 //________________________________________________________________
 bool AliHFTreeHandler::SetMCGenVariables(int runnumber, unsigned int eventID, AliAODMCParticle* mcpart) {
 
@@ -101,11 +101,18 @@ class AliHFTreeHandler : public TObject
         fCandType=0;
       }
       else {      
-        fTreeVar->Fill(); 
+        if(fFillPerEvent && !fColumnBranch.empty()) AppendCandidate(); //stored in FlushEvent()
+        else fTreeVar->Fill(); 
         fCandType=0;
         fRunNumberPrevCand = fRunNumber;
       }
     } 
+    void FlushEvent(int runnumber, unsigned int eventID); //to be called at the end of each event when candidates are stored per event
+
+    //storage options, applied with ApplyStorageOptions() after BuildTree/BuildTreeMCGen
+    void SetFillPerEvent(bool fillperevent=true) {fFillPerEvent=fillperevent;}
+    void AddFloat16Branches(TString prefix, int nbits, float min=0., float max=0.);
+    TTree* ApplyStorageOptions();
     
     //common methods
     void SetFillJets(bool FillJets) {fFillJets=FillJets;}
@@ -197,6 +204,9 @@ class AliHFTreeHandler : public TObject
   
     void GetNsigmaTPCMeanSigmaData(float &mean, float &sigma, AliPID::EParticleType species, float pTPC, float eta);
 
+    void AppendCandidate();
+    int GetFloat16Option(TString branchname) const;
+
     TTree* fTreeVar; /// tree with variables
     unsigned int fNProngs; /// number of prongs
     unsigned int fNCandidates; /// number of candidates in one fill (event)
@@ -279,8 +289,19 @@ class AliHFTreeHandler : public TObject
     Int_t fSubJetAlgorithm; //SubJet finding algorithm
     Double_t fMinJetPt; //Jet finding mimimum Jet pT
 
+    bool fFillPerEvent; /// flag to store one tree entry per event, with one array per variable
+    unsigned int fNCandEvent; /// number of candidates stored in the current event (per-event filling)
+    vector<TString> fFloat16Prefix; /// name prefixes of the float branches stored as Float16_t
+    vector<int> fFloat16Nbits; /// number of bits of the Float16_t branches
+    vector<float> fFloat16Min; /// lower limit of the Float16_t branches (min==max: truncated mantissa)
+    vector<float> fFloat16Max; /// upper limit of the Float16_t branches
+    vector<char*> fColumnSource; //!<! address of the variable of each column
+    vector<int> fColumnSize; //!<! size in bytes of a column element
+    vector<TBranch*> fColumnBranch; //!<! array branches of the per-event tree
+    vector<vector<char> > fColumnBuffer; //!<! per-event column buffers
+
   /// \cond CLASSIMP
-  ClassDef(AliHFTreeHandler,9); ///
+  ClassDef(AliHFTreeHandler,10); ///
   /// \endcond
 };
 #endif
@@ -261,6 +261,15 @@ void AliAnalysisTaskSEVertexingHF::UserExec(Option_t */*option*/)
   return;
 }
 
+//________________________________________________________________________
+void AliAnalysisTaskSEVertexingHF::FinishTaskOutput()
+{
+  // Print the rejections of the 3 and 4 prong prefilter stages,
+  // once per worker
+  //
+  if(fVHF) fVHF->PrintPrefilterStatistics();
+}
+
 //________________________________________________________________________
 void AliAnalysisTaskSEVertexingHF::Terminate(Option_t */*option*/)
 {
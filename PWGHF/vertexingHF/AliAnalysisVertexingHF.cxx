@@ -70,6 +70,8 @@
 #include "AliCodeTimer.h"
 #include "AliMultSelection.h"
 #include <cstring>
+#include <unordered_map>
+#include <vector>
 
 /// \cond CLASSIMP
 ClassImp(AliAnalysisVertexingHF);
@@ -157,10 +159,13 @@ fMassDplus(0.),
 fMassDs(0.),
 fMassLambdaC(0.),
 fMassDstar(0.),
-fMassJpsi(0.)
+fMassJpsi(0.),
+fMaxPairVertexCache(100000)
 {
   /// Default constructor
 
+  for(Int_t i=0; i<kNPrefilterStages; i++) { f3ProngPrefilter[i]=0; f4ProngPrefilter[i]=0; }
+
   Double_t d02[2]={0.,0.};
   Double_t d03[3]={0.,0.,0.};
   Double_t d04[4]={0.,0.,0.,0.};
@@ -252,11 +257,13 @@ fMassDplus(source.fMassDplus),
 fMassDs(source.fMassDs),
 fMassLambdaC(source.fMassLambdaC),
 fMassDstar(source.fMassDstar),
-fMassJpsi(source.fMassJpsi)
+fMassJpsi(source.fMassJpsi),
+fMaxPairVertexCache(source.fMaxPairVertexCache)
 {
   ///
   /// Copy constructor
   ///
+  for(Int_t i=0; i<kNPrefilterStages; i++) { f3ProngPrefilter[i]=0; f4ProngPrefilter[i]=0; }
 }
 //--------------------------------------------------------------------------
 AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVertexingHF &source)
@@ -344,6 +351,7 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
   fMassLambdaC = source.fMassLambdaC;
   fMassDstar = source.fMassDstar;
   fMassJpsi = source.fMassJpsi;
+  fMaxPairVertexCache = source.fMaxPairVertexCache;
 
   return *this;
 }
@@ -618,6 +626,28 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   AliDebug(1,Form(" Selected tracks: %d",nSeleTrks));
   fnSeleTrksTotal += nSeleTrks;
 
+  // momenta at the primary vertex, for the invariant mass prefilter of the 3 and 4 prongs
+  std::vector<Double_t> momAtVertex(3*nSeleTrks);
+  for(Int_t iTrk=0; iTrk<nSeleTrks; iTrk++) ((AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrk))->GetPxPyPz(&momAtVertex[3*iTrk]);
+
+  // pair vertices of the 3 prongs, shared by all the triplets built on the same pair of tracks.
+  // AliVertexerTracks works on copies of the tracks, so the tracks are left as they are.
+  std::unordered_map<Long64_t,AliAODVertex*> pairVertices;
+  auto pairVertex = [&](Int_t iTrk0, Int_t iTrk1, TObjArray *pair, Bool_t &owned) -> AliAODVertex* {
+    owned=kFALSE;
+    const Long64_t key=(Long64_t)iTrk0*nSeleTrks+iTrk1;
+    std::unordered_map<Long64_t,AliAODVertex*>::const_iterator cached=pairVertices.find(key);
+    if(cached!=pairVertices.end()) {
+      f3ProngPrefilter[kPrefPairVertexReused]++;
+      return cached->second;
+    }
+    Double_t pairDispersion;
+    AliAODVertex *vtx=ReconstructSecondaryVertex(pair,pairDispersion);
+    if((Long64_t)pairVertices.size()<fMaxPairVertexCache) pairVertices[key]=vtx;
+    else owned=kTRUE;
+    return vtx;
+  };
+
 
   TObjArray *twoTrackArray1    = new TObjArray(2);
   TObjArray *twoTrackArray2    = new TObjArray(2);
@@ -1053,6 +1083,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       for(iTrkP2=iTrkP1+1; iTrkP2<nSeleTrks; iTrkP2++) {
 
 	if(iTrkP2==iTrkP1 || iTrkP2==iTrkN1) continue;
+	if(f3Prong) f3ProngPrefilter[kPrefCombinations]++;
 
 	//if(iTrkP2%1==0) AliDebug(1,Form("    2nd loop on pos: track number %d of %d",iTrkP2,nSeleTrks));
 
@@ -1128,17 +1159,33 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
 	SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
 	SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
+	if(f3Prong) f3ProngPrefilter[kPrefTrackChecks]++;
 
 	//printf("********** %d %d %d\n",postrack1->GetID(),postrack2->GetID(),negtrack1->GetID());
 
+	// check invariant mass cuts for D+,Ds,Lc, before the track-to-track DCAs
+        massCutOK=kTRUE;
+	if(f3Prong && fMassCutBeforeVertexing){
+	  mompos2[0]=momAtVertex[3*iTrkP2]; mompos2[1]=momAtVertex[3*iTrkP2+1]; mompos2[2]=momAtVertex[3*iTrkP2+2];
+	  Double_t pxDau[3]={mompos1[0],momneg1[0],mompos2[0]};
+	  Double_t pyDau[3]={mompos1[1],momneg1[1],mompos2[1]};
+	  Double_t pzDau[3]={mompos1[2],momneg1[2],mompos2[2]};
+	  //	  massCutOK = SelectInvMassAndPt3prong(threeTrackArray);
+	  massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
+	}
+	if(f3Prong && massCutOK) f3ProngPrefilter[kPrefMassPt]++;
+	if(f3Prong && !massCutOK && !f4Prong) {
+	  postrack2=0;
+	  continue;
+	}
+
 	dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
 	if(dcap2n1>dcaMax) { postrack2=0; continue; }
 	dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
 	if(dcap1p2>dcaMax) { postrack2=0; continue; }
+	if(f3Prong && massCutOK) f3ProngPrefilter[kPrefDCA]++;
 
-	// check invariant mass cuts for D+,Ds,Lc
-        massCutOK=kTRUE;
-	if(f3Prong) {
+	if(f3Prong && massCutOK) {
 	  if(postrack2->Charge()>0) {
 	    threeTrackArray->AddAt(postrack1,0);
 	    threeTrackArray->AddAt(negtrack1,1);
@@ -1148,29 +1195,15 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    threeTrackArray->AddAt(postrack1,1);
 	    threeTrackArray->AddAt(postrack2,2);
 	  }
-	  if(fMassCutBeforeVertexing){
-	    postrack2->GetPxPyPz(mompos2);
-	    Double_t pxDau[3]={mompos1[0],momneg1[0],mompos2[0]};
-	    Double_t pyDau[3]={mompos1[1],momneg1[1],mompos2[1]};
-	    Double_t pzDau[3]={mompos1[2],momneg1[2],mompos2[2]};
-	    //	    massCutOK = SelectInvMassAndPt3prong(threeTrackArray);
-	    massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
-	  }
-	}
-
-	if(f3Prong && !massCutOK) {
-	  threeTrackArray->Clear();
-	  if(!f4Prong) {
-	    postrack2=0;
-	    continue;
-	  }
 	}
 
 	// Vertexing
 	twoTrackArray2->AddAt(postrack2,0);
 	twoTrackArray2->AddAt(negtrack1,1);
-	AliAODVertex *vertexp2n1 = ReconstructSecondaryVertex(twoTrackArray2,dispersion);
+	Bool_t ownVertexp2n1=kFALSE;
+	AliAODVertex *vertexp2n1 = pairVertex(iTrkP2,iTrkN1,twoTrackArray2,ownVertexp2n1);
 	if(!vertexp2n1) {
+	  threeTrackArray->Clear();
 	  twoTrackArray2->Clear();
 	  postrack2=0;
 	  continue;
@@ -1178,10 +1211,12 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
 	// 3 prong candidates
 	if(f3Prong && massCutOK) {
+	  f3ProngPrefilter[kPrefVertexing]++;
 
 	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
 	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,vertexp2n1,dcap1n1,dcap2n1,dcap1p2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
 	  if(ok3Prong) {
+	    f3ProngPrefilter[kPrefSelected]++;
             AliAODVertex *v3Prong=0x0;
 	    if(!fMakeReducedRHF)v3Prong = new (verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
 	    if(!isLikeSign3Prong) {
@@ -1247,6 +1282,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	  for(iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
 
 	    if(iTrkN2==iTrkP1 || iTrkN2==iTrkP2 || iTrkN2==iTrkN1) continue;
+	    f4ProngPrefilter[kPrefCombinations]++;
 
 	    //if(iTrkN2%1==0) AliDebug(1,Form("    3rd loop on neg: track number %d of %d",iTrkN2,nSeleTrks));
 
@@ -1274,33 +1310,43 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
 	    SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
 	    SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
+	    f4ProngPrefilter[kPrefTrackChecks]++;
+
+	    // check invariant mass cuts for D0, before the track-to-track DCAs
+	    massCutOK=kTRUE;
+	    if(fMassCutBeforeVertexing) {
+	      const Int_t iTrk4[4]={iTrkP1,iTrkN1,iTrkP2,iTrkN2};
+	      Double_t pxDau[4],pyDau[4],pzDau[4];
+	      for(Int_t iDau=0; iDau<4; iDau++) {
+		pxDau[iDau]=momAtVertex[3*iTrk4[iDau]];
+		pyDau[iDau]=momAtVertex[3*iTrk4[iDau]+1];
+		pzDau[iDau]=momAtVertex[3*iTrk4[iDau]+2];
+	      }
+	      massCutOK = SelectInvMassAndPt4prong(pxDau,pyDau,pzDau);
+	    }
+	    if(!massCutOK) {
+	      negtrack2=0;
+	      continue;
+	    }
+	    f4ProngPrefilter[kPrefMassPt]++;
 
 	    dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
 	    if(dcap1n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
             dcap2n2 = postrack2->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
             if(dcap2n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
-
+	    f4ProngPrefilter[kPrefDCA]++;
+	    f4ProngPrefilter[kPrefVertexing]++;
 
 	    fourTrackArray->AddAt(postrack1,0);
 	    fourTrackArray->AddAt(negtrack1,1);
 	    fourTrackArray->AddAt(postrack2,2);
 	    fourTrackArray->AddAt(negtrack2,3);
 
-	    // check invariant mass cuts for D0
-	    massCutOK=kTRUE;
-	    if(fMassCutBeforeVertexing)
-	      massCutOK = SelectInvMassAndPt4prong(fourTrackArray);
-
-	    if(!massCutOK) {
-	      fourTrackArray->Clear();
-	      negtrack2=0;
-	      continue;
-	    }
-
 	    // Vertexing
 	    AliAODVertex* secVert4PrAOD = ReconstructSecondaryVertex(fourTrackArray,dispersion);
 	    io4Prong = Make4Prong(fourTrackArray,event,secVert4PrAOD,vertexp1n1,vertexp1n1p2,dcap1n1,dcap1n2,dcap2n1,dcap2n2,ok4Prong);
 	    if(ok4Prong) {
+	      f4ProngPrefilter[kPrefSelected]++;
 	      rd = new(aodCharm4ProngRef[i4Prong++])AliAODRecoDecayHF4Prong(*io4Prong);
 	      if(fMakeReducedRHF){
 		rd->DeleteRecoD();
@@ -1326,7 +1372,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	}
 
 	postrack2 = 0;
-	delete vertexp2n1;
+	if(ownVertexp2n1) delete vertexp2n1;
 
       } // end 2nd loop on positive tracks
 
@@ -1336,6 +1382,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       for(iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
 
 	if(iTrkN2==iTrkP1 || iTrkN2==iTrkP2 || iTrkN2==iTrkN1) continue;
+	if(f3Prong) f3ProngPrefilter[kPrefCombinations]++;
 
 	//if(iTrkN2%1==0) AliDebug(1,Form("    2nd loop on neg: track number %d of %d",iTrkN2,nSeleTrks));
 
@@ -1407,21 +1454,13 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
 	SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
 	SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
+	if(f3Prong) f3ProngPrefilter[kPrefTrackChecks]++;
 	//printf("********** %d %d %d\n",postrack1->GetID(),negtrack1->GetID(),negtrack2->GetID());
 
-	dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-	if(dcap1n2>dcaMax) { negtrack2=0; continue; }
-	dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-	if(dcan1n2>dcaMax) { negtrack2=0; continue; }
-
-	threeTrackArray->AddAt(negtrack1,0);
-	threeTrackArray->AddAt(postrack1,1);
-	threeTrackArray->AddAt(negtrack2,2);
-
-	// check invariant mass cuts for D+,Ds,Lc
+	// check invariant mass cuts for D+,Ds,Lc, before the track-to-track DCAs
         massCutOK=kTRUE;
 	if(fMassCutBeforeVertexing && f3Prong){
-	  negtrack2->GetPxPyPz(momneg2);
+	  momneg2[0]=momAtVertex[3*iTrkN2]; momneg2[1]=momAtVertex[3*iTrkN2+1]; momneg2[2]=momAtVertex[3*iTrkN2+2];
 	  Double_t pxDau[3]={momneg1[0],mompos1[0],momneg2[0]};
 	  Double_t pyDau[3]={momneg1[1],mompos1[1],momneg2[1]};
 	  Double_t pzDau[3]={momneg1[2],mompos1[2],momneg2[2]};
@@ -1429,26 +1468,40 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	  massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
 	}
 	if(!massCutOK) {
-	  threeTrackArray->Clear();
 	  negtrack2=0;
 	  continue;
 	}
+	if(f3Prong) f3ProngPrefilter[kPrefMassPt]++;
 
-	// Vertexing
+	dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	if(dcap1n2>dcaMax) { negtrack2=0; continue; }
+	dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	if(dcan1n2>dcaMax) { negtrack2=0; continue; }
+	if(f3Prong) f3ProngPrefilter[kPrefDCA]++;
+
+	threeTrackArray->AddAt(negtrack1,0);
+	threeTrackArray->AddAt(postrack1,1);
+	threeTrackArray->AddAt(negtrack2,2);
+
+	// Vertexing, the (+,-) pair vertex may already be known from the +-+ loop
 	twoTrackArray2->AddAt(postrack1,0);
 	twoTrackArray2->AddAt(negtrack2,1);
 
-	AliAODVertex *vertexp1n2 = ReconstructSecondaryVertex(twoTrackArray2,dispersion);
+	Bool_t ownVertexp1n2=kFALSE;
+	AliAODVertex *vertexp1n2 = pairVertex(iTrkP1,iTrkN2,twoTrackArray2,ownVertexp1n2);
 	if(!vertexp1n2) {
+	  threeTrackArray->Clear();
 	  twoTrackArray2->Clear();
 	  negtrack2=0;
 	  continue;
 	}
 
 	if(f3Prong) {
+	  f3ProngPrefilter[kPrefVertexing]++;
 	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
 	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,vertexp1n2,dcap1n1,dcap1n2,dcan1n2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
 	  if(ok3Prong) {
+	    f3ProngPrefilter[kPrefSelected]++;
 	    AliAODVertex *v3Prong = 0x0;
             if(!fMakeReducedRHF) v3Prong = new(verticesHFRef[iVerticesHF++])AliAODVertex(*secVert3PrAOD);
 	    if(!isLikeSign3Prong) {
@@ -1487,7 +1540,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	}
 	threeTrackArray->Clear();
 	negtrack2 = 0;
-	delete vertexp1n2;
+	if(ownVertexp1n2) delete vertexp1n2;
 
       } // end 2nd loop on negative tracks
 
@@ -1547,6 +1600,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   delete [] seleFlags; seleFlags=NULL;
   if(evtNumber) {delete [] evtNumber; evtNumber=NULL;}
   tracksAtVertex.Delete();
+  for(std::unordered_map<Long64_t,AliAODVertex*>::iterator it=pairVertices.begin(); it!=pairVertices.end(); ++it) delete it->second;
 
   if(fInputAOD) {
     seleTrksArray.Delete();
@@ -2892,6 +2946,26 @@ AliAODVertex* AliAnalysisVertexingHF::PrimaryVertex(const TObjArray *trkArray,
   return vertexAOD;
 }
 //-----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::PrintPrefilterStatistics() const {
+  /// Print the number of 3 and 4 prong track combinations rejected
+  /// at each stage of FindCandidates, cheapest checks first
+
+  const Long64_t *counts[2]={f3ProngPrefilter,f4ProngPrefilter};
+  const char *nameProng[2]={"3 prong","4 prong"};
+  const char *nameStage[kPrefSelected]={"","charge, single-track and PID flags","invariant mass and pt","track-to-track DCA","pair vertex"};
+  for(Int_t iProng=0; iProng<2; iProng++) {
+    if(counts[iProng][kPrefCombinations]==0) continue;
+    printf("%s track combinations: %lld\n",nameProng[iProng],counts[iProng][kPrefCombinations]);
+    for(Int_t iStage=kPrefTrackChecks; iStage<=kPrefVertexing; iStage++) {
+      printf("    rejected by %-36s %lld\n",nameStage[iStage],counts[iProng][iStage-1]-counts[iProng][iStage]);
+    }
+    printf("    secondary vertex fitted: %lld, candidates stored: %lld\n",counts[iProng][kPrefVertexing],counts[iProng][kPrefSelected]);
+  }
+  if(f3ProngPrefilter[kPrefPairVertexReused]>0) printf("3 prong pair vertices reused: %lld\n",f3ProngPrefilter[kPrefPairVertexReused]);
+
+  return;
+}
+//-----------------------------------------------------------------------------
 void AliAnalysisVertexingHF::PrintStatus() const {
   /// Print parameters being used
 
@@ -49,6 +49,8 @@ class AliAODv0;
 //-----------------------------------------------------------------------------
 class AliAnalysisVertexingHF : public TNamed {
  public:
+  /// stages of the 3 and 4 prong loops in FindCandidates, cheapest checks first
+  enum EPrefilterStage {kPrefCombinations,kPrefTrackChecks,kPrefMassPt,kPrefDCA,kPrefVertexing,kPrefSelected,kPrefPairVertexReused,kNPrefilterStages};
   //
   AliAnalysisVertexingHF();
   AliAnalysisVertexingHF(const AliAnalysisVertexingHF& source);
@@ -73,6 +75,7 @@ class AliAnalysisVertexingHF : public TNamed {
   Bool_t FillRecoCasc(AliVEvent *event,AliAODRecoCascadeHF *rc,Bool_t isDStar,Bool_t recoSecVtx=kFALSE);
   Bool_t RecoSecondaryVertexForCascades(AliVEvent *event, AliAODRecoCascadeHF *rc);
   void PrintStatus() const;
+  void PrintPrefilterStatistics() const;
   void SetSecVtxWithKF() { fSecVtxWithKF=kTRUE; }
   void SetD0toKpiOn() { fD0toKpi=kTRUE; }
   void SetD0toKpiOff() { fD0toKpi=kFALSE; }
@@ -179,6 +182,8 @@ class AliAnalysisVertexingHF : public TNamed {
   void SetCutsDStartoKpipi(AliRDHFCutsDStartoKpipi* cuts) { fCutsDStartoKpipi = cuts; }
   AliRDHFCutsDStartoKpipi* GetCutsDStartoKpipi() const { return fCutsDStartoKpipi; }
   void SetMassCutBeforeVertexing(Bool_t flag) { fMassCutBeforeVertexing=flag; }
+  void SetMaxPairVertexCache(Int_t n) { fMaxPairVertexCache=n; }
+  Long64_t GetPrefilterCounter(Int_t nProngs, Int_t stage) const { return nProngs==4 ? f4ProngPrefilter[stage] : f3ProngPrefilter[stage]; }
 
   void SetMasses();
   Bool_t CheckCutsConsistency();
@@ -350,6 +355,10 @@ class AliAnalysisVertexingHF : public TNamed {
   Double_t fMassDstar;
   Double_t fMassJpsi;
 
+  Int_t fMaxPairVertexCache; /// max number of pair vertices kept per event for the 3 prongs
+  Long64_t f3ProngPrefilter[kNPrefilterStages]; //! 3 prong combinations passing each stage
+  Long64_t f4ProngPrefilter[kNPrefilterStages]; //! 4 prong combinations passing each stage
+
 
   //
   void AddRefs(AliAODVertex *v,AliAODRecoDecayHF *rd,const AliVEvent *event,
@@ -422,7 +431,7 @@ class AliAnalysisVertexingHF : public TNamed {
 				  TObjArray *twoTrackArrayV0);
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisVertexingHF,27);  // Reconstruction of HF decay candidates
+  ClassDef(AliAnalysisVertexingHF,28);  // Reconstruction of HF decay candidates
   /// \endcond
 };
 
@@ -13,6 +13,11 @@
  * provided "as is" without express or implied warranty.                  *
  **************************************************************************/
 
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <TMath.h>
 #include <TPad.h>
 #include <TCanvas.h>
@@ -30,6 +35,20 @@
 ClassImp(AliHFInvMassMultiTrialFit);
 /// \endcond
 
+namespace {
+  /// definition of a trial in the list built by DoMultiTrials
+  enum ETrialDefs{ kDefRebin, kDefFirstBin, kDefMinMass, kDefMaxMass, kDefBkg, kDefSig, kDefConf,
+		   kDefTrial,    // trial number (1-based) within the histograms of one case
+		   kDefUnit,     // unit of work: same rebinned histogram and fit configuration
+		   kDefSeed,     // index of the neighbouring trial used for the warm start, -1 if none
+		   kNTrialDefs };
+  /// result of a trial, followed by kNBinCountValues values for each bin counting step
+  enum ETrialValues{ kTrialDone, kTrialAccepted, kTrialChi2, kTrialSignif, kTrialErSignif, kTrialMean, kTrialErMean,
+		     kTrialSigma, kTrialErSigma, kTrialRawYield, kTrialErRawYield, kTrialBkg, kTrialErBkg,
+		     kTrialBkgBEdge, kTrialErBkgBEdge, kNTrialValues };
+  enum EBinCountValues{ kBinCountDone, kBinCountRawYield0, kBinCountErRawYield0, kBinCountRawYield1, kBinCountErRawYield1, kNBinCountValues };
+}
+
 
 //_________________________________________________________________________
 AliHFInvMassMultiTrialFit::AliHFInvMassMultiTrialFit() : 
@@ -107,6 +126,8 @@ AliHFInvMassMultiTrialFit::AliHFInvMassMultiTrialFit() :
   fNtupleBinCount(0x0),
   fMinYieldGlob(0),
   fMaxYieldGlob(0),
+  fNWorkers(1),
+  fUseWarmStart(kFALSE),
   fMassFitters()
 {
   // constructor
@@ -261,34 +282,38 @@ Bool_t AliHFInvMassMultiTrialFit::CreateHistos(){
 
 }
 
+//________________________________________________________________________
+Int_t AliHFInvMassMultiTrialFit::GetNTrialValues() const{
+  // number of values stored for each trial
+  return kNTrialValues+kNBinCountValues*fNumOfnSigmaBinCSteps;
+}
+
 //________________________________________________________________________
 Bool_t AliHFInvMassMultiTrialFit::DoMultiTrials(TH1D* hInvMassHisto, TPad* thePad){
   // perform the multiple fits
+  // The trials are listed first in the order of the nested loops on rebin, first bin, fit range
+  // and fit function configuration, fitted (in worker processes if requested) and then written
+  // to the output histograms and ntuples in the same order
 
   Bool_t hOK=CreateHistos();
   if(!hOK) return kFALSE;
 
   Int_t itrial=0;
-  Int_t itrialBC=0;
-  Int_t totTrials=fNumOfRebinSteps*fNumOfFirstBinSteps*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps;
+  const Int_t nCases=kNBkgFuncCases*kNFitConfCases*kNSigFuncCases;
+  const Int_t nUnits=fNumOfRebinSteps*fNumOfFirstBinSteps*nCases;
+  std::vector<Int_t> unitId(nUnits,-1);
+  std::vector<Int_t> trialIndex(nUnits*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps,-1);
+  std::vector<Int_t> trialDefs;
+  Int_t nTrials=0;
+  Int_t nActiveUnits=0;
 
   fMinYieldGlob=999999.;
   fMaxYieldGlob=0.;
-  Float_t xnt[16];
-  Float_t xntBC[14];
 
   for(Int_t ir=0; ir<fNumOfRebinSteps; ir++){
-    Int_t rebin=fRebinSteps[ir];
     for(Int_t iFirstBin=1; iFirstBin<=fNumOfFirstBinSteps; iFirstBin++) {
-      TH1F* hRebinned=0x0;
-      if(fNumOfFirstBinSteps==1) hRebinned=(TH1F*)AliVertexingHFUtils::RebinHisto(hInvMassHisto,rebin,-1);
-      else hRebinned=(TH1F*)AliVertexingHFUtils::RebinHisto(hInvMassHisto,rebin,iFirstBin);
       for(Int_t iMinMass=0; iMinMass<fNumOfLowLimFitSteps; iMinMass++){
-        Double_t minMassForFit=fLowLimFitSteps[iMinMass];
-        Double_t hmin=TMath::Max(minMassForFit,hRebinned->GetBinLowEdge(2));
         for(Int_t iMaxMass=0; iMaxMass<fNumOfUpLimFitSteps; iMaxMass++){
-          Double_t maxMassForFit=fUpLimFitSteps[iMaxMass];
-          Double_t hmax=TMath::Min(maxMassForFit,hRebinned->GetBinLowEdge(hRebinned->GetNbinsX()));
           ++itrial;
           for(Int_t typeb=0; typeb<kNBkgFuncCases; typeb++){
             if(typeb==kExpoBkg && !fUseExpoBkg) continue;
@@ -310,220 +335,398 @@ Bool_t AliHFInvMassMultiTrialFit::DoMultiTrials(TH1D* hInvMassHisto, TPad* thePa
 		if (igs==kFixSigFreeMean  && !fUseFixSigFreeMean) continue;
 		if (igs==kFixSigFixMean   && !fUseFixSigFixMean) continue;
 		Int_t theCase=igs*kNBkgFuncCases*kNSigFuncCases+types*kNBkgFuncCases+typeb;
-		Int_t globBin=itrial+theCase*totTrials;
-		for(Int_t j=0; j<16; j++) xnt[j]=0.;
-		
-		Bool_t mustDeleteFitter = kTRUE;
-		AliHFInvMassFitter*  fitter=0x0;
-		if(typeb==kExpoBkg){
-		  fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kExpo, types);
-		}else if(typeb==kLinBkg){
-		  fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kLin, types);
-		}else if(typeb==kPol2Bkg){
-		  fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kPol2, types);
-		}else if(typeb==kPowBkg){
-		  fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kPow, types);
-		}else if(typeb==kPowTimesExpoBkg){
-		  fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kPowEx, types);
-		}else{
-		  fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, 6, types);
-		  if(typeb==kPol3Bkg) fitter->SetPolDegreeForBackgroundFit(3);
-		  if(typeb==kPol4Bkg) fitter->SetPolDegreeForBackgroundFit(4);
-		  if(typeb==kPol5Bkg) fitter->SetPolDegreeForBackgroundFit(5);
-		}
-		if(types==k2Gaus){
-		  if(fFixSecondGausSig>=0.) fitter->SetFixSecondGaussianSigma(fFixSecondGausSig);
-		  if(fFixSecondGausFrac>=0.) fitter->SetFixFrac2Gaus(fFixSecondGausFrac);
-		}else if(types==k2GausSigmaRatioPar){
-		  if(fFixSecondGausSigRat>=0.) fitter->SetFixRatio2GausSigma(fFixSecondGausSigRat);
-		  if(fFixSecondGausFrac>=0.) fitter->SetFixFrac2Gaus(fFixSecondGausFrac);
-		}
-		// D0 Reflection
-		if(fhTemplRefl && fhTemplSign){
-		  TH1F *hReflModif=(TH1F*)AliVertexingHFUtils::AdaptTemplateRangeAndBinning(fhTemplRefl,hRebinned,minMassForFit,maxMassForFit);
-		  TH1F *hSigModif=(TH1F*)AliVertexingHFUtils::AdaptTemplateRangeAndBinning(fhTemplSign,hRebinned,minMassForFit,maxMassForFit);
-		  TH1F* hrfl=fitter->SetTemplateReflections(hReflModif,"2gaus",minMassForFit,maxMassForFit);
-		  if(!hrfl) printf("ERROR in SetTemplateReflections\n");
-		  if(fFixRefloS>0){
-		    Double_t fixSoverRefAt=fFixRefloS*(hReflModif->Integral(hReflModif->FindBin(minMassForFit*1.0001),hReflModif->FindBin(maxMassForFit*0.999))/hSigModif->Integral(hSigModif->FindBin(minMassForFit*1.0001),hSigModif->FindBin(maxMassForFit*0.999)));
-		    fitter->SetFixReflOverS(fixSoverRefAt);
-		  }
-		  delete hReflModif;
-		  delete hSigModif;
-		}
-		if(fUseSecondPeak){
-		  fitter->IncludeSecondGausPeak(fMassSecondPeak, fFixMassSecondPeak, fSigmaSecondPeak, fFixSigmaSecondPeak);
-		}
-		if(fFitOption==1) fitter->SetUseChi2Fit();
-		fitter->SetInitialGaussianMean(fMassD);
-		fitter->SetInitialGaussianSigma(fSigmaGausMC);
-		xnt[0]=rebin;
-		xnt[1]=iFirstBin;
-		xnt[2]=minMassForFit;
-		xnt[3]=maxMassForFit;
-		xnt[4]=typeb;
-		xnt[5]=types;
-		xnt[7]=0;
-		if(igs==kFixSigFreeMean){
-		  fitter->SetFixGaussianSigma(fSigmaGausMC);
-		  xnt[6]=1;
-		}else if(igs==kFixSigUpFreeMean){
-		  fitter->SetFixGaussianSigma(fSigmaGausMC*(1.+fSigmaMCVariationUp));
-		  xnt[6]=2;
-		}else if(igs==kFixSigDownFreeMean){
-		  fitter->SetFixGaussianSigma(fSigmaGausMC*(1.-fSigmaMCVariationDw));
-		  xnt[6]=3;
-		}else if(igs==kFreeSigFreeMean){
-		  xnt[6]=0;
-		}else if(igs==kFixSigFixMean){
-		  fitter->SetFixGaussianSigma(fSigmaGausMC);
-		  fitter->SetFixGaussianMean(fMassD);
-		  xnt[6]=1;
-		  xnt[7]=1;
-		}else if(igs==kFreeSigFixMean){
-		  fitter->SetFixGaussianMean(fMassD);
-		  xnt[6]=0;
-		  xnt[7]=1;
-		}
-		Bool_t out=kFALSE;
-		Double_t chisq=-1.;
-		Double_t sigma=0.;
-		Double_t esigma=0.;
-		Double_t pos=.0;
-		Double_t epos=.0;
-		Double_t ry=.0;
-		Double_t ery=.0;
-		Double_t significance=0.;
-		Double_t erSignif=0.;
-		Double_t bkg=0.;
-		Double_t erbkg=0.;
-		Double_t bkgBEdge=0;
-		Double_t erbkgBEdge=0;
-		if(typeb<kNBkgFuncCases){
-		  printf("****** START FIT OF HISTO %s WITH REBIN %d FIRST BIN %d MASS RANGE %f-%f BACKGROUND FIT FUNCTION=%d CONFIG SIGMA/MEAN=%d\n",hInvMassHisto->GetName(),rebin,iFirstBin,minMassForFit,maxMassForFit,typeb,igs);
-		  out=fitter->MassFitter(0);
-		  chisq=fitter->GetReducedChiSquare();
-		  fitter->Significance(fnSigmaForBkgEval,significance,erSignif);
-		  sigma=fitter->GetSigma();
-		  pos=fitter->GetMean();
-		  esigma=fitter->GetSigmaUncertainty();
-		  if(esigma<0.00001) esigma=0.0001;
-		  epos=fitter->GetMeanUncertainty();
-		  if(epos<0.00001) epos=0.0001;
-		  ry=fitter->GetRawYield();
-		  ery=fitter->GetRawYieldError();
-		  fitter->Background(fnSigmaForBkgEval,bkg,erbkg);
-		  Double_t minval = hInvMassHisto->GetXaxis()->GetBinLowEdge(hInvMassHisto->FindBin(pos-fnSigmaForBkgEval*sigma));
-		  Double_t maxval = hInvMassHisto->GetXaxis()->GetBinUpEdge(hInvMassHisto->FindBin(pos+fnSigmaForBkgEval*sigma));
-		  fitter->Background(minval,maxval,bkgBEdge,erbkgBEdge);
-		  if(out && fDrawIndividualFits && thePad){
-		    thePad->Clear();
-		    fitter->DrawHere(thePad, fnSigmaForBkgEval);
-		    fMassFitters.push_back(fitter);
-		    mustDeleteFitter = kFALSE;
-		    for (auto format : fInvMassFitSaveAsFormats) {
-		      thePad->SaveAs(Form("FitOutput_%s_Trial%d.%s",hInvMassHisto->GetName(),globBin, format.c_str()));
-		    }
-		  }
-		}
-		xnt[8]=chisq;
-		if(out && chisq>0. && sigma>0.5*fSigmaGausMC && sigma<2.0*fSigmaGausMC){
-		  xnt[9]=significance;
-		  xnt[10]=pos;
-		  xnt[11]=epos;
-		  xnt[12]=sigma;
-		  xnt[13]=esigma;
-		  xnt[14]=ry;
-		  xnt[15]=ery;
-		  fHistoRawYieldDistAll->Fill(ry);
-		  fHistoRawYieldTrialAll->SetBinContent(globBin,ry);
-		  fHistoRawYieldTrialAll->SetBinError(globBin,ery);
-		  fHistoSigmaTrialAll->SetBinContent(globBin,sigma);
-		  fHistoSigmaTrialAll->SetBinError(globBin,esigma);
-		  fHistoMeanTrialAll->SetBinContent(globBin,pos);
-		  fHistoMeanTrialAll->SetBinError(globBin,epos);
-		  fHistoChi2TrialAll->SetBinContent(globBin,chisq);
-		  fHistoChi2TrialAll->SetBinError(globBin,0.00001);
-		  fHistoSignifTrialAll->SetBinContent(globBin,significance);
-		  fHistoSignifTrialAll->SetBinError(globBin,erSignif);
-		  if(fSaveBkgVal) {
-		    fHistoBkgTrialAll->SetBinContent(globBin,bkg);
-		    fHistoBkgTrialAll->SetBinError(globBin,erbkg);
-		    fHistoBkgInBinEdgesTrialAll->SetBinContent(globBin,bkgBEdge);
-		    fHistoBkgInBinEdgesTrialAll->SetBinError(globBin,erbkgBEdge);
-		  }
-
-		  if(ry<fMinYieldGlob) fMinYieldGlob=ry;
-		  if(ry>fMaxYieldGlob) fMaxYieldGlob=ry;
-		  fHistoRawYieldDist[theCase]->Fill(ry);
-		  fHistoRawYieldTrial[theCase]->SetBinContent(itrial,ry);
-		  fHistoRawYieldTrial[theCase]->SetBinError(itrial,ery);
-		  fHistoSigmaTrial[theCase]->SetBinContent(itrial,sigma);
-		  fHistoSigmaTrial[theCase]->SetBinError(itrial,esigma);
-		  fHistoMeanTrial[theCase]->SetBinContent(itrial,pos);
-		  fHistoMeanTrial[theCase]->SetBinError(itrial,epos);
-		  fHistoChi2Trial[theCase]->SetBinContent(itrial,chisq);
-		  fHistoChi2Trial[theCase]->SetBinError(itrial,0.00001);
-		  fHistoSignifTrial[theCase]->SetBinContent(itrial,significance);
-		  fHistoSignifTrial[theCase]->SetBinError(itrial,erSignif);
-		  if(fSaveBkgVal) {
-		    fHistoBkgTrial[theCase]->SetBinContent(itrial,bkg);
-		    fHistoBkgTrial[theCase]->SetBinError(itrial,erbkg);
-		    fHistoBkgInBinEdgesTrial[theCase]->SetBinContent(itrial,bkgBEdge);
-		    fHistoBkgInBinEdgesTrial[theCase]->SetBinError(itrial,erbkgBEdge);
-		  }
-		  fNtupleMultiTrials->Fill(xnt);
-		  if(types==0){
-		    // bin counting done only for 1 case of signal line shape
-		    for(Int_t j=0; j<9; j++) xntBC[j]=xnt[j];
-		  
-		  
-		    for(Int_t iStepBC=0; iStepBC<fNumOfnSigmaBinCSteps; iStepBC++){
-		      Double_t minMassBC=fMassD-fnSigmaBinCSteps[iStepBC]*sigma;
-		      Double_t maxMassBC=fMassD+fnSigmaBinCSteps[iStepBC]*sigma;
-		      if(minMassBC>minMassForFit &&
-			 maxMassBC<maxMassForFit &&
-				   minMassBC>(hRebinned->GetXaxis()->GetXmin()) &&
-			 maxMassBC<(hRebinned->GetXaxis()->GetXmax())){
-			Double_t cnts0,ecnts0;
-			Double_t cnts1,ecnts1;
-			cnts0=fitter->GetRawYieldBinCounting(ecnts0,fnSigmaBinCSteps[iStepBC],0,0);
-			cnts1=fitter->GetRawYieldBinCounting(ecnts1,fnSigmaBinCSteps[iStepBC],1,0);
-			xntBC[9]=fnSigmaBinCSteps[iStepBC];
-			xntBC[10]=cnts0;
-			xntBC[11]=ecnts0;
-			xntBC[12]=cnts1;
-			xntBC[13]=ecnts1;
-			++itrialBC;
-			fHistoRawYieldDistBinC0All->Fill(cnts0);
-			fHistoRawYieldTrialBinC0All->SetBinContent(globBin,iStepBC+1,cnts0);
-			fHistoRawYieldTrialBinC0All->SetBinError(globBin,iStepBC+1,ecnts0);
-			fHistoRawYieldTrialBinC0[theCase]->SetBinContent(itrial,iStepBC+1,cnts0);
-			fHistoRawYieldTrialBinC0[theCase]->SetBinError(itrial,iStepBC+1,ecnts0);
-			fHistoRawYieldDistBinC0[theCase]->Fill(cnts0);
-			fHistoRawYieldDistBinC1All->Fill(cnts1);
-			fHistoRawYieldTrialBinC1All->SetBinContent(globBin,iStepBC+1,cnts1);
-			fHistoRawYieldTrialBinC1All->SetBinError(globBin,iStepBC+1,ecnts1);
-			fHistoRawYieldTrialBinC1[theCase]->SetBinContent(itrial,iStepBC+1,cnts1);
-			fHistoRawYieldTrialBinC1[theCase]->SetBinError(itrial,iStepBC+1,ecnts1);
-			fHistoRawYieldDistBinC1[theCase]->Fill(cnts1);
-			fNtupleBinCount->Fill(xntBC);
-		      }
-		    }
-		  }
-		}
-		if (mustDeleteFitter) delete fitter;
+		// fits of the same histogram and function configuration on the grid of fit ranges
+		// form a unit, the unit of the work distribution and of the warm start chain
+		Int_t unit=(ir*fNumOfFirstBinSteps+iFirstBin-1)*nCases+theCase;
+		if(unitId[unit]<0) unitId[unit]=nActiveUnits++;
+		Int_t seed=-1;
+		if(iMaxMass>0) seed=trialIndex[(unit*fNumOfLowLimFitSteps+iMinMass)*fNumOfUpLimFitSteps+iMaxMass-1];
+		else if(iMinMass>0) seed=trialIndex[(unit*fNumOfLowLimFitSteps+iMinMass-1)*fNumOfUpLimFitSteps];
+		trialIndex[(unit*fNumOfLowLimFitSteps+iMinMass)*fNumOfUpLimFitSteps+iMaxMass]=nTrials;
+		Int_t def[kNTrialDefs]={ir,iFirstBin,iMinMass,iMaxMass,typeb,types,igs,itrial,unitId[unit],seed};
+		trialDefs.insert(trialDefs.end(),def,def+kNTrialDefs);
+		++nTrials;
 	      }
 	    }
 	  }
 	}
       }
+    }
+  }
+
+  const Int_t nValues=GetNTrialValues();
+  std::vector<Double_t> results(nTrials*nValues,0.);
+  if(fNWorkers!=1 && !(fDrawIndividualFits && thePad) && nTrials>0){
+    RunTrialsInWorkers(hInvMassHisto,nTrials,trialDefs.data(),results.data());
+  }
+  // sequential path, also picks up the trials not completed by the workers
+  ProcessTrials(hInvMassHisto,nTrials,trialDefs.data(),results.data(),1,0,thePad);
+
+  for(Int_t it=0; it<nTrials; it++){
+    FillTrialOutput(&trialDefs[it*kNTrialDefs],&results[it*nValues]);
+  }
+  return kTRUE;
+}
+
+//________________________________________________________________________
+void AliHFInvMassMultiTrialFit::ProcessTrials(TH1D* hInvMassHisto, Int_t nTrials, const Int_t* trialDefs, Double_t* results,
+					      Int_t nWorkers, Int_t iWorker, TPad* thePad){
+  // fit the trials of the units assigned to worker iWorker (out of nWorkers) not yet done
+  // trials are processed in the order of the list, so that the neighbour used for the
+  // warm start is always fitted before
+
+  const Int_t nValues=GetNTrialValues();
+  TH1F* hRebinned=0x0;
+  Int_t curRebin=-1;
+  Int_t curFirstBin=-1;
+  for(Int_t it=0; it<nTrials; it++){
+    const Int_t* def=&trialDefs[it*kNTrialDefs];
+    Double_t* res=&results[it*nValues];
+    if(res[kTrialDone]>0.) continue;
+    if(def[kDefUnit]%nWorkers!=iWorker) continue;
+    Int_t ir=def[kDefRebin];
+    Int_t iFirstBin=def[kDefFirstBin];
+    if(ir!=curRebin || iFirstBin!=curFirstBin){
       delete hRebinned;
+      if(fNumOfFirstBinSteps==1) hRebinned=(TH1F*)AliVertexingHFUtils::RebinHisto(hInvMassHisto,fRebinSteps[ir],-1);
+      else hRebinned=(TH1F*)AliVertexingHFUtils::RebinHisto(hInvMassHisto,fRebinSteps[ir],iFirstBin);
+      curRebin=ir;
+      curFirstBin=iFirstBin;
+    }
+    const Double_t* seed=0x0;
+    if(fUseWarmStart && def[kDefSeed]>=0 && results[def[kDefSeed]*nValues+kTrialAccepted]>0.) seed=&results[def[kDefSeed]*nValues];
+    Int_t theCase=def[kDefConf]*kNBkgFuncCases*kNSigFuncCases+def[kDefSig]*kNBkgFuncCases+def[kDefBkg];
+    Int_t totTrials=fNumOfRebinSteps*fNumOfFirstBinSteps*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps;
+    FitTrial(hInvMassHisto,hRebinned,def,def[kDefTrial]+theCase*totTrials,seed,res,thePad);
+  }
+  delete hRebinned;
+}
+
+//________________________________________________________________________
+Bool_t AliHFInvMassMultiTrialFit::RunTrialsInWorkers(TH1D* hInvMassHisto, Int_t nTrials, const Int_t* trialDefs, Double_t* results){
+  // fit the trials in forked worker processes writing to a shared result array
+  // (the mass fitters rely on the global TMinuit instance and on the global list of functions, so they
+  // cannot run in threads; each process has its own copy and gives the same fit as the sequential path)
+  // trials not completed by the workers are left to the sequential path
+
+  Int_t nWorkers=fNWorkers;
+  if(nWorkers<=0) nWorkers=(Int_t)sysconf(_SC_NPROCESSORS_ONLN);
+  if(nWorkers<2) return kFALSE;
+
+  const Int_t nValues=GetNTrialValues();
+  size_t size=sizeof(Double_t)*nTrials*nValues;
+  void* shared=mmap(0x0,size,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_ANONYMOUS,-1,0);
+  if(shared==MAP_FAILED){
+    printf("AliHFInvMassMultiTrialFit: cannot allocate shared memory, trials fitted sequentially\n");
+    return kFALSE;
+  }
+  Double_t* sharedResults=(Double_t*)shared;
+  memcpy(sharedResults,results,size);
+
+  printf("AliHFInvMassMultiTrialFit: fitting %d trials with %d worker processes\n",nTrials,nWorkers);
+  fflush(stdout);
+  fflush(stderr);
+  std::vector<pid_t> workers;
+  for(Int_t iw=0; iw<nWorkers; iw++){
+    pid_t pid=fork();
+    if(pid==0){
+      ProcessTrials(hInvMassHisto,nTrials,trialDefs,sharedResults,nWorkers,iw,0x0);
+      fflush(stdout);
+      _exit(0);
+    }
+    if(pid<0){
+      printf("AliHFInvMassMultiTrialFit: fork failed for worker %d\n",iw);
+      break;
     }
+    workers.push_back(pid);
   }
+  for(size_t iw=0; iw<workers.size(); iw++){
+    Int_t status=0;
+    waitpid(workers[iw],&status,0);
+  }
+  memcpy(results,sharedResults,size);
+  munmap(shared,size);
   return kTRUE;
 }
 
+//________________________________________________________________________
+Bool_t AliHFInvMassMultiTrialFit::FitTrial(TH1D* hInvMassHisto, TH1F* hRebinned, const Int_t* def, Int_t globBin,
+					   const Double_t* seed, Double_t* result, TPad* thePad){
+  // fit of one trial, the results are stored in result (layout given by ETrialValues)
+
+  Int_t rebin=fRebinSteps[def[kDefRebin]];
+  Int_t iFirstBin=def[kDefFirstBin];
+  Double_t minMassForFit=fLowLimFitSteps[def[kDefMinMass]];
+  Double_t maxMassForFit=fUpLimFitSteps[def[kDefMaxMass]];
+  Int_t typeb=def[kDefBkg];
+  Int_t types=def[kDefSig];
+  Int_t igs=def[kDefConf];
+  Double_t hmin=TMath::Max(minMassForFit,hRebinned->GetBinLowEdge(2));
+  Double_t hmax=TMath::Min(maxMassForFit,hRebinned->GetBinLowEdge(hRebinned->GetNbinsX()));
+
+  Bool_t mustDeleteFitter = kTRUE;
+  AliHFInvMassFitter*  fitter=0x0;
+  if(typeb==kExpoBkg){
+    fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kExpo, types);
+  }else if(typeb==kLinBkg){
+    fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kLin, types);
+  }else if(typeb==kPol2Bkg){
+    fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kPol2, types);
+  }else if(typeb==kPowBkg){
+    fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kPow, types);
+  }else if(typeb==kPowTimesExpoBkg){
+    fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, AliHFInvMassFitter::kPowEx, types);
+  }else{
+    fitter=new AliHFInvMassFitter(hRebinned, hmin, hmax, 6, types);
+    if(typeb==kPol3Bkg) fitter->SetPolDegreeForBackgroundFit(3);
+    if(typeb==kPol4Bkg) fitter->SetPolDegreeForBackgroundFit(4);
+    if(typeb==kPol5Bkg) fitter->SetPolDegreeForBackgroundFit(5);
+  }
+  if(types==k2Gaus){
+    if(fFixSecondGausSig>=0.) fitter->SetFixSecondGaussianSigma(fFixSecondGausSig);
+    if(fFixSecondGausFrac>=0.) fitter->SetFixFrac2Gaus(fFixSecondGausFrac);
+  }else if(types==k2GausSigmaRatioPar){
+    if(fFixSecondGausSigRat>=0.) fitter->SetFixRatio2GausSigma(fFixSecondGausSigRat);
+    if(fFixSecondGausFrac>=0.) fitter->SetFixFrac2Gaus(fFixSecondGausFrac);
+  }
+  // D0 Reflection
+  if(fhTemplRefl && fhTemplSign){
+    TH1F *hReflModif=(TH1F*)AliVertexingHFUtils::AdaptTemplateRangeAndBinning(fhTemplRefl,hRebinned,minMassForFit,maxMassForFit);
+    TH1F *hSigModif=(TH1F*)AliVertexingHFUtils::AdaptTemplateRangeAndBinning(fhTemplSign,hRebinned,minMassForFit,maxMassForFit);
+    TH1F* hrfl=fitter->SetTemplateReflections(hReflModif,"2gaus",minMassForFit,maxMassForFit);
+    if(!hrfl) printf("ERROR in SetTemplateReflections\n");
+    if(fFixRefloS>0){
+      Double_t fixSoverRefAt=fFixRefloS*(hReflModif->Integral(hReflModif->FindBin(minMassForFit*1.0001),hReflModif->FindBin(maxMassForFit*0.999))/hSigModif->Integral(hSigModif->FindBin(minMassForFit*1.0001),hSigModif->FindBin(maxMassForFit*0.999)));
+      fitter->SetFixReflOverS(fixSoverRefAt);
+    }
+    delete hReflModif;
+    delete hSigModif;
+  }
+  if(fUseSecondPeak){
+    fitter->IncludeSecondGausPeak(fMassSecondPeak, fFixMassSecondPeak, fSigmaSecondPeak, fFixSigmaSecondPeak);
+  }
+  if(fFitOption==1) fitter->SetUseChi2Fit();
+  fitter->SetInitialGaussianMean(fMassD);
+  fitter->SetInitialGaussianSigma(fSigmaGausMC);
+  if(seed){
+    // warm start from the converged fit of the neighbouring fit range
+    fitter->SetInitialGaussianMean(seed[kTrialMean]);
+    fitter->SetInitialGaussianSigma(seed[kTrialSigma]);
+  }
+  if(igs==kFixSigFreeMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC);
+  }else if(igs==kFixSigUpFreeMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC*(1.+fSigmaMCVariationUp));
+  }else if(igs==kFixSigDownFreeMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC*(1.-fSigmaMCVariationDw));
+  }else if(igs==kFixSigFixMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC);
+    fitter->SetFixGaussianMean(fMassD);
+  }else if(igs==kFreeSigFixMean){
+    fitter->SetFixGaussianMean(fMassD);
+  }
+  Double_t chisq=-1.;
+  Double_t sigma=0.;
+  Double_t esigma=0.;
+  Double_t pos=.0;
+  Double_t epos=.0;
+  Double_t ry=.0;
+  Double_t ery=.0;
+  Double_t significance=0.;
+  Double_t erSignif=0.;
+  Double_t bkg=0.;
+  Double_t erbkg=0.;
+  Double_t bkgBEdge=0;
+  Double_t erbkgBEdge=0;
+  printf("****** START FIT OF HISTO %s WITH REBIN %d FIRST BIN %d MASS RANGE %f-%f BACKGROUND FIT FUNCTION=%d CONFIG SIGMA/MEAN=%d\n",hInvMassHisto->GetName(),rebin,iFirstBin,minMassForFit,maxMassForFit,typeb,igs);
+  Bool_t out=fitter->MassFitter(0);
+  chisq=fitter->GetReducedChiSquare();
+  fitter->Significance(fnSigmaForBkgEval,significance,erSignif);
+  sigma=fitter->GetSigma();
+  pos=fitter->GetMean();
+  esigma=fitter->GetSigmaUncertainty();
+  if(esigma<0.00001) esigma=0.0001;
+  epos=fitter->GetMeanUncertainty();
+  if(epos<0.00001) epos=0.0001;
+  ry=fitter->GetRawYield();
+  ery=fitter->GetRawYieldError();
+  fitter->Background(fnSigmaForBkgEval,bkg,erbkg);
+  Double_t minval = hInvMassHisto->GetXaxis()->GetBinLowEdge(hInvMassHisto->FindBin(pos-fnSigmaForBkgEval*sigma));
+  Double_t maxval = hInvMassHisto->GetXaxis()->GetBinUpEdge(hInvMassHisto->FindBin(pos+fnSigmaForBkgEval*sigma));
+  fitter->Background(minval,maxval,bkgBEdge,erbkgBEdge);
+  if(out && fDrawIndividualFits && thePad){
+    thePad->Clear();
+    fitter->DrawHere(thePad, fnSigmaForBkgEval);
+    fMassFitters.push_back(fitter);
+    mustDeleteFitter = kFALSE;
+    for (auto format : fInvMassFitSaveAsFormats) {
+      thePad->SaveAs(Form("FitOutput_%s_Trial%d.%s",hInvMassHisto->GetName(),globBin, format.c_str()));
+    }
+  }
+  Bool_t accepted=(out && chisq>0. && sigma>0.5*fSigmaGausMC && sigma<2.0*fSigmaGausMC);
+  result[kTrialAccepted]=accepted;
+  result[kTrialChi2]=chisq;
+  result[kTrialSignif]=significance;
+  result[kTrialErSignif]=erSignif;
+  result[kTrialMean]=pos;
+  result[kTrialErMean]=epos;
+  result[kTrialSigma]=sigma;
+  result[kTrialErSigma]=esigma;
+  result[kTrialRawYield]=ry;
+  result[kTrialErRawYield]=ery;
+  result[kTrialBkg]=bkg;
+  result[kTrialErBkg]=erbkg;
+  result[kTrialBkgBEdge]=bkgBEdge;
+  result[kTrialErBkgBEdge]=erbkgBEdge;
+  if(accepted && types==0){
+    // bin counting done only for 1 case of signal line shape
+    for(Int_t iStepBC=0; iStepBC<fNumOfnSigmaBinCSteps; iStepBC++){
+      Double_t* resBC=&result[kNTrialValues+iStepBC*kNBinCountValues];
+      Double_t minMassBC=fMassD-fnSigmaBinCSteps[iStepBC]*sigma;
+      Double_t maxMassBC=fMassD+fnSigmaBinCSteps[iStepBC]*sigma;
+      if(minMassBC>minMassForFit &&
+	 maxMassBC<maxMassForFit &&
+	 minMassBC>(hRebinned->GetXaxis()->GetXmin()) &&
+	 maxMassBC<(hRebinned->GetXaxis()->GetXmax())){
+	resBC[kBinCountDone]=1.;
+	resBC[kBinCountRawYield0]=fitter->GetRawYieldBinCounting(resBC[kBinCountErRawYield0],fnSigmaBinCSteps[iStepBC],0,0);
+	resBC[kBinCountRawYield1]=fitter->GetRawYieldBinCounting(resBC[kBinCountErRawYield1],fnSigmaBinCSteps[iStepBC],1,0);
+      }
+    }
+  }
+  result[kTrialDone]=1.;
+  if (mustDeleteFitter) delete fitter;
+  return accepted;
+}
+
+//________________________________________________________________________
+void AliHFInvMassMultiTrialFit::FillTrialOutput(const Int_t* def, const Double_t* result){
+  // fill histograms and ntuples with the result of one trial
+
+  if(result[kTrialAccepted]<=0.) return;
+  Int_t itrial=def[kDefTrial];
+  Int_t typeb=def[kDefBkg];
+  Int_t types=def[kDefSig];
+  Int_t igs=def[kDefConf];
+  Int_t theCase=igs*kNBkgFuncCases*kNSigFuncCases+types*kNBkgFuncCases+typeb;
+  Int_t totTrials=fNumOfRebinSteps*fNumOfFirstBinSteps*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps;
+  Int_t globBin=itrial+theCase*totTrials;
+  Double_t minMassForFit=fLowLimFitSteps[def[kDefMinMass]];
+  Double_t maxMassForFit=fUpLimFitSteps[def[kDefMaxMass]];
+  Double_t chisq=result[kTrialChi2];
+  Double_t significance=result[kTrialSignif];
+  Double_t erSignif=result[kTrialErSignif];
+  Double_t pos=result[kTrialMean];
+  Double_t epos=result[kTrialErMean];
+  Double_t sigma=result[kTrialSigma];
+  Double_t esigma=result[kTrialErSigma];
+  Double_t ry=result[kTrialRawYield];
+  Double_t ery=result[kTrialErRawYield];
+  Double_t bkg=result[kTrialBkg];
+  Double_t erbkg=result[kTrialErBkg];
+  Double_t bkgBEdge=result[kTrialBkgBEdge];
+  Double_t erbkgBEdge=result[kTrialErBkgBEdge];
+
+  Float_t xnt[16];
+  Float_t xntBC[14];
+  xnt[0]=fRebinSteps[def[kDefRebin]];
+  xnt[1]=def[kDefFirstBin];
+  xnt[2]=minMassForFit;
+  xnt[3]=maxMassForFit;
+  xnt[4]=typeb;
+  xnt[5]=types;
+  xnt[6]=0;
+  xnt[7]=0;
+  if(igs==kFixSigFreeMean){
+    xnt[6]=1;
+  }else if(igs==kFixSigUpFreeMean){
+    xnt[6]=2;
+  }else if(igs==kFixSigDownFreeMean){
+    xnt[6]=3;
+  }else if(igs==kFixSigFixMean){
+    xnt[6]=1;
+    xnt[7]=1;
+  }else if(igs==kFreeSigFixMean){
+    xnt[7]=1;
+  }
+  xnt[8]=chisq;
+  xnt[9]=significance;
+  xnt[10]=pos;
+  xnt[11]=epos;
+  xnt[12]=sigma;
+  xnt[13]=esigma;
+  xnt[14]=ry;
+  xnt[15]=ery;
+  fHistoRawYieldDistAll->Fill(ry);
+  fHistoRawYieldTrialAll->SetBinContent(globBin,ry);
+  fHistoRawYieldTrialAll->SetBinError(globBin,ery);
+  fHistoSigmaTrialAll->SetBinContent(globBin,sigma);
+  fHistoSigmaTrialAll->SetBinError(globBin,esigma);
+  fHistoMeanTrialAll->SetBinContent(globBin,pos);
+  fHistoMeanTrialAll->SetBinError(globBin,epos);
+  fHistoChi2TrialAll->SetBinContent(globBin,chisq);
+  fHistoChi2TrialAll->SetBinError(globBin,0.00001);
+  fHistoSignifTrialAll->SetBinContent(globBin,significance);
+  fHistoSignifTrialAll->SetBinError(globBin,erSignif);
+  if(fSaveBkgVal) {
+    fHistoBkgTrialAll->SetBinContent(globBin,bkg);
+    fHistoBkgTrialAll->SetBinError(globBin,erbkg);
+    fHistoBkgInBinEdgesTrialAll->SetBinContent(globBin,bkgBEdge);
+    fHistoBkgInBinEdgesTrialAll->SetBinError(globBin,erbkgBEdge);
+  }
+
+  if(ry<fMinYieldGlob) fMinYieldGlob=ry;
+  if(ry>fMaxYieldGlob) fMaxYieldGlob=ry;
+  fHistoRawYieldDist[theCase]->Fill(ry);
+  fHistoRawYieldTrial[theCase]->SetBinContent(itrial,ry);
+  fHistoRawYieldTrial[theCase]->SetBinError(itrial,ery);
+  fHistoSigmaTrial[theCase]->SetBinContent(itrial,sigma);
+  fHistoSigmaTrial[theCase]->SetBinError(itrial,esigma);
+  fHistoMeanTrial[theCase]->SetBinContent(itrial,pos);
+  fHistoMeanTrial[theCase]->SetBinError(itrial,epos);
+  fHistoChi2Trial[theCase]->SetBinContent(itrial,chisq);
+  fHistoChi2Trial[theCase]->SetBinError(itrial,0.00001);
+  fHistoSignifTrial[theCase]->SetBinContent(itrial,significance);
+  fHistoSignifTrial[theCase]->SetBinError(itrial,erSignif);
+  if(fSaveBkgVal) {
+    fHistoBkgTrial[theCase]->SetBinContent(itrial,bkg);
+    fHistoBkgTrial[theCase]->SetBinError(itrial,erbkg);
+    fHistoBkgInBinEdgesTrial[theCase]->SetBinContent(itrial,bkgBEdge);
+    fHistoBkgInBinEdgesTrial[theCase]->SetBinError(itrial,erbkgBEdge);
+  }
+  fNtupleMultiTrials->Fill(xnt);
+  if(types==0){
+    // bin counting done only for 1 case of signal line shape
+    for(Int_t j=0; j<9; j++) xntBC[j]=xnt[j];
+    for(Int_t iStepBC=0; iStepBC<fNumOfnSigmaBinCSteps; iStepBC++){
+      const Double_t* resBC=&result[kNTrialValues+iStepBC*kNBinCountValues];
+      if(resBC[kBinCountDone]<=0.) continue;
+      Double_t cnts0=resBC[kBinCountRawYield0];
+      Double_t ecnts0=resBC[kBinCountErRawYield0];
+      Double_t cnts1=resBC[kBinCountRawYield1];
+      Double_t ecnts1=resBC[kBinCountErRawYield1];
+      xntBC[9]=fnSigmaBinCSteps[iStepBC];
+      xntBC[10]=cnts0;
+      xntBC[11]=ecnts0;
+      xntBC[12]=cnts1;
+      xntBC[13]=ecnts1;
+      fHistoRawYieldDistBinC0All->Fill(cnts0);
+      fHistoRawYieldTrialBinC0All->SetBinContent(globBin,iStepBC+1,cnts0);
+      fHistoRawYieldTrialBinC0All->SetBinError(globBin,iStepBC+1,ecnts0);
+      fHistoRawYieldTrialBinC0[theCase]->SetBinContent(itrial,iStepBC+1,cnts0);
+      fHistoRawYieldTrialBinC0[theCase]->SetBinError(itrial,iStepBC+1,ecnts0);
+      fHistoRawYieldDistBinC0[theCase]->Fill(cnts0);
+      fHistoRawYieldDistBinC1All->Fill(cnts1);
+      fHistoRawYieldTrialBinC1All->SetBinContent(globBin,iStepBC+1,cnts1);
+      fHistoRawYieldTrialBinC1All->SetBinError(globBin,iStepBC+1,ecnts1);
+      fHistoRawYieldTrialBinC1[theCase]->SetBinContent(itrial,iStepBC+1,cnts1);
+      fHistoRawYieldTrialBinC1[theCase]->SetBinError(itrial,iStepBC+1,ecnts1);
+      fHistoRawYieldDistBinC1[theCase]->Fill(cnts1);
+      fNtupleBinCount->Fill(xntBC);
+    }
+  }
+}
+
 //________________________________________________________________________
 void AliHFInvMassMultiTrialFit::SaveToRoot(TString fileName, TString option) const{
   // save histos in a root file for further analysis
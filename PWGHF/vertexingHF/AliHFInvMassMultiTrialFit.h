@@ -105,6 +105,13 @@ class AliHFInvMassMultiTrialFit : public TNamed {
 
   void SetDrawIndividualFits(Bool_t opt=kTRUE){fDrawIndividualFits=opt;}
 
+  /// Fit the trials in n worker processes (0: one per core), the output is the same as with
+  /// the default sequential fits (n=1). Not used when the individual fits are drawn
+  void SetNumberOfWorkers(Int_t n){fNWorkers=n;}
+  /// Start the fits from the mean and sigma of the converged fit of the neighbouring fit range
+  /// (same histogram and configuration); changes the starting point, hence the results w.r.t. the default
+  void SetUseWarmStart(Bool_t opt=kTRUE){fUseWarmStart=opt;}
+
   Bool_t DoMultiTrials(TH1D* hInvMassHisto, TPad* thePad=0x0);
   void SaveToRoot(TString fileName, TString option="recreate") const;
   void DrawHistos(TCanvas* cry) const;
@@ -131,6 +138,13 @@ class AliHFInvMassMultiTrialFit : public TNamed {
   Bool_t CreateHistos();
   Bool_t DoFitWithPol3Bkg(TH1F* histoToFit, Double_t  hmin, Double_t  hmax,
 			  Int_t theCase);
+  Int_t  GetNTrialValues() const;
+  void   ProcessTrials(TH1D* hInvMassHisto, Int_t nTrials, const Int_t* trialDefs, Double_t* results,
+		       Int_t nWorkers, Int_t iWorker, TPad* thePad);
+  Bool_t RunTrialsInWorkers(TH1D* hInvMassHisto, Int_t nTrials, const Int_t* trialDefs, Double_t* results);
+  Bool_t FitTrial(TH1D* hInvMassHisto, TH1F* hRebinned, const Int_t* def, Int_t globBin,
+		  const Double_t* seed, Double_t* result, TPad* thePad);
+  void   FillTrialOutput(const Int_t* def, const Double_t* result);
 
   AliHFInvMassMultiTrialFit(const AliHFInvMassMultiTrialFit &source);
   AliHFInvMassMultiTrialFit& operator=(const AliHFInvMassMultiTrialFit& source);
@@ -220,10 +234,13 @@ class AliHFInvMassMultiTrialFit : public TNamed {
   Double_t fMinYieldGlob;   /// minimum yield
   Double_t fMaxYieldGlob;   /// maximum yield
 
+  Int_t  fNWorkers;         /// number of worker processes for the fits
+  Bool_t fUseWarmStart;     /// flag for starting the fits from the neighbouring fit range
+
   std::vector<AliHFInvMassFitter*> fMassFitters; //!<! Mass fitters
 
   /// \cond CLASSIMP
-  ClassDef(AliHFInvMassMultiTrialFit,5); /// class for multiple trials of invariant mass fit
+  ClassDef(AliHFInvMassMultiTrialFit,6); /// class for multiple trials of invariant mass fit
   /// \endcond
 };
 
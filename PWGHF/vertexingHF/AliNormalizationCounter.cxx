@@ -39,6 +39,7 @@
 #include <TObjArray.h>
 #include <TString.h>
 #include <TCanvas.h>
+#include <TBuffer.h>
 #include <AliPhysicsSelection.h>
 #include <AliMultiplicity.h>
 
@@ -46,6 +47,17 @@
 ClassImp(AliNormalizationCounter);
 /// \endcond
 
+namespace {
+  /// Names of the keys of the Event rubric, in the order of AliNormalizationCounter::EEventKey
+  const char* kEventKeyNames[AliNormalizationCounter::kNEventKeys] = {
+    "triggered", "V0AND", "PileUp", "PbPbC0SMH-B-NOPF-ALLNOTRD", "Candles0.3", "PrimaryV", "countForNorm",
+    "noPrimaryV", "zvtxGT10", "!V0A&Candle03", "!V0A&PrimaryV",
+    "Candid(Filter)", "Candid(Analysis)", "NCandid(Filter)", "NCandid(Analysis)"
+  };
+  /// Format of the counter keys
+  enum { kKeyRun=0, kKeyRunMult, kKeyRunMultSphero, kKeyRunSphero };
+}
+
 //____________________________________________
 AliNormalizationCounter::AliNormalizationCounter(): 
 TNamed(),
@@ -61,7 +73,11 @@ fHistTrackFilterSpdMult(0),
 fHistTrackAnaSpdMult(0),
 fHistGenVertexZ(0),
 fHistGenVertexZRecoPV(0),
-fHistRecoVertexZ(0)
+fHistRecoVertexZ(0),
+fPendingRun(-1),
+fPendingSlots(),
+fPendingKeys(),
+fPendingCounts()
 {
   // empty constructor
 }
@@ -81,7 +97,11 @@ fHistTrackFilterSpdMult(0),
 fHistTrackAnaSpdMult(0),
 fHistGenVertexZ(0),
 fHistGenVertexZRecoPV(0),
-fHistRecoVertexZ(0)
+fHistRecoVertexZ(0),
+fPendingRun(-1),
+fPendingSlots(),
+fPendingKeys(),
+fPendingCounts()
 {
   ;
 }
@@ -161,6 +181,8 @@ Long64_t AliNormalizationCounter::Merge(TCollection* list){
 }
 //_______________________________________
 void AliNormalizationCounter::Add(const AliNormalizationCounter *norm){
+  FlushCounts();
+  const_cast<AliNormalizationCounter*>(norm)->FlushCounts();
   fCounters.Add(&(norm->fCounters));
   fHistTrackFilterEvMult->Add(norm->fHistTrackFilterEvMult);
   fHistTrackAnaEvMult->Add(norm->fHistTrackAnaEvMult);
@@ -202,7 +224,7 @@ void AliNormalizationCounter::StoreEvent(AliVEvent *event,AliRDHFCuts *rdCut,Boo
   //event must be either physics or MC
   if(!(event->GetEventType() == 7||event->GetEventType() == 0))return;
   
-  FillCounters("triggered",runNumber,multiplicity,spherocity);
+  FillCounters(kTriggered,runNumber,multiplicity,spherocity);
 
   //Find V0AND
   AliTriggerAnalysis trAn; /// Trigger Analysis
@@ -213,7 +235,7 @@ void AliNormalizationCounter::StoreEvent(AliVEvent *event,AliRDHFCuts *rdCut,Boo
     v0B = trAn.IsOfflineTriggerFired(eventESD , AliTriggerAnalysis::kV0C);
     v0A = trAn.IsOfflineTriggerFired(eventESD , AliTriggerAnalysis::kV0A);
   }
-  if(v0A&&v0B) FillCounters("V0AND",runNumber,multiplicity,spherocity);
+  if(v0A&&v0B) FillCounters(kV0AND,runNumber,multiplicity,spherocity);
   
   //FindPrimary vertex  
   // AliVVertex *vtrc =  (AliVVertex*)event->GetPrimaryVertex();
@@ -226,30 +248,30 @@ void AliNormalizationCounter::StoreEvent(AliVEvent *event,AliRDHFCuts *rdCut,Boo
   AliAODEvent *eventAOD = (AliAODEvent*)event;
   TString trigclass=eventAOD->GetFiredTriggerClasses();
   if(trigclass.Contains("C0SMH-B-NOPF-ALLNOTRD")||trigclass.Contains("C0SMH-B-NOPF-ALL")){
-    FillCounters("PbPbC0SMH-B-NOPF-ALLNOTRD",runNumber,multiplicity,spherocity);
+    FillCounters(kPbPbC0SMH,runNumber,multiplicity,spherocity);
   }
 
   //FindPrimary vertex  
   if(isEventSelected){
-    FillCounters("PrimaryV",runNumber,multiplicity,spherocity);
+    FillCounters(kPrimaryV,runNumber,multiplicity,spherocity);
     flagPV=kTRUE;
   }else{
     if(rdCut->GetWhyRejection()==0){
-      FillCounters("noPrimaryV",runNumber,multiplicity,spherocity);
+      FillCounters(kNoPrimaryV,runNumber,multiplicity,spherocity);
     }
     //find good vtx outside range
     if(rdCut->GetWhyRejection()==6){
-      FillCounters("zvtxGT10",runNumber,multiplicity,spherocity);
-      FillCounters("PrimaryV",runNumber,multiplicity,spherocity);
+      FillCounters(kZvtxGT10,runNumber,multiplicity,spherocity);
+      FillCounters(kPrimaryV,runNumber,multiplicity,spherocity);
       flagPV=kTRUE;
     }
     if(rdCut->GetWhyRejection()==1){
-      FillCounters("PileUp",runNumber,multiplicity,spherocity);
+      FillCounters(kPileUp,runNumber,multiplicity,spherocity);
     }
   }
   //to be counted for normalization
   if(rdCut->CountEventForNormalization()){
-    FillCounters("countForNorm",runNumber,multiplicity,spherocity);
+    FillCounters(kCountForNorm,runNumber,multiplicity,spherocity);
   }
   // fill histograms of vertex position
   if(mc){
@@ -270,17 +292,17 @@ void AliNormalizationCounter::StoreEvent(AliVEvent *event,AliRDHFCuts *rdCut,Boo
   for(Int_t i=0;i<trkEntries&&!flag03;i++){
     AliAODTrack *track=(AliAODTrack*)event->GetTrack(i);
     if((track->Pt()>0.3)&&(!flag03)){
-      FillCounters("Candles0.3",runNumber,multiplicity,spherocity);
+      FillCounters(kCandles03,runNumber,multiplicity,spherocity);
       flag03=kTRUE;
       break;
     }
   }
   
   if(!(v0A&&v0B)&&(flag03)){ 
-    FillCounters("!V0A&Candle03",runNumber,multiplicity,spherocity);
+    FillCounters(kNotV0ACandle03,runNumber,multiplicity,spherocity);
   }
   if(!(v0A&&v0B)&&flagPV){
-    FillCounters("!V0A&PrimaryV",runNumber,multiplicity,spherocity);
+    FillCounters(kNotV0APrimaryV,runNumber,multiplicity,spherocity);
   }
   
   return;
@@ -308,33 +330,19 @@ void AliNormalizationCounter::StoreCandidates(AliVEvent *event,Int_t nCand,Bool_
   Int_t runNumber = event->GetRunNumber();
   Int_t multiplicity = Multiplicity(event);
   if(nCand==0)return;
+  Int_t format = fMultiplicity ? kKeyRunMult : kKeyRun;
   if(flagFilter){
-    if(fMultiplicity) 
-      fCounters.Count(Form("Event:Candid(Filter)/Run:%d/Multiplicity:%d",runNumber,multiplicity));
-    else 
-      fCounters.Count(Form("Event:Candid(Filter)/Run:%d",runNumber));
-    for(Int_t i=0;i<nCand;i++){ 
-      if(fMultiplicity) 
-	fCounters.Count(Form("Event:NCandid(Filter)/Run:%d/Multiplicity:%d",runNumber,multiplicity));
-      else 
-	fCounters.Count(Form("Event:NCandid(Filter)/Run:%d",runNumber));
-    }
+    CountSlot(format,kCandidFilter,runNumber,multiplicity,0);
+    CountSlot(format,kNCandidFilter,runNumber,multiplicity,0,nCand);
   }else{
-    if(fMultiplicity) 
-      fCounters.Count(Form("Event:Candid(Analysis)/Run:%d/Multiplicity:%d",runNumber,multiplicity));
-    else
-      fCounters.Count(Form("Event:Candid(Analysis)/Run:%d",runNumber));
-    for(Int_t i=0;i<nCand;i++){ 
-      if(fMultiplicity) 
-	fCounters.Count(Form("Event:NCandid(Analysis)/Run:%d/Multiplicity:%d",runNumber,multiplicity));
-      else
-	fCounters.Count(Form("Event:NCandid(Analysis)/Run:%d",runNumber));
-    }
+    CountSlot(format,kCandidAnalysis,runNumber,multiplicity,0);
+    CountSlot(format,kNCandidAnalysis,runNumber,multiplicity,0,nCand);
   }
   return;
 }
 //_______________________________________________________________________
 TH1D* AliNormalizationCounter::DrawAgainstRuns(TString candle,Bool_t drawHist){
+  FlushCounts();
   //
   fCounters.SortRubric("Run");
   TString selection;
@@ -348,6 +356,7 @@ TH1D* AliNormalizationCounter::DrawAgainstRuns(TString candle,Bool_t drawHist){
 //___________________________________________________________________________
 TH1D* AliNormalizationCounter::DrawRatio(TString candle1,TString candle2){
   //
+  FlushCounts();
   fCounters.SortRubric("Run");
   TString name;
 
@@ -365,10 +374,12 @@ TH1D* AliNormalizationCounter::DrawRatio(TString candle1,TString candle2){
 }
 //___________________________________________________________________________
 void AliNormalizationCounter::PrintRubrics(){
+  FlushCounts();
   fCounters.PrintKeyWords();
 }
 //___________________________________________________________________________
 Double_t AliNormalizationCounter::GetSum(TString candle){
+  FlushCounts();
   TString selection="event:";
   selection.Append(candle);
   return fCounters.GetSum(selection.Data());
@@ -400,6 +411,7 @@ Double_t AliNormalizationCounter::GetNEventsForNorm(){
 }
 //___________________________________________________________________________
 Double_t AliNormalizationCounter::GetNEventsForNorm(Int_t runnumber){
+  FlushCounts();
   TString listofruns = fCounters.GetKeyWords("RUN");
   if(!listofruns.Contains(Form("%d",runnumber))){
     printf("WARNING: %d is not a valid run number\n",runnumber);
@@ -423,6 +435,7 @@ Double_t AliNormalizationCounter::GetNEventsForNorm(Int_t minmultiplicity, Int_t
     return 0.;
   }
 
+  FlushCounts();
   TString listofruns = fCounters.GetKeyWords("Multiplicity");
 
   Int_t nmultbins = maxmultiplicity - minmultiplicity;
@@ -454,6 +467,7 @@ Double_t AliNormalizationCounter::GetNEventsForNorm(Int_t minmultiplicity, Int_t
     return 0.;
   }
 
+  FlushCounts();
   TString listofruns = fCounters.GetKeyWords("Multiplicity");
   TString listofruns2 = fCounters.GetKeyWords("Spherocity");
   TObjArray* arr=listofruns2.Tokenize(",");
@@ -495,6 +509,7 @@ Double_t AliNormalizationCounter::GetNEventsForNormSpheroOnly(Double_t minsphero
     return 0.;
   }
 
+  FlushCounts();
   TString listofruns = fCounters.GetKeyWords("Spherocity");
   TObjArray* arr=listofruns.Tokenize(",");
   Int_t nSphVals=arr->GetEntries();
@@ -531,6 +546,7 @@ Double_t AliNormalizationCounter::GetSum(TString candle,Int_t minmultiplicity, I
     return 0.;
   }
 
+  FlushCounts();
   TString listofruns = fCounters.GetKeyWords("Multiplicity");
   Double_t sum=0.;
   for (Int_t ibin=minmultiplicity; ibin<=maxmultiplicity; ibin++) {
@@ -548,6 +564,7 @@ Double_t AliNormalizationCounter::GetSum(TString candle,Int_t minmultiplicity, I
 
 //___________________________________________________________________________
 TH1D* AliNormalizationCounter::DrawNEventsForNorm(Bool_t drawRatio){
+  FlushCounts();
   //usare algebra histos
   fCounters.SortRubric("Run");
   TString selection;
@@ -603,17 +620,82 @@ Int_t AliNormalizationCounter::Multiplicity(AliVEvent* event){
 }
 
 //___________________________________________________________________________
-void AliNormalizationCounter::FillCounters(TString name, Int_t runNumber, Int_t multiplicity, Double_t spherocity){
+void AliNormalizationCounter::FillCounters(Int_t eventKey, Int_t runNumber, Int_t multiplicity, Double_t spherocity){
 
 
   Int_t sphToInteger=spherocity*fSpherocitySteps;
   if(fMultiplicity  && !fSpherocity) 
-    fCounters.Count(Form("Event:%s/Run:%d/Multiplicity:%d",name.Data(),runNumber,multiplicity));
+    CountSlot(kKeyRunMult,eventKey,runNumber,multiplicity,0);
   else if(fMultiplicity  && fSpherocity) 
-    fCounters.Count(Form("Event:%s/Run:%d/Multiplicity:%d/Spherocity:%d",name.Data(),runNumber,multiplicity,sphToInteger));
+    CountSlot(kKeyRunMultSphero,eventKey,runNumber,multiplicity,sphToInteger);
   else if(!fMultiplicity  && fSpherocity) 
-    fCounters.Count(Form("Event:%s/Run:%d/Spherocity:%d",name.Data(),runNumber,sphToInteger));
+    CountSlot(kKeyRunSphero,eventKey,runNumber,0,sphToInteger);
   else 
-    fCounters.Count(Form("Event:%s/Run:%d",name.Data(),runNumber));
+    CountSlot(kKeyRun,eventKey,runNumber,0,0);
   return;
 }
+
+//___________________________________________________________________________
+void AliNormalizationCounter::CountSlot(Int_t format, Int_t eventKey, Int_t runNumber, Int_t multiplicity, Int_t spherocity, Int_t value){
+  /// Add value to the slot of the key, the counter key string is built only
+  /// the first time the combination is met in the run. The slots are moved
+  /// to fCounters when the run changes and before fCounters is accessed.
+
+  if(runNumber!=fPendingRun){
+    FlushCounts();
+    fPendingRun=runNumber;
+  }
+
+  std::pair<Int_t,std::pair<Int_t,Int_t> > slotKey(format*kNEventKeys+eventKey,std::make_pair(multiplicity,spherocity));
+  std::map<std::pair<Int_t,std::pair<Int_t,Int_t> >,Int_t>::iterator it=fPendingSlots.find(slotKey);
+  if(it!=fPendingSlots.end()){
+    fPendingCounts[it->second]+=value;
+    return;
+  }
+
+  TString key;
+  const char* name=kEventKeyNames[eventKey];
+  switch(format){
+  case kKeyRunMult:
+    key.Form("Event:%s/Run:%d/Multiplicity:%d",name,runNumber,multiplicity);
+    break;
+  case kKeyRunMultSphero:
+    key.Form("Event:%s/Run:%d/Multiplicity:%d/Spherocity:%d",name,runNumber,multiplicity,spherocity);
+    break;
+  case kKeyRunSphero:
+    key.Form("Event:%s/Run:%d/Spherocity:%d",name,runNumber,spherocity);
+    break;
+  default:
+    key.Form("Event:%s/Run:%d",name,runNumber);
+    break;
+  }
+  fPendingSlots[slotKey]=fPendingKeys.size();
+  fPendingKeys.push_back(key);
+  fPendingCounts.push_back(value);
+  return;
+}
+
+//___________________________________________________________________________
+void AliNormalizationCounter::FlushCounts(){
+  /// Move the pending counts to fCounters, in order of first use of the keys
+  for(UInt_t islot=0; islot<fPendingKeys.size(); islot++){
+    if(fPendingCounts[islot]>0) fCounters.Count(fPendingKeys[islot],fPendingCounts[islot]);
+  }
+  fPendingSlots.clear();
+  fPendingKeys.clear();
+  fPendingCounts.clear();
+  fPendingRun=-1;
+  return;
+}
+
+//___________________________________________________________________________
+void AliNormalizationCounter::Streamer(TBuffer &R__b){
+  /// Stream an object of class AliNormalizationCounter, the pending counts
+  /// are moved to fCounters before writing
+  if(R__b.IsReading()){
+    R__b.ReadClassBuffer(AliNormalizationCounter::Class(),this);
+  }else{
+    FlushCounts();
+    R__b.WriteClassBuffer(AliNormalizationCounter::Class(),this);
+  }
+}
@@ -44,17 +44,25 @@
 #include "AliAnalysisDataContainer.h"
 #include "AliRDHFCuts.h"
 //#include "AliAnalysisVertexingHF.h"
+#include <map>
+#include <utility>
+#include <vector>
 
 class AliNormalizationCounter : public TNamed
 {
  public:
 
+  /// Keys of the Event rubric, counted through integer slots
+  enum EEventKey {kTriggered=0, kV0AND, kPileUp, kPbPbC0SMH, kCandles03, kPrimaryV, kCountForNorm,
+                  kNoPrimaryV, kZvtxGT10, kNotV0ACandle03, kNotV0APrimaryV,
+                  kCandidFilter, kCandidAnalysis, kNCandidFilter, kNCandidAnalysis, kNEventKeys};
+
   AliNormalizationCounter();
   AliNormalizationCounter(const char *name);
   virtual ~AliNormalizationCounter();
   Long64_t Merge(TCollection* list);
 
-  AliCounterCollection* GetCounter(){return &fCounters;}
+  AliCounterCollection* GetCounter(){FlushCounts(); return &fCounters;}
   void Init();
   void Add(const AliNormalizationCounter*);
   void SetESD(Bool_t flag){fESD=flag;}
@@ -87,7 +95,9 @@ class AliNormalizationCounter : public TNamed
   AliNormalizationCounter(const AliNormalizationCounter &source);
   AliNormalizationCounter& operator=(const AliNormalizationCounter& source);
   Int_t Multiplicity(AliVEvent* event);
-  void FillCounters(TString name, Int_t runNumber, Int_t multiplicity, Double_t spherocity);
+  void FillCounters(Int_t eventKey, Int_t runNumber, Int_t multiplicity, Double_t spherocity);
+  void CountSlot(Int_t format, Int_t eventKey, Int_t runNumber, Int_t multiplicity, Int_t spherocity, Int_t value=1);
+  void FlushCounts();
 
 
   AliCounterCollection fCounters; /// internal counter
@@ -104,8 +114,14 @@ class AliNormalizationCounter : public TNamed
   TH1F *fHistGenVertexZRecoPV; /// histo of generated z vertex for events with reco vert
   TH1F *fHistRecoVertexZ;      /// histo of reconstructed z vertex
 
+  /// counts not yet added to fCounters, one slot per key of the current run
+  Int_t fPendingRun;                                                   //! run of the pending counts
+  std::map<std::pair<Int_t,std::pair<Int_t,Int_t> >,Int_t> fPendingSlots; //! (format and event key, (multiplicity, spherocity)) -> slot
+  std::vector<TString> fPendingKeys;                                   //! counter key of each slot, in order of first use
+  std::vector<Int_t> fPendingCounts;                                   //! pending counts of each slot
+
   /// \cond CLASSIMP    
-  ClassDef(AliNormalizationCounter,8);
+  ClassDef(AliNormalizationCounter,9);
   /// \endcond
 };
 #endif
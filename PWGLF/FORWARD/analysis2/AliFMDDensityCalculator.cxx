@@ -261,6 +261,7 @@ AliFMDDensityCalculator::SetupForData(const TAxis& axis)
     // o->fMultCut = fCuts.GetFixedCut(o->fDet, o->fRing);
     // o->fPoisson.Init(o->fDet,o->fRing,fEtaLumping, fPhiLumping);
   }
+  CacheStripTables();
 }
 
 //____________________________________________________________________
@@ -343,6 +344,50 @@ AliFMDDensityCalculator::GetMultCut(UShort_t d, Char_t r, Double_t eta,
   // return fCuts.GetMultCut(d,r,eta,errors);
 }
 
+//____________________________________________________________________
+void
+AliFMDDensityCalculator::CacheStripTables()
+{
+  // Fill the per-ring look-up tables used in Calculate.  The strip
+  // positions, the acceptance corrections and the low cuts do not
+  // change from event to event, so we calculate them only once here.
+  // Only the part that depends on the interaction point is done per
+  // event.
+  DGUARD(fDebug, 2, "Cache strip tables in FMD density calculator");
+  TIter    next(&fRingHistos);
+  RingHistos* o = 0;
+  while ((o = static_cast<RingHistos*>(next()))) {
+    UShort_t d  = o->fDet;
+    Char_t   r  = o->fRing;
+    UShort_t ns = (r == 'I' || r == 'i' ?  20 :  40);
+    UShort_t nt = (r == 'I' || r == 'i' ? 512 : 256);
+    o->fNStrips = nt;
+    o->fStripX.Set(ns*nt);
+    o->fStripY.Set(ns*nt);
+    o->fSectorZ.Set(ns);
+    o->fStripAcc.Set(nt);
+    for (UShort_t s = 0; s < ns; s++) { 
+      Double_t phiD  = AliForwardUtil::GetSectorPhi(d, r, s);
+      Double_t zD    = AliForwardUtil::GetSectorZ(d, r, s);
+      if (phiD == AliForwardUtil::kInvalidValue) 
+	zD = AliForwardUtil::kInvalidValue;
+      o->fSectorZ[s] = zD;
+      for (UShort_t t = 0; t < nt; t++) { 
+	Double_t rD = AliForwardUtil::GetStripR(r, t);
+	o->fStripX[s*nt+t] = rD*TMath::Cos(phiD);
+	o->fStripY[s*nt+t] = rD*TMath::Sin(phiD);
+      }
+    }
+    for (UShort_t t = 0; t < nt; t++) 
+      o->fStripAcc[t] = (fAccI && fAccO ? AcceptanceCorrection(r, t) : 1);
+
+    Int_t nEta = fLowCuts->GetNbinsX();
+    o->fLowCut.Set(nEta+2);
+    for (Int_t i = 0; i <= nEta+1; i++) 
+      o->fLowCut[i] = Rng2Cut(d, r, i, fLowCuts);
+  }
+}
+
 #ifndef NO_TIMING
 # define START_TIMER(T) if (fDoTiming) T.Start(true)
 # define GET_TIMER(T,V) if (fDoTiming) V = T.CpuTime()
@@ -416,6 +461,11 @@ AliFMDDensityCalculator::Calculate(const AliESDFMD&        fmd,
 	fRingHistos.ls();
 	return false;
       }
+      // Per-ring tables from CacheStripTables.  We use the raw arrays
+      // since we do not want a bounds check.
+      const Float_t*  acc    = rh->fStripAcc.GetArray();
+      const Double_t* lowCut = rh->fLowCut.GetArray();
+      TAxis*          cutAx  = fLowCuts->GetXaxis();
       // rh->fPoisson.SetObject(d,r,vtxbin,cent);
       rh->fPoisson.Reset(0);
       rh->fTotal->Reset();
@@ -443,7 +493,8 @@ AliFMDDensityCalculator::Calculate(const AliESDFMD&        fmd,
 	  if (fRecalculatePhi) {
 	    // Correct for (x,y) off set of the interaction point 
 	    // AliForwardUtil::GetEtaPhiFromStrip(r,t,eta,phi,ip.X(),ip.Y());
-	    if (!AliForwardUtil::GetEtaPhi(d,r,s,t,ip,eta,phi) ||
+	    // if (!AliForwardUtil::GetEtaPhi(d,r,s,t,ip,eta,phi) ||
+	    if (!rh->StripEtaPhi(s,t,ip,eta,phi) ||
 		TMath::Abs(eta) < 1) {
 	      AliWarningF("FMD%d%c[%2d,%3d] (%f,%f,%f) eta=%f phi=%f (%f)",
 			  d, r, s, t, ip.X(), ip.Y(), ip.Z(), eta,
@@ -485,11 +536,12 @@ AliFMDDensityCalculator::Calculate(const AliESDFMD&        fmd,
 
 	  // --- Apply phi corner correction to eloss ----------------
 	  if (fUsePhiAcceptance == kPhiCorrectELoss) 
-	    mult *= AcceptanceCorrection(r,t);
+	    mult *= acc[t]; // AcceptanceCorrection(r,t);
 
 	  // --- Get the low multiplicity cut ------------------------
 	  Double_t cut  = 1024;
-	  if (eta != AliESDFMD::kInvalidEta) cut = GetMultCut(d, r, eta,false);
+	  // Same as GetMultCut(d, r, eta, false)
+	  if (eta != AliESDFMD::kInvalidEta) cut = lowCut[cutAx->FindBin(eta)];
 	  else AliWarningF("Eta for FMD%d%c[%02d,%03d] is invalid: %f", 
 			   d, r, s, t, eta);
 
@@ -507,7 +559,7 @@ AliFMDDensityCalculator::Calculate(const AliESDFMD&        fmd,
 	  // Temporary stuff - remove Correction call 
 	  Double_t c = 1;
 	  if (fUsePhiAcceptance == kPhiCorrectNch) 
-	    c = AcceptanceCorrection(r,t);
+	    c = acc[t]; // AcceptanceCorrection(r,t);
 	  // Double_t c = Correction(d,r,t,eta,lowFlux);
 	  ADD_TIMER(timer,corrTime);
 	  fCorrections->Fill(c);
@@ -1265,7 +1317,13 @@ AliFMDDensityCalculator::RingHistos::RingHistos()
     fPhiBefore(0),
     fPhiAfter(0),
     fEtaBefore(0),
-    fEtaAfter(0)
+    fEtaAfter(0),
+    fNStrips(0),
+    fStripX(),
+    fStripY(),
+    fSectorZ(),
+    fStripAcc(),
+    fLowCut()
 {
   // 
   // Default CTOR
@@ -1298,7 +1356,13 @@ AliFMDDensityCalculator::RingHistos::RingHistos(UShort_t d, Char_t r)
     fPhiBefore(0),
     fPhiAfter(0),
     fEtaBefore(0),
-    fEtaAfter(0)
+    fEtaAfter(0),
+    fNStrips(0),
+    fStripX(),
+    fStripY(),
+    fSectorZ(),
+    fStripAcc(),
+    fLowCut()
 {
   // 
   // Constructor
@@ -1484,7 +1548,13 @@ AliFMDDensityCalculator::RingHistos::RingHistos(const RingHistos& o)
     fPhiBefore(o.fPhiBefore),
     fPhiAfter(o.fPhiAfter),
     fEtaBefore(o.fEtaBefore),
-    fEtaAfter(o.fEtaAfter)
+    fEtaAfter(o.fEtaAfter),
+    fNStrips(o.fNStrips),
+    fStripX(o.fStripX),
+    fStripY(o.fStripY),
+    fSectorZ(o.fSectorZ),
+    fStripAcc(o.fStripAcc),
+    fLowCut(o.fLowCut)
 {
   // 
   // Copy constructor 
@@ -1549,6 +1619,12 @@ AliFMDDensityCalculator::RingHistos::operator=(const RingHistos& o)
   fPhiAfter            = static_cast<TH1D*>(o.fPhiAfter->Clone());
   fEtaBefore           = static_cast<TH1D*>(o.fEtaBefore->Clone());
   fEtaAfter            = static_cast<TH1D*>(o.fEtaAfter->Clone());
+  fNStrips             = o.fNStrips;
+  fStripX              = o.fStripX;
+  fStripY              = o.fStripY;
+  fSectorZ             = o.fSectorZ;
+  fStripAcc            = o.fStripAcc;
+  fLowCut              = o.fLowCut;
   return *this;
 }
 //____________________________________________________________________
@@ -1587,6 +1663,27 @@ AliFMDDensityCalculator::RingHistos::SetupForData(const TAxis& eAxis)
   if (fList) fList->Add(fPhiAcc);
 }
 
+//____________________________________________________________________
+Bool_t
+AliFMDDensityCalculator::RingHistos::StripEtaPhi(UShort_t        s, 
+						 UShort_t        t, 
+						 const TVector3& ip,
+						 Double_t&       eta, 
+						 Double_t&       phi) const
+{
+  // Same as AliForwardUtil::GetEtaPhi, but with the strip position
+  // taken from the tables filled in CacheStripTables
+  Double_t zD = fSectorZ[s];
+  if (zD == AliForwardUtil::kInvalidValue) 
+    return AliForwardUtil::GetEtaPhi(fDet, fRing, s, t, ip, eta, phi);
+
+  Int_t    i  = s*fNStrips+t;
+  Double_t iX = ip.X(); if (iX > 100) iX = 0; // No X
+  Double_t iY = ip.Y(); if (iY > 100) iY = 0; // No Y
+  return AliForwardUtil::GetEtaPhi(fStripX[i]-iX, fStripY[i]-iY, zD-ip.Z(),
+				   eta, phi);
+}
+
 //____________________________________________________________________
 void
 AliFMDDensityCalculator::RingHistos::CreateOutputObjects(TList* dir)
@@ -16,6 +16,8 @@
 #include <TNamed.h>
 #include <TList.h>
 #include <TArrayI.h>
+#include <TArrayF.h>
+#include <TArrayD.h>
 #include <TVector3.h>
 #include "AliForwardUtil.h"
 #include "AliFMDMultCuts.h"
@@ -297,6 +299,11 @@ protected:
    * @param axis Default @f$\eta@f$ axis from parent task 
    */  
   void CacheMaxWeights(const TAxis& axis);
+  /** 
+   * Fill the per-ring strip tables (geometry, acceptance correction,
+   * and low cuts).  Must be called after CacheMaxWeights.
+   */
+  void CacheStripTables();
   /** 
    * Find the (cached) maximum weight for FMD<i>dr</i> in 
    * @f$\eta@f$ bin @a iEta
@@ -441,6 +448,20 @@ protected:
      * @param nEvents Number of events 
      */
     void Terminate(TList* dir, Int_t nEvents);
+    /** 
+     * Calculate @f$(\eta,\varphi)@f$ of a strip from the cached
+     * geometry.  Gives the same result as AliForwardUtil::GetEtaPhi
+     * 
+     * @param s    Sector 
+     * @param t    Strip 
+     * @param ip   Interaction point 
+     * @param eta  On return, the eta
+     * @param phi  On return, the phi (in radians)
+     * 
+     * @return true on success 
+     */
+    Bool_t StripEtaPhi(UShort_t s, UShort_t t, const TVector3& ip,
+		       Double_t& eta, Double_t& phi) const;
     TList*    fList;
     // TH2D*     fEvsN;           // Correlation of Eloss vs uncorrected Nch
     // TH2D*     fEvsM;           // Correlation of Eloss vs corrected Nch
@@ -465,6 +486,12 @@ protected:
     TH1D*     fPhiAfter;       // Phi after re-calc
     TH1D*     fEtaBefore;      // Phi before re-calce 
     TH1D*     fEtaAfter;       // Phi after re-calc
+    UShort_t  fNStrips;        //! Strips per sector 
+    TArrayD   fStripX;         //! X of strips (sector major) 
+    TArrayD   fStripY;         //! Y of strips (sector major) 
+    TArrayD   fSectorZ;        //! Z of sectors 
+    TArrayF   fStripAcc;       //! Acceptance correction per strip 
+    TArrayD   fLowCut;         //! Low cut per eta bin (incl. under/overflow)
     // ClassDef(RingHistos,10);
   };
   /** 
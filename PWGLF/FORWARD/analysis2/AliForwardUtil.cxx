@@ -618,9 +618,15 @@ Bool_t AliForwardUtil::GetEtaPhi(UShort_t det, Char_t ring,
     phi = kInvalidValue;
     return false;
   }
-  Double_t   r       = TMath::Sqrt(TMath::Power(pos.X(),2)+
-				   TMath::Power(pos.Y(),2));
-  Double_t   theta   = TMath::ATan2(r, pos.Z());
+  return GetEtaPhi(pos.X(), pos.Y(), pos.Z(), eta, phi);
+}
+//_____________________________________________________________________
+Bool_t AliForwardUtil::GetEtaPhi(Double_t dX, Double_t dY, Double_t dZ,
+				 Double_t& eta, Double_t& phi)
+{
+  Double_t   r       = TMath::Sqrt(TMath::Power(dX,2)+
+				   TMath::Power(dY,2));
+  Double_t   theta   = TMath::ATan2(r, dZ);
   Double_t   tant    = TMath::Tan(theta/2);
   if (TMath::Abs(theta) < 1e-9) {
     ::Warning("GetEtaPhi","tan(theta/2)=%f very small", tant);
@@ -628,7 +634,7 @@ Bool_t AliForwardUtil::GetEtaPhi(UShort_t det, Char_t ring,
     phi = kInvalidValue;
     return false;
   }
-  phi = TMath::ATan2(pos.Y(), pos.X());
+  phi = TMath::ATan2(dY, dX);
   eta = -TMath::Log(tant);
   if (phi < 0)              phi += TMath::TwoPi();
   if (phi > TMath::TwoPi()) phi -= TMath::TwoPi();
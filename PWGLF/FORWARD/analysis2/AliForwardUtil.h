@@ -284,6 +284,19 @@ public:
   static Bool_t GetEtaPhi(UShort_t det, Char_t ring, UShort_t sec,
 			  UShort_t str, const TVector3& ip,
 			  Double_t& eta, Double_t& phi);
+  /** 
+   * Get the eta and phi of a position relative to the interaction point 
+   * 
+   * @param dX    X coordinate relative to the interaction point 
+   * @param dY    Y coordinate relative to the interaction point 
+   * @param dZ    Z coordinate relative to the interaction point 
+   * @param eta   On return, the eta
+   * @param phi   On return, the phi (in radians)
+   *
+   * @return true on success 
+   */
+  static Bool_t GetEtaPhi(Double_t dX, Double_t dY, Double_t dZ,
+			  Double_t& eta, Double_t& phi);
   /** 
    * Get eta from strip
    * 
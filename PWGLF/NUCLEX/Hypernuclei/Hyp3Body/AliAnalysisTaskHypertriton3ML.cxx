@@ -85,6 +85,26 @@ int IsTrueHyperTriton3Candidate(AliESDtrack *t1, AliESDtrack *t2, AliESDtrack *t
   return (IsHyperTriton3(mom, mcEvent)) ? mom1 : -1;
 }
 
+/// Invariant mass window of the saved candidates
+constexpr double kMinHypMass = 2.9;
+constexpr double kMaxHypMass = 3.2;
+/// Safety margin for the kinematic pruning, to be insensitive to the rounding of the momenta
+constexpr double kMassPruningMargin = 1.e-3;
+
+/// Lower bound of the invariant mass of a system with total energy e and sum of the momentum moduli p, reached
+/// when all the momenta are collinear. The momentum moduli are not modified by the propagation of the tracks, hence
+/// the bound holds for the candidate built at the decay vertex.
+double MinInvariantMass(double e, double p) {
+  const double m2 = e * e - p * p;
+  return m2 > 0. ? std::sqrt(m2) : 0.;
+}
+
+CHypertriton3Daughter MakeDaughter(AliESDtrack *track, float nSigmaTPC, AliPID::EParticleType species) {
+  const double mass = AliPID::ParticleMass(species);
+  const double p    = track->P();
+  return {track, nSigmaTPC, static_cast<float>(p), static_cast<float>(std::sqrt(p * p + mass * mass))};
+}
+
 bool HasTOF(AliVTrack *track) {
   const bool hasTOFout  = track->GetStatus() & AliVTrack::kTOFout;
   const bool hasTOFtime = track->GetStatus() & AliVTrack::kTIME;
@@ -295,9 +315,9 @@ void AliAnalysisTaskHypertriton3ML::UserExec(Option_t *) {
     if (std::abs(nSigmaTPCDeu) < fMaxNSigmaTPCDeu && dcaNorm > fMinDCA2PrimaryVtxDeu) {
       if (HasTOF(track)) {
         if (std::abs(fPIDResponse->NumberOfSigmasTOF(track, AliPID::kDeuteron)) < fMaxNSigmaTOFDeu)
-          fDeuVector.push_back(track);
+          fDeuVector.push_back(MakeDaughter(track, nSigmaTPCDeu, AliPID::kDeuteron));
       } else {
-        fDeuVector.push_back(track);
+        fDeuVector.push_back(MakeDaughter(track, nSigmaTPCDeu, AliPID::kDeuteron));
       }
     }
 
@@ -305,9 +325,9 @@ void AliAnalysisTaskHypertriton3ML::UserExec(Option_t *) {
     if (std::abs(nSigmaTPCP) < fMaxNSigmaTPCP && dcaNorm > fMinDCA2PrimaryVtxP) {
       if (HasTOF(track)) {
         if (std::abs(fPIDResponse->NumberOfSigmasTOF(track, AliPID::kProton)) < fMaxNSigmaTOFP)
-          fPVector.push_back(track);
+          fPVector.push_back(MakeDaughter(track, nSigmaTPCP, AliPID::kProton));
       } else {
-        fPVector.push_back(track);
+        fPVector.push_back(MakeDaughter(track, nSigmaTPCP, AliPID::kProton));
       }
     }
 
@@ -315,9 +335,9 @@ void AliAnalysisTaskHypertriton3ML::UserExec(Option_t *) {
     if (std::abs(nSigmaTPCPi) < fMaxNSigmaTPCPi && dcaNorm > fMinDCA2PrimaryVtxPi && track->Pt() < fMaxPtPion) {
       if (HasTOF(track)) {
         if (std::abs(fPIDResponse->NumberOfSigmasTOF(track, AliPID::kPion)) < fMaxNSigmaTOFPi)
-          fPiVector.push_back(track);
+          fPiVector.push_back(MakeDaughter(track, nSigmaTPCPi, AliPID::kPion));
       } else {
-        fPiVector.push_back(track);
+        fPiVector.push_back(MakeDaughter(track, nSigmaTPCPi, AliPID::kPion));
       }
     }
   }
@@ -327,25 +347,47 @@ void AliAnalysisTaskHypertriton3ML::UserExec(Option_t *) {
     if (gRandom->Rndm() > fDownscalingFactorByEvent) return;
   }
 
-  for (const auto &deu : fDeuVector) {
-    float nSigmaDeu = fPIDResponse->NumberOfSigmasTPC(deu, AliPID::kDeuteron);
+  // The combinatorics is staged: the deuteron-proton seeds and then the full triplets are pruned with a kinematic
+  // lower bound of the invariant mass before running the vertexer, and the deuteron-proton closest point is computed
+  // once per seed and shared by all the pions attached to it.
+  const double massPi = AliPID::ParticleMass(AliPID::kPion);
+  float seedGuess[3];
+
+  for (const auto &deuDaughter : fDeuVector) {
+    AliESDtrack *deu = deuDaughter.fTrack;
+    float nSigmaDeu  = deuDaughter.fNSigmaTPC;
 
-    for (const auto &p : fPVector) {
+    for (const auto &pDaughter : fPVector) {
+      AliESDtrack *p = pDaughter.fTrack;
       if (deu == p) continue;
       if (p->Charge() * deu->Charge() < 0) continue;
 
-      float nSigmaP = fPIDResponse->NumberOfSigmasTPC(p, AliPID::kProton);
+      const double seedE = deuDaughter.fE + pDaughter.fE;
+      const double seedP = deuDaughter.fP + pDaughter.fP;
+      if (MinInvariantMass(seedE, seedP) + massPi > kMaxHypMass + kMassPruningMargin) continue;
 
-      for (const auto &pi : fPiVector) {
+      float nSigmaP     = pDaughter.fNSigmaTPC;
+      bool hasSeedGuess = false;
+
+      for (const auto &piDaughter : fPiVector) {
+        AliESDtrack *pi = piDaughter.fTrack;
         if (p == pi || deu == pi) continue;
         if (pi->Charge() * p->Charge() > 0) continue;
 
-        float nSigmaPi = fPIDResponse->NumberOfSigmasTPC(pi, AliPID::kPion);
+        if (MinInvariantMass(seedE + piDaughter.fE, seedP + piDaughter.fP) > kMaxHypMass + kMassPruningMargin)
+          continue;
+
+        float nSigmaPi = piDaughter.fNSigmaTPC;
 
         int momLab = IsTrueHyperTriton3Candidate(deu, p, pi, mcEvent);
         if ((momLab == -1) && fOnlyTrueCandidates) continue;
 
-        bool recoVertex = fVertexer.FindDecayVertex(deu, p, pi, b);
+        if (!hasSeedGuess) {
+          AliVertexerHyperTriton3Body::Find2ProngClosestPoint(deu, p, b, seedGuess);
+          hasSeedGuess = true;
+        }
+
+        bool recoVertex = fVertexer.FindDecayVertex(deu, p, pi, b, seedGuess);
         if (!recoVertex) continue;
 
         AliESDVertex *decayVtx = static_cast<AliESDVertex *>(fVertexer.GetCurrentVertex());
@@ -359,15 +401,17 @@ void AliAnalysisTaskHypertriton3ML::UserExec(Option_t *) {
 
         double dcaDecayDeu[2], dcaDecayP[2], dcaDecayPi[2];
 
-        deu->PropagateToDCA(decayVtx, b, 1000., dcaDecayDeu);
-        p->PropagateToDCA(decayVtx, b, 1000., dcaDecayP);
-        pi->PropagateToDCA(decayVtx, b, 1000., dcaDecayPi);
+        // the daughters are propagated on local copies, so that every combination starts from the ESD tracks
+        AliExternalTrackParam deuAtVtx(*deu), pAtVtx(*p), piAtVtx(*pi);
+        deuAtVtx.PropagateToDCA(decayVtx, b, 1000., dcaDecayDeu);
+        pAtVtx.PropagateToDCA(decayVtx, b, 1000., dcaDecayP);
+        piAtVtx.PropagateToDCA(decayVtx, b, 1000., dcaDecayPi);
 
         LVector_t deu4Vector, p4Vector, pi4Vector, hyp4Vector;
 
-        deu4Vector.SetCoordinates(deu->Px(), deu->Py(), deu->Pz(), AliPID::ParticleMass(AliPID::kDeuteron));
-        p4Vector.SetCoordinates(p->Px(), p->Py(), p->Pz(), AliPID::ParticleMass(AliPID::kProton));
-        pi4Vector.SetCoordinates(pi->Px(), pi->Py(), pi->Pz(), AliPID::ParticleMass(AliPID::kPion));
+        deu4Vector.SetCoordinates(deuAtVtx.Px(), deuAtVtx.Py(), deuAtVtx.Pz(), AliPID::ParticleMass(AliPID::kDeuteron));
+        p4Vector.SetCoordinates(pAtVtx.Px(), pAtVtx.Py(), pAtVtx.Pz(), AliPID::ParticleMass(AliPID::kProton));
+        pi4Vector.SetCoordinates(piAtVtx.Px(), piAtVtx.Py(), piAtVtx.Pz(), AliPID::ParticleMass(AliPID::kPion));
 
         hyp4Vector = deu4Vector + p4Vector + pi4Vector;
 
@@ -375,7 +419,7 @@ void AliAnalysisTaskHypertriton3ML::UserExec(Option_t *) {
         float hypM  = hyp4Vector.M();
 
         if ((hypPt < fMinCanidatePtToSave) || (fMaxCanidatePtToSave < hypPt)) continue;
-        if (hypM < 2.9 || hypM > 3.2) continue;
+        if (hypM < kMinHypMass || hypM > kMaxHypMass) continue;
 
         double dTotHyper = std::sqrt(decayLenght[0] * decayLenght[0] + decayLenght[1] * decayLenght[1] +
                                      decayLenght[2] * decayLenght[2]);
@@ -401,25 +445,25 @@ void AliAnalysisTaskHypertriton3ML::UserExec(Option_t *) {
         hyp3r.fDecayVtxY = decayVtx->GetY();
         hyp3r.fDecayVtxZ = decayVtx->GetZ();
 
-        hyp3r.fPxDeu = deu->Px();
-        hyp3r.fPyDeu = deu->Py();
-        hyp3r.fPzDeu = deu->Pz();
-        hyp3r.fPxP   = p->Px();
-        hyp3r.fPyP   = p->Py();
-        hyp3r.fPzP   = p->Pz();
-        hyp3r.fPxPi  = pi->Px();
-        hyp3r.fPyPi  = pi->Py();
-        hyp3r.fPzPi  = pi->Pz();
-
-        hyp3r.fPosXDeu = deu->GetX();
-        hyp3r.fPosYDeu = deu->GetY();
-        hyp3r.fPosZDeu = deu->GetZ();
-        hyp3r.fPosXP   = p->GetX();
-        hyp3r.fPosYP   = p->GetY();
-        hyp3r.fPosZP   = p->GetZ();
-        hyp3r.fPosXPi  = pi->GetX();
-        hyp3r.fPosYPi  = pi->GetY();
-        hyp3r.fPosZPi  = pi->GetZ();
+        hyp3r.fPxDeu = deuAtVtx.Px();
+        hyp3r.fPyDeu = deuAtVtx.Py();
+        hyp3r.fPzDeu = deuAtVtx.Pz();
+        hyp3r.fPxP   = pAtVtx.Px();
+        hyp3r.fPyP   = pAtVtx.Py();
+        hyp3r.fPzP   = pAtVtx.Pz();
+        hyp3r.fPxPi  = piAtVtx.Px();
+        hyp3r.fPyPi  = piAtVtx.Py();
+        hyp3r.fPzPi  = piAtVtx.Pz();
+
+        hyp3r.fPosXDeu = deuAtVtx.GetX();
+        hyp3r.fPosYDeu = deuAtVtx.GetY();
+        hyp3r.fPosZDeu = deuAtVtx.GetZ();
+        hyp3r.fPosXP   = pAtVtx.GetX();
+        hyp3r.fPosYP   = pAtVtx.GetY();
+        hyp3r.fPosZP   = pAtVtx.GetZ();
+        hyp3r.fPosXPi  = piAtVtx.GetX();
+        hyp3r.fPosYPi  = piAtVtx.GetY();
+        hyp3r.fPosZPi  = piAtVtx.GetZ();
 
         hyp3r.fDCAxyDeu = dcaDecayDeu[0];
         hyp3r.fDCAzDeu  = dcaDecayDeu[1];
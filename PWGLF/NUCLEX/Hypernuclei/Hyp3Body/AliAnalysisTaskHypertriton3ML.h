@@ -114,6 +114,15 @@ struct SHypertriton3 {
   float fPzPi;
 };
 
+/// Per-event cache of the daughter quantities used in the combinatorics which do not change
+/// when the tracks are propagated by the vertexer
+struct CHypertriton3Daughter {
+  AliESDtrack *fTrack;
+  float fNSigmaTPC;
+  float fP; /// momentum modulus, conserved by the propagation in the magnetic field
+  float fE; /// energy under the daughter mass hypothesis
+};
+
 class AliAnalysisTaskHypertriton3ML : public AliAnalysisTaskSE {
 
 public:
@@ -219,14 +228,14 @@ private:
   std::vector<RHypertriton3> fRHypertriton; //!
   REvent fREvent;                           //!
 
-  std::vector<AliESDtrack *> fDeuVector;
-  std::vector<AliESDtrack *> fPVector;
-  std::vector<AliESDtrack *> fPiVector;
+  std::vector<CHypertriton3Daughter> fDeuVector; //!
+  std::vector<CHypertriton3Daughter> fPVector;   //!
+  std::vector<CHypertriton3Daughter> fPiVector;  //!
 
   AliAnalysisTaskHypertriton3ML(const AliAnalysisTaskHypertriton3ML &);            // not implemented
   AliAnalysisTaskHypertriton3ML &operator=(const AliAnalysisTaskHypertriton3ML &); // not implemented
 
-  ClassDef(AliAnalysisTaskHypertriton3ML, 1);
+  ClassDef(AliAnalysisTaskHypertriton3ML, 2);
 };
 
 #endif
\ No newline at end of file
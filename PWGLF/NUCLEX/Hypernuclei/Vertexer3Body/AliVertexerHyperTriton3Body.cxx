@@ -25,10 +25,12 @@ AliVertexerHyperTriton3Body::~AliVertexerHyperTriton3Body() {
   if (mCurrentVertex) delete mCurrentVertex;
 }
 
-void AliVertexerHyperTriton3Body::Find2ProngClosestPoint(AliExternalTrackParam *track1, AliExternalTrackParam *track2,
-                                                         float b, float *pos) {
-  /// Extracted from the constructor of AliESDv0
+void AliVertexerHyperTriton3Body::Find2ProngClosestPoint(const AliExternalTrackParam *trackIn1,
+                                                         const AliExternalTrackParam *trackIn2, float b, float *pos) {
+  /// Extracted from the constructor of AliESDv0, working on copies so that the input tracks are not propagated
 
+  AliExternalTrackParam copy1(*trackIn1), copy2(*trackIn2);
+  AliExternalTrackParam *track1 = &copy1, *track2 = &copy2;
   track1->PropagateToDCA(track2, b);
   track2->PropagateToDCA(track1, b);
 
@@ -67,7 +69,24 @@ bool AliVertexerHyperTriton3Body::FindDecayVertex(AliExternalTrackParam *deutero
   if (deuteronTrack->Charge() * protonTrack->Charge() < 0 || protonTrack->Charge() * pionTrack->Charge() > 0)
     return false;
 
+  float deuteronProtonGuess[3];
+  Find2ProngClosestPoint(deuteronTrack, protonTrack, b, deuteronProtonGuess);
+  return FindDecayVertex(deuteronTrack, protonTrack, pionTrack, b, deuteronProtonGuess);
+}
+
+bool AliVertexerHyperTriton3Body::FindDecayVertex(AliExternalTrackParam *deuteronTrack,
+                                                  AliExternalTrackParam *protonTrack,
+                                                  AliExternalTrackParam *pionTrack, float b,
+                                                  const float *deuteronProtonGuess) {
+
+  /// Cut on the charges
+  if (deuteronTrack->Charge() * protonTrack->Charge() < 0 || protonTrack->Charge() * pionTrack->Charge() > 0)
+    return false;
+
   float initialGuesses[3][3];
+  for (int iDim = 0; iDim < 3; ++iDim) {
+    initialGuesses[0][iDim] = deuteronProtonGuess[iDim];
+  }
 
   AliExternalTrackParam *tracks[3]{deuteronTrack, protonTrack, pionTrack};
 
@@ -76,7 +95,7 @@ bool AliVertexerHyperTriton3Body::FindDecayVertex(AliExternalTrackParam *deutero
   trArray.Add(protonTrack);
   trArray.Add(pionTrack);
 
-  for (int iTrack = 0; iTrack < 3; ++iTrack) {
+  for (int iTrack = 1; iTrack < 3; ++iTrack) {
     Find2ProngClosestPoint(tracks[iTrack], tracks[(iTrack + 1) % 3], b, initialGuesses[iTrack]);
   }
 
@@ -19,7 +19,12 @@ public:
 
   bool FindDecayVertex(AliExternalTrackParam *deuteronTrack, AliExternalTrackParam *protonTrack,
                        AliExternalTrackParam *pionTrack, float b);
-  static void Find2ProngClosestPoint(AliExternalTrackParam *track1, AliExternalTrackParam *track2, float b, float *pos);
+  /// Same as above, with the deuteron-proton closest point already computed by the caller (e.g. once per seed pair)
+  bool FindDecayVertex(AliExternalTrackParam *deuteronTrack, AliExternalTrackParam *protonTrack,
+                       AliExternalTrackParam *pionTrack, float b, const float *deuteronProtonGuess);
+  /// Closest point of two tracks, the tracks themselves are left untouched
+  static void Find2ProngClosestPoint(const AliExternalTrackParam *track1, const AliExternalTrackParam *track2, float b,
+                                     float *pos);
 
   void SetMaxDinstanceInit(float maxD) { mMaxDistanceInitialGuesses = maxD; }
   void SetToleranceGuessCompatibility(int tol) { mToleranceGuessCompatibility = tol; }
@@ -0,0 +1,313 @@
+#include "AliAnalysisCODEXcodec.h"
+
+#include <TList.h>
+#include <TObjString.h>
+#include <TTree.h>
+#include <TError.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace AliAnalysisCODEX {
+
+  namespace {
+    const char* kCodecInfoName = "CODEXcodec";
+
+    TObjString* FindCodecInfo(TTree *tree) {
+      TObjString *info = 0x0;
+      TIter next(tree->GetUserInfo());
+      while (TObject *obj = next()) {
+        TObjString *str = dynamic_cast<TObjString*>(obj);
+        if (str && str->GetString().BeginsWith(kCodecInfoName)) info = str;
+      }
+      return info;
+    }
+
+    int BitsForCode(unsigned long long code) {
+      int nBits = 1;
+      while (nBits < 64 && (code >> nBits)) nBits++;
+      return nBits;
+    }
+  }
+
+  Field::Field(const string &name, float min, float max, float binWidth) :
+    mName{name},
+    mMin{min},
+    mMax{max},
+    mBinWidth{binWidth > 0.f ? binWidth : 1.f},
+    mNbits{1},
+    mMaxCode{1u} {
+      if (mMax < mMin) mMax = mMin;
+      unsigned long long maxCode = (unsigned long long)(ceil((mMax - mMin) / mBinWidth));
+      if (maxCode < 1ull) maxCode = 1ull;
+      if (maxCode > 0xFFFFFFFFull) {
+        /// Too fine for 32 bits: keep the range and coarsen the step
+        ::Warning("AliAnalysisCODEX::Field", "%s: bin width %g needs more than 32 bits, using 32", mName.data(), mBinWidth);
+        maxCode = 0xFFFFFFFFull;
+        mBinWidth = (mMax - mMin) / maxCode;
+      }
+      mMaxCode = (unsigned int)maxCode;
+      mNbits = BitsForCode(maxCode);
+    }
+
+  Field Field::FromBits(const string &name, float min, float max, int nBits) {
+    if (nBits < 1) nBits = 1;
+    if (nBits > 32) nBits = 32;
+    const unsigned long long maxCode = (1ull << nBits) - 1ull;
+    Field field(name, min, max, 1.f);
+    /// Use the full bit budget even when rounding of the width changes the number of bins
+    field.mBinWidth = field.mMax > field.mMin ? (field.mMax - field.mMin) / maxCode : 1.f;
+    field.mMaxCode = (unsigned int)maxCode;
+    field.mNbits = nBits;
+    return field;
+  }
+
+  unsigned int Field::Encode(float value) const {
+    if (value != value) return 0u; /// NaN
+    const float bin = round((value - mMin) / mBinWidth);
+    if (bin <= 0.f) return 0u;
+    if (bin >= float(mMaxCode)) return mMaxCode;
+    return (unsigned int)bin;
+  }
+
+  string Field::Serialise() const {
+    char buffer[256];
+    snprintf(buffer, 256, ":%.9g:%.9g:%.9g:%d:%u", mMin, mMax, mBinWidth, mNbits, mMaxCode);
+    return mName + buffer;
+  }
+
+  bool Field::Deserialise(const string &text, Field &field) {
+    const size_t sep = text.find(':');
+    if (sep == string::npos) return false;
+    float min, max, binWidth;
+    int nBits;
+    unsigned int maxCode;
+    if (sscanf(text.data() + sep + 1, "%g:%g:%g:%d:%u", &min, &max, &binWidth, &nBits, &maxCode) != 5) return false;
+    field = Field(text.substr(0, sep), min, max, 1.f);
+    field.mBinWidth = binWidth;
+    field.mNbits = nBits;
+    field.mMaxCode = maxCode;
+    return true;
+  }
+
+  void Basket::Pack(const vector<Field> &fields, const vector<unsigned int> &codes, int nRows) {
+    const int nFields = fields.size();
+    mNrows = nRows;
+    mOffsets.resize(nFields);
+    int nWords = 0;
+    for (int iF = 0; iF < nFields; ++iF) {
+      mOffsets[iF] = nWords;
+      nWords += WordsForColumn(fields[iF].GetNbits(), nRows);
+    }
+    mWords.assign(nWords, 0ull);
+
+    for (int iF = 0; iF < nFields; ++iF) {
+      const int nBits = fields[iF].GetNbits();
+      unsigned long long *words = mWords.data() + mOffsets[iF];
+      for (int iR = 0; iR < nRows; ++iR) {
+        const unsigned long long code = codes[iR * nFields + iF];
+        const long bit = long(iR) * nBits;
+        const int word = bit >> 6;
+        const int shift = bit & 63;
+        words[word] |= code << shift;
+        if (shift + nBits > 64) words[word + 1] |= code >> (64 - shift);
+      }
+    }
+  }
+
+  void Basket::UnpackCodes(const Field &field, int column, unsigned int *out) const {
+    const int nBits = field.GetNbits();
+    const unsigned long long mask = (1ull << nBits) - 1ull;
+    const unsigned long long *words = mWords.data() + mOffsets[column];
+    for (int iR = 0; iR < mNrows; ++iR) {
+      const long bit = long(iR) * nBits;
+      const int word = bit >> 6;
+      const int shift = bit & 63;
+      unsigned long long code = words[word] >> shift;
+      if (shift + nBits > 64) code |= words[word + 1] << (64 - shift);
+      out[iR] = (unsigned int)(code & mask);
+    }
+  }
+
+  void Basket::Unpack(const Field &field, int column, float *out) const {
+    /// Fields that fit a power of two width never straddle two words, the
+    /// inner loop is then branch free and the compiler can vectorise it.
+    const int nBits = field.GetNbits();
+    const unsigned long long mask = (1ull << nBits) - 1ull;
+    const unsigned long long *words = mWords.data() + mOffsets[column];
+    const float min = field.GetMin();
+    const float width = field.GetBinWidth();
+    if (64 % nBits == 0) {
+      const int perWord = 64 / nBits;
+      for (int iR = 0; iR < mNrows; ++iR)
+        out[iR] = min + float((words[iR / perWord] >> ((iR % perWord) * nBits)) & mask) * width;
+      return;
+    }
+    for (int iR = 0; iR < mNrows; ++iR) {
+      const long bit = long(iR) * nBits;
+      const int word = bit >> 6;
+      const int shift = bit & 63;
+      unsigned long long code = words[word] >> shift;
+      if (shift + nBits > 64) code |= words[word + 1] << (64 - shift);
+      out[iR] = min + float(code & mask) * width;
+    }
+  }
+
+  ColumnWriter::ColumnWriter(int basketSize) :
+    mFields(),
+    mBasketSize{basketSize > 0 ? basketSize : 4096},
+    mCodes(),
+    mNbuffered{0},
+    mNrows{0l},
+    mTree{0x0},
+    mBasket(),
+    mNwords{0},
+    mBuffer() {}
+
+  int ColumnWriter::AddField(const Field &field) {
+    if (mTree) {
+      ::Error("AliAnalysisCODEX::ColumnWriter::AddField", "Fields must be declared before connecting the tree, %s ignored", field.GetName().data());
+      return -1;
+    }
+    mFields.push_back(field);
+    return int(mFields.size()) - 1;
+  }
+
+  void ColumnWriter::Connect(TTree *tree) {
+    mTree = tree;
+    mCodes.resize(mBasketSize * mFields.size());
+    int maxWords = 0;
+    std::ostringstream info;
+    info << kCodecInfoName << ';' << mBasketSize;
+    for (size_t iF = 0; iF < mFields.size(); ++iF) {
+      maxWords += Basket::WordsForColumn(mFields[iF].GetNbits(), mBasketSize);
+      info << ';' << mFields[iF].Serialise();
+    }
+    mBuffer.resize(maxWords > 0 ? maxWords : 1);
+    mTree->Branch("nRows", &mBasket.mNrows, "nRows/I");
+    mTree->Branch("nWords", &mNwords, "nWords/I");
+    mTree->Branch("words", mBuffer.data(), "words[nWords]/l");
+    mTree->GetUserInfo()->Add(new TObjString(info.str().data()));
+  }
+
+  void ColumnWriter::Fill(const float *values) {
+    if (!mTree) {
+      ::Error("AliAnalysisCODEX::ColumnWriter::Fill", "No tree connected, row ignored");
+      return;
+    }
+    const int nFields = mFields.size();
+    unsigned int *codes = mCodes.data() + mNbuffered * nFields;
+    for (int iF = 0; iF < nFields; ++iF)
+      codes[iF] = mFields[iF].Encode(values[iF]);
+    mNrows++;
+    if (++mNbuffered == mBasketSize) Flush();
+  }
+
+  void ColumnWriter::Flush() {
+    if (!mNbuffered) return;
+    if (!mTree) {
+      ::Error("AliAnalysisCODEX::ColumnWriter::Flush", "No tree connected, %d rows dropped", mNbuffered);
+      mNbuffered = 0;
+      return;
+    }
+    mBasket.Pack(mFields, mCodes, mNbuffered);
+    mNwords = mBasket.mWords.size();
+    std::copy(mBasket.mWords.begin(), mBasket.mWords.end(), mBuffer.begin());
+    mTree->Fill();
+    mNbuffered = 0;
+  }
+
+  ColumnReader::ColumnReader(TTree *tree) :
+    mFields(),
+    mTree{0x0},
+    mBasket(),
+    mInfo(),
+    mTreeNumber{-1},
+    mNrows{0},
+    mNwords{0},
+    mBuffer() {
+      if (tree) Connect(tree);
+    }
+
+  bool ColumnReader::Connect(TTree *tree) {
+    mTree = 0x0;
+    mFields.clear();
+    mInfo.clear();
+    mTreeNumber = -1;
+    /// For a TChain the user info of the chain itself is empty, the description is in the files
+    tree->LoadTree(0);
+    TObjString *info = FindCodecInfo(tree->GetTree() ? tree->GetTree() : tree);
+    if (!info) {
+      ::Error("AliAnalysisCODEX::ColumnReader::Connect", "Tree %s has no codec description", tree->GetName());
+      return false;
+    }
+
+    std::istringstream stream(info->GetString().Data() + strlen(kCodecInfoName) + 1);
+    string token;
+    std::getline(stream, token, ';');
+    const int basketSize = atoi(token.data());
+    int maxWords = 0;
+    while (std::getline(stream, token, ';')) {
+      Field field;
+      if (!Field::Deserialise(token, field)) {
+        ::Error("AliAnalysisCODEX::ColumnReader::Connect", "Cannot parse field %s", token.data());
+        mFields.clear();
+        return false;
+      }
+      mFields.push_back(field);
+      maxWords += Basket::WordsForColumn(field.GetNbits(), basketSize);
+    }
+
+    mTree = tree;
+    mInfo = info->GetString().Data();
+    mTreeNumber = tree->GetTreeNumber();
+    mBuffer.resize(maxWords > 0 ? maxWords : 1);
+    mTree->SetBranchAddress("nRows", &mNrows);
+    mTree->SetBranchAddress("nWords", &mNwords);
+    mTree->SetBranchAddress("words", mBuffer.data());
+    return true;
+  }
+
+  long ColumnReader::GetNbaskets() const {
+    return mTree ? mTree->GetEntries() : 0l;
+  }
+
+  int ColumnReader::ReadBasket(long iBasket) {
+    mBasket.mNrows = 0;
+    if (!mTree || mTree->LoadTree(iBasket) < 0) return 0;
+    if (mTree->GetTreeNumber() != mTreeNumber) {
+      /// New file of a chain: the words buffer is sized for the first description
+      TObjString *info = FindCodecInfo(mTree->GetTree());
+      if (!info || mInfo != info->GetString().Data()) {
+        ::Error("AliAnalysisCODEX::ColumnReader::ReadBasket", "Tree %d of the chain has a different codec description", mTree->GetTreeNumber());
+        return 0;
+      }
+      mTreeNumber = mTree->GetTreeNumber();
+    }
+    if (mTree->GetEntry(iBasket) <= 0) return 0;
+    mBasket.mNrows = mNrows;
+    mBasket.mOffsets.resize(mFields.size());
+    int nWords = 0;
+    for (size_t iF = 0; iF < mFields.size(); ++iF) {
+      mBasket.mOffsets[iF] = nWords;
+      nWords += Basket::WordsForColumn(mFields[iF].GetNbits(), mNrows);
+    }
+    if (nWords != mNwords) {
+      ::Error("AliAnalysisCODEX::ColumnReader::ReadBasket", "Basket %ld has %d words, %d expected", iBasket, mNwords, nWords);
+      mBasket.mNrows = 0;
+      return 0;
+    }
+    mBasket.mWords.assign(mBuffer.begin(), mBuffer.begin() + mNwords);
+    return mNrows;
+  }
+
+  int ColumnReader::FindField(const string &name) const {
+    for (size_t iF = 0; iF < mFields.size(); ++iF)
+      if (mFields[iF].GetName() == name) return iF;
+    return -1;
+  }
+}
@@ -0,0 +1,129 @@
+#ifndef ALIANALYSISCODEXCODEC_H
+#define ALIANALYSISCODEXCODEC_H
+
+#include <Rtypes.h>
+#include <string>
+#include <vector>
+
+class TTree;
+
+using std::string;
+using std::vector;
+
+/// Quantised columnar codec, generalisation of the fixed bin widths used in the
+/// CODEX track format (kTPCsigmaBinWidth, kDCAbinWidth, ...).
+///
+/// A task declares its fields with a range and either a bin width or a bit budget.
+/// Rows are buffered in baskets; when a basket is full each field is stored as a
+/// bit-aligned column of quantised codes, starting on a 64 bit word boundary so that
+/// a column can be decoded without touching the others. Values outside the range
+/// saturate to the first or last bin, as the CODEX setters do.
+///
+/// Usage in an AliAnalysisTaskSE:
+///   UserCreateOutputObjects: mTree = new TTree(...); mWriter.AddField(...); mWriter.Connect(mTree);
+///   UserExec:                mWriter.Fill(values);
+///   FinishTaskOutput:        mWriter.Flush();
+/// and offline ColumnReader reader(tree); reader.ReadBasket(i); reader.Decode(field, out);
+/// The reader also takes a TChain of such trees, all written with the same fields.
+
+namespace AliAnalysisCODEX {
+
+  class Field {
+    public:
+      Field(const string &name = "", float min = 0.f, float max = 1.f, float binWidth = 1.f);
+
+      static Field FromBits(const string &name, float min, float max, int nBits);
+
+      unsigned int Encode(float value) const;
+      float        Decode(unsigned int code) const { return mMin + code * mBinWidth; }
+
+      const string& GetName()     const { return mName; }
+      float         GetMin()      const { return mMin; }
+      float         GetMax()      const { return mMax; }
+      float         GetBinWidth() const { return mBinWidth; }
+      int           GetNbits()    const { return mNbits; }
+      unsigned int  GetMaxCode()  const { return mMaxCode; }
+
+      string        Serialise() const;
+      static bool   Deserialise(const string &text, Field &field);
+
+    private:
+      string       mName;      /// Name of the field
+      float        mMin;       /// Lower edge of the range, decoded value of code 0
+      float        mMax;       /// Upper edge of the range
+      float        mBinWidth;  /// Quantisation step
+      int          mNbits;     /// Number of bits of the codes, at most 32
+      unsigned int mMaxCode;   /// Largest code, saturation value
+  };
+
+  /// Bit-aligned storage of the quantised columns of a basket
+  class Basket {
+    public:
+      Basket() : mNrows(0), mOffsets(), mWords() {}
+
+      void  Pack(const vector<Field> &fields, const vector<unsigned int> &codes, int nRows);
+      void  Unpack(const Field &field, int column, float *out) const;
+      void  UnpackCodes(const Field &field, int column, unsigned int *out) const;
+
+      static int WordsForColumn(int nBits, int nRows) { return (nBits * nRows + 63) / 64; }
+
+      int                         mNrows;   /// Number of rows in the basket
+      vector<int>                 mOffsets; /// First word of each column
+      vector<unsigned long long>  mWords;   /// Packed columns
+  };
+
+  class ColumnWriter {
+    public:
+      ColumnWriter(int basketSize = 4096);
+
+      int   AddField(const Field &field);
+      int   AddField(const string &name, float min, float max, float binWidth) { return AddField(Field(name, min, max, binWidth)); }
+      int   AddFieldBits(const string &name, float min, float max, int nBits)  { return AddField(Field::FromBits(name, min, max, nBits)); }
+
+      void  Connect(TTree *tree);
+      void  Fill(const float *values);
+      void  Flush();
+
+      int   GetNfields()    const { return int(mFields.size()); }
+      long  GetNrows()      const { return mNrows; }
+      const Field& GetField(int i) const { return mFields[i]; }
+
+    private:
+      vector<Field>              mFields;     /// Declared fields
+      int                        mBasketSize; /// Rows per basket
+      vector<unsigned int>       mCodes;      /// Row-major codes of the current basket
+      int                        mNbuffered;  /// Rows in the current basket
+      long                       mNrows;      /// Total number of rows filled
+      TTree                     *mTree;       /// Output tree, one entry per basket
+      Basket                     mBasket;     /// Basket being written
+      int                        mNwords;     /// Branch buffer: number of words
+      vector<unsigned long long> mBuffer;     /// Branch buffer: words
+  };
+
+  class ColumnReader {
+    public:
+      ColumnReader(TTree *tree = 0x0);
+
+      bool  Connect(TTree *tree);
+      long  GetNbaskets() const;
+      int   ReadBasket(long iBasket);
+      void  Decode(int field, float *out) const { mBasket.Unpack(mFields[field], field, out); }
+      void  DecodeCodes(int field, unsigned int *out) const { mBasket.UnpackCodes(mFields[field], field, out); }
+      int   FindField(const string &name) const;
+
+      int   GetNfields() const { return int(mFields.size()); }
+      int   GetNrows()   const { return mBasket.mNrows; }
+      const Field& GetField(int i) const { return mFields[i]; }
+
+    private:
+      vector<Field>              mFields;  /// Fields read from the user info of the (first) tree
+      TTree                     *mTree;    /// Input tree
+      Basket                     mBasket;  /// Current basket
+      string                     mInfo;    /// Codec description the buffers are sized for
+      int                        mTreeNumber; /// Current tree of a chain
+      int                        mNrows;   /// Branch buffer: number of rows
+      int                        mNwords;  /// Branch buffer: number of words
+      vector<unsigned long long> mBuffer;  /// Branch buffer: words
+  };
+}
+#endif
@@ -32,6 +32,7 @@ public:
    AliRsnCutMiniPair(const char *name = "cut", EType type = kTypes);
    virtual ~AliRsnCutMiniPair() { }
 
+   EType          GetType() const {return fType;}
    virtual Bool_t IsSelected(TObject *obj);
 
 private:
@@ -568,9 +568,15 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    Int_t ievt, nEvents = (Int_t)fEvBuffer->GetEntries();
    Int_t idef, nDefs   = fHistograms.GetEntries();
    Int_t imix, iloop, ifill;
+   Int_t igroup, nGroups;
    AliRsnMiniOutput *def = 0x0;
    AliRsnMiniOutput::EComputation compType;
 
+   // pair outputs which loop on the same pairs are filled together
+   AliRsnMiniOutput **groupDefs = new AliRsnMiniOutput*[nDefs > 0 ? nDefs : 1];
+   Int_t *groupStart = new Int_t[nDefs + 1];
+   nGroups = GroupPairOutputs(kFALSE, groupDefs, groupStart);
+
    Int_t printNum = fMixPrintRefresh;
    if (printNum < 0) {
       if (nEvents>1e5) printNum=nEvents/100;
@@ -603,21 +609,11 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
                def->FillEvent(fMiniEvent, &fValues);
                break;
             case AliRsnMiniOutput::kTruePair:
-               //AliDebugClass(1, Form("Event %d, def '%s': true-pair histogram filling", ievt, def->GetName()));
-               ifill = def->FillPair(fMiniEvent, fMiniEvent, &fValues);
-               break;
             case AliRsnMiniOutput::kTrackPair:
-               //AliDebugClass(1, Form("Event %d, def '%s': pair-value histogram filling", ievt, def->GetName()));
-               ifill = def->FillPair(fMiniEvent, fMiniEvent, &fValues);
-               break;
             case AliRsnMiniOutput::kTrackPairRotated1:
-               //AliDebugClass(1, Form("Event %d, def '%s': rotated (1) background histogram filling", ievt, def->GetName()));
-               ifill = def->FillPair(fMiniEvent, fMiniEvent, &fValues);
-               break;
             case AliRsnMiniOutput::kTrackPairRotated2:
-               //AliDebugClass(1, Form("Event %d, def '%s': rotated (2) background histogram filling", ievt, def->GetName()));
-               ifill = def->FillPair(fMiniEvent, fMiniEvent, &fValues);
-               break;
+               // filled below, in groups
+               continue;
             default:
                // other kinds are processed elsewhere
                ifill = 0;
@@ -626,11 +622,17 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
          // message
          AliDebugClass(1, Form("Event %6d: def = '%15s' -- fills = %5d", ievt, def->GetName(), ifill));
       }
+      for (igroup = 0; igroup < nGroups; igroup++) {
+         ifill = AliRsnMiniOutput::FillPairGroup(&groupDefs[groupStart[igroup]], groupStart[igroup + 1] - groupStart[igroup], fMiniEvent, fMiniEvent, &fValues);
+         AliDebugClass(1, Form("Event %6d: def = '%15s' (+%d) -- fills = %5d", ievt, groupDefs[groupStart[igroup]]->GetName(), groupStart[igroup + 1] - groupStart[igroup] - 1, ifill));
+      }
    }
 
    // if no mixing is required, stop here and post the output
    if (fNMix < 1) {
       AliDebugClass(2, "Stopping here, since no mixing is required");
+      delete [] groupDefs;
+      delete [] groupStart;
       PostData(1, fOutput);
       return;
    }
@@ -681,6 +683,7 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    timer.Stop(); timer.Print(); fflush(stdout); timer.Start();
 
    // perform mixing
+   nGroups = GroupPairOutputs(kTRUE, groupDefs, groupStart);
    TObjArray *list = 0x0;
    TObjString *os = 0x0;
    for (ievt = 0; ievt < nEvents; ievt++) {
@@ -696,14 +699,13 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
       while ( (os = (TObjString *)next()) ) {
          imix = os->GetString().Atoi();
          fEvBuffer->GetEntry(imix);
-         for (idef = 0; idef < nDefs; idef++) {
-            def = (AliRsnMiniOutput *)fHistograms[idef];
-            if (!def) continue;
-            if (!def->IsTrackPairMix()) continue;
-            ifill += def->FillPair(&evMain, fMiniEvent, &fValues, kTRUE);
-            if (!def->IsSymmetric()) {
+         for (igroup = 0; igroup < nGroups; igroup++) {
+            AliRsnMiniOutput **group = &groupDefs[groupStart[igroup]];
+            Int_t nGroupDefs = groupStart[igroup + 1] - groupStart[igroup];
+            ifill += AliRsnMiniOutput::FillPairGroup(group, nGroupDefs, &evMain, fMiniEvent, &fValues, kTRUE);
+            if (!group[0]->IsSymmetric()) {
                AliDebugClass(2, "Reflecting non symmetric pair");
-               ifill += def->FillPair(fMiniEvent, &evMain, &fValues, kFALSE);
+               ifill += AliRsnMiniOutput::FillPairGroup(group, nGroupDefs, fMiniEvent, &evMain, &fValues, kFALSE);
             }
          }
       }
@@ -711,6 +713,8 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    }
 
    delete [] smatched;
+   delete [] groupDefs;
+   delete [] groupStart;
 
    AliInfo(Form("[%s] EventMixing %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout);
@@ -720,6 +724,63 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    if (fRsnTreeInFile) PostData(2, fEvBuffer);
 }
 
+//__________________________________________________________________________________________________
+/// Collects the pair outputs of the single-event pass (or of the mixing pass, if 'mixing' is true)
+/// in groups of outputs which loop on the same pairs, to be filled with AliRsnMiniOutput::FillPairGroup.
+/// The groups are stored one after the other in 'defs': group i goes from defs[start[i]]
+/// to defs[start[i+1]-1]. Returns the number of groups.
+/// Groups are in the order of their first output, and outputs which cannot share the pairs
+/// (see AliRsnMiniOutput::IsPairShareable) are left alone, so that each histogram
+/// gets exactly the same fills as when filling the outputs one by one.
+///
+Int_t AliRsnMiniAnalysisTask::GroupPairOutputs(Bool_t mixing, AliRsnMiniOutput **defs, Int_t *start)
+{
+   Int_t idef, jdef, nDefs = fHistograms.GetEntries();
+   Int_t ngroups = 0, n = 0;
+   AliRsnMiniOutput *def = 0x0, *other = 0x0;
+
+   Bool_t *isPair = new Bool_t[nDefs > 0 ? nDefs : 1];
+   for (idef = 0; idef < nDefs; idef++) {
+      def = (AliRsnMiniOutput *)fHistograms[idef];
+      isPair[idef] = kFALSE;
+      if (!def) continue;
+      switch (def->GetComputation()) {
+         case AliRsnMiniOutput::kTruePair:
+         case AliRsnMiniOutput::kTrackPair:
+         case AliRsnMiniOutput::kTrackPairRotated1:
+         case AliRsnMiniOutput::kTrackPairRotated2:
+            isPair[idef] = !mixing;
+            break;
+         case AliRsnMiniOutput::kTrackPairMix:
+            isPair[idef] = mixing;
+            break;
+         default:
+            break;
+      }
+   }
+
+   for (idef = 0; idef < nDefs; idef++) {
+      if (!isPair[idef]) continue;
+      def = (AliRsnMiniOutput *)fHistograms[idef];
+      start[ngroups++] = n;
+      defs[n++] = def;
+      isPair[idef] = kFALSE;
+      if (!def->IsPairShareable(&fValues)) continue;
+      for (jdef = idef + 1; jdef < nDefs; jdef++) {
+         if (!isPair[jdef]) continue;
+         other = (AliRsnMiniOutput *)fHistograms[jdef];
+         if (!def->HasSamePairs(other) || !other->IsPairShareable(&fValues)) continue;
+         defs[n++] = other;
+         isPair[jdef] = kFALSE;
+      }
+   }
+   start[ngroups] = n;
+
+   delete [] isPair;
+   AliDebugClass(1, Form("%d %s outputs in %d groups", n, (mixing ? "mixing" : "pair"), ngroups));
+   return ngroups;
+}
+
 //__________________________________________________________________________________________________
 /// Terminate function. 
 /// Called only once at the end.
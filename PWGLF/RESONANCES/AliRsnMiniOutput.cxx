@@ -25,6 +25,7 @@
 
 #include "AliLog.h"
 #include "AliRsnCutSet.h"
+#include "AliRsnCutMiniPair.h"
 #include "AliRsnMiniAxis.h"
 #include "AliRsnMiniOutput.h"
 #include "AliRsnMiniValue.h"
@@ -527,36 +528,61 @@ Int_t AliRsnMiniOutput::FillPair(AliRsnMiniEvent *event1, AliRsnMiniEvent *event
       return kFALSE;
    }
 
+   AliRsnMiniOutput *self = this;
+   return FillPairGroup(&self, 1, event1, event2, valueList, refFirst);
+}
+
+//________________________________________________________________________________________
+Int_t AliRsnMiniOutput::FillPairGroup(AliRsnMiniOutput **outputs, Int_t nOutputs, AliRsnMiniEvent *event1, AliRsnMiniEvent *event2, TClonesArray *valueList, Bool_t refFirst)
+{
+//
+// Same as FillPair, for a group of outputs which select the same pairs
+// (see HasSamePairs): the loop on the pairs and the kinematics of each pair
+// are done once, and each pair is then passed to all the outputs of the group.
+// Every output gets its own copy of the pair, since computing some values
+// modifies it. Returns the total number of fillings.
+//
+
+   if (nOutputs < 1) return 0;
+
+   // the daughter definitions are taken from the first output
+   AliRsnMiniOutput *ref = outputs[0];
+
    // loop variables
-   Int_t i1, i2, start, nadded = 0;
+   Int_t i1, i2, iout, start, nadded = 0;
    AliRsnMiniParticle *p1, *p2;
    Double_t mass1, mass2;
 
    // it is necessary to know if criteria for the two daughters are the same
    // and if the two events are the same or not (mixing)
    //Bool_t sameCriteria = ((fCharge[0] == fCharge[1]) && (fCutID[0] == fCutID[1]));
-   Bool_t sameCriteria = ((fCharge[0] == fCharge[1]) && (fDaughter[0] == fDaughter[1]));
+   Bool_t sameCriteria = ((ref->fCharge[0] == ref->fCharge[1]) && (ref->fDaughter[0] == ref->fDaughter[1]));
    Bool_t sameEvent = (event1->ID() == event2->ID());
 
-   TString selList1  = "";
-   TString selList2  = "";
-   Int_t   n1 = event1->CountParticles(fSel1, fCharge[0], fCutID[0]);
-   Int_t   n2 = event2->CountParticles(fSel2, fCharge[1], fCutID[1]);
-   for (i1 = 0; i1 < n1; i1++) selList1.Append(Form("%d ", fSel1[i1]));
-   for (i2 = 0; i2 < n2; i2++) selList2.Append(Form("%d ", fSel2[i2]));
-   AliDebugClass(1, Form("[%10s] Part #1: [%s] -- evID %6d -- charge = %c -- cut ID = %d --> %4d tracks (%s)", GetName(), (event1 == event2 ? "def" : "mix"), event1->ID(), fCharge[0], fCutID[0], n1, selList1.Data()));
-   AliDebugClass(1, Form("[%10s] Part #2: [%s] -- evID %6d -- charge = %c -- cut ID = %d --> %4d tracks (%s)", GetName(), (event1 == event2 ? "def" : "mix"), event2->ID(), fCharge[1], fCutID[1], n2, selList2.Data()));
+   Int_t   n1 = event1->CountParticles(ref->fSel1, ref->fCharge[0], ref->fCutID[0]);
+   Int_t   n2 = event2->CountParticles(ref->fSel2, ref->fCharge[1], ref->fCutID[1]);
+   if (AliDebugLevelClass() >= 1) {
+      TString selList1  = "";
+      TString selList2  = "";
+      for (i1 = 0; i1 < n1; i1++) selList1.Append(Form("%d ", ref->fSel1[i1]));
+      for (i2 = 0; i2 < n2; i2++) selList2.Append(Form("%d ", ref->fSel2[i2]));
+      AliDebugClass(1, Form("[%10s] Part #1: [%s] -- evID %6d -- charge = %c -- cut ID = %d --> %4d tracks (%s)", ref->GetName(), (event1 == event2 ? "def" : "mix"), event1->ID(), ref->fCharge[0], ref->fCutID[0], n1, selList1.Data()));
+      AliDebugClass(1, Form("[%10s] Part #2: [%s] -- evID %6d -- charge = %c -- cut ID = %d --> %4d tracks (%s)", ref->GetName(), (event1 == event2 ? "def" : "mix"), event2->ID(), ref->fCharge[1], ref->fCutID[1], n2, selList2.Data()));
+   }
    if (!n1 || !n2) {
       AliDebugClass(1, "No pairs to mix");
       return 0;
    }
 
+   // a single output fills its own pair directly, a group fills a shared one
+   // which starts from the state of the first output, as all outputs of the
+   // group have seen the same sequence of pairs
+   AliRsnMiniPair shared(ref->fPair);
+   AliRsnMiniPair &pair = (nOutputs > 1 ? shared : ref->fPair);
+
    // external loop
    for (i1 = 0; i1 < n1; i1++) {
-      p1 = event1->GetParticle(fSel1[i1]);
-      //p1 = event1->GetParticle(i1);
-      //if (p1->Charge() != fCharge[0]) continue;
-      //if (!p1->HasCutBit(fCutID[0])) continue;
+      p1 = event1->GetParticle(ref->fSel1[i1]);
       // define starting point for inner loop
       // if daughter selection criteria (charge, cuts) are the same
       // and the two events coincide, internal loop must start from
@@ -566,45 +592,67 @@ Int_t AliRsnMiniOutput::FillPair(AliRsnMiniEvent *event1, AliRsnMiniEvent *event
       AliDebugClass(2, Form("Start point = %d", start));
       // internal loop
       for (i2 = start; i2 < n2; i2++) {
-         p2 = event2->GetParticle(fSel2[i2]);
-         //p2 = event2->GetParticle(i2);
-         //if (p2->Charge() != fCharge[1]) continue;
-         //if (!p2->HasCutBit(fCutID[1])) continue;
+         p2 = event2->GetParticle(ref->fSel2[i2]);
          // avoid to mix a particle with itself
          if (sameEvent && (p1->Index() == p2->Index()) && (!p1->IsResonance())) {
             AliDebugClass(2, "Skipping same index");
             continue;
          }
          // sum momenta
-          
          mass1 = p1->StoredMass(kFALSE);
-         if(!fUseStoredMass[0] || mass1 < 0.0) mass1 = GetMass(0);
+         if(!ref->fUseStoredMass[0] || mass1 < 0.0) mass1 = ref->GetMass(0);
          mass2 = p2->StoredMass(kFALSE);
-         if(!fUseStoredMass[1] || mass2 < 0.0) mass2 = GetMass(1);
-         fPair.Fill(p1, p2, mass1, mass2, fMotherMass);
-	 
+         if(!ref->fUseStoredMass[1] || mass2 < 0.0) mass2 = ref->GetMass(1);
+         pair.Fill(p1, p2, mass1, mass2, ref->fMotherMass);
+
          // do rotation if needed
-         if (fComputation == kTrackPairRotated1) fPair.InvertP(kTRUE);
-         if (fComputation == kTrackPairRotated2) fPair.InvertP(kFALSE);
-         // if required, check that this is a true pair
-         if (fComputation == kTruePair) {
-            if (fPair.Mother() < 0)  {
-               continue;
-            } else if (fPair.MotherPDG() != fMotherPDG) {
-               continue;
-            }
-            Bool_t decayMatch = kFALSE;
-            if (AliRsnDaughter::IsEquivalentPDGCode(p1->PDGAbs() , GetPDG(0))
+         if (ref->fComputation == kTrackPairRotated1) pair.InvertP(kTRUE);
+         if (ref->fComputation == kTrackPairRotated2) pair.InvertP(kFALSE);
+
+         // pass the pair to each output
+         for (iout = 0; iout < nOutputs; iout++) {
+            AliRsnMiniOutput *out = outputs[iout];
+            if (nOutputs > 1) out->fPair = shared;
+            if (!out->AcceptPair(p1, p2)) continue;
+            // get computed values & fill histogram
+            nadded++;
+            if (refFirst) out->ComputeValues(event1, valueList); else out->ComputeValues(event2, valueList);
+            out->FillHistogram();
+         }
+      } // end internal loop
+   } // end external loop
+
+   AliDebugClass(1, Form("Pairs added in total = %4d", nadded));
+   return nadded;
+}
+
+//________________________________________________________________________________________
+Bool_t AliRsnMiniOutput::AcceptPair(AliRsnMiniParticle *p1, AliRsnMiniParticle *p2)
+{
+//
+// Output-specific checks on the pair stored in 'fPair':
+// true pair requirements (if required) and pair cuts.
+//
+
+   // if required, check that this is a true pair
+   if (fComputation == kTruePair) {
+      if (fPair.Mother() < 0)  {
+         return kFALSE;
+      } else if (fPair.MotherPDG() != fMotherPDG) {
+         return kFALSE;
+      }
+      Bool_t decayMatch = kFALSE;
+      if (AliRsnDaughter::IsEquivalentPDGCode(p1->PDGAbs() , GetPDG(0))
 		&& AliRsnDaughter::IsEquivalentPDGCode(p2->PDGAbs() , GetPDG(1)))
-               decayMatch = kTRUE;
-            if (AliRsnDaughter::IsEquivalentPDGCode(p2->PDGAbs() , GetPDG(0))
+         decayMatch = kTRUE;
+      if (AliRsnDaughter::IsEquivalentPDGCode(p2->PDGAbs() , GetPDG(0))
 		&& AliRsnDaughter::IsEquivalentPDGCode(p1->PDGAbs() , GetPDG(1)))
-               decayMatch = kTRUE;
-            if (!decayMatch) continue;
-	    if ( (fMaxNSisters>0) && (p1->NTotSisters()==p2->NTotSisters()) && (p1->NTotSisters()>fMaxNSisters)) continue;
+         decayMatch = kTRUE;
+      if (!decayMatch) return kFALSE;
+	    if ( (fMaxNSisters>0) && (p1->NTotSisters()==p2->NTotSisters()) && (p1->NTotSisters()>fMaxNSisters)) return kFALSE;
 	    if ( fCheckP &&(TMath::Abs(fPair.PmotherX()-(p1->Px(1)+p2->Px(1)))/(TMath::Abs(fPair.PmotherX())+1.e-13)) > 0.00001 &&
 		          (TMath::Abs(fPair.PmotherY()-(p1->Py(1)+p2->Py(1)))/(TMath::Abs(fPair.PmotherY())+1.e-13)) > 0.00001 &&
-     			  (TMath::Abs(fPair.PmotherZ()-(p1->Pz(1)+p2->Pz(1)))/(TMath::Abs(fPair.PmotherZ())+1.e-13)) > 0.00001 ) continue;
+  			  (TMath::Abs(fPair.PmotherZ()-(p1->Pz(1)+p2->Pz(1)))/(TMath::Abs(fPair.PmotherZ())+1.e-13)) > 0.00001 ) return kFALSE;
 	    if ( fCheckFeedDown ){
 	    		Int_t pdgGranma = 0;
 	  		Bool_t isFromB=kFALSE;
@@ -621,33 +669,82 @@ Int_t AliRsnMiniOutput::FillPair(AliRsnMiniEvent *event1, AliRsnMiniEvent *event
 			  }
 	  		if (pdgGranma == -99999){
 	  			AliDebug(2,"This particle does not have a quark in his genealogy\n");
-	  			continue;
+	  			return kFALSE;
 	  		}
 	  		if (pdgGranma == -9999){
 	  			AliDebug(2,"This particle come from a B decay channel but according to the settings of the task, we keep only the prompt charm particles\n");
-	  			continue;
+	  			return kFALSE;
 	  		}
 	 
 	  		if (pdgGranma == -999){
 	  			AliDebug(2,"This particle come from a prompt charm particles but according to the settings of the task, we want only the ones coming from B\n");
-	  			continue;
+	  			return kFALSE;
 	  		}
 		    }
-         }
-         // check pair against cuts
-         if (fPairCuts) {
-            if (!fPairCuts->IsSelected(&fPair)) continue;
-         }
-         // get computed values & fill histogram
-         nadded++;
-         if (refFirst) ComputeValues(event1, valueList); else ComputeValues(event2, valueList);
-         FillHistogram();
-      } // end internal loop
-   } // end external loop
+   }
+   // check pair against cuts
+   if (fPairCuts) {
+      if (!fPairCuts->IsSelected(&fPair)) return kFALSE;
+   }
+   return kTRUE;
+}
 
-   AliDebugClass(1, Form("Pairs added in total = %4d", nadded));
-   return nadded;
+//________________________________________________________________________________________
+Bool_t AliRsnMiniOutput::HasSamePairs(const AliRsnMiniOutput *other) const
+{
+//
+// Tells if the other output loops on the same pairs with the same kinematics:
+// same daughter selections and masses, and same rotation of the daughters.
+// True pairs are built like the track pairs, and differ only in AcceptPair.
+//
+
+   if (!other) return kFALSE;
+
+   Int_t rot1 = ((fComputation == kTrackPairRotated1 || fComputation == kTrackPairRotated2) ? (Int_t)fComputation : (Int_t)kTrackPair);
+   Int_t rot2 = ((other->fComputation == kTrackPairRotated1 || other->fComputation == kTrackPairRotated2) ? (Int_t)other->fComputation : (Int_t)kTrackPair);
+   if (IsTrackPairMix() != other->IsTrackPairMix()) return kFALSE;
+   if (rot1 != rot2) return kFALSE;
+
+   for (Int_t i = 0; i < 2; i++) {
+      if (fCutID[i] != other->fCutID[i]) return kFALSE;
+      if (fCharge[i] != other->fCharge[i]) return kFALSE;
+      if (fDaughter[i] != other->fDaughter[i]) return kFALSE;
+      if (fUseStoredMass[i] != other->fUseStoredMass[i]) return kFALSE;
+   }
+   return (fMotherMass == other->fMotherMass);
 }
+
+//________________________________________________________________________________________
+Bool_t AliRsnMiniOutput::IsPairShareable(TClonesArray *valueList)
+{
+//
+// Tells if this output can be filled in a group with others (see FillPairGroup).
+// Outputs which use random numbers for a pair (PhiV, as value or as pair cut)
+// must be filled on their own, to keep the same sequence of random numbers,
+// and so do outputs with pair cuts of other kinds than AliRsnCutMiniPair.
+//
+
+   Int_t i, ival, nval = valueList->GetEntries();
+   for (i = 0; i < fAxes.GetEntries(); i++) {
+      AliRsnMiniAxis *axis = (AliRsnMiniAxis *)fAxes[i];
+      if (!axis) continue;
+      ival = axis->GetValueID();
+      if (ival < 0 || ival >= nval) continue;
+      AliRsnMiniValue *val = (AliRsnMiniValue *)valueList->At(ival);
+      if (val && val->GetType() == AliRsnMiniValue::kPhiV) return kFALSE;
+   }
+
+   if (fPairCuts) {
+      TObjArray *cuts = fPairCuts->GetCuts();
+      for (i = 0; i < cuts->GetEntriesFast(); i++) {
+         AliRsnCutMiniPair *cut = dynamic_cast<AliRsnCutMiniPair *>(cuts->At(i));
+         if (!cut || cut->GetType() == AliRsnCutMiniPair::kPhiVRange) return kFALSE;
+      }
+   }
+
+   return kTRUE;
+}
+
 //___________________________________________________________
 void AliRsnMiniOutput::SetDselection(UShort_t originDselection)
 {
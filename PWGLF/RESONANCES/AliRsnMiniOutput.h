@@ -110,6 +110,9 @@ public:
    Bool_t          FillMotherInAcceptance(const AliRsnMiniPair *pair, AliRsnMiniEvent *event, TClonesArray *valueList);
    Bool_t          FillEvent(AliRsnMiniEvent *event, TClonesArray *valueList);
    Int_t           FillPair(AliRsnMiniEvent *event1, AliRsnMiniEvent *event2, TClonesArray *valueList, Bool_t refFirst = kTRUE);
+   Bool_t          HasSamePairs(const AliRsnMiniOutput *other) const;
+   Bool_t          IsPairShareable(TClonesArray *valueList);
+   static Int_t    FillPairGroup(AliRsnMiniOutput **outputs, Int_t nOutputs, AliRsnMiniEvent *event1, AliRsnMiniEvent *event2, TClonesArray *valueList, Bool_t refFirst = kTRUE);
 
 private:
 
@@ -117,6 +120,7 @@ private:
    void   CreateHistogramSparse(const char *name);
    void   ComputeValues(AliRsnMiniEvent *event, TClonesArray *valueList);
    void   FillHistogram();
+   Bool_t AcceptPair(AliRsnMiniParticle *p1, AliRsnMiniParticle *p2);
 
    EOutputType      fOutputType;       //  type of output
    EComputation     fComputation;      //  type of computation
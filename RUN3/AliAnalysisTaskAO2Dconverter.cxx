@@ -20,6 +20,7 @@
 
 #include "TChain.h"
 #include "TTree.h"
+#include "TBranch.h"
 #include "AliAnalysisTask.h"
 #include "AliAnalysisManager.h"
 #include "AliESDEvent.h"
@@ -30,6 +31,7 @@
 #include "AliESDCaloCells.h"
 #include "AliESDHeader.h"
 #include "AliESDtrack.h"
+#include "AliESDTOFCluster.h"
 
 #include "AliMCEvent.h"
 #include "AliMCEventHandler.h"
@@ -90,11 +92,37 @@ const TClass* AliAnalysisTaskAO2Dconverter::Generator[kGenerators] = { AliGenEve
 TTree* AliAnalysisTaskAO2Dconverter::CreateTree(TreeIndex t)
 {
   fTree[t] = new TTree(TreeName[t], TreeTitle[t]);
-  if (fTreeStatus[t])
-    fTree[t]->Branch("fEventId", &fEventId, "fEventId/l"); // Branch common to all trees
+  if (fTreeStatus[t]) {
+    if (t == kEvents)
+      fTree[t]->Branch("fEventId", &fEventId, "fEventId/l");
+    else
+      fTree[t]->Branch("fCollisionsID", &fCollisionsID, "fCollisionsID/I"); // Branch common to all the other trees
+  }
   return fTree[t];
 }
 
+void AliAnalysisTaskAO2Dconverter::SetIOSettings(TreeIndex t)
+{
+  if (!fTreeStatus[t])
+    return;
+  if (fBasketSize[t] > 0)
+    fTree[t]->SetBasketSize("*", fBasketSize[t]);
+  if (fCompressionAlgorithm[t] >= 0 || fCompressionLevel[t] >= 0) {
+    // Same encoding as ROOT::CompressionSettings: 100 * algorithm + level
+    // A component which is not set is taken from the current setting of the branch, i.e. the one of the output file
+    TObjArray* branches = fTree[t]->GetListOfBranches();
+    for (Int_t i = 0; i < branches->GetEntries(); i++) {
+      TBranch* branch = (TBranch*)branches->At(i);
+      Int_t current = branch->GetCompressionSettings();
+      if (current < 0) // Branch not attached to a file: ROOT default (ZLIB, level 1)
+        current = 101;
+      const Int_t algorithm = fCompressionAlgorithm[t] >= 0 ? fCompressionAlgorithm[t] : current / 100;
+      const Int_t level = fCompressionLevel[t] >= 0 ? fCompressionLevel[t] : current % 100;
+      branch->SetCompressionSettings(100 * algorithm + level);
+    }
+  }
+}
+
 void AliAnalysisTaskAO2Dconverter::PostTree(TreeIndex t)
 {
   if (!fTreeStatus[t])
@@ -104,9 +132,13 @@ void AliAnalysisTaskAO2Dconverter::PostTree(TreeIndex t)
 
 void AliAnalysisTaskAO2Dconverter::FillTree(TreeIndex t)
 {
-  if (!fTreeStatus[t])
+  if (!fTreeStatus[t]) {
+    if (t == kEvents) // Collisions are counted also without the event tree, the other trees refer to them with fCollisionsID
+      fEntries[t]++;
     return;
+  }
   fTree[t]->Fill();
+  fEntries[t]++;
 }
 
 void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
@@ -134,11 +166,20 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
     Events->Branch("fEventTime", &fEventTime, "fEventTime[10]/F");
     Events->Branch("fEventTimeRes", &fEventTimeRes, "fEventTimeRes[10]/F");
     Events->Branch("fEventTimeMask", &fEventTimeMask, "fEventTimeMask[10]/b");
+    // Collision to tracks, cells, TOF clusters and particles association
+    Events->Branch("fIndexTracks", &fIndexTracks, "fIndexTracks/I");
+    Events->Branch("fNTracks", &fNTracks, "fNTracks/I");
+    Events->Branch("fIndexCalo", &fIndexCalo, "fIndexCalo/I");
+    Events->Branch("fNCalo", &fNCalo, "fNCalo/I");
+    Events->Branch("fIndexTOF", &fIndexTOF, "fIndexTOF/I");
+    Events->Branch("fNTOF", &fNTOF, "fNTOF/I");
     if (fTaskMode == kMC) {
       Events->Branch("fGeneratorID", &fGeneratorID, "fGeneratorID/S");
       Events->Branch("fMCVtxX", &fMCVtxX, "fMCVtxX/F");
       Events->Branch("fMCVtxY", &fMCVtxY, "fMCVtxY/F");
       Events->Branch("fMCVtxZ", &fMCVtxZ, "fMCVtxZ/F");
+      Events->Branch("fIndexKine", &fIndexKine, "fIndexKine/I");
+      Events->Branch("fNKine", &fNKine, "fNKine/I");
     }
   }
   PostTree(kEvents);
@@ -202,6 +243,8 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   TTree* TOF = CreateTree(kTOF);
   TOF->SetAutoFlush(fNumberOfEventsPerCluster);
   if (fTreeStatus[kTOF]) {
+    if (fTOFTrackIndex)
+      TOF->Branch("fTracksID", &fTracksID, "fTracksID/I");
     TOF->Branch("fTOFChannel", &fTOFChannel, "fTOFChannel/I");
     TOF->Branch("fTOFncls", &fTOFncls, "fTOFncls/S");
     TOF->Branch("fDx", &fDx, "fDx/F");
@@ -229,6 +272,9 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   }
   PostTree(kKinematics);
 
+  for (Int_t i = 0; i < kTrees; i++)
+    SetIOSettings((TreeIndex)i);
+
   Prune(); //Removing all unwanted branches (if any)
 }
 
@@ -255,6 +301,35 @@ void AliAnalysisTaskAO2Dconverter::Prune()
   fPruneList = "";
 }
 
+void AliAnalysisTaskAO2Dconverter::FillTOFMatchable()
+{
+  // Invert the cluster -> matchable tracks association once per event.
+  // For each track only the first slot of each cluster is kept, as in the
+  // search done before per track and per cluster
+  const Int_t ntrk = fESD->GetNumberOfTracks();
+  if ((Int_t)fTOFMatchable.size() < ntrk)
+    fTOFMatchable.resize(ntrk);
+  for (Int_t itrk = 0; itrk < ntrk; itrk++)
+    fTOFMatchable[itrk].clear();
+
+  TClonesArray* TOFclusters = fESD->GetESDTOFClusters();
+  const Int_t ncls = TOFclusters ? TOFclusters->GetEntriesFast() : 0;
+  for (Int_t icls = 0; icls < ncls; icls++) {
+    AliESDTOFCluster* TOFcls = (AliESDTOFCluster*)TOFclusters->At(icls);
+    if (!TOFcls)
+      continue;
+    for (Int_t mtchbl = 0; mtchbl < TOFcls->GetNMatchableTracks(); mtchbl++) {
+      const Int_t trackIndex = TOFcls->GetTrackIndex(mtchbl);
+      if (trackIndex < 0 || trackIndex >= ntrk)
+        continue;
+      std::vector<std::pair<Int_t, Int_t> >& matchable = fTOFMatchable[trackIndex];
+      if (!matchable.empty() && matchable.back().first == icls)
+        continue; // Keep the first slot only
+      matchable.push_back(std::make_pair(icls, mtchbl));
+    }
+  }
+}
+
 void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
 {
   fESD = dynamic_cast<AliESDEvent *>(InputEvent());
@@ -291,6 +366,12 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
     ::Fatal("AliAnalysisTaskAO2Dconverter::UserExec", "Vertex not defined");
   }
   fEventId = GetEventIdAsLong(fESD->GetHeader());
+  // The event tree is filled last, once the number of entries of the collision in each tree is known
+  fCollisionsID = fEntries[kEvents];
+  fIndexTracks = fEntries[kTracks];
+  fIndexCalo = fEntries[kCalo];
+  fIndexTOF = fEntries[kTOF];
+  fIndexKine = fEntries[kKinematics];
   fVtxX = vtx->GetX();
   fVtxY = vtx->GetY();
   fVtxZ = vtx->GetZ();
@@ -341,10 +422,11 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
       }
     }
   }
-  FillTree(kEvents);
 
   // Fill fTrackTree
   Int_t ntrk = fESD->GetNumberOfTracks();
+  if (fTreeStatus[kTOF])
+    FillTOFMatchable();
   for (Int_t itrk = 0; itrk < ntrk; itrk++)
   {
     AliESDtrack *track = fESD->GetTrack(itrk);
@@ -397,19 +479,36 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
 
     fTOFncls = track->GetNTOFclusters();
 
-    if (fTOFncls > 0) {
+    if (fTOFncls > 0 && fTreeStatus[kTOF]) {
+      fTracksID = fEntries[kTracks];
       Int_t* TOFclsIndex = track->GetTOFclusterArray(); //Index of the matchable cluster (there are fNTOFClusters of them)
+      const Int_t trackID = track->GetID();
+      const Bool_t mapped = trackID >= 0 && trackID < ntrk;
       for (Int_t icls = 0; icls < fTOFncls; icls++) {
         AliESDTOFCluster* TOFcls = (AliESDTOFCluster*)fESD->GetESDTOFClusters()->At(TOFclsIndex[icls]);
         fToT = TOFcls->GetTOFsignalToT(0);
         fTOFChannel = TOFcls->GetTOFchannel();
-        for (Int_t mtchbl = 0; mtchbl < TOFcls->GetNMatchableTracks(); mtchbl++) {
-          if (TOFcls->GetTrackIndex(mtchbl) != track->GetID())
-            continue;
-          fDx = TOFcls->GetDx(mtchbl);
-          fDz = TOFcls->GetDz(mtchbl);
-          fLengthRatio = fLength > 0 ? TOFcls->GetLength(mtchbl) / fLength : -1;
-          break;
+        Int_t slot = -1;
+        if (mapped) { // Slot of this track in the cluster from the inverse map
+          const std::vector<std::pair<Int_t, Int_t> >& matchable = fTOFMatchable[trackID];
+          for (size_t imtch = 0; imtch < matchable.size(); imtch++) {
+            if (matchable[imtch].first != TOFclsIndex[icls])
+              continue;
+            slot = matchable[imtch].second;
+            break;
+          }
+        } else {
+          for (Int_t mtchbl = 0; mtchbl < TOFcls->GetNMatchableTracks(); mtchbl++) {
+            if (TOFcls->GetTrackIndex(mtchbl) != trackID)
+              continue;
+            slot = mtchbl;
+            break;
+          }
+        }
+        if (slot >= 0) {
+          fDx = TOFcls->GetDx(slot);
+          fDz = TOFcls->GetDz(slot);
+          fLengthRatio = fLength > 0 ? TOFcls->GetLength(slot) / fLength : -1;
         }
         FillTree(kTOF);
       }
@@ -485,6 +584,13 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
       FillTree(kKinematics);
     }
   }
+
+  fNTracks = fEntries[kTracks] - fIndexTracks;
+  fNCalo = fEntries[kCalo] - fIndexCalo;
+  fNTOF = fEntries[kTOF] - fIndexTOF;
+  fNKine = fEntries[kKinematics] - fIndexKine;
+  FillTree(kEvents);
+
   //Posting data
   for (Int_t i = 0; i < kTrees; i++)
     PostTree((TreeIndex)i);
@@ -15,6 +15,9 @@
 
 #include <Rtypes.h>
 
+#include <utility>
+#include <vector>
+
 class AliESDEvent;
 
 class AliAnalysisTaskAO2Dconverter : public AliAnalysisTaskSE
@@ -73,6 +76,13 @@ public:
   void Prune(TString p) { fPruneList = p; }; // Setter of the pruning list
   void SetMCMode() { fTaskMode = kMC; };     // Setter of the MC running mode
 
+  // I/O settings of the output trees, negative values keep the defaults of the output file
+  void SetCompression(TreeIndex t, Int_t algorithm, Int_t level) { fCompressionAlgorithm[t] = algorithm; fCompressionLevel[t] = level; };
+  void SetCompression(Int_t algorithm, Int_t level) { for (Int_t i = 0; i < kTrees; i++) SetCompression((TreeIndex)i, algorithm, level); };
+  void SetBasketSize(TreeIndex t, Int_t size) { fBasketSize[t] = size; };
+
+  void SetTOFTrackIndex(Bool_t flag = kTRUE) { fTOFTrackIndex = flag; }; // Store in the TOF tree the index of the track in the track tree
+
   AliAnalysisFilter fTrackFilter; // Standard track filter object
 private:
   AliEventCuts fEventCuts;      //! Standard event cuts
@@ -83,11 +93,20 @@ private:
   TTree* fTree[kTrees] = { nullptr }; //! Array with all the output trees
   void Prune();                       // Function to perform tree pruning
   void FillTree(TreeIndex t);         // Function to fill the trees (only the active ones)
+  void SetIOSettings(TreeIndex t);    // Function to apply the compression and basket size settings
 
   // Task configuration variables
   TString fPruneList = "";                // Names of the branches that will not be saved to output file
   Bool_t fTreeStatus[kTrees] = { kTRUE }; // Status of the trees i.e. kTRUE (enabled) or kFALSE (disabled)
   int fNumberOfEventsPerCluster = 1000;   // Maximum basket size of the trees
+  Int_t fCompressionAlgorithm[kTrees] = { -1, -1, -1, -1, -1 }; // Compression algorithm of the trees (ROOT::RCompressionSetting::EAlgorithm)
+  Int_t fCompressionLevel[kTrees] = { -1, -1, -1, -1, -1 };     // Compression level of the trees
+  Int_t fBasketSize[kTrees] = { -1, -1, -1, -1, -1 };           // Basket size in bytes of the branches of the trees
+  Bool_t fTOFTrackIndex = kFALSE;         // Add to the TOF tree the index of the track in the track tree
+
+  // Per event map from the track index to the TOF clusters (index, matchable slot) it is matchable to
+  std::vector<std::vector<std::pair<Int_t, Int_t> > > fTOFMatchable; //!
+  void FillTOFMatchable();            // Function to fill fTOFMatchable once per event
 
   TaskModes fTaskMode = kStandard; // Running mode of the task. Useful to set for e.g. MC mode
 
@@ -95,6 +114,15 @@ private:
 
   // Event variables
   ULong64_t fEventId = 0u;      /// Event unique id
+  Int_t fEntries[kTrees] = { 0 }; //! Number of entries filled in each tree (of collisions processed for the event tree)
+  Int_t fIndexTracks = -1;      /// Index of the first track of the collision in the track tree
+  Int_t fNTracks = 0;           /// Number of tracks of the collision
+  Int_t fIndexCalo = -1;        /// Index of the first cell of the collision in the calo tree
+  Int_t fNCalo = 0;             /// Number of calo cells of the collision
+  Int_t fIndexTOF = -1;         /// Index of the first cluster of the collision in the TOF tree
+  Int_t fNTOF = 0;              /// Number of TOF clusters of the collision
+  Int_t fIndexKine = -1;        /// Index of the first particle of the collision in the kinematics tree
+  Int_t fNKine = 0;             /// Number of particles of the collision
   Float_t fVtxX = -999.f;       /// Primary vertex x coordinate
   Float_t fVtxY = -999.f;       /// Primary vertex y coordinate
   Float_t fVtxZ = -999.f;       /// Primary vertex z coordinate
@@ -113,8 +141,10 @@ private:
 
   // fTrackTree variables
 
-  // Identifier to associate tracks to collisions.
-  // The inversed association (collisions to tracks) is generated on the fly
+  // Identifier to associate tracks, calo cells, TOF clusters and particles to collisions.
+  // Index of the collision in the event tree of the same output, the inversed association
+  // (collisions to tracks) is stored in the event tree as first index and number of entries
+  Int_t fCollisionsID = -1;     /// Index of the collision in the event tree
 
   // Coordinate system parameters
   Float_t fX = -999.f;     /// X coordinate for the point of parametrisation
@@ -186,6 +216,7 @@ private:
   Float_t fVt = -999.f; /// t of production vertex
 
   // TOF
+  Int_t fTracksID = -1;          /// Index of the track in the track tree
   Int_t fTOFChannel = -1;        /// Index of the matched channel
   Short_t fTOFncls = -1;         /// Number of matchable clusters of the track
   Float_t fDx = -999.f;          /// Residual along x
@@ -199,7 +230,7 @@ private:
   Float_t fTime = -999.f;       /// Cell time
   Char_t fType = -1;            /// Cell type (-1 is undefined, 0 is PHOS, 1 is EMCAL)
 
-  ClassDef(AliAnalysisTaskAO2Dconverter, 1);
+  ClassDef(AliAnalysisTaskAO2Dconverter, 3);
 };
 
 #endif